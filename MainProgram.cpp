@@ -23,6 +23,9 @@ int main(int argc, char *argv[]) {
     MainProgram mainProgram;
 
     int targetFpsFromArg = -1;
+    string aotProjectPath;
+    string aotOutputDir = "aot";
+    int executorBenchFrames = 0; // --executor-bench: 0 이면 일반 실행
     for (int i = 1; i < argc; ++i) {
         string arg = argv[i];
         if (arg == "--help" || arg == "-h") {
@@ -41,6 +44,20 @@ int main(int argc, char *argv[]) {
                     "                       0: 비활성, 1: 활성 (기본값)\n" +
                     "  --showfps <0|1>      FPS 를 표시합니다.\n" +
                     "                       0: 사용 안 함 (기본값), 1: 사용\n" +
+                    "  --boost <0|1>        부스트 모드를 사용합니다. 반복문을 프레임마다 기다리지 않고 연속 실행합니다.\n" +
+                    "                       0: 사용 안 함 (기본값), 1: 사용\n" +
+                    "  --shard <0|1|2>      엔티티 샤드 실행. 한 오브젝트의 스크립트를 한 작업 스레드에서 잠금 없이 실행합니다.\n" +
+                    "                       0: 고정 안 함 (작업자 수에 따라 결과가 달라질 수 있음), 1: 오브젝트마다 (기본값), 2: 원본과 복제본을 함께\n" +
+                    "  --executor=<auto|pool|inline>\n" +
+                    "                       스크립트 실행기. inline 은 모든 스크립트를 메인 스레드에서 잠금 없이 실행합니다.\n" +
+                    "                       auto: 오브젝트가 20개 미만이면 inline (기본값)\n" +
+                    "  --executor-bench[=<프레임 수>]\n" +
+                    "                       같은 프로젝트를 inline 과 pool 실행기로 각각 돌려 프레임 지연과 초당 틱 수를 출력하고 종료합니다.\n" +
+                    "                       (기본값: 600 프레임)\n" +
+                    "  --aot <project.json> -o <폴더>\n" +
+                    "                       프로젝트를 C++ 소스(omocha_aot.cpp)로 변환하고 종료합니다.\n" +
+                    "                       -DOMOCHA_AOT_SOURCE=<파일> 로 엔진과 함께 빌드합니다.\n" +
+                    "                       대기 없는 구간의 계산/이동/변수 블록만 네이티브 코드가 되고 나머지는 인터프리터가 실행합니다.\n" +
                     "  -h, --help         이 도움말을 표시하고 종료합니다.\n\n" +
                     "예제:\n" +
                     "  OmochaEngine.exe --setfps 120 --setVsync 0"; // 예시 실행 파일 이름
@@ -147,6 +164,70 @@ int main(int argc, char *argv[]) {
                 cerr << "Warning: Value for --showfps out of range. Using default (0)." << endl;
                 engine.specialConfig.showFPS = false;
             }
+        } else if (arg == "--aot" && i + 1 < argc) {
+            aotProjectPath = argv[++i];
+        } else if (arg == "-o" && i + 1 < argc) {
+            aotOutputDir = argv[++i];
+        } else if (arg == "--boost" && i + 1 < argc) {
+            try {
+                string argValue = argv[i + 1];
+                engine.specialConfig.boostMode = stoi(argValue) == 1;
+                i++;
+            } catch (const invalid_argument &) {
+                cerr << "Warning: Invalid argument for --boost. Expected a number (0 or 1). Using default (0)." <<
+                        endl;
+                engine.specialConfig.boostMode = false;
+            }
+            catch (const out_of_range &) {
+                cerr << "Warning: Value for --boost out of range. Using default (0)." << endl;
+                engine.specialConfig.boostMode = false;
+            }
+        } else if (arg == "--shard" && i + 1 < argc) {
+            try {
+                int shardMode = stoi(argv[i + 1]);
+                engine.specialConfig.entityShardMode = (shardMode >= 0 && shardMode <= 2) ? shardMode : 1;
+                i++;
+            } catch (const invalid_argument &) {
+                cerr << "Warning: Invalid argument for --shard. Expected a number (0, 1 or 2). Using default (1)." <<
+                        endl;
+                engine.specialConfig.entityShardMode = 1;
+            }
+            catch (const out_of_range &) {
+                cerr << "Warning: Value for --shard out of range. Using default (1)." << endl;
+                engine.specialConfig.entityShardMode = 1;
+            }
+        } else if (arg.rfind("--executor-bench", 0) == 0) {
+            executorBenchFrames = 600;
+            if (arg.size() > 17 && arg[16] == '=') {
+                try {
+                    executorBenchFrames = stoi(arg.substr(17));
+                } catch (const exception &) {
+                    executorBenchFrames = 0;
+                }
+                if (executorBenchFrames <= 0) {
+                    cerr << "Warning: Invalid argument for --executor-bench. Expected a positive frame count. Using default (600)." <<
+                            endl;
+                    executorBenchFrames = 600;
+                }
+            }
+        } else if (arg.rfind("--executor", 0) == 0) {
+            string executor;
+            if (arg.size() > 11 && arg[10] == '=') {
+                executor = arg.substr(11);
+            } else if (arg == "--executor" && i + 1 < argc) {
+                executor = argv[++i];
+            }
+            if (executor == "auto") {
+                engine.specialConfig.scriptExecutor = 0;
+            } else if (executor == "pool") {
+                engine.specialConfig.scriptExecutor = 1;
+            } else if (executor == "inline") {
+                engine.specialConfig.scriptExecutor = 2;
+            } else {
+                cerr << "Warning: Invalid argument for --executor. Expected auto, pool or inline. Using default (auto)." <<
+                        endl;
+                engine.specialConfig.scriptExecutor = 0;
+            }
         }
     }
 
@@ -154,6 +235,15 @@ int main(int argc, char *argv[]) {
 
     SetTitle(OMOCHA_ENGINE_NAME);
 
+    if (!aotProjectPath.empty()) {
+        // AOT 변환만 하고 종료합니다. (그래픽/사운드 초기화 없음)
+        if (!engine.loadProject(aotProjectPath)) {
+            engine.EngineStdOut("AOT: failed to load project " + aotProjectPath, 2);
+            return 1;
+        }
+        return engine.exportAotSource(aotOutputDir) ? 0 : 1;
+    }
+
     string insideprojectPath = string(BASE_ASSETS) + "temp/project.json";
     string outSideprojectPath = string(BASE_ASSETS) + "project.json";
 
@@ -236,6 +326,10 @@ int main(int argc, char *argv[]) {
         }
 
         engine.renderLoadingScreen();
+        if (executorBenchFrames > 0) {
+            engine.runExecutorBenchmark(executorBenchFrames);
+            return 0;
+        }
         engine.EngineStdOut("Entering game loop.", 0);
         engine.runStartButtonScripts();
         bool quit = false;
@@ -284,7 +378,7 @@ int main(int argc, char *argv[]) {
                 }
                 if (engine.m_projectLoadRequestedViaOFD.load(std::memory_order_relaxed)) {
                     std::string pathToLoad; {
-                        std::lock_guard<std::recursive_mutex> lock(engine.m_engineDataMutex);
+                        std::lock_guard lock(engine.m_engineDataMutex);
                         // m_pendingProjectToLoadPath 접근 보호
                         pathToLoad = engine.m_pendingProjectToLoadPath;
                         engine.m_pendingProjectToLoadPath.clear(); // 경로 사용 후 초기화
@@ -303,19 +397,21 @@ int main(int argc, char *argv[]) {
             SDL_GetMouseState(&windowMouseX_main, &windowMouseY_main);
             engine.updateCurrentMouseStageCoordinates(windowMouseX_main, windowMouseY_main); // 엔티티 업데이트
             engine.updateMouseCursor(windowMouseX_main, windowMouseY_main); // 마우스 커서 업데이트
+            engine.beginBoostFrameBudget(); // 부스트 모드: 이번 프레임 스크립트 실행 예산 시작
             {
                 // std::lock_guard의 범위를 지정하기 위한 블록
-                std::lock_guard<std::recursive_mutex> lock(engine.m_engineDataMutex); // entities 맵 접근 전에 뮤텍스 잠금
+                std::lock_guard lock(engine.m_engineDataMutex); // entities 맵 접근 전에 뮤텍스 잠금
                 for (auto &[entity_key, entity_ptr]: engine.getEntities_Modifiable()) {
                     // entity_ptr is now std::shared_ptr<Entity>
                     if (entity_ptr) {
                         entity_ptr->updateDialog(deltaTime); // 다이얼로그 시간 업데이트
-                        entity_ptr->processInternalContinuations(deltaTime); // BLOCK_INTERNAL 상태 스크립트 직접 처리
-                        entity_ptr->resumeExplicitWaitScripts(deltaTime); // EXPLICIT_WAIT_SECOND 상태 스크립트 재개
-                        entity_ptr->resumeSoundWaitScripts(deltaTime); // SOUND_FINISH 상태 스크립트 재개
                     }
                 }
+                // BLOCK_INTERNAL / EXPLICIT_WAIT_SECOND / SOUND_FINISH 는 깨어날 스레드만 예약 큐에서 꺼내 재개
+                engine.processScriptWakeups(deltaTime);
             } // 여기서 lock_guard가 소멸되면서 뮤텍스 자동 해제
+            engine.resumeTextInputWaiters(); // TEXT_INPUT 상태 스크립트 재개 (ask_and_wait)
+            engine.runScriptFrame(); // 이번 프레임에 실행할 스크립트 스레드를 모두 실행하고 렌더링 전에 합류
 
             // answer 변수 업데이트가 필요한지 확인
             if (engine.checkAndClearAnswerUpdateFlag()) {
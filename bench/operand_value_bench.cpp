@@ -0,0 +1,216 @@
+// calc_basic 연산 체인 마이크로벤치마크
+//
+// "before" 는 최적화 전 OperandValue 의 변환 방식(istringstream 파싱, to_string 형식화, 연산자 문자열 비교)을
+// 그대로 옮긴 LegacyValue 이고, "after" 는 엔진이 쓰는 OperandValue + applyCalcBasic 입니다.
+// 각 항목은 같은 입력으로 같은 결과를 만들어야 하므로 마지막 값을 함께 출력합니다.
+//
+//   operand_value_bench [반복 횟수]
+
+#include "engine/blocks/OperandValue.h"
+#include "engine/blocks/BlockExecutor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <locale>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    // 최적화 전 구현 (문자열 값은 매번 복사/trim 후 istringstream 으로 파싱, 숫자는 매번 to_string)
+    struct LegacyValue
+    {
+        enum class Type { EMPTY, NUMBER, STRING, BOOLEAN };
+        Type type = Type::EMPTY;
+        string string_val;
+        double number_val = 0.0;
+
+        LegacyValue() = default;
+        explicit LegacyValue(double v) : type(Type::NUMBER), number_val(v) {}
+        explicit LegacyValue(string v) : type(Type::STRING), string_val(move(v)) {}
+
+        static void trim(string &s)
+        {
+            s.erase(s.begin(), find_if(s.begin(), s.end(), [](unsigned char ch) { return !isspace(ch); }));
+            s.erase(find_if(s.rbegin(), s.rend(), [](unsigned char ch) { return !isspace(ch); }).base(), s.end());
+        }
+
+        static bool isNumber(const string &s)
+        {
+            string str = s;
+            trim(str);
+            if (str.empty())
+                return false;
+            try
+            {
+                size_t pos;
+                stod(str, &pos);
+                return pos == str.length();
+            }
+            catch (const exception &)
+            {
+                return false;
+            }
+        }
+
+        double asNumber() const
+        {
+            if (type == Type::NUMBER)
+                return number_val;
+            if (type != Type::STRING)
+                return 0.0;
+            string temp = string_val;
+            trim(temp);
+            if (temp.empty())
+                return 0.0;
+            istringstream iss(temp);
+            iss.imbue(locale::classic());
+            double value;
+            iss >> value;
+            if (!iss.fail() && iss.eof())
+                return value;
+            return 0.0;
+        }
+
+        string asString() const
+        {
+            if (type == Type::STRING)
+                return string_val;
+            if (type != Type::NUMBER)
+                return "";
+            if (isnan(number_val))
+                return "NaN";
+            if (isinf(number_val))
+                return number_val > 0 ? "Infinity" : "-Infinity";
+            string s = to_string(number_val);
+            s.erase(s.find_last_not_of('0') + 1, string::npos);
+            if (!s.empty() && s.back() == '.')
+                s.pop_back();
+            return s;
+        }
+    };
+
+    LegacyValue legacyCalcBasic(const string &anOperator, const LegacyValue &left, const LegacyValue &right)
+    {
+        if (anOperator == "PLUS")
+        {
+            bool leftIsNumeric = left.type == LegacyValue::Type::NUMBER ||
+                                 (left.type == LegacyValue::Type::STRING && LegacyValue::isNumber(left.string_val));
+            bool rightIsNumeric = right.type == LegacyValue::Type::NUMBER ||
+                                  (right.type == LegacyValue::Type::STRING && LegacyValue::isNumber(right.string_val));
+            if (leftIsNumeric && rightIsNumeric)
+                return LegacyValue(left.asNumber() + right.asNumber());
+            return LegacyValue(left.asString() + right.asString());
+        }
+        double l = left.asNumber();
+        double r = right.asNumber();
+        if (anOperator == "MINUS")
+            return LegacyValue(l - r);
+        if (anOperator == "MULTI")
+            return LegacyValue(l * r);
+        if (anOperator == "DIVIDE")
+            return LegacyValue(l / r);
+        return {};
+    }
+
+    template<typename Fn>
+    double measureNs(size_t iterations, Fn &&fn)
+    {
+        const auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+            fn(i);
+        const auto elapsed = chrono::steady_clock::now() - start;
+        return static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(elapsed).count()) /
+               static_cast<double>(iterations);
+    }
+
+    void report(const char *name, double beforeNs, double afterNs, const string &beforeResult,
+                const string &afterResult)
+    {
+        printf("%-34s %10.1f ns %10.1f ns %8.2fx   (%s / %s)\n", name, beforeNs, afterNs, beforeNs / afterNs,
+               beforeResult.c_str(), afterResult.c_str());
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t iterations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200000;
+    const Block block; // applyCalcBasic 오류 보고용
+    const string objectId = "bench";
+
+    printf("%-34s %13s %13s %9s\n", "calc_basic chain (per iteration)", "before", "after", "speedup");
+
+    // 1. 숫자 리터럴 체인: ((a + b) * c - d) / e
+    {
+        LegacyValue legacyResult;
+        const LegacyValue la(12.5), lb(7.25), lc(3.0), ld(1.5), le(4.0);
+        double before = measureNs(iterations, [&](size_t) {
+            LegacyValue v = legacyCalcBasic("PLUS", la, lb);
+            v = legacyCalcBasic("MULTI", v, lc);
+            v = legacyCalcBasic("MINUS", v, ld);
+            legacyResult = legacyCalcBasic("DIVIDE", v, le);
+        });
+        OperandValue result;
+        const OperandValue a(12.5), b(7.25), c(3.0), d(1.5), e(4.0);
+        double after = measureNs(iterations, [&](size_t) {
+            OperandValue v = applyCalcBasic(CalcBasicOperator::PLUS, a, b, block, objectId);
+            v = applyCalcBasic(CalcBasicOperator::MULTI, v, c, block, objectId);
+            v = applyCalcBasic(CalcBasicOperator::MINUS, v, d, block, objectId);
+            result = applyCalcBasic(CalcBasicOperator::DIVIDE, v, e, block, objectId);
+        });
+        report("number literals", before, after, legacyResult.asString(), result.asString());
+    }
+
+    // 2. 문자열 피연산자 체인 (문자열로 저장된 변수/입력값을 반복해서 읽는 경우)
+    {
+        LegacyValue legacyResult;
+        const LegacyValue la(string("12.5")), lb(string(" 7.25")), lc(string("3")), ld(string("1.5"));
+        double before = measureNs(iterations, [&](size_t) {
+            LegacyValue v = legacyCalcBasic("PLUS", la, lb);
+            v = legacyCalcBasic("MULTI", v, lc);
+            legacyResult = legacyCalcBasic("MINUS", v, ld);
+        });
+        OperandValue result;
+        const OperandValue a(string("12.5")), b(string(" 7.25")), c(string("3")), d(string("1.5"));
+        double after = measureNs(iterations, [&](size_t) {
+            OperandValue v = applyCalcBasic(CalcBasicOperator::PLUS, a, b, block, objectId);
+            v = applyCalcBasic(CalcBasicOperator::MULTI, v, c, block, objectId);
+            result = applyCalcBasic(CalcBasicOperator::MINUS, v, d, block, objectId);
+        });
+        report("string operands", before, after, legacyResult.asString(), result.asString());
+    }
+
+    // 3. 카운터: 변수 = 변수 + 1 (최적화 전에는 변수가 문자열로 저장되어 매번 파싱/형식화)
+    {
+        string legacyVariable = "0";
+        const LegacyValue one(1.0);
+        double before = measureNs(iterations, [&](size_t) {
+            legacyVariable = legacyCalcBasic("PLUS", LegacyValue(legacyVariable), one).asString();
+        });
+        OperandValue variable(0.0);
+        const OperandValue step(1.0);
+        double after = measureNs(iterations, [&](size_t) {
+            variable = applyCalcBasic(CalcBasicOperator::PLUS, variable, step, block, objectId);
+        });
+        report("counter (var = var + 1)", before, after, legacyVariable, variable.asString());
+    }
+
+    // 4. 문자열 이어 붙이기 (숫자가 아닌 피연산자)
+    {
+        LegacyValue legacyResult;
+        const LegacyValue la(string("score: ")), lb(42.0);
+        double before = measureNs(iterations, [&](size_t) { legacyResult = legacyCalcBasic("PLUS", la, lb); });
+        OperandValue result;
+        const OperandValue a(string("score: ")), b(42.0);
+        double after = measureNs(iterations, [&](size_t) {
+            result = applyCalcBasic(CalcBasicOperator::PLUS, a, b, block, objectId);
+        });
+        report("concatenation", before, after, legacyResult.asString(), result.asString());
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+// WorkStealingPool 게시/실행 처리량 벤치마크
+//
+// 작업자 수를 1 ~ 32 로 바꿔 가며 빈 작업을 게시하고 모두 실행될 때까지의 처리량(ops/s)을 잽니다.
+// - injected : 작업자가 아닌 스레드(메인 루프)가 모든 작업을 게시 -> 주입 큐 경로
+// - fan-out  : 루트 작업 몇 개가 작업자 안에서 자식 작업을 게시 -> 작업자 덱 push/pop 과 훔치기 경로
+// - locked   : 비교용. 전에 쓰던 방식처럼 뮤텍스 하나로 보호하는 큐 하나를 모든 작업자가 공유
+//
+//   work_stealing_pool_bench [작업 수]
+
+#include "util/WorkStealingPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    constexpr size_t kThreadCounts[] = {1, 2, 4, 8, 16, 32};
+    constexpr size_t kFanOutRoots = 64;
+
+    // 비교용 단일 큐 풀
+    class LockedQueuePool
+    {
+    public:
+        explicit LockedQueuePool(size_t threadCount)
+        {
+            for (size_t i = 0; i < threadCount; ++i)
+            {
+                m_threads.emplace_back([this] {
+                    while (true)
+                    {
+                        function<void()> task;
+                        {
+                            unique_lock lock(m_mutex);
+                            m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                            if (m_tasks.empty())
+                                return;
+                            task = move(m_tasks.front());
+                            m_tasks.pop();
+                        }
+                        task();
+                    }
+                });
+            }
+        }
+
+        ~LockedQueuePool()
+        {
+            {
+                lock_guard lock(m_mutex);
+                m_stop = true;
+            }
+            m_cv.notify_all();
+            for (thread &t : m_threads)
+                t.join();
+        }
+
+        void submit(function<void()> task)
+        {
+            {
+                lock_guard lock(m_mutex);
+                m_tasks.push(move(task));
+            }
+            m_cv.notify_one();
+        }
+
+    private:
+        vector<thread> m_threads;
+        queue<function<void()>> m_tasks;
+        mutex m_mutex;
+        condition_variable m_cv;
+        bool m_stop = false;
+    };
+
+    void waitFor(const atomic<size_t> &done, size_t expected)
+    {
+        while (done.load(memory_order_acquire) < expected)
+            this_thread::yield();
+    }
+
+    template<typename Fn>
+    double opsPerSecond(size_t operations, Fn &&fn)
+    {
+        const auto start = chrono::steady_clock::now();
+        fn();
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        return static_cast<double>(operations) / elapsed.count();
+    }
+
+    double benchInjected(size_t threads, size_t tasks)
+    {
+        WorkStealingPool pool(threads, [](WorkStealingPool::Task &task) { task(); });
+        atomic<size_t> done{0};
+        return opsPerSecond(tasks, [&] {
+            for (size_t i = 0; i < tasks; ++i)
+                pool.submit([&done] { done.fetch_add(1, memory_order_release); });
+            waitFor(done, tasks);
+        });
+    }
+
+    double benchFanOut(size_t threads, size_t tasks)
+    {
+        WorkStealingPool pool(threads, [](WorkStealingPool::Task &task) { task(); });
+        atomic<size_t> done{0};
+        const size_t children = tasks / kFanOutRoots;
+        return opsPerSecond(children * kFanOutRoots, [&] {
+            for (size_t r = 0; r < kFanOutRoots; ++r)
+            {
+                pool.submit([&pool, &done, children] {
+                    for (size_t i = 0; i < children; ++i)
+                        pool.submit([&done] { done.fetch_add(1, memory_order_release); });
+                });
+            }
+            waitFor(done, children * kFanOutRoots);
+        });
+    }
+
+    double benchLocked(size_t threads, size_t tasks)
+    {
+        LockedQueuePool pool(threads);
+        atomic<size_t> done{0};
+        return opsPerSecond(tasks, [&] {
+            for (size_t i = 0; i < tasks; ++i)
+                pool.submit([&done] { done.fetch_add(1, memory_order_release); });
+            waitFor(done, tasks);
+        });
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t tasks = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1'000'000;
+    printf("%zu empty tasks per run (hardware threads: %u)\n", tasks, thread::hardware_concurrency());
+    printf("%8s %16s %16s %16s\n", "threads", "injected ops/s", "fan-out ops/s", "locked ops/s");
+    for (size_t threads : kThreadCounts)
+    {
+        const double injected = benchInjected(threads, tasks);
+        const double fanOut = benchFanOut(threads, tasks);
+        const double locked = benchLocked(threads, tasks);
+        printf("%8zu %16.0f %16.0f %16.0f\n", threads, injected, fanOut, locked);
+    }
+    return 0;
+}
@@ -10,6 +10,8 @@
 #include <cmath>
 #include <cstdio>
 #include <algorithm>
+#include <unordered_set>
+#include <bit>
 #include <memory>
 #include <chrono>
 #include <format>
@@ -19,6 +21,8 @@
 #include <nlohmann/json.hpp>
 #include "blocks/BlockExecutor.h"
 #include "blocks/blockTypes.h"
+#include "blocks/ScriptCompiler.h"
+#include "blocks/AotCompiler.h"
 #include <future>
 #include <random>
 #include <regex>
@@ -53,6 +57,9 @@ const float Engine::MIN_LIST_WIDTH = 80.0f;
 const float Engine::MIN_LIST_HEIGHT = 60.0f;
 const float MOUSE_WHEEL_SCROLL_SPEED = 20.0f;
 const char *FONT_ASSETS = "font/";
+const double BOOST_FRAME_BUDGET_RATIO = 0.75; // 부스트 모드에서 스크립트가 사용할 수 있는 프레임 시간 비율
+const int64_t MIN_SCRIPT_QUANTUM_NS = 1'000'000; // 틱이 많아도 한 틱에 주는 최소 CPU 할당량
+const size_t INLINE_EXECUTOR_MAX_OBJECTS = 20; // 자동 선택에서 이보다 오브젝트가 적으면 인라인 실행기를 사용
 string PROJECT_NAME;
 string WINDOW_TITLE;
 string LOADING_METHOD_NAME;
@@ -63,37 +70,8 @@ static string NlohmannJsonToString(const nlohmann::json &value) {
 
 // Anonymous namespace for helper functions local to this file
 namespace {
-    // Helper function to recursively filter 'params' arrays within a JSON structure
-    void RecursiveFilterParamsArray(nlohmann::json &paramsArray, Engine &engine, const std::string &parentContext) {
-        if (!paramsArray.is_array()) {
-            // This function expects an array.
-            // If paramsArray was supposed to be an array but isn't, the calling code (ParseBlockDataInternal) handles logging.
-            return;
-        }
-
-        nlohmann::json filteredArray = nlohmann::json::array();
-        for (const auto &item: paramsArray) {
-            if (item.is_null()) {
-                // Skip null items
-                continue;
-            } else if (item.is_object() && item.contains("type") && item.contains("params") && item["params"].
-                       is_array()) {
-                // It's a block-like structure. Make a copy to modify its "params".
-                nlohmann::json subBlockCopy = item;
-                RecursiveFilterParamsArray(subBlockCopy["params"], engine,
-                                           parentContext + " -> sub-param-block (type: " + subBlockCopy.value(
-                                               "type", "unknown") + ")"); // Recursively filter its params
-                filteredArray.push_back(subBlockCopy); // Add the processed sub-block
-            } else {
-                // It's a literal or a non-block object, keep it.
-                filteredArray.push_back(item);
-            }
-        }
-        paramsArray = filteredArray; // Replace the original array with the filtered one
-    }
-
     Block ParseBlockDataInternal(const nlohmann::json &blockJson, Engine &engine, const std::string &contextForLog) {
-        Block newBlock; // Default constructor initializes paramsJson to kNullType
+        Block newBlock;
 
         // Parse ID
         std::string tempId = engine.getSafeStringFromJson(blockJson, "id", contextForLog, "", true, false);
@@ -120,26 +98,29 @@ namespace {
             // engine.EngineStdOut("ERROR: Block " + contextForLog + " (id: " + newBlock.id + ") has missing or empty 'type'. Cannot parse block.", 2);
             return Block(); // Return an empty/invalid block
         }
+        // 실행 시 문자열 비교를 피하기 위해 opcode 를 로드 시점에 한 번만 해석합니다.
+        newBlock.opcode = Omocha::stringToBlockTypeEnum(newBlock.type);
+        if (newBlock.opcode == Omocha::BlockTypeEnum::UNKNOWN) {
+            engine.EngineStdOut(
+                "WARN: Block " + contextForLog + " (id: " + newBlock.id + ") has unsupported type '" + newBlock.type +
+                "'. It will be skipped at runtime.", 1, "");
+        }
 
         // Parse Params
+        // 파라미터는 로드 시 Operand 로 변환하여 보관하고, 원본 JSON 은 로드가 끝나면 해제됩니다.
         if (blockJson.contains("params")) {
             const nlohmann::json &paramsVal = blockJson["params"];
             if (paramsVal.is_array()) {
-                newBlock.paramsJson = paramsVal; // Initial copy
                 std::string paramsContext = contextForLog + " (id: " + newBlock.id + ", type: " + newBlock.type +
                                             ") params";
-                RecursiveFilterParamsArray(newBlock.paramsJson, engine, paramsContext);
+                newBlock.params = parseOperands(engine, paramsVal, paramsContext);
             } else {
                 // params가 있지만 배열이 아닌 경우
                 engine.EngineStdOut(
                     "WARN: Block " + contextForLog + " (id: " + newBlock.id + ", type: " + newBlock.type +
                     ") has 'params' but it's not an array. Params will be empty. Value: " +
                     NlohmannJsonToString(paramsVal), 1, ""); // Added empty thread ID
-                newBlock.paramsJson = nlohmann::json::array(); // Ensure it's an empty array
             }
-        } else {
-            // 'params' 멤버가 없으면 빈 배열로 초기화합니다.
-            newBlock.paramsJson = nlohmann::json::array();
         }
 
         // Parse Statements (Inner Scripts)
@@ -157,8 +138,6 @@ namespace {
                                 innerBlockJsonVal, engine,
                                 innerScriptContext + " inner_block " + std::to_string(innerBlockIdx));
                             // Ensure both id and type are valid before adding
-                            // Also, ensure that FilterNullsInParamsJsonArray has been called for parsedInnerBlock's paramsJson
-                            // This is handled because ParseBlockDataInternal calls FilterNullsInParamsJsonArray before returning.
                             if (!parsedInnerBlock.id.empty() && !parsedInnerBlock.type.empty()) {
                                 innerScript.blocks.push_back(std::move(parsedInnerBlock));
                                 // Log only if successfully parsed and added
@@ -238,58 +217,36 @@ Engine::Engine() : window(nullptr), renderer(nullptr),
                                   ? 1.0f
                                   : std::clamp(static_cast<float>(this->specialConfig.setZoomfactor), Engine::MIN_ZOOM,
                                                Engine::MAX_ZOOM)), m_pressedObjectId(""),
-                   logger("omocha_engine.log"),
-                   threadPool(std::make_unique<ThreadPool>(
-                       *this, (max)(1u, std::thread::hardware_concurrency() > 0
-                                            ? std::thread::hardware_concurrency()
-                                            : 2))) {
+                   logger("omocha_engine.log") {
     EngineStdOut(
         string(OMOCHA_ENGINE_NAME) + " v" + string(OMOCHA_ENGINE_VERSION) + " " + string(OMOCHA_DEVELOPER_NAME), 4);
     EngineStdOut("See Project page " + string(OMOCHA_ENGINE_GITHUB), 4);
     startThreadPool((max)(1u, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 2));
 }
 
-void Engine::workerLoop() {
-    while (true) {
-        std::function<void()> task; {
-            std::unique_lock<std::mutex> lock(m_taskQueueMutex_std);
-            m_taskQueueCV_std.wait(lock, [this] {
-                return m_isShuttingDown.load(std::memory_order_relaxed) || !m_taskQueue.empty();
-            });
-            if (m_isShuttingDown.load(std::memory_order_relaxed) && m_taskQueue.empty()) {
-                return; // Exit if shutting down and no more tasks
-            }
-            if (m_taskQueue.empty()) {
-                continue;
-            }
-            task = std::move(m_taskQueue.front());
-            m_taskQueue.pop();
-        }
-        if (task) {
-            try {
-                task();
-            } catch (const ScriptBlockExecutionError &sbee) {
-                // 이미 EngineStdOut 및 showMessageBox를 호출하는 예외 핸들러가 Entity::executeScript 내에 있으므로,
-                // Entity 레벨에서 예외가 발생하여 여기까지 온 경우, 메시지 박스를 표시하고 종료합니다.
-                EngineStdOut(
-                    "ScriptBlockExecutionError in worker thread: " + std::string(sbee.what()) + " Block: " + sbee.
-                    blockId, 2);
-                this->showMessageBox(
-                    "스크립트 실행 중 오류 발생:\n" + std::string(sbee.what()) + "\n블록 ID: " + sbee.blockId + "\n블록 타입: " + sbee.
-                    blockType, msgBoxIconType.ICON_ERROR);
-                exit(EXIT_FAILURE);
-            }
-            catch (const std::exception &e) {
-                EngineStdOut("Exception in worker thread task: " + std::string(e.what()), 2);
-                this->showMessageBox("작업 스레드에서 예외 발생:\n" + std::string(e.what()), msgBoxIconType.ICON_ERROR);
-                exit(EXIT_FAILURE);
-            }
-            catch (...) {
-                EngineStdOut("Unknown exception in worker thread task.", 2);
-                this->showMessageBox("알 수 없는 예외가 작업 스레드에서 발생했습니다.", msgBoxIconType.ICON_ERROR);
-                exit(EXIT_FAILURE);
-            }
-        }
+void Engine::runPoolTask(std::function<void()> &task) {
+    try {
+        task();
+    } catch (const ScriptBlockExecutionError &sbee) {
+        // 이미 EngineStdOut 및 showMessageBox를 호출하는 예외 핸들러가 Entity::executeScript 내에 있으므로,
+        // Entity 레벨에서 예외가 발생하여 여기까지 온 경우, 메시지 박스를 표시하고 종료합니다.
+        EngineStdOut(
+            "ScriptBlockExecutionError in worker thread: " + std::string(sbee.what()) + " Block: " + sbee.
+            blockId, 2);
+        this->showMessageBox(
+            "스크립트 실행 중 오류 발생:\n" + std::string(sbee.what()) + "\n블록 ID: " + sbee.blockId + "\n블록 타입: " + sbee.
+            blockType, msgBoxIconType.ICON_ERROR);
+        exit(EXIT_FAILURE);
+    }
+    catch (const std::exception &e) {
+        EngineStdOut("Exception in worker thread task: " + std::string(e.what()), 2);
+        this->showMessageBox("작업 스레드에서 예외 발생:\n" + std::string(e.what()), msgBoxIconType.ICON_ERROR);
+        exit(EXIT_FAILURE);
+    }
+    catch (...) {
+        EngineStdOut("Unknown exception in worker thread task.", 2);
+        this->showMessageBox("알 수 없는 예외가 작업 스레드에서 발생했습니다.", msgBoxIconType.ICON_ERROR);
+        exit(EXIT_FAILURE);
     }
 }
 
@@ -401,16 +358,8 @@ Engine::~Engine() {
     EngineStdOut("Engine shutting down...");
     m_isShuttingDown.store(true, std::memory_order_relaxed); // 모든 스레드에 종료 신호
 
-    // 1. BlockExecutor::ThreadPool (engine.threadPool) 명시적 종료
-    // 이 풀의 작업자 스레드가 종료 시 로그를 남기므로, 다른 리소스 해제 전에 완료해야 합니다.
-    if (threadPool) {
-        EngineStdOut("Stopping BlockExecutor::ThreadPool...", 0);
-        threadPool.reset(); // unique_ptr의 reset()을 호출하여 ThreadPool 소멸자 실행 및 스레드 join
-        EngineStdOut("BlockExecutor::ThreadPool stopped.", 0);
-    }
-
-    // 2. Engine 자체의 m_workerThreads 풀 종료 (사용 중인 경우)
-    stopThreadPool(); // 이 함수는 m_workerThreads를 중지하고 join합니다.
+    // 작업자 풀 종료. 작업자가 종료 중에도 로그를 남길 수 있으므로 다른 리소스 해제 전에 완료해야 합니다.
+    stopThreadPool(); // 이 함수는 m_workerPool 의 작업자를 중지하고 join합니다.
 
     // TerminateGE 보다 먼저 폰트 캐시 정리
     for (auto const &[key, val]: m_fontCache) {
@@ -532,6 +481,8 @@ bool Engine::loadProject(const string &projectFilePath) {
         objects_in_order.clear();
         entities.clear();
         objectScripts.clear();
+        m_userFunctions.clear();
+        m_userFunctionIndex.clear();
         m_mouseClickedScripts.clear();
         m_mouseClickCanceledScripts.clear();
         m_whenObjectClickedScripts.clear();
@@ -547,10 +498,25 @@ bool Engine::loadProject(const string &projectFilePath) {
     {
         lock_guard lock(m_engineDataMutex);
         m_HUDVariables.clear();
+        m_variables.clear();
         scenes.clear();
-        m_cloneCounters.clear();
+        m_cloneCounters.clear(); {
+            std::lock_guard<std::mutex> inputLock(m_textInputMutex);
+            m_pendingTextInputs.clear();
+            m_textInputWaiter = {};
+        } {
+            lock_guard wakeLock(m_scriptWakeMutex);
+            m_scriptWakeQueue = {};
+            m_nextFrameWakes.clear();
+            m_conditionWaits.clear();
+            m_soundWaits.clear();
+            m_nextFrameSoundWakes.clear();
+        } {
+            lock_guard tickLock(m_scriptTickMutex);
+            m_pendingScriptTicks.clear();
+        }
+        m_commandBuffers.clear();
 
-        m_scriptExecutionCounter.store(0, std::memory_order_relaxed);
         m_needsTextureRecreation = false;
 
         resetProjectTimer(); // m_projectTimerValue, m_projectTimerRunning, m_projectTimerStartTime 초기화
@@ -671,6 +637,46 @@ bool Engine::loadProject(const string &projectFilePath) {
                 EngineStdOut("'specialConfig.showFPS' field missing or not boolean. Using default: false", 1);
             }
 
+            // boostMode (명령줄 --boost 로 이미 켜졌다면 유지합니다)
+            if (specialConfigJson.contains("boostMode") && specialConfigJson["boostMode"].is_boolean()) {
+                this->specialConfig.boostMode = this->specialConfig.boostMode || specialConfigJson["boostMode"].get<bool>();
+            } else {
+                EngineStdOut("'specialConfig.boostMode' field missing or not boolean. Using default: " +
+                             string(this->specialConfig.boostMode ? "true" : "false"), 1);
+            }
+
+            // entityShardMode (명령줄 --shard 로 이미 정했다면 유지합니다)
+            if (specialConfigJson.contains("entityShardMode") && specialConfigJson["entityShardMode"].is_number_integer()) {
+                int shardMode = specialConfigJson["entityShardMode"].get<int>();
+                if (shardMode >= 0 && shardMode <= 2 && this->specialConfig.entityShardMode < 0) {
+                    this->specialConfig.entityShardMode = shardMode;
+                }
+            }
+
+            // scriptCpuBudget
+            if (specialConfigJson.contains("scriptCpuBudget") && specialConfigJson["scriptCpuBudget"].is_number()) {
+                double budget = specialConfigJson["scriptCpuBudget"].get<double>();
+                if (budget > 0.0 && budget <= 1.0) {
+                    this->specialConfig.scriptCpuBudget = static_cast<float>(budget);
+                } else {
+                    EngineStdOut("'specialConfig.scriptCpuBudget' must be in (0, 1]. Using default: " +
+                                 to_string(this->specialConfig.scriptCpuBudget), 1);
+                }
+            }
+
+            // scriptExecutor: "auto" | "pool" | "inline" (명령줄 --executor 로 이미 정했다면 유지합니다)
+            if (specialConfigJson.contains("scriptExecutor") && specialConfigJson["scriptExecutor"].is_string() &&
+                this->specialConfig.scriptExecutor == 0) {
+                const string executor = specialConfigJson["scriptExecutor"].get<string>();
+                if (executor == "pool") {
+                    this->specialConfig.scriptExecutor = 1;
+                } else if (executor == "inline") {
+                    this->specialConfig.scriptExecutor = 2;
+                } else if (executor != "auto") {
+                    EngineStdOut("'specialConfig.scriptExecutor' must be auto, pool or inline. Using default: auto", 1);
+                }
+            }
+
             // maxEntity
             if (specialConfigJson.contains("maxEntity") && specialConfigJson["maxEntity"].is_number()) {
                 int maxEntity = specialConfigJson["maxEntity"].get<int>();
@@ -726,6 +732,8 @@ bool Engine::loadProject(const string &projectFilePath) {
             }
 
             HUDVariableDisplay currentVarDisplay;
+            string initialValue;
+            VariableList initialItems;
 
             // name 파싱
             if (variableJson.contains("name") && variableJson["name"].is_string()) {
@@ -777,11 +785,11 @@ bool Engine::loadProject(const string &projectFilePath) {
                         }
                         // else: 0-31 범위의 제어 문자 (탭, 줄바꿈, 캐리지리턴 제외) 및 127 (DEL)은 제거됩니다.
                     }
-                    currentVarDisplay.value = sanitized_value;
+                    initialValue = sanitized_value;
 
                     // 정제 후 문자열이 비어있고, 리스트 타입이 아니라면 "0"으로 설정
-                    if (currentVarDisplay.variableType != "list" && currentVarDisplay.value.empty()) {
-                        currentVarDisplay.value = "0";
+                    if (currentVarDisplay.variableType != "list" && initialValue.empty()) {
+                        initialValue = "0";
                         // 로그 메시지는 필요에 따라 추가/수정
                         EngineStdOut(
                             "Variable '" + currentVarDisplay.name +
@@ -789,41 +797,41 @@ bool Engine::loadProject(const string &projectFilePath) {
                     }
                 } else if (valNode.is_number_integer()) {
                     long long int_val = valNode.get<long long>();
-                    currentVarDisplay.value = std::to_string(int_val); // CORRECT
+                    initialValue = std::to_string(int_val); // CORRECT
                 } else if (valNode.is_number_float()) {
                     double float_val = valNode.get<double>();
-                    if (isnan(float_val)) currentVarDisplay.value = "NaN";
-                    else if (isinf(float_val)) currentVarDisplay.value = (float_val > 0 ? "Infinity" : "-Infinity");
+                    if (isnan(float_val)) initialValue = "NaN";
+                    else if (isinf(float_val)) initialValue = (float_val > 0 ? "Infinity" : "-Infinity");
                     else {
                         std::string s = std::to_string(float_val);
                         s.erase(s.find_last_not_of('0') + 1, std::string::npos);
                         if (!s.empty() && s.back() == '.') {
                             s.pop_back();
                         }
-                        currentVarDisplay.value = s; // CORRECT
+                        initialValue = s; // CORRECT
                     }
                 } else if (valNode.is_boolean()) {
-                    currentVarDisplay.value = valNode.get<bool>() ? "true" : "false";
+                    initialValue = valNode.get<bool>() ? "true" : "false";
                 } else if (valNode.is_null()) {
-                    currentVarDisplay.value = "0"; // 엔트리는 초기화되지 않은 변수를 0으로 취급하는 경향
+                    initialValue = "0"; // 엔트리는 초기화되지 않은 변수를 0으로 취급하는 경향
                     EngineStdOut(
                         "Variable '" + currentVarDisplay.name +
                         "' has a null value. Interpreting as \"0\".", 1);
                 } else {
-                    currentVarDisplay.value = "0"; // 예상치 못한 타입도 "0"으로
+                    initialValue = "0"; // 예상치 못한 타입도 "0"으로
                     EngineStdOut(
                         "Variable '" + currentVarDisplay.name +
                         "' has an unexpected type for 'value' field. Interpreting as \"0\". Value: " +
                         NlohmannJsonToString(valNode), 1);
                 }
             } else {
-                currentVarDisplay.value = "0"; // 'value' 필드가 없으면 "0"으로 초기화
+                initialValue = "0"; // 'value' 필드가 없으면 "0"으로 초기화
                 EngineStdOut(
                     "Variable '" + currentVarDisplay.name + "' is missing 'value' field. Interpreting as \"0\".",
                     1);
             }
-            if (currentVarDisplay.variableType != "list" && currentVarDisplay.value.empty()) {
-                currentVarDisplay.value = "0"; // Default to "0" if empty after parsing
+            if (currentVarDisplay.variableType != "list" && initialValue.empty()) {
+                initialValue = "0"; // Default to "0" if empty after parsing
                 EngineStdOut(
                     "Variable '" + currentVarDisplay.name +
                     "' had an empty or fully sanitized string value after parsing. Defaulting to \"0\".", 1);
@@ -906,23 +914,15 @@ bool Engine::loadProject(const string &projectFilePath) {
                             continue;
                         }
 
-                        ListItem item;
-                        if (itemJson.contains("key") && itemJson["key"].is_string()) {
-                            item.key = itemJson["key"].get<string>();
-                        } else {
-                            item.key = "";
-                        }
-
+                        // 항목의 key 는 블록에서 쓰지 않으므로 읽지 않습니다.
                         if (itemJson.contains("data") && itemJson["data"].is_string()) {
-                            item.data = itemJson["data"].get<string>();
+                            initialItems.push_back(VariableList::Item::fromString(itemJson["data"].get<string>()));
                         } else {
-                            item.data = "";
+                            initialItems.push_back(VariableList::Item::fromString(""));
                             EngineStdOut(
                                 "List item for '" + currentVarDisplay.name + "' at index " + to_string(j_item) +
                                 " missing 'data' or not string. Using empty.", 1);
                         }
-
-                        currentVarDisplay.array.push_back(item);
                     }
                 } else {
                     EngineStdOut(
@@ -931,9 +931,24 @@ bool Engine::loadProject(const string &projectFilePath) {
                 }
             }
 
+            currentVarDisplay.slot = m_variables.add(currentVarDisplay.id, currentVarDisplay.objectId,
+                                                     currentVarDisplay.variableType == "list",
+                                                     currentVarDisplay.isCloud);
+            VariableStore::Slot &data = m_variables.slot(currentVarDisplay.slot);
+            // 숫자/불리언 값은 타입 그대로 둡니다. (문자열 "007" 처럼 표기가 중요한 값은 문자열로 남깁니다)
+            if (variableJson.contains("value") && variableJson["value"].is_number() &&
+                initialValue != "NaN" && initialValue.find("Infinity") == string::npos) {
+                data.value = OperandValue(variableJson["value"].get<double>());
+            } else if (variableJson.contains("value") && variableJson["value"].is_boolean()) {
+                data.value = OperandValue(variableJson["value"].get<bool>());
+            } else {
+                data.value = OperandValue(initialValue);
+            }
+            data.items = move(initialItems);
+            data.hud = static_cast<uint32_t>(m_HUDVariables.size());
             this->m_HUDVariables.push_back(currentVarDisplay);
             EngineStdOut(
-                " Parsed variable: " + currentVarDisplay.name + " = " + currentVarDisplay.value + " (Type: " +
+                " Parsed variable: " + currentVarDisplay.name + " = " + initialValue + " (Type: " +
                 currentVarDisplay.variableType + ")", 3);
         }
     } // "Variables" 파싱 if 문의 닫는 중괄호 추가
@@ -1681,6 +1696,8 @@ bool Engine::loadProject(const string &projectFilePath) {
         // Potentially show a message box or return false if objects are mandatory
     }
 
+    loadUserFunctions(document);
+
     scenes.clear();
     /**
      * @brief 씬 (scenes) 정보 로드
@@ -1789,15 +1806,10 @@ bool Engine::loadProject(const string &projectFilePath) {
                     if (script.blocks.size() > 1) {
                         string keyIdentifierString;
                         bool keyIdentifierFound = false;
-                        if (firstBlock.paramsJson.is_array() && firstBlock.paramsJson.size() > 0) {
-                            // nlohmann::json
-                            if (firstBlock.paramsJson[0].is_string()) {
-                                keyIdentifierString = firstBlock.paramsJson[0].get<std::string>();
-                                keyIdentifierFound = true;
-                            } else if (firstBlock.paramsJson[0].is_null() && firstBlock.paramsJson.size() > 1 &&
-                                       // nlohmann::json
-                                       firstBlock.paramsJson[1].is_string()) {
-                                keyIdentifierString = firstBlock.paramsJson[1].get<std::string>();
+                        if (!firstBlock.params.empty()) {
+                            // null 파라미터는 로드 시 제거되므로 키 식별자는 첫 번째 항목입니다.
+                            if (firstBlock.params[0].isString()) {
+                                keyIdentifierString = firstBlock.params[0].value.stringValue();
                                 keyIdentifierFound = true;
                             }
 
@@ -1809,8 +1821,7 @@ bool Engine::loadProject(const string &projectFilePath) {
                             } else {
                                 EngineStdOut(
                                     " -> object ID " + objectId +
-                                    " 'press key' invalid param or missing message ID. Params JSON: " + firstBlock.
-                                    paramsJson.dump() + ".",
+                                    " 'press key' invalid param or missing message ID. Params JSON: " + describeOperands(firstBlock.params) + ".",
                                     1);
                             }
                         }
@@ -1846,11 +1857,9 @@ bool Engine::loadProject(const string &projectFilePath) {
                         EngineStdOut(
                             "DEBUG_MSG: Processing when_message_cast for " + objectId + ". First block ID: " +
                             firstBlock.id, 3, "");
-                        bool isArr = firstBlock.paramsJson.is_array();
-                        int arrSize = isArr ? static_cast<int>(firstBlock.paramsJson.size()) : -1; // SizeType to int
-                        bool firstIsStr = (isArr && arrSize >= 1) ? firstBlock.paramsJson[0].is_string() : false;
-                        EngineStdOut("DEBUG_MSG:   paramsJson.is_array(): " + std::string(isArr ? "true" : "false") +
-                                     ", Size: " + std::to_string(arrSize) +
+                        int arrSize = static_cast<int>(firstBlock.params.size());
+                        bool firstIsStr = arrSize >= 1 && firstBlock.params[0].isString();
+                        EngineStdOut("DEBUG_MSG:   params size: " + std::to_string(arrSize) +
                                      ", [0].is_string(): " + std::string(firstIsStr ? "true" : "false"),
                                      3, "");
 
@@ -1858,10 +1867,9 @@ bool Engine::loadProject(const string &projectFilePath) {
                         std::string actualMessageName; // 예: "게임 시작" (사용자 정의 이름)
                         bool messageParamFound = false;
 
-                        // After FilterNullsInParamsJsonArray, the signal ID should be the first element if present.
-                        if (firstBlock.paramsJson.is_array() && !firstBlock.paramsJson.empty() && // Use !empty()
-                            firstBlock.paramsJson[0].is_string()) {
-                            messageIdToReceive = firstBlock.paramsJson[0].get<std::string>();
+                        // null 파라미터는 로드 시 제거되므로 신호 ID 는 첫 번째 항목입니다.
+                        if (!firstBlock.params.empty() && firstBlock.params[0].isString()) {
+                            messageIdToReceive = firstBlock.params[0].value.stringValue();
                             EngineStdOut("DEBUG_MSG:   Extracted messageIdToReceive: '" + messageIdToReceive + "'", 3,
                                          "");
                             messageParamFound = true;
@@ -1885,7 +1893,7 @@ bool Engine::loadProject(const string &projectFilePath) {
                                             true);
 
                                         if (!msg_id.empty()) {
-                                            std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+                                            std::lock_guard lock(m_engineDataMutex);
                                             m_messageIdToNameMap[msg_id] = msg_name;
                                             EngineStdOut(
                                                 "  Mapped global message ID '" + msg_id + "' to Name: '" + msg_name +
@@ -1908,8 +1916,7 @@ bool Engine::loadProject(const string &projectFilePath) {
                         } else {
                             EngineStdOut(
                                 " -> object ID " + objectId +
-                                " 'recive signal' invalid param or missing message ID. Params JSON: " + firstBlock.
-                                paramsJson.dump() + ".",
+                                " 'recive signal' invalid param or missing message ID. Params JSON: " + describeOperands(firstBlock.params) + ".",
                                 1);
                         }
                     }
@@ -1936,10 +1943,252 @@ bool Engine::loadProject(const string &projectFilePath) {
     EngineStdOut(
         "Finished identifying event-triggered scripts. Start button scripts found: " + to_string(
             startButtonScripts.size()), 0);
+    compileAllScripts();
+    selectScriptExecutor();
     EngineStdOut("Project JSON file parsed successfully.", 0);
     return true;
 }
 
+void Engine::compileAllScripts() {
+    lock_guard lock(m_engineDataMutex);
+    size_t compiledCount = 0;
+    size_t instructionCount = 0;
+    // 함수 본문을 먼저 컴파일합니다. (CALL 명령은 함수 인덱스만 참조하므로 순서와 무관하게 재귀 호출도 가능)
+    for (auto &function: m_userFunctions) {
+        try {
+            assignLoopSlots(function.body);
+            compileUserFunction(*this, function);
+        } catch (const exception &e) {
+            function.body.program = nullptr;
+            EngineStdOut("Failed to compile user function " + function.id + ": " + e.what(), 2);
+        }
+    }
+    // 엔진 전역 상태를 쓰는 함수를 표시합니다. 그런 함수를 부르는 함수도 포함되도록 바뀌지 않을 때까지 반복합니다.
+    auto calleeUsesSharedState = [this](const Block &callBlock) {
+        const int index = findUserFunction(callBlock.type.substr(5)); // "func_" 뒤가 함수 ID
+        return index < 0 || m_userFunctions[index].body.usesSharedState;
+    };
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto &function: m_userFunctions) {
+            if (function.body.usesSharedState) {
+                continue;
+            }
+            if (analyzeSharedState(function.body, calleeUsesSharedState) ||
+                (function.returnValue.block && analyzeSharedState(*function.returnValue.block, calleeUsesSharedState))) {
+                function.body.usesSharedState = true;
+                changed = true;
+            }
+        }
+    }
+    for (auto &[objectId, scripts]: objectScripts) {
+        for (auto &script: scripts) {
+            script.usesSharedState = analyzeSharedState(script, calleeUsesSharedState);
+            try {
+                assignLoopSlots(script);
+                script.program = compileScript(*this, objectId, script);
+            } catch (const exception &e) {
+                // 컴파일에 실패한 스크립트는 트리 인터프리터로 실행합니다.
+                script.program = nullptr;
+                EngineStdOut("Failed to compile script for object " + objectId + ": " + e.what(), 1);
+            }
+            if (script.program) {
+                compiledCount++;
+                instructionCount += script.program->code.size();
+            }
+        }
+    }
+    EngineStdOut(format("Compiled {} scripts into {} instructions.", compiledCount, instructionCount), 0);
+}
+
+bool Engine::exportAotSource(const string &outputDir) {
+    lock_guard lock(m_engineDataMutex);
+    vector<pair<string, const ScriptProgram *>> programs;
+    for (const auto &function: m_userFunctions) {
+        if (function.body.program) {
+            programs.emplace_back("function " + function.id, function.body.program.get());
+        }
+    }
+    for (const auto &[objectId, scripts]: objectScripts) {
+        for (size_t i = 0; i < scripts.size(); ++i) {
+            if (scripts[i].program) {
+                programs.emplace_back(format("object {} script #{}", objectId, i), scripts[i].program.get());
+            }
+        }
+    }
+
+    size_t regionCount = 0;
+    string source = generateAotSource(programs, regionCount);
+    filesystem::path outputPath = filesystem::path(outputDir) / "omocha_aot.cpp";
+    try {
+        filesystem::create_directories(outputDir);
+    } catch (const filesystem::filesystem_error &e) {
+        EngineStdOut("Failed to create AOT output directory " + outputDir + ": " + e.what(), 2);
+        return false;
+    }
+    ofstream file(outputPath, ios::binary);
+    if (!file.is_open()) {
+        EngineStdOut("Failed to open AOT output file: " + outputPath.string(), 2);
+        return false;
+    }
+    file << source;
+    if (!file) {
+        EngineStdOut("Failed to write AOT output file: " + outputPath.string(), 2);
+        return false;
+    }
+    EngineStdOut(format("AOT: wrote {} native regions from {} programs to {}", regionCount, programs.size(),
+                        outputPath.string()), 0);
+    return true;
+}
+
+int Engine::findUserFunction(const string &functionId) const {
+    auto it = m_userFunctionIndex.find(functionId);
+    return it != m_userFunctionIndex.end() ? static_cast<int>(it->second) : -1;
+}
+
+const UserFunction *Engine::getUserFunction(size_t index) const {
+    return index < m_userFunctions.size() ? &m_userFunctions[index] : nullptr;
+}
+
+void Engine::loadUserFunctions(const nlohmann::json &document) {
+    m_userFunctions.clear();
+    m_userFunctionIndex.clear();
+    if (!document.contains("functions") || !document["functions"].is_array()) {
+        EngineStdOut("project.json has no 'functions' array. No user functions loaded.", 0);
+        return;
+    }
+    for (const auto &functionJson: document["functions"]) {
+        if (!functionJson.is_object()) {
+            EngineStdOut("WARN: Function entry is not an object. Skipping. Content: " + functionJson.dump(), 1);
+            continue;
+        }
+        UserFunction function;
+        function.id = getSafeStringFromJson(functionJson, "id", "function entry", "", false, false);
+        if (function.id.empty()) {
+            EngineStdOut("WARN: Function entry is missing 'id'. Skipping. Content: " + functionJson.dump(), 1);
+            continue;
+        }
+        const string context = "function " + function.id;
+        function.returnsValue = functionJson.contains("type") && functionJson["type"].is_string() &&
+                                functionJson["type"].get<string>() == "value";
+        if (functionJson.contains("runWithoutScreenRefresh") && functionJson["runWithoutScreenRefresh"].is_boolean()) {
+            function.runWithoutScreenRefresh = functionJson["runWithoutScreenRefresh"].get<bool>();
+        }
+        // 지역 변수: [{ id, name, value }]. 호출 프레임에서 인자 뒤 자리를 쓰고 호출마다 value 로 초기화됩니다.
+        if (functionJson.contains("localVariables") && functionJson["localVariables"].is_array()) {
+            for (const auto &localJson: functionJson["localVariables"]) {
+                const string localId = localJson.is_object()
+                                           ? getSafeStringFromJson(localJson, "id", context + " local variable", "",
+                                                                   false, false)
+                                           : "";
+                if (localId.empty()) {
+                    EngineStdOut("WARN: " + context + " has a local variable without 'id'. Skipping. Content: " +
+                                 localJson.dump(), 1);
+                    continue;
+                }
+                // 전역 변수와 같이 숫자/불리언 값은 타입 그대로 둡니다.
+                OperandValue initialValue(0.0);
+                if (localJson.contains("value")) {
+                    const auto &valueNode = localJson["value"];
+                    if (valueNode.is_number()) {
+                        initialValue = OperandValue(valueNode.get<double>());
+                    } else if (valueNode.is_boolean()) {
+                        initialValue = OperandValue(valueNode.get<bool>());
+                    } else if (valueNode.is_string()) {
+                        initialValue = OperandValue(valueNode.get<string>());
+                    }
+                }
+                initialValue.precompute(); // 여러 스레드가 호출할 때마다 복사합니다.
+                function.localVariableIds.push_back(localId);
+                function.localVariableValues.push_back(std::move(initialValue));
+            }
+        }
+
+        // content 는 오브젝트 script 와 같이 JSON 문자열로 저장됩니다.
+        if (!functionJson.contains("content") || !functionJson["content"].is_string()) {
+            EngineStdOut("WARN: " + context + " is missing 'content' string. Skipping.", 1);
+            continue;
+        }
+        nlohmann::json content;
+        try {
+            content = nlohmann::json::parse(functionJson["content"].get<string>());
+        } catch (const nlohmann::json::parse_error &e) {
+            EngineStdOut("ERROR: Failed to parse content JSON of " + context + ": " + e.what(), 2);
+            continue;
+        }
+        const nlohmann::json *createBlock = nullptr;
+        if (content.is_array()) {
+            for (const auto &thread: content) {
+                if (thread.is_array() && !thread.empty() && thread[0].is_object() && thread[0].contains("type") &&
+                    thread[0]["type"].is_string()) {
+                    const string headType = thread[0]["type"].get<string>();
+                    if (headType == "function_create" || headType == "function_create_value") {
+                        createBlock = &thread[0];
+                        break;
+                    }
+                }
+            }
+        }
+        if (!createBlock || !createBlock->contains("params") || !(*createBlock)["params"].is_array()) {
+            EngineStdOut("WARN: " + context + " has no function_create block. Skipping.", 1);
+            continue;
+        }
+        const nlohmann::json &createParams = (*createBlock)["params"];
+
+        // 파라미터: params[0] 에서 시작해 params[1] 로 이어지는 function_field_* 체인
+        const nlohmann::json *field = createParams.empty() ? nullptr : &createParams[0];
+        while (field && field->is_object() && field->contains("params") && (*field)["params"].is_array()) {
+            const string fieldType = (field->contains("type") && (*field)["type"].is_string())
+                                         ? (*field)["type"].get<string>()
+                                         : "";
+            const nlohmann::json &fieldParams = (*field)["params"];
+            if ((fieldType == "function_field_string" || fieldType == "function_field_boolean") &&
+                !fieldParams.empty() && fieldParams[0].is_object() && fieldParams[0].contains("type") &&
+                fieldParams[0]["type"].is_string()) {
+                function.paramTypes.push_back(fieldParams[0]["type"].get<string>());
+            }
+            field = fieldParams.size() > 1 ? &fieldParams[1] : nullptr;
+        }
+
+        // 결과값: function_create_value 의 나머지 파라미터 중 첫 번째 값
+        if (function.returnsValue) {
+            for (size_t i = 1; i < createParams.size(); ++i) {
+                if (!createParams[i].is_null()) {
+                    function.returnValue = parseOperand(*this, createParams[i], context + " return value");
+                    function.returnValue.value.precompute();
+                    break;
+                }
+            }
+        }
+
+        // 본문: blocks[0] 은 function_create 자리이고 (컴파일 시 건너뜀) 나머지는 statements[0] 의 블록입니다.
+        Block header((*createBlock)["type"].get<string>());
+        header.id = getSafeStringFromJson(*createBlock, "id", context, "", false, true);
+        function.body.blocks.push_back(std::move(header));
+        if (createBlock->contains("statements") && (*createBlock)["statements"].is_array() &&
+            !(*createBlock)["statements"].empty() && (*createBlock)["statements"][0].is_array()) {
+            const nlohmann::json &bodyJson = (*createBlock)["statements"][0];
+            for (size_t i = 0; i < bodyJson.size(); ++i) {
+                if (!bodyJson[i].is_object()) {
+                    continue;
+                }
+                Block parsedBlock = ParseBlockDataInternal(bodyJson[i], *this,
+                                                           context + " block at index " + to_string(i));
+                if (!parsedBlock.id.empty() && !parsedBlock.type.empty()) {
+                    function.body.blocks.push_back(std::move(parsedBlock));
+                }
+            }
+        }
+
+        EngineStdOut(format("  Parsed {} with {} params, {} local variables and {} blocks.", context,
+                            function.paramTypes.size(), function.localVariableIds.size(),
+                            function.body.blocks.size() - 1), 3);
+        m_userFunctionIndex[function.id] = m_userFunctions.size();
+        m_userFunctions.push_back(std::move(function));
+    }
+    EngineStdOut("Loaded " + to_string(m_userFunctions.size()) + " user functions.", 0);
+}
+
 std::string Engine::OFD() const {
 #ifdef _WIN32
     OPENFILENAMEA ofn; // ANSI 버전
@@ -1980,7 +2229,7 @@ std::string Engine::OFD() const {
 }
 
 std::string Engine::getMessageNameById(const std::string &messageId) const {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // m_messageIdToNameMap 접근 보호
+    std::lock_guard lock(m_engineDataMutex); // m_messageIdToNameMap 접근 보호
     auto it = m_messageIdToNameMap.find(messageId);
     if (it != m_messageIdToNameMap.end()) {
         return it->second; // 저장된 사용자 정의 이름 반환
@@ -2696,7 +2945,7 @@ void Engine::drawAllEntities() {
     }
 
     // Lock the mutex that protects objects_in_order and entities
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+    std::lock_guard lock(m_engineDataMutex);
 
     SDL_SetRenderTarget(renderer, tempScreenTexture);
 
@@ -3878,7 +4127,7 @@ void Engine::drawImGui() {
     }
     // 엔트리 변수 창
     if (!m_HUDVariables.empty()) {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // m_HUDVariables 접근 보호
+        std::lock_guard lock(m_engineDataMutex); // m_HUDVariables 접근 보호
 
         int window_w, window_h;
         SDL_GetRenderOutputSize(renderer, &window_w, &window_h);
@@ -3952,8 +4201,9 @@ void Engine::drawImGui() {
 
                     ImGui::BeginChild(("ListItems_" + var.id).c_str(), child_size, true,
                                       ImGuiWindowFlags_HorizontalScrollbar);
-                    for (size_t j = 0; j < var.array.size(); ++j) {
-                        const ListItem &listItem = var.array[j];
+                    const VariableList &listItems = m_variables.slot(var.slot).items;
+                    for (size_t j = 0; j < listItems.size(); ++j) {
+                        const string itemText = listItems.stringAt(j);
                         ImGui::Text("%zu", j + 1);
                         ImGui::SameLine();
                         ImVec4 itemValueTextColor = ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // 흰색 텍스트
@@ -3961,7 +4211,7 @@ void Engine::drawImGui() {
 
                         // 배경색을 먼저 적용하기 위해 커서 위치 계산
                         ImVec2 textPos = ImGui::GetCursorPos();
-                        ImVec2 textSize = ImGui::CalcTextSize(listItem.data.c_str(), nullptr, true,
+                        ImVec2 textSize = ImGui::CalcTextSize(itemText.c_str(), nullptr, true,
                                                               ImGui::GetContentRegionAvail().x -
                                                               ImGui::GetCursorPosX()); // 현재 줄에서 사용 가능한 너비만큼
 
@@ -3980,7 +4230,7 @@ void Engine::drawImGui() {
                         ImGui::SetCursorPosX(ImGui::GetCursorPosX() + ImGui::GetStyle().FramePadding.x);
                         ImGui::SetCursorPosY(ImGui::GetCursorPosY() + ImGui::GetStyle().FramePadding.y);
                         ImGui::PushStyleColor(ImGuiCol_Text, itemValueTextColor);
-                        ImGui::TextWrapped("%s", listItem.data.c_str());
+                        ImGui::TextWrapped("%s", itemText.c_str());
                         ImGui::PopStyleColor(); // 텍스트 색상 스타일 복원
                         ImGui::Spacing();
                     }
@@ -4067,7 +4317,9 @@ void Engine::drawImGui() {
                     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 1.0f, 1.0f));
 
                     char valueBuffer[256];
-                    strncpy(valueBuffer, var.value.c_str(), sizeof(valueBuffer) - 1);
+                    // 숫자 변수는 여기서 처음 문자열로 만들어지고, 값이 바뀔 때까지 캐시됩니다.
+                    const string valueText = m_variables.slot(var.slot).value.asString();
+                    strncpy(valueBuffer, valueText.c_str(), sizeof(valueBuffer) - 1);
                     valueBuffer[sizeof(valueBuffer) - 1] = 0;
 
                     float valueTextWidth = ImGui::CalcTextSize(valueBuffer).x;
@@ -4132,14 +4384,18 @@ void Engine::drawImGui() {
                     ImGui::SetNextItemOpen(m_treeCollapseTargetState, ImGuiCond_Always);
                 }
                 if (ImGui::TreeNodeEx(entityNodeId.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
-                    std::lock_guard<std::recursive_mutex> entity_state_lock(entity->getStateMutex());
+                    std::lock_guard entity_state_lock(entity->getStateMutex());
+                    const Entity::CpuUsage cpuUsage = entity->getCpuUsage();
+                    ImGui::Text("CPU: %.3f ms this frame | %.1f ms total",
+                                cpuUsage.frameIndex == m_scriptFrameIndex ? cpuUsage.frameNs / 1e6 : 0.0,
+                                cpuUsage.totalNs / 1e6);
                     if (entity->scriptThreadStates.empty()) {
                         ImGui::Text("(No script threads)");
                     }
 
-                    for (const auto &threadPair: entity->scriptThreadStates) {
-                        const std::string &threadId = threadPair.first;
-                        const Entity::ScriptThreadState &state = threadPair.second;
+                    for (const auto &thread: entity->scriptThreadStates) {
+                        const std::string &threadId = thread.id;
+                        const Entity::ScriptThreadState &state = thread.state;
 
                         // 스레드별 트리 노드 생성
                         std::string threadNodeId = "Thread: " + truncate_str_len(threadId, 25);
@@ -4158,6 +4414,9 @@ void Engine::drawImGui() {
                             if (state.isWaiting && !state.blockIdForWait.empty()) {
                                 ImGui::Text("Waiting Block: %s", truncate_str_len(state.blockIdForWait, 15).c_str());
                             }
+                            ImGui::Text("CPU: last tick %.3f ms | %.1f ms total | deficit %.3f ms",
+                                        state.cpuLastTickNs / 1e6, state.cpuTotalNs / 1e6,
+                                        state.cpuDeficitNs / 1e6);
 
                             // ResumingAt 정보 추가 (유효성 검사 강화)
                             if (state.resumeAtBlockIndex != -1) {
@@ -4175,6 +4434,17 @@ void Engine::drawImGui() {
                                 }
                             }
 
+                            if (state.scriptPtrForResume && state.scriptPtrForResume->program) {
+                                ImGui::Text("PC: %zu / %zu", state.programCounter,
+                                            state.callFrames.empty()
+                                                ? state.scriptPtrForResume->program->code.size()
+                                                : state.callFrames.back().function->body.program->code.size());
+                                if (!state.callFrames.empty()) {
+                                    ImGui::Text("In Function: %s (Depth %zu)",
+                                                state.callFrames.back().function->id.c_str(), state.callFrames.size());
+                                }
+                            }
+
                             if (state.terminateRequested) {
                                 ImGui::Text("Termination Requested");
                             }
@@ -4182,14 +4452,17 @@ void Engine::drawImGui() {
                             if (!state.loopCounters.empty()) {
                                 std::string loopInfoStr = "Loop Counters: ";
                                 int counter = 0;
-                                for (const auto &loopPair: state.loopCounters) {
+                                for (size_t slot = 0; slot < state.loopCounters.size(); ++slot) {
+                                    int value = state.loopCounters.get(static_cast<int>(slot));
+                                    if (value == Entity::LoopSlots::kUnused) {
+                                        continue;
+                                    }
                                     if (counter++ > 3) {
                                         // 너무 많은 루프 카운터 표시 방지 (예: 최대 4개)
                                         loopInfoStr += "...";
                                         break;
                                     }
-                                    loopInfoStr += "[" + truncate_str_len(loopPair.first, 10) + ":" + std::to_string(
-                                        loopPair.second) + "] ";
+                                    loopInfoStr += "[#" + std::to_string(slot) + ":" + std::to_string(value) + "] ";
                                 }
                                 ImGui::Text(loopInfoStr.c_str());
                             }
@@ -4293,7 +4566,7 @@ void Engine::updateMouseCursor(float mouseWindowX, float mouseWindowY) {
     // 윈도우 좌표를 스테이지 좌표로 변환
     if (mapWindowToStageCoordinates(static_cast<int>(mouseWindowX), static_cast<int>(mouseWindowY), stageMouseX,
                                     stageMouseY)) {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // entities 및 objects_in_order 접근 보호
+        std::lock_guard lock(m_engineDataMutex); // entities 및 objects_in_order 접근 보호
 
         // objects_in_order는 렌더링 순서 (인덱스가 작을수록 위에 그려짐)를 따르므로,
         // 0번 인덱스부터 순회하여 가장 먼저 마우스와 충돌하는 엔티티를 찾습니다.
@@ -4334,6 +4607,21 @@ void Engine::updateMouseCursor(float mouseWindowX, float mouseWindowY) {
 
 void Engine::processInput(const SDL_Event &event, float deltaTime) {
     ImGuiIO &io = ImGui::GetIO();
+    // 조건 기다리기 (wait_until_true) 를 깨울 입력
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+        case SDL_EVENT_TEXT_INPUT:
+            noteConditionInput(kWaitOnKeyboard);
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            noteConditionInput(kWaitOnMouse);
+            break;
+        default:
+            break;
+    }
     if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN) {
         if (io.WantCaptureMouse) {
             // ImGui가 이 마우스 클릭을 사용하려고 함. 게임 로직에서는 무시.
@@ -5188,15 +5476,9 @@ void Engine::runStartButtonScripts() {
         EngineStdOut("Running 'Start Button Clicked' scripts...", 0);
     }
 
-    for (const auto &scriptPair: startButtonScripts) {
-        const string &objectId = scriptPair.first;
-        const Script *scriptPtr = scriptPair.second;
-        EngineStdOut(" -> Running script for object: " + objectId, 3);
-        std::string sceneContext = getCurrentSceneId(); // 현재 씬 컨텍스트 가져오기
-        this->dispatchScriptForExecution(objectId, scriptPtr, sceneContext, 0.0);
-        m_gameplayInputActive = true;
-    }
-    EngineStdOut("Finished running 'Start Button Clicked' scripts.", 0);
+    size_t started = dispatchScriptBatch(startButtonScripts, getCurrentSceneId(), false);
+    m_gameplayInputActive = true;
+    EngineStdOut("Finished running 'Start Button Clicked' scripts (" + to_string(started) + " thread(s)).", 0);
 }
 
 void Engine::initFps() {
@@ -5218,6 +5500,440 @@ void Engine::setfps(int fps) {
     }
 }
 
+void Engine::beginBoostFrameBudget() {
+    if (!specialConfig.boostMode) {
+        return;
+    }
+    double frameTimeNs = 1'000'000'000.0 / max(1, specialConfig.TARGET_FPS);
+    m_boostBudgetDeadlineNs.store(SDL_GetTicksNS() + static_cast<Uint64>(frameTimeNs * BOOST_FRAME_BUDGET_RATIO),
+                                  memory_order_relaxed);
+}
+
+bool Engine::hasBoostBudget() const {
+    return specialConfig.boostMode && SDL_GetTicksNS() < m_boostBudgetDeadlineNs.load(memory_order_relaxed);
+}
+
+bool Engine::scriptTickQuantumExpired() {
+    return s_tickDeadlineNs != 0 && SDL_GetTicksNS() >= s_tickDeadlineNs;
+}
+
+bool Engine::isRecordingCommands() {
+    return s_openScriptTickFrame && s_runningScriptTick;
+}
+
+void Engine::applyScriptCpuBudget(vector<ScriptTick> &ticks) {
+    // 프레임 시간의 scriptCpuBudget 만큼을 이번 프레임의 틱 수로 나눠 줍니다.
+    // 작업자 수는 쓰지 않으므로 풀 크기가 달라도 같은 할당량을 받습니다. (양보 시점은 측정한 CPU 시간에 따릅니다)
+    if (ticks.empty()) {
+        return;
+    }
+    const double frameTimeNs = 1'000'000'000.0 / max(1, specialConfig.TARGET_FPS);
+    const int64_t quantum = (max)(MIN_SCRIPT_QUANTUM_NS,
+                                  static_cast<int64_t>(frameTimeNs * specialConfig.scriptCpuBudget /
+                                                       static_cast<double>(ticks.size())));
+    size_t kept = 0;
+    vector<ScriptTick> deferred;
+    for (ScriptTick &tick: ticks) {
+        tick.allowanceNs = tick.entity->grantScriptQuantum(tick.executionThreadId, quantum);
+        if (tick.allowanceNs > 0) {
+            if (&ticks[kept] != &tick) {
+                ticks[kept] = move(tick);
+            }
+            ++kept;
+        } else {
+            deferred.push_back(move(tick));
+        }
+    }
+    ticks.resize(kept);
+    if (deferred.empty()) {
+        return;
+    }
+    EngineStdOut(format("Script CPU budget: deferring {} thread(s) that overran their time slice.", deferred.size()), 5);
+    lock_guard lock(m_scriptTickMutex);
+    for (ScriptTick &tick: deferred) {
+        m_pendingScriptTicks.push_back(move(tick));
+    }
+}
+
+void Engine::scheduleScriptWake(weak_ptr<Entity> entity, const string &executionThreadId, Uint64 wakeTime,
+                                Entity::WaitType type) {
+    lock_guard lock(m_scriptWakeMutex);
+    ScriptWake wake{wakeTime, m_scriptWakeSequence++, move(entity), executionThreadId, type};
+    if (type == Entity::WaitType::BLOCK_INTERNAL && wakeTime == 0) {
+        m_nextFrameWakes.push_back(move(wake));
+    } else {
+        m_scriptWakeQueue.push(move(wake));
+    }
+}
+
+void Engine::processScriptWakeups(float deltaTime) {
+    const Uint64 now = SDL_GetTicks();
+    if (Entity::consumeStateWritten()) {
+        m_entityEpoch.fetch_add(1, memory_order_release); // 메인 스레드의 변경 (드래그 등)
+    } {
+        lock_guard lock(m_scriptWakeMutex);
+        // 재개 중에 다시 양보한 스레드는 비워 둔 m_nextFrameWakes 에 쌓여 다음 프레임에 처리됩니다.
+        m_dueWakes.swap(m_nextFrameWakes);
+        // 조건이 읽는 입력이 바뀐 스레드만 깨워 조건을 다시 평가합니다.
+        erase_if(m_conditionWaits, [this](ConditionWait &wait) {
+            if (wait.entity.expired()) {
+                return true;
+            }
+            if (conditionInputStamp(wait.variableBuckets, wait.sources) == wait.stamp) {
+                return false;
+            }
+            m_dueWakes.push_back({0, m_scriptWakeSequence++, move(wait.entity), move(wait.executionThreadId),
+                                  Entity::WaitType::BLOCK_INTERNAL});
+            return true;
+        });
+        while (!m_scriptWakeQueue.empty() && m_scriptWakeQueue.top().wakeTime <= now) {
+            m_dueWakes.push_back(m_scriptWakeQueue.top());
+            m_scriptWakeQueue.pop();
+        }
+        // 끝난 소리를 기다리는 스레드만 깨웁니다. 기다리는 스레드가 없는 재생 ID 는 버립니다.
+        m_dueSoundWakes.swap(m_nextFrameSoundWakes);
+        uint64_t playbackId = 0;
+        while (aeHelper.popFinishedSound(playbackId)) {
+            if (auto it = m_soundWaits.find(playbackId); it != m_soundWaits.end()) {
+                m_dueSoundWakes.push_back(move(it->second));
+                m_soundWaits.erase(it);
+            }
+        }
+        if (aeHelper.consumeFinishedOverflow()) {
+            // 큐가 넘쳐 알림을 잃었습니다. 기다리는 재생을 한 번 직접 확인합니다.
+            EngineStdOut("Sound completion queue overflowed. Checking sound waits directly.", 1);
+            erase_if(m_soundWaits, [this](auto &entry) {
+                if (aeHelper.isPlaybackActive(entry.first)) {
+                    return false;
+                }
+                m_dueSoundWakes.push_back(move(entry.second));
+                return true;
+            });
+        }
+    }
+    for (const SoundWake &wake: m_dueSoundWakes) {
+        if (shared_ptr<Entity> entity = wake.entity.lock()) {
+            entity->resumeSoundWait(wake.executionThreadId, wake.playbackId, deltaTime);
+        }
+    }
+    m_dueSoundWakes.clear();
+    for (const ScriptWake &wake: m_dueWakes) {
+        shared_ptr<Entity> entity = wake.entity.lock();
+        if (!entity) {
+            continue; // 삭제된 엔티티 (복제본 삭제 등)
+        }
+        if (wake.type == Entity::WaitType::BLOCK_INTERNAL) {
+            entity->resumeInternalContinuation(wake.executionThreadId, wake.wakeTime, deltaTime);
+        } else {
+            entity->resumeExplicitWait(wake.executionThreadId, wake.wakeTime, deltaTime);
+        }
+    }
+    m_dueWakes.clear();
+}
+
+size_t Engine::conditionVariableBucket(const string &variableId) {
+    return hash<string>{}(variableId) % kConditionVariableBuckets;
+}
+
+void Engine::noteVariableWrite(const string &variableId) {
+    m_variableEpochs[conditionVariableBucket(variableId)].fetch_add(1, memory_order_release);
+}
+
+void Engine::noteConditionInput(uint8_t sources) {
+    if (sources & kWaitOnKeyboard) {
+        m_keyboardEpoch.fetch_add(1, memory_order_release);
+    }
+    if (sources & kWaitOnMouse) {
+        m_mouseEpoch.fetch_add(1, memory_order_release);
+    }
+    if (sources & kWaitOnEntity) {
+        m_entityEpoch.fetch_add(1, memory_order_release);
+    }
+}
+
+uint64_t Engine::conditionInputStamp(uint64_t variableBuckets, uint8_t sources) const {
+    // 각 횟수는 늘어나기만 하므로 합이 같으면 어느 입력도 바뀌지 않은 것입니다.
+    uint64_t stamp = 0;
+    for (uint64_t buckets = variableBuckets; buckets != 0; buckets &= buckets - 1) {
+        stamp += m_variableEpochs[countr_zero(buckets)].load(memory_order_acquire);
+    }
+    if (sources & kWaitOnKeyboard) {
+        stamp += m_keyboardEpoch.load(memory_order_acquire);
+    }
+    if (sources & (kWaitOnMouse | kWaitOnEntity)) {
+        stamp += m_mouseEpoch.load(memory_order_acquire); // 엔티티는 마우스로 끌어서 옮길 수 있습니다.
+    }
+    if (sources & kWaitOnEntity) {
+        stamp += m_entityEpoch.load(memory_order_acquire);
+    }
+    return stamp;
+}
+
+void Engine::parkConditionWait(weak_ptr<Entity> entity, const string &executionThreadId, uint64_t variableBuckets,
+                               uint8_t sources, uint64_t stamp) {
+    lock_guard lock(m_scriptWakeMutex);
+    m_conditionWaits.push_back({move(entity), executionThreadId, variableBuckets, sources, stamp});
+}
+
+void Engine::watchSoundCompletion(weak_ptr<Entity> entity, const string &executionThreadId, uint64_t playbackId,
+                                  bool retry) {
+    lock_guard lock(m_scriptWakeMutex);
+    SoundWake wake{playbackId, move(entity), executionThreadId};
+    if (retry) {
+        m_nextFrameSoundWakes.push_back(move(wake));
+    } else {
+        m_soundWaits[playbackId] = move(wake);
+    }
+}
+
+thread_local Engine::ScriptFrame *Engine::s_openScriptTickFrame = nullptr;
+thread_local Engine::ScriptTick *Engine::s_runningScriptTick = nullptr;
+thread_local uint32_t Engine::s_tickCommandSequence = 0;
+thread_local Uint64 Engine::s_tickDeadlineNs = 0;
+
+void Engine::enqueueScriptTick(shared_ptr<Entity> entity, const Script *script, const string &sceneIdAtDispatch,
+                               const string &executionThreadId, float deltaTime, bool resumed) {
+    if (m_isShuttingDown.load(memory_order_relaxed)) {
+        EngineStdOut("Engine is shutting down. Script tick not queued.", 1, executionThreadId);
+        return;
+    }
+    lock_guard lock(m_scriptTickMutex);
+    m_pendingScriptTicks.push_back({
+        .entity = move(entity), .script = script, .sceneIdAtDispatch = sceneIdAtDispatch,
+        .executionThreadId = executionThreadId, .deltaTime = deltaTime, .resumed = resumed,
+        .sequence = m_scriptTickSequence++
+    });
+}
+
+size_t Engine::runScriptFrame() {
+    auto frame = make_shared<ScriptFrame>(); {
+        lock_guard lock(m_scriptTickMutex);
+        frame->ticks.swap(m_pendingScriptTicks);
+    }
+    ++m_scriptFrameIndex;
+    applyScriptCpuBudget(frame->ticks);
+    if (frame->ticks.empty()) {
+        return 0;
+    }
+    const int shardMode = specialConfig.entityShardMode >= 0 ? specialConfig.entityShardMode : 1;
+    for (ScriptTick &tick: frame->ticks) {
+        tick.shardKey = tick.entity->getId();
+        if (shardMode == 2 && tick.entity->getIsClone() && !tick.entity->getOriginalClonedFromId().empty()) {
+            tick.shardKey = tick.entity->getOriginalClonedFromId();
+        }
+    }
+    // 등록 순서는 작업자 스레드에서 등록된 틱끼리 경합하므로, 작업자 수와 무관한 키로 실행 순서를 정합니다.
+    // 같은 엔티티의 스크립트는 objectScripts 벡터 안의 위치(주소) 순서입니다.
+    ranges::stable_sort(frame->ticks, [](const ScriptTick &a, const ScriptTick &b) {
+        if (a.shardKey != b.shardKey) {
+            return a.shardKey < b.shardKey;
+        }
+        const string &idA = a.entity->getId();
+        const string &idB = b.entity->getId();
+        if (idA != idB) {
+            return idA < idB;
+        }
+        if (a.script != b.script) {
+            return less<const Script *>()(a.script, b.script);
+        }
+        return a.sequence < b.sequence;
+    });
+    // 변수/리스트 같은 엔진 전역 상태를 쓰는 스크립트가 하나라도 있는 샤드 키는 모두 공유 샤드 하나로 모아
+    // 정렬 순서대로 실행합니다. 나머지 샤드는 자기 엔티티와 다른 엔티티의 프레임 스냅샷만 다루므로
+    // 어느 작업자가 언제 실행하든 결과가 같습니다.
+    unordered_set<string> sharedKeys;
+    for (const ScriptTick &tick: frame->ticks) {
+        if (tick.script && tick.script->usesSharedState) {
+            sharedKeys.insert(tick.shardKey);
+        }
+    }
+    const auto sharedEnd = ranges::stable_partition(frame->ticks, [&sharedKeys](const ScriptTick &tick) {
+        return sharedKeys.contains(tick.shardKey);
+    }).begin();
+    const size_t sharedTickCount = static_cast<size_t>(sharedEnd - frame->ticks.begin());
+
+    // 같은 샤드 키(엔티티)의 틱은 한 작업자가 순서대로 실행합니다.
+    // entityShardMode 가 0 이 아니면 그 엔티티들을 샤드에 고정해 잠금 없이 접근하고, 다른 샤드는 스냅샷을 읽습니다.
+    const size_t tickCount = frame->ticks.size();
+    for (size_t first = 0; first < tickCount;) {
+        size_t last = first + 1;
+        if (first < sharedTickCount) {
+            last = sharedTickCount;
+        } else {
+            while (last < tickCount && frame->ticks[last].shardKey == frame->ticks[first].shardKey) {
+                ++last;
+            }
+        }
+        ScriptShard shard{first, last - first, shardMode != 0 ? ++m_nextShardToken : 0};
+        if (shard.token != 0) {
+            const Entity *previous = nullptr;
+            for (size_t i = first; i < last; ++i) {
+                const shared_ptr<Entity> &entity = frame->ticks[i].entity;
+                if (entity.get() != previous) {
+                    entity->beginFrameShard(shard.token);
+                    frame->shardEntities.push_back(entity);
+                    previous = entity.get();
+                }
+            }
+        }
+        frame->shards.push_back(shard);
+        first = last;
+    }
+    frame->remaining.store(frame->shards.size(), memory_order_relaxed);
+    m_commandBuffers.resize((m_workerPool ? m_workerPool->size() : 0) + 1);
+
+    // 메인 스레드는 틱을 직접 실행하지 않습니다. (ask_and_wait 동기 경로처럼 메인 루프를 기다리는 블록이 있음)
+    // 인라인 실행기는 작업자가 없으므로 여기서 모든 틱을 실행하며, 그런 블록은 기다리지 않는 경로를 씁니다.
+    const size_t helpers = m_workerPool ? (min)(m_workerPool->size(), frame->shards.size()) : 0;
+    if (helpers == 0) {
+        drainScriptFrame(frame);
+    } else {
+        for (size_t i = 0; i < helpers; ++i) {
+            submitTask([this, frame] { drainScriptFrame(frame); });
+        }
+        unique_lock lock(m_scriptFrameMutex);
+        m_scriptFrameCv.wait(lock, [this, &frame] {
+            return frame->remaining.load(memory_order_acquire) == 0 || m_isShuttingDown.load(memory_order_relaxed);
+        });
+    }
+    for (const shared_ptr<Entity> &entity: frame->shardEntities) {
+        entity->endFrameShard();
+    }
+    if (!m_isShuttingDown.load(memory_order_relaxed)) {
+        processCommands();
+    }
+    return tickCount;
+}
+
+void Engine::drainScriptFrame(const shared_ptr<ScriptFrame> &frame) {
+    const size_t shardCount = frame->shards.size();
+    for (size_t i = frame->cursor.fetch_add(1, memory_order_relaxed); i < shardCount;
+         i = frame->cursor.fetch_add(1, memory_order_relaxed)) {
+        const ScriptShard &shard = frame->shards[i];
+        s_openScriptTickFrame = frame.get();
+        Entity::setCurrentShardToken(shard.token);
+        bool leftFrame = false;
+        for (size_t t = shard.firstTick; t < shard.firstTick + shard.tickCount; ++t) {
+            ScriptTick &tick = frame->ticks[t];
+            if (leftFrame) {
+                // 앞 틱이 배리어에서 빠졌으므로 샤드의 나머지는 다음 프레임에 실행합니다.
+                enqueueScriptTick(tick.entity, tick.script, tick.sceneIdAtDispatch, tick.executionThreadId,
+                                  tick.deltaTime, tick.resumed);
+                continue;
+            }
+            if (tick.entity && !m_isShuttingDown.load(memory_order_relaxed)) {
+                s_runningScriptTick = &tick;
+                s_tickCommandSequence = 0;
+                const Uint64 startNs = SDL_GetTicksNS();
+                s_tickDeadlineNs = startNs + static_cast<Uint64>(tick.allowanceNs);
+                tick.entity->runScriptTick(tick.script, tick.executionThreadId, tick.sceneIdAtDispatch,
+                                           tick.deltaTime, tick.resumed);
+                s_tickDeadlineNs = 0;
+                s_runningScriptTick = nullptr;
+                const Uint64 elapsedNs = SDL_GetTicksNS() - startNs;
+                // 배리어에서 빠진 틱은 입력 등을 기다린 시간이 섞여 있으므로 빚으로 치지 않습니다.
+                tick.entity->accountScriptTick(tick.executionThreadId, m_scriptFrameIndex, elapsedNs,
+                                               s_openScriptTickFrame ? tick.allowanceNs
+                                                                     : static_cast<int64_t>(elapsedNs));
+                if (Entity::consumeStateWritten()) {
+                    m_entityEpoch.fetch_add(1, memory_order_release);
+                }
+            }
+            if (!s_openScriptTickFrame) {
+                leftFrame = true;
+                tick.entity->reattachFrameShard();
+            }
+        }
+        Entity::setCurrentShardToken(0);
+        completeScriptTick();
+    }
+}
+
+void Engine::completeScriptTick() {
+    ScriptFrame *frame = s_openScriptTickFrame;
+    if (!frame) {
+        return;
+    }
+    s_openScriptTickFrame = nullptr;
+    if (frame->remaining.fetch_sub(1, memory_order_acq_rel) == 1) {
+        lock_guard lock(m_scriptFrameMutex);
+        m_scriptFrameCv.notify_all();
+    }
+}
+
+void Engine::leaveScriptFrame() {
+    if (!s_openScriptTickFrame) {
+        return;
+    }
+    if (s_runningScriptTick) {
+        // 배리어 뒤에도 실행되므로 샤드 고정을 풀고 잠금으로 접근합니다.
+        s_runningScriptTick->entity->detachFromFrameShard();
+        Entity::setCurrentShardToken(0);
+    }
+    completeScriptTick();
+}
+
+void Engine::submitCommand(EngineCommand command) {
+    ScriptFrame *frame = s_openScriptTickFrame;
+    if (!frame || !s_runningScriptTick) {
+        applyCommand(command);
+        return;
+    }
+    const int worker = m_workerPool ? m_workerPool->currentWorkerIndex() : -1;
+    const size_t buffer = worker >= 0 ? static_cast<size_t>(worker) : m_commandBuffers.size() - 1;
+    const auto tickIndex = static_cast<uint64_t>(s_runningScriptTick - frame->ticks.data());
+    command.order = (tickIndex << 24) | s_tickCommandSequence++;
+    m_commandBuffers[buffer].push_back(move(command));
+}
+
+void Engine::processCommands() {
+    vector<EngineCommand> commands;
+    for (vector<EngineCommand> &buffer: m_commandBuffers) {
+        ranges::move(buffer, back_inserter(commands));
+        buffer.clear();
+    }
+    if (commands.empty()) {
+        return;
+    }
+    // 틱 실행 순서는 작업자 수와 무관하므로, 어느 작업자가 기록했든 같은 순서로 적용됩니다.
+    ranges::sort(commands, {}, &EngineCommand::order);
+    for (EngineCommand &command: commands) {
+        applyCommand(command);
+    }
+}
+
+void Engine::applyCommand(EngineCommand &command) {
+    switch (command.type) {
+        case EngineCommand::Type::CHANGE_OBJECT_INDEX:
+            changeObjectIndex(command.targetId, command.indexChange);
+            break;
+        case EngineCommand::Type::CREATE_CLONE:
+            createCloneOfEntity(command.targetId, command.sceneIdForScripts, &command.cloneState);
+            break;
+        case EngineCommand::Type::DELETE_ENTITY:
+            deleteEntity(command.targetId);
+            break;
+        case EngineCommand::Type::DELETE_ALL_CLONES:
+            deleteAllClonesOf(command.targetId);
+            break;
+        case EngineCommand::Type::START_SCENE:
+            goToScene(command.targetId);
+            break;
+        case EngineCommand::Type::START_NEXT_SCENE:
+            goToNextScene();
+            break;
+        case EngineCommand::Type::START_PREVIOUS_SCENE:
+            goToPreviousScene();
+            break;
+        case EngineCommand::Type::SET_ENTITY_STATE:
+            if (Entity *entity = getEntityById(command.targetId)) {
+                command.entityWrite(*entity);
+            }
+            break;
+    }
+    noteConditionInput(kWaitOnEntity);
+}
+
 void Engine::updateFps() {
     framecount++;
     Uint64 now = SDL_GetTicks(); // 현재 시간
@@ -5232,7 +5948,7 @@ void Engine::updateFps() {
 }
 
 void Engine::startProjectTimer() {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // 타이머 변수 접근 보호
+    std::lock_guard lock(m_engineDataMutex); // 타이머 변수 접근 보호
     // 타이머가 이미 실행 중이면 아무것도 하지 않습니다.
     // 중지된 상태였다면, m_projectTimerValue는 중지 시점의 값을 가지고 있으므로,
     // m_projectTimerRunning 플래그만 true로 설정하고, m_projectTimerStartTime을 현재 시간으로 업데이트합니다.
@@ -5244,7 +5960,7 @@ void Engine::startProjectTimer() {
 }
 
 void Engine::stopProjectTimer() {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // 타이머 변수 접근 보호
+    std::lock_guard lock(m_engineDataMutex); // 타이머 변수 접근 보호
     if (m_projectTimerRunning) {
         Uint64 currentTime = SDL_GetTicks();
         // 경과 시간을 밀리초 단위로 가져와 초 단위로 변환 (소수점 이하 밀리초)
@@ -5260,7 +5976,7 @@ void Engine::stopProjectTimer() {
 }
 
 void Engine::resetProjectTimer() {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // 타이머 변수 접근 보호
+    std::lock_guard lock(m_engineDataMutex); // 타이머 변수 접근 보호
     m_projectTimerValue = 0.0;
     m_projectTimerRunning = false;
     m_projectTimerStartTime = 0; // 시작 시간도 초기화
@@ -5269,7 +5985,7 @@ void Engine::resetProjectTimer() {
 
 
 double Engine::getProjectTimerValue() const {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // 타이머 변수 접근 보호
+    std::lock_guard lock(m_engineDataMutex); // 타이머 변수 접근 보호
     if (m_projectTimerRunning) {
         Uint64 currentTime = SDL_GetTicks();
         // 현재 세션의 경과 시간 (밀리초)
@@ -5325,7 +6041,7 @@ Entity *Engine::getEntityById_nolock(const std::string &id) {
 
 // Shared pointer version of getEntityById
 std::shared_ptr<Entity> Engine::getEntityByIdShared(const std::string &id) {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // Protects entities map
+    std::lock_guard lock(m_engineDataMutex); // Protects entities map
     auto it = entities.find(id);
     if (it != entities.end()) {
         return it->second; // entities map stores std::shared_ptr<Entity>
@@ -5581,11 +6297,22 @@ bool Engine::showMessageBox(const string &message, int IconType, bool showYesNo)
 void Engine::activateTextInput(const std::string &requesterObjectId, const std::string &question,
                                const std::string &executionThreadId) {
     EngineStdOut("Activating text input for object " + requesterObjectId + " with question: \"" + question + "\"", 0,
-                 executionThreadId); {
+                 executionThreadId);
+    if (m_inlineExecutor) {
+        // 이 스레드가 곧 메인 루프이므로 기다리면 대답을 받을 수 없습니다. 질문만 띄우고 이어서 실행합니다.
+        EngineStdOut("Inline executor cannot block for text input. Showing question without waiting; "
+                     "'answer' updates when the user replies.", 1, executionThreadId);
+        requestTextInput(requesterObjectId, question, executionThreadId, true);
+        return;
+    }
+    // 대답은 메인 루프가 받으므로 이 틱이 끝나기를 기다리면 프레임이 멈춥니다. 배리어에서 먼저 빠집니다.
+    leaveScriptFrame(); {
         std::unique_lock<std::mutex> lock(m_textInputMutex);
-        if (m_textInputActive) {
+        if (m_textInputActive || !m_textInputWaiter.executionThreadId.empty()) {
             EngineStdOut("Text input already active. Waiting for it to complete...", 1, executionThreadId);
-            m_textInputCv.wait(lock, [this] { return !m_textInputActive || m_isShuttingDown; });
+            m_textInputCv.wait(lock, [this] {
+                return (!m_textInputActive && m_textInputWaiter.executionThreadId.empty()) || m_isShuttingDown;
+            });
         }
 
         // 이전 입력 상태 정리 및 새 입력 상태 설정
@@ -5595,21 +6322,7 @@ void Engine::activateTextInput(const std::string &requesterObjectId, const std::
         m_textInputActive = true;
     }
 
-    m_gameplayInputActive = false; // 텍스트 입력 중에는 일반 게임플레이 키 입력 비활성화
-
-    // SDL 텍스트 입력 시작 (IME 등 활성화)
-    SDL_StartTextInput(window); // Entity에 질문 다이얼로그 표시 요청
-    {
-        std::lock_guard<std::recursive_mutex> guard(m_engineDataMutex);
-        std::shared_ptr<Entity> entity = getEntityByIdShared(requesterObjectId); // Use shared_ptr version
-        if (entity) {
-            entity->showDialog(question, "ask", 0); // 0 duration means it stays until explicitly removed
-            EngineStdOut("Successfully showed dialog for entity " + requesterObjectId, 3, executionThreadId);
-        } else {
-            EngineStdOut("Warning: Entity " + requesterObjectId + " not found when trying to show 'ask' dialog.", 1,
-                         executionThreadId);
-        }
-    } {
+    showTextInputPrompt({requesterObjectId, question, executionThreadId}); {
         std::unique_lock<std::mutex> inputLock(m_textInputMutex);
         EngineStdOut("Script thread " + executionThreadId + " waiting for text input...", 0, executionThreadId);
 
@@ -5635,6 +6348,79 @@ void Engine::activateTextInput(const std::string &requesterObjectId, const std::
     }
 }
 
+void Engine::showTextInputPrompt(const TextInputRequest &request) {
+    m_gameplayInputActive = false; // 텍스트 입력 중에는 일반 게임플레이 키 입력 비활성화
+
+    // SDL 텍스트 입력 시작 (IME 등 활성화)
+    SDL_StartTextInput(window); // Entity에 질문 다이얼로그 표시 요청
+    std::lock_guard guard(m_engineDataMutex);
+    std::shared_ptr<Entity> entity = getEntityByIdShared(request.objectId); // Use shared_ptr version
+    if (entity) {
+        entity->showDialog(request.question, "ask", 0); // 0 duration means it stays until explicitly removed
+        EngineStdOut("Successfully showed dialog for entity " + request.objectId, 3, request.executionThreadId);
+    } else {
+        EngineStdOut("Warning: Entity " + request.objectId + " not found when trying to show 'ask' dialog.", 1,
+                     request.executionThreadId);
+    }
+}
+
+void Engine::requestTextInput(const std::string &requesterObjectId, const std::string &question,
+                              const std::string &executionThreadId, bool detached) {
+    TextInputRequest request{requesterObjectId, question, executionThreadId, detached}; {
+        std::lock_guard<std::mutex> lock(m_textInputMutex);
+        if (m_textInputActive || !m_textInputWaiter.executionThreadId.empty()) {
+            EngineStdOut("Text input already active. Queued question for object " + requesterObjectId, 1,
+                         executionThreadId);
+            m_pendingTextInputs.push_back(std::move(request));
+            return;
+        }
+        m_currentTextInputBuffer.clear();
+        m_textInputQuestionMessage = question;
+        m_textInputRequesterObjectId = requesterObjectId;
+        m_textInputActive = true;
+        m_textInputWaiter = request;
+    }
+    EngineStdOut("Activating text input for object " + requesterObjectId + " with question: \"" + question +
+                 "\"" + (detached ? "" : " (script suspended)"), 0, executionThreadId);
+    showTextInputPrompt(request);
+}
+
+void Engine::resumeTextInputWaiters() {
+    TextInputRequest answered; {
+        std::lock_guard<std::mutex> lock(m_textInputMutex);
+        if (!m_textInputActive) {
+            answered = m_textInputWaiter;
+        }
+    }
+    if (!answered.executionThreadId.empty()) {
+        std::shared_ptr<Entity> entity = getEntityByIdShared(answered.objectId);
+        if (entity && !answered.detached && !entity->resumeTextInputWait(answered.executionThreadId)) {
+            return; // 스크립트가 아직 멈추기 전이면 다음 프레임에 다시 시도
+        }
+        SDL_StopTextInput(window);
+        m_gameplayInputActive = true; {
+            std::lock_guard<std::mutex> lock(m_textInputMutex);
+            m_textInputWaiter = {};
+        }
+        m_textInputCv.notify_all(); // activateTextInput 으로 기다리는 스레드가 있으면 이어서 질문
+    }
+
+    TextInputRequest next; {
+        std::lock_guard<std::mutex> lock(m_textInputMutex);
+        if (m_textInputActive || !m_textInputWaiter.executionThreadId.empty() || m_pendingTextInputs.empty()) {
+            return;
+        }
+        next = std::move(m_pendingTextInputs.front());
+        m_pendingTextInputs.pop_front();
+        m_currentTextInputBuffer.clear();
+        m_textInputQuestionMessage = next.question;
+        m_textInputRequesterObjectId = next.objectId;
+        m_textInputActive = true;
+        m_textInputWaiter = next;
+    }
+    showTextInputPrompt(next);
+}
+
 std::string Engine::getLastAnswer() const {
     std::lock_guard<std::mutex> lock(m_textInputMutex); // Protect access to m_lastAnswer
     return m_lastAnswer;
@@ -5650,14 +6436,15 @@ void Engine::updateAnswerVariable() {
         currentAnswer = m_lastAnswer;
     }
 
-    std::unique_lock<std::recursive_mutex> dataLock(m_engineDataMutex, std::try_to_lock);
+    std::unique_lock dataLock(m_engineDataMutex, std::try_to_lock);
     if (!dataLock.owns_lock()) {
         requestAnswerUpdate(); // 락을 얻지 못했다면 나중에 다시 시도
         return;
     }
     for (auto &var: m_HUDVariables) {
         if (var.variableType == "answer" || (var.variableType == "list" && var.isAnswerList)) {
-            var.value = currentAnswer;
+            m_variables.slot(var.slot).value = OperandValue(currentAnswer);
+            noteVariableWrite(var.id);
             EngineStdOut("Updated " + var.variableType + " variable '" + var.name + "' value to: " + currentAnswer, 3);
             // answer 타입일 경우 첫 번째 변수만 업데이트하고 종료
             if (var.variableType == "answer") {
@@ -5743,7 +6530,7 @@ void Engine::goToScene(const string &sceneId) {
         }
 
         const std::string oldSceneId = currentSceneId; {
-            std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+            std::lock_guard lock(m_engineDataMutex);
 
             // 1. 모든 엔티티의 스크립트 상태를 확인하고 필요한 작업 수행
             for (const auto &[entityId, entityPtr]: entities) {
@@ -5753,30 +6540,33 @@ void Engine::goToScene(const string &sceneId) {
                     // 글로벌이 아니고 현재 씬에 속한 엔티티의 스크립트 종료
                     if (!isGlobal && objInfo->sceneId == oldSceneId) {
                         // 스크립트 스레드를 완전히 종료하고 상태를 지우는 대신, 일시 중지 상태로 변경
-                        std::lock_guard<std::recursive_mutex> entity_lock(entityPtr->getStateMutex());
-                        for (auto &threadPair: entityPtr->scriptThreadStates) {
-                            auto &state = threadPair.second;
+                        std::lock_guard entity_lock(entityPtr->getStateMutex());
+                        for (auto &thread: entityPtr->scriptThreadStates) {
+                            auto &state = thread.state;
                             if (!state.terminateRequested) {
                                 // 이미 종료 요청된 스크립트는 제외
                                 state.isWaiting = true;
                                 state.currentWaitType = Entity::WaitType::SCENE_CHANGE_SUSPEND; // 새로운 대기 타입 설정
                                 // resumeAtBlockIndex, scriptPtrForResume, loopCounters 등 기존 상태는 유지됨
                                 EngineStdOut(
-                                    "Entity " + entityId + " suspended script thread " + threadPair.first +
-                                    " due to scene change.", 0, threadPair.first);
+                                    "Entity " + entityId + " suspended script thread " + thread.id +
+                                    " due to scene change.", 0, thread.id);
                             } else {
                                 // 이미 종료 요청된 스크립트는 상태를 정리 (workerLoop에서 최종 종료될 것임)
                                 state.isWaiting = false;
                                 state.resumeAtBlockIndex = -1;
                                 state.blockIdForWait = "";
                                 state.loopCounters.clear();
+                                state.programLoopCounters.clear();
+                                state.callFrames.clear();
+                                state.frameValueTop = 0;
                                 state.currentWaitType = Entity::WaitType::NONE;
                                 state.scriptPtrForResume = nullptr;
                                 state.sceneIdAtDispatchForResume = "";
                                 state.originalInnerBlockIdForWait = ""; // 관련 정보 초기화
                                 EngineStdOut(
-                                    "Entity " + entityId + " script thread " + threadPair.first +
-                                    " was already marked for termination. Clearing state.", 0, threadPair.first);
+                                    "Entity " + entityId + " script thread " + thread.id +
+                                    " was already marked for termination. Clearing state.", 0, thread.id);
                             }
                         }
                     }
@@ -5815,7 +6605,7 @@ void Engine::goToScene(const string &sceneId) {
 
         // 3. 새로운 씬으로 전환하기 전에 엔티티들을 초기 위치로 리셋
         {
-            lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // 초기 위치 정보를 ObjectInfo의 entity 필드에서 수집
+            lock_guard lock(m_engineDataMutex); // 초기 위치 정보를 ObjectInfo의 entity 필드에서 수집
             map<std::string, std::pair<double, double> > initialPositions;
             map<string, pair<double, double> > scale;
             map<string, bool> visiblity;
@@ -6002,7 +6792,7 @@ void Engine::resumeSuspendedScriptsInCurrentScene() {
         std::string /*sceneIdAtDispatch*/, // 이 값은 state.sceneIdAtDispatchForResume에서 가져옴
         int /*resumeAtBlockIndex*/,
         std::string /*originalInnerBlockIdForWait*/> > tasksToDispatch; {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+        std::lock_guard lock(m_engineDataMutex);
 
         for (auto const &[entityId, entityPtr]: entities) {
             if (!entityPtr) continue;
@@ -6014,12 +6804,12 @@ void Engine::resumeSuspendedScriptsInCurrentScene() {
 
             // 현재 씬에 속하거나 전역 엔티티인 경우에만 스크립트 상태 확인
             if (isGlobal || objInfo->sceneId == currentSceneId) {
-                std::lock_guard<std::recursive_mutex> entity_lock(entityPtr->getStateMutex());
+                std::lock_guard entity_lock(entityPtr->getStateMutex());
 
                 for (auto it_state = entityPtr->scriptThreadStates.begin();
                      it_state != entityPtr->scriptThreadStates.end(); /* manual increment */) {
-                    auto &execId = it_state->first;
-                    auto &state = it_state->second;
+                    auto &execId = it_state->id;
+                    auto &state = it_state->state;
 
                     if (state.isWaiting && state.currentWaitType == Entity::WaitType::SCENE_CHANGE_SUSPEND) {
                         // 재개 조건:
@@ -6107,25 +6897,8 @@ void Engine::triggerWhenSceneStartScripts() {
         return;
     }
     EngineStdOut("Triggering 'when_scene_start' scripts for scene: " + currentSceneId, 0);
-    for (const auto &scriptPair: m_whenStartSceneLoadedScripts) {
-        const string &objectId = scriptPair.first;
-        const Script *scriptPtr = scriptPair.second;
-
-        bool executeForScene = false;
-        for (const auto &objInfo: objects_in_order) {
-            if (objInfo.id == objectId && (objInfo.sceneId == currentSceneId || objInfo.sceneId == "global" || objInfo.
-                                           sceneId.empty())) {
-                executeForScene = true;
-                break;
-            }
-        }
-
-        if (executeForScene) {
-            EngineStdOut(
-                "  -> Running 'when_scene_start' script for object ID: " + objectId + " in scene " + currentSceneId, 3);
-            this->dispatchScriptForExecution(objectId, scriptPtr, currentSceneId, 0.0);
-        }
-    }
+    size_t started = dispatchScriptBatch(m_whenStartSceneLoadedScripts, currentSceneId, true);
+    EngineStdOut("  -> Started " + to_string(started) + " 'when_scene_start' thread(s) in scene " + currentSceneId, 3);
 }
 
 int Engine::getBlockCountForObject(const std::string &objectId) const {
@@ -6156,7 +6929,7 @@ int Engine::getBlockCountForScene(const std::string &sceneId) const {
 }
 
 void Engine::changeObjectIndex(const std::string &entityId, Omocha::ObjectIndexChangeType changeType) {
-    std::lock_guard<std::recursive_mutex> lock(this->m_engineDataMutex); // Protect access to objects_in_order
+    std::lock_guard lock(this->m_engineDataMutex); // Protect access to objects_in_order
 
     auto it = std::find_if(objects_in_order.begin(), objects_in_order.end(),
                            [&entityId](const ObjectInfo &objInfo) {
@@ -6288,7 +7061,7 @@ void Engine::drawDialogs() {
 
 
     for (auto &pair: entities) {
-        std::lock_guard<std::recursive_mutex> entity_lock(pair.second->getStateMutex());
+        std::lock_guard entity_lock(pair.second->getStateMutex());
         Entity *entity = pair.second.get();
 
         if (entity && entity->hasActiveDialog()) {
@@ -6739,6 +7512,7 @@ SDL_Texture *Engine::LoadTextureFromSvgResource(SDL_Renderer *renderer, int reso
 }
 
 bool Engine::setEntitySelectedCostume(const std::string &entityId, const std::string &costumeId) {
+    Entity::markStateWritten();
     for (auto &objInfo: objects_in_order) {
         if (objInfo.id == entityId) {
             // Check if the costumeId exists in objInfo.costumes
@@ -6767,6 +7541,7 @@ bool Engine::setEntitySelectedCostume(const std::string &entityId, const std::st
 }
 
 bool Engine::setEntitychangeToNextCostume(const string &entityId, const string &asOption) {
+    Entity::markStateWritten();
     for (auto &objInfo: objects_in_order) {
         if (objInfo.id == entityId) {
             if (objInfo.costumes.size() <= 1) {
@@ -6828,81 +7603,86 @@ void Engine::raiseMessage(const std::string &messageId, const std::string &sende
         "Message '" + messageId + "' raised by object " + senderObjectId + " (Thread: " + executionThreadId + ")", 0,
         executionThreadId);
     auto it = m_messageReceivedScripts.find(messageId);
-    if (it != m_messageReceivedScripts.end()) {
-        const auto &scriptsToRun = it->second;
-        EngineStdOut(
-            "Found " + std::to_string(scriptsToRun.size()) + " script(s) listening for message '" + messageId + "'", 0,
-            executionThreadId);
-        for (const auto &scriptPair: scriptsToRun) {
-            const std::string &listeningObjectId = scriptPair.first;
-            const Script *scriptPtr = scriptPair.second;
-
-            // Optional: Prevent an object from triggering its own message-received script if that's desired behavior.
-            // if (listeningObjectId == senderObjectId) {
-            //     EngineStdOut("Object " + listeningObjectId + " is trying to trigger its own message '" + messageId + "'. Skipping.", 1, executionThreadId);
-            //     continue;
-            // }
-
-            Entity *listeningEntity = getEntityById(listeningObjectId);
-            if (listeningEntity) {
-                // Check if the listening entity is in the current scene or is global
-                const ObjectInfo *objInfoPtr = getObjectInfoById(listeningObjectId);
-                if (objInfoPtr) {
-                    bool isInCurrentScene = (objInfoPtr->sceneId == currentSceneId);
-                    bool isGlobal = (objInfoPtr->sceneId == "global" || objInfoPtr->sceneId.empty());
-                    if (isInCurrentScene || isGlobal) {
-                        EngineStdOut(
-                            "Dispatching message-received script for object: " + listeningObjectId + " (Message: '" +
-                            messageId + "') " + getMessageNameById(messageId), 3, executionThreadId); // LEVEL 0 -> 3
-                        // 메시지 수신 스크립트는 항상 새 스레드로 시작 (existingExecutionThreadId를 비워둠)
-                        // 또한, 메시지를 받은 시점의 씬 컨텍스트(currentSceneId)를 사용합니다.
-                        // 기존 코드에서 sceneIdAtDispatch가 항상 currentSceneId로 전달되었으므로,
-                        // 이 부분은 변경 없이 유지하거나 명시적으로 currentSceneId를 전달할 수 있습니다.
-                        // 여기서는 명확성을 위해 currentSceneId를 전달합니다.
-                        // deltaTime은 이벤트 발생 시점이므로 0.0f가 적절합니다.
-                        this->dispatchScriptForExecution(listeningObjectId, scriptPtr, currentSceneId, 0.0f, "");
-                        // 엔진 파라미터 감지 (신호)
-                        std::string oeParamValue = getOEparam(getMessageNameById(messageId)); // "<OE:OFD>"에서 "OFD" 추출
-
-                        if (!oeParamValue.empty()) {
-                            // OE 신호인지 확인
-                            EngineStdOut("OE Param extracted: " + oeParamValue, 3, executionThreadId);
-                            if (oeParamValue == "OFD") {
-                                std::string ofdResult = this->OFD(); // OFD() 한 번만 호출
-                                if (!ofdResult.empty()) {
-                                    EngineStdOut(format("Opened EntryFile {}", ofdResult));
-                                    m_pendingProjectToLoadPath = ofdResult;
-                                    m_projectLoadRequestedViaOFD.store(true, memory_order_relaxed);
-                                } else {
-                                    this->showMessageBox("사용자 가 파일열기 를 취소했습니다.",SDL_MESSAGEBOX_INFORMATION);
-                                }
-                            }
-                            // 다른 OE 신호 처리 로직 추가 가능
-                            // else if (oeParamValue == "ANOTHER_OE_SIGNAL") { /* ... */ }
-                        }
-                    } else {
-                        EngineStdOut(
-                            "Script for message '" + messageId + "' on object " + listeningObjectId +
-                            " not run because object is not in current scene (" + currentSceneId + ") and not global.",
-                            1, executionThreadId);
-                    }
-                } else {
-                    EngineStdOut(
-                        "ObjectInfo not found for entity ID '" + listeningObjectId + "' during message '" + messageId +
-                        "' processing. Script not run.",
-                        1, executionThreadId);
-                }
+    if (it == m_messageReceivedScripts.end()) {
+        EngineStdOut("No scripts found listening for message '" + messageId + "'", 0, executionThreadId);
+        return;
+    }
+    const auto &scriptsToRun = it->second;
+    // 메시지 수신 스크립트는 항상 새 스레드로, 메시지를 받은 시점의 장면 컨텍스트(currentSceneId)에서 시작합니다.
+    size_t started = dispatchScriptBatch(scriptsToRun, currentSceneId, true);
+    EngineStdOut(
+        "Dispatched " + to_string(started) + " of " + to_string(scriptsToRun.size()) +
+        " script(s) listening for message '" + messageId + "' " + getMessageNameById(messageId), 3, executionThreadId);
+    if (started == 0) {
+        return;
+    }
+    // 엔진 파라미터 감지 (신호). 받는 스크립트 수와 관계없이 신호마다 한 번만 처리합니다.
+    std::string oeParamValue = getOEparam(getMessageNameById(messageId)); // "<OE:OFD>"에서 "OFD" 추출
+    if (!oeParamValue.empty()) {
+        // OE 신호인지 확인
+        EngineStdOut("OE Param extracted: " + oeParamValue, 3, executionThreadId);
+        if (oeParamValue == "OFD") {
+            std::string ofdResult = this->OFD(); // OFD() 한 번만 호출
+            if (!ofdResult.empty()) {
+                EngineStdOut(format("Opened EntryFile {}", ofdResult));
+                m_pendingProjectToLoadPath = ofdResult;
+                m_projectLoadRequestedViaOFD.store(true, memory_order_relaxed);
             } else {
-                EngineStdOut(
-                    "Entity " + listeningObjectId +
-                    " not found when trying to execute message-received script for message '" + messageId + "'.",
-                    1,
-                    executionThreadId);
+                this->showMessageBox("사용자 가 파일열기 를 취소했습니다.",SDL_MESSAGEBOX_INFORMATION);
             }
         }
-    } else {
-        EngineStdOut("No scripts found listening for message '" + messageId + "'", 0, executionThreadId);
+        // 다른 OE 신호 처리 로직 추가 가능
+        // else if (oeParamValue == "ANOTHER_OE_SIGNAL") { /* ... */ }
+    }
+}
+
+size_t Engine::dispatchScriptBatch(const vector<pair<string, const Script *>> &scripts,
+                                   const string &sceneIdAtDispatch, bool currentSceneOnly) {
+    if (scripts.empty() || m_isShuttingDown.load(memory_order_relaxed)) {
+        return 0;
+    }
+    vector<ScriptTick> ticks;
+    ticks.reserve(scripts.size()); {
+        lock_guard lock(m_engineDataMutex); // entities / objects_in_order 접근 보호
+        // 오브젝트마다 getObjectInfoById 로 선형 탐색하지 않고, 현재 장면에서 실행할 오브젝트를 한 번에 모읍니다.
+        unordered_set<string_view> runnableObjects;
+        if (currentSceneOnly) {
+            runnableObjects.reserve(objects_in_order.size());
+            for (const ObjectInfo &objInfo: objects_in_order) {
+                if (objInfo.sceneId == currentSceneId || objInfo.sceneId == "global" || objInfo.sceneId.empty()) {
+                    runnableObjects.insert(objInfo.id);
+                }
+            }
+        }
+        for (const auto &[objectId, scriptPtr]: scripts) {
+            if (!scriptPtr || (currentSceneOnly && !runnableObjects.contains(objectId))) {
+                continue;
+            }
+            auto entityIt = entities.find(objectId);
+            if (entityIt == entities.end() || !entityIt->second) {
+                EngineStdOut("dispatchScriptBatch: Entity " + objectId + " not found. Cannot schedule script.", 1);
+                continue;
+            }
+            string executionThreadId = entityIt->second->createScriptThread(scriptPtr);
+            if (executionThreadId.empty()) {
+                continue;
+            }
+            ticks.push_back({
+                .entity = entityIt->second, .script = scriptPtr, .sceneIdAtDispatch = sceneIdAtDispatch,
+                .executionThreadId = move(executionThreadId)
+            });
+        }
+    }
+    if (ticks.empty()) {
+        return 0;
+    }
+    const size_t started = ticks.size();
+    lock_guard lock(m_scriptTickMutex);
+    for (ScriptTick &tick: ticks) {
+        tick.sequence = m_scriptTickSequence++;
+        m_pendingScriptTicks.push_back(move(tick));
     }
+    return started;
 }
 
 void Engine::dispatchScriptForExecution(const std::string &entityId, const Script *scriptPtr,
@@ -6916,7 +7696,7 @@ void Engine::dispatchScriptForExecution(const std::string &entityId, const Scrip
 
     // Entity 객체를 찾습니다.
     Entity *entity = nullptr; {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // entities 맵 접근 보호
+        std::lock_guard lock(m_engineDataMutex); // entities 맵 접근 보호
         entity = getEntityById_nolock(entityId);
     }
 
@@ -6962,7 +7742,7 @@ bool Engine::saveCloudVariablesToJson() {
     }
 
     EngineStdOut("Saving cloud variables to: " + filePath, 3);
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // Protect m_HUDVariables
+    std::lock_guard lock(m_engineDataMutex); // Protect m_HUDVariables
 
     nlohmann::json doc = nlohmann::json::array();
 
@@ -6971,18 +7751,19 @@ bool Engine::saveCloudVariablesToJson() {
             nlohmann::json varJson = nlohmann::json::object();
 
             varJson["name"] = hudVar.name;
-            varJson["value"] = hudVar.value;
+            const VariableStore::Slot &data = m_variables.slot(hudVar.slot);
+            varJson["value"] = data.value.asString();
             varJson["objectId"] = hudVar.objectId;
             varJson["variableType"] = hudVar.variableType;
 
             if (hudVar.variableType == "list") {
                 nlohmann::json arrayJson = nlohmann::json::array();
-                for (const auto &item: hudVar.array) {
+                data.items.forEach([&arrayJson](const VariableList::Item &item) {
                     nlohmann::json itemJson = nlohmann::json::object();
-                    itemJson["key"] = item.key;
-                    itemJson["data"] = item.data;
+                    itemJson["key"] = ""; // 저장 형식 유지용 (항목 key 는 보관하지 않음)
+                    itemJson["data"] = item.asString();
                     arrayJson.push_back(itemJson);
-                }
+                });
                 varJson["array"] = arrayJson;
             }
             doc.push_back(varJson);
@@ -7044,7 +7825,7 @@ bool Engine::loadCloudVariablesFromJson() {
         return false;
     }
 
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // Protect m_HUDVariables
+    std::lock_guard lock(m_engineDataMutex); // Protect m_HUDVariables
 
     int updatedCount = 0;
     int notFoundCount = 0;
@@ -7094,34 +7875,28 @@ bool Engine::loadCloudVariablesFromJson() {
         for (auto &hudVar: m_HUDVariables) {
             if (hudVar.isCloud && hudVar.name == name && hudVar.objectId == objectId && hudVar.variableType ==
                 variableType) {
-                hudVar.value = value;
+                VariableStore::Slot &data = m_variables.slot(hudVar.slot);
+                data.value = OperandValue(value);
                 EngineStdOut(
                     "Cloud variable '" + name + "' (Object: '" + (objectId.empty() ? "global" : objectId) +
                     "') updated to value: '" + value + "'", 3);
 
                 if (variableType == "list") {
-                    hudVar.array.clear();
+                    data.items.clear();
                     if (savedVarJson.contains("array") && savedVarJson["array"].is_array()) {
                         const nlohmann::json &arrayJson = savedVarJson["array"];
                         for (const auto &itemJson: arrayJson) // Corrected: Iterate over nlohmann::json array
                         {
                             if (itemJson.is_object()) {
-                                ListItem listItem;
-                                if (itemJson.contains("key") && itemJson["key"].is_string()) {
-                                    listItem.key = itemJson["key"].get<string>();
-                                } else {
-                                    listItem.key = "";
-                                }
                                 if (itemJson.contains("data") && itemJson["data"].is_string()) {
-                                    listItem.data = itemJson["data"].get<string>();
+                                    data.items.push_back(VariableList::Item::fromString(itemJson["data"].get<string>()));
                                 } else {
-                                    listItem.data = "";
+                                    data.items.push_back(VariableList::Item::fromString(""));
                                 }
-                                hudVar.array.push_back(listItem);
                             }
                         }
                         EngineStdOut(
-                            "  List '" + name + "' updated with " + std::to_string(hudVar.array.size()) + " items.", 0);
+                            "  List '" + name + "' updated with " + std::to_string(data.items.size()) + " items.", 0);
                     }
                 }
                 foundAndUpdated = true;
@@ -7162,7 +7937,7 @@ void Engine::performProjectRestart() {
     // currentEntitiesSnapshot을 만드는 동안만 m_engineDataMutex를 잠급니다.
     EngineStdOut("Requesting termination of all entity scripts...", 0);
     std::vector<std::shared_ptr<Entity> > currentEntitiesSnapshot; {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+        std::lock_guard lock(m_engineDataMutex);
         for (auto const &[id, entity_ptr]: entities) {
             currentEntitiesSnapshot.push_back(entity_ptr);
         }
@@ -7178,21 +7953,14 @@ void Engine::performProjectRestart() {
     // --- 단계 2: 스레드 풀 종료 (m_engineDataMutex를 잡지 않은 상태에서) ---
     // 작업자 스레드들이 m_isShuttingDown 플래그를 보고 빠르게 종료하도록 유도합니다.
 
-    // 2.1 Engine의 메인 작업 스레드 풀 중지 및 조인
-    EngineStdOut("Stopping main worker thread pool (m_workerThreads)...", 0);
-    stopThreadPool(); // 이 함수는 내부적으로 m_workerThreads의 join을 처리합니다.
-
-    // 2.2 BlockExecutor의 스레드 풀 중지 및 조인
-    if (threadPool) {
-        EngineStdOut("Stopping BlockExecutor::ThreadPool (engine.threadPool)...", 0);
-        threadPool.reset(); // ThreadPool 소멸자가 내부 스레드를 join합니다.
-        EngineStdOut("BlockExecutor::ThreadPool stopped.", 0);
-    }
+    // 2.1 Engine의 작업자 풀 중지 및 조인
+    EngineStdOut("Stopping worker pool (m_workerPool)...", 0);
+    stopThreadPool(); // 이 함수는 내부적으로 m_workerPool 작업자의 join을 처리합니다.
     EngineStdOut("All worker threads are expected to be joined now.", 0);
 
     // --- 단계 3: 모든 스레드가 종료된 후, m_engineDataMutex를 잠그고 나머지 정리 작업 수행 ---
     EngineStdOut("Performing final cleanup of engine state and collections...", 0); {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+        std::lock_guard lock(m_engineDataMutex);
 
         // 3.1 엔티티별 상태 정리 (스크립트 상태, 다이얼로그 등)
         EngineStdOut("Clearing script states and dialogs from entities...", 0);
@@ -7213,6 +7981,8 @@ void Engine::performProjectRestart() {
         entities.clear(); // shared_ptr 참조 카운트가 0이 되면 Entity 소멸자 호출
         objects_in_order.clear();
         objectScripts.clear();
+        m_userFunctions.clear();
+        m_userFunctionIndex.clear();
 
         // 이벤트 스크립트 목록 초기화
         startButtonScripts.clear();
@@ -7226,6 +7996,7 @@ void Engine::performProjectRestart() {
         m_whenCloneStartScripts.clear();
 
         m_HUDVariables.clear();
+        m_variables.clear();
         scenes.clear();
         m_sceneOrder.clear();
         m_cloneCounters.clear();
@@ -7245,14 +8016,10 @@ void Engine::performProjectRestart() {
     // --- 단계 4: 스레드 풀 재 생성 및 프로젝트/에셋 리로드 (m_engineDataMutex를 잡지 않은 상태에서) ---
     m_isShuttingDown.store(false, std::memory_order_relaxed); // 재시작을 위해 종료 플래그 리셋
 
-    EngineStdOut("Re-creating thread pools...", 0);
-    // Engine의 메인 스레드 풀 재시작
-    startThreadPool((max)(2u, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 2u));
-    // BlockExecutor의 스레드 풀 재생성
-    if (!threadPool) {
-        // 위에서 reset()으로 해제되었으므로 다시 생성
-        threadPool = std::make_unique<ThreadPool>(
-            *this, (max)(1u, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 2));
+    if (!m_inlineExecutor) {
+        // 인라인 실행기였다면 loadProject 의 selectScriptExecutor 가 필요할 때만 풀을 만듭니다.
+        EngineStdOut("Re-creating worker pool...", 0);
+        startThreadPool((max)(2u, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 2u));
     }
 
     EngineStdOut("Reloading project data...", 0);
@@ -7312,7 +8079,7 @@ void Engine::requestStopObject(const std::string &callingEntityId, const std::st
         + targetOption, 0, callingThreadId);
 
     if (targetOption == "all") {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // Protects entities map
+        std::lock_guard lock(m_engineDataMutex); // Protects entities map
         for (auto &pair: entities) {
             if (pair.second) {
                 pair.second->terminateAllScriptThread(""); // Terminate all threads for this entity
@@ -7344,7 +8111,7 @@ void Engine::requestStopObject(const std::string &callingEntityId, const std::st
                 callingThreadId + ")", 0, callingThreadId);
         }
     } else if (targetOption == "other_objects") {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // Protects entities map
+        std::lock_guard lock(m_engineDataMutex); // Protects entities map
         for (auto &pair: entities) {
             if (pair.first != callingEntityId && pair.second) {
                 // If it's not the calling entity
@@ -7360,27 +8127,97 @@ void Engine::requestStopObject(const std::string &callingEntityId, const std::st
 
 void Engine::startThreadPool(size_t numThreads) {
     m_isShuttingDown.store(false, std::memory_order_relaxed);
-    for (size_t i = 0; i < numThreads; ++i) {
-        m_workerThreads.emplace_back(&Engine::workerLoop, this);
+    m_workerPool = std::make_unique<WorkStealingPool>(numThreads, [this](std::function<void()> &task) {
+        runPoolTask(task);
+    });
+    EngineStdOut("thread pool started with " + std::to_string(m_workerPool->size()) + " threads.", 0);
+}
+
+void Engine::selectScriptExecutor() {
+    const size_t objectCount = objects_in_order.size();
+    const int mode = specialConfig.scriptExecutor;
+    const bool useInline = mode == 2 || (mode == 0 && objectCount < INLINE_EXECUTOR_MAX_OBJECTS);
+    if (useInline) {
+        // 작업자가 모두 join 된 뒤에야 잠금을 건너뛸 수 있습니다.
+        stopThreadPool();
+        ExecutorLockElision::setSingleThreaded(true);
+        m_inlineExecutor = true;
+    } else {
+        ExecutorLockElision::setSingleThreaded(false);
+        m_inlineExecutor = false;
+        if (!m_workerPool) {
+            startThreadPool((max)(1u, std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 2u));
+        }
     }
-    EngineStdOut("thread pool started with " + std::to_string(numThreads) + " threads.", 0);
+    EngineStdOut(string("Script executor: ") + (useInline ? "inline (main thread, no locking)" : "worker pool") +
+                 " for " + to_string(objectCount) + " objects" + (mode == 0 ? " (auto)" : ""), 0);
 }
 
-void Engine::stopThreadPool() {
-    EngineStdOut("Stopping thread pool...", 0);
-    // m_isShuttingDown is typically set by the caller (destructor or restart logic)
-    // If not, it should be set here:
+void Engine::runExecutorBenchmark(int frames) {
+    const int savedExecutor = specialConfig.scriptExecutor;
+    const int targetFps = specialConfig.TARGET_FPS > 0 ? specialConfig.TARGET_FPS : 60;
+    const Uint64 frameBudgetNs = SDL_NS_PER_SECOND / static_cast<Uint64>(targetFps);
+    const float deltaTime = static_cast<float>(frameBudgetNs) / static_cast<float>(SDL_NS_PER_SECOND);
+
+    // 두 실행기 모두 프로젝트를 처음부터 다시 시작해 같은 틱 부하를 받습니다.
+    for (const int mode: {2, 1}) {
+        specialConfig.scriptExecutor = mode;
+        performProjectRestart(); // loadProject -> selectScriptExecutor, 시작 버튼 스크립트 실행
+        const string name = mode == 2 ? "inline" : "pool(" + to_string(m_workerPool ? m_workerPool->size() : 0) + ")";
+
+        vector<Uint64> latencies;
+        latencies.reserve(static_cast<size_t>(frames));
+        size_t totalTicks = 0;
+        for (int f = 0; f < frames; ++f) {
+            const Uint64 frameStart = SDL_GetTicksNS();
+            SDL_PumpEvents();
+            beginBoostFrameBudget(); {
+                lock_guard lock(m_engineDataMutex);
+                for (auto &[id, entity]: entities) {
+                    if (entity) {
+                        entity->updateDialog(deltaTime);
+                    }
+                }
+                processScriptWakeups(deltaTime);
+            }
+            resumeTextInputWaiters();
+            const Uint64 scriptStart = SDL_GetTicksNS();
+            totalTicks += runScriptFrame();
+            latencies.push_back(SDL_GetTicksNS() - scriptStart);
+            // 대기 블록이 실제 게임 루프와 같은 시각에 깨어나도록 목표 프레임 시간에 맞춥니다.
+            const Uint64 elapsed = SDL_GetTicksNS() - frameStart;
+            if (elapsed < frameBudgetNs) {
+                SDL_DelayNS(frameBudgetNs - elapsed);
+            }
+        }
 
-    m_taskQueueCV_std.notify_all(); // Wake up all workers
-    for (std::thread &worker: m_workerThreads) {
-        if (worker.joinable()) {
-            worker.join();
+        Uint64 totalNs = 0;
+        for (const Uint64 ns: latencies) {
+            totalNs += ns;
         }
+        ranges::sort(latencies);
+        const auto ms = [](Uint64 ns) { return static_cast<double>(ns) / 1'000'000.0; };
+        const size_t p95 = latencies.empty() ? 0 : (latencies.size() * 95 - 1) / 100;
+        const double ticksPerSecond = totalNs > 0
+                                          ? static_cast<double>(totalTicks) * SDL_NS_PER_SECOND / static_cast<double>(totalNs)
+                                          : 0.0;
+        EngineStdOut(format("Executor benchmark [{}]: {} frames, {} ticks, "
+                            "frame latency avg {:.3f} ms / p95 {:.3f} ms / max {:.3f} ms, {:.0f} ticks/s",
+                            name, latencies.size(), totalTicks,
+                            latencies.empty() ? 0.0 : ms(totalNs) / static_cast<double>(latencies.size()),
+                            latencies.empty() ? 0.0 : ms(latencies[p95]),
+                            latencies.empty() ? 0.0 : ms(latencies.back()), ticksPerSecond), 0);
     }
-    m_workerThreads.clear();
-    // Clear any remaining tasks in the queue
-    std::queue<std::function<void()> > empty;
-    std::swap(m_taskQueue, empty);
+
+    specialConfig.scriptExecutor = savedExecutor;
+    selectScriptExecutor();
+}
+
+void Engine::stopThreadPool() {
+    EngineStdOut("Stopping thread pool...", 0);
+    // m_isShuttingDown is typically set by the caller (destructor or restart logic)
+    // 남은 작업은 m_isShuttingDown 을 보고 바로 끝나며, 풀 소멸자가 작업자를 join 합니다.
+    m_workerPool.reset();
     EngineStdOut("pool stopped and joined.", 0);
 }
 
@@ -7390,12 +8227,13 @@ int Engine::getNextCloneIdSuffix(const std::string &originalId) {
 }
 
 std::shared_ptr<Entity> Engine::createCloneOfEntity(const std::string &originalEntityId,
-                                                    const std::string &sceneIdForScripts) {
+                                                    const std::string &sceneIdForScripts,
+                                                    const Entity::FrameSnapshot *initialState) {
     EngineStdOut("Attempting to create clone of entity: " + originalEntityId, 0);
 
     const ObjectInfo *originalObjInfo = nullptr;
     Entity *originalEntity = nullptr; {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+        std::lock_guard lock(m_engineDataMutex);
         if (entities.size() >= static_cast<size_t>(specialConfig.MAX_ENTITY)) {
             EngineStdOut(
                 "Cannot create clone: Maximum entity limit (" + std::to_string(specialConfig.MAX_ENTITY) + ") reached.",
@@ -7426,24 +8264,26 @@ std::shared_ptr<Entity> Engine::createCloneOfEntity(const std::string &originalE
     // The ObjectInfo copy is a shallow copy for SDL_Texture*, which is correct.
 
     // 3. Create new Entity for the clone
+    // 지연 생성이면 복제 블록을 실행한 시점의 원본 상태, 아니면 현재 상태에서 시작합니다.
+    const Entity::FrameSnapshot state = initialState ? *initialState : originalEntity->captureState();
     Entity *cloneEntity = new Entity(
         this,
         cloneId,
         cloneObjInfo.name,
-        originalEntity->getX(), originalEntity->getY(), // Clones start at original's current position
-        originalEntity->getRegX(), originalEntity->getRegY(),
-        originalEntity->getScaleX(), originalEntity->getScaleY(),
-        originalEntity->getRotation(), originalEntity->getDirection(),
-        originalEntity->getWidth(), originalEntity->getHeight(),
-        originalEntity->isVisible(), // Clones are visible by default if original is, or follow original's visibility
-        originalEntity->getRotateMethod());
+        state.x, state.y, // Clones start at original's current position
+        state.regX, state.regY,
+        state.scaleX, state.scaleY,
+        state.rotation, state.direction,
+        state.width, state.height,
+        state.visible, // Clones are visible by default if original is, or follow original's visibility
+        state.rotateMethod);
 
     cloneEntity->setIsClone(true, originalEntityId);
 
     // Copy effects
-    cloneEntity->setEffectBrightness(originalEntity->getEffectBrightness());
-    cloneEntity->setEffectAlpha(originalEntity->getEffectAlpha());
-    cloneEntity->setEffectHue(originalEntity->getEffectHue());
+    cloneEntity->setEffectBrightness(state.effectBrightness);
+    cloneEntity->setEffectAlpha(state.effectAlpha);
+    cloneEntity->setEffectHue(state.effectHue);
 
     // Pen state: Clones typically start with a clean pen state (pen up, default color)
     // The Entity constructor already initializes PenState (brush, paint) to default.
@@ -7457,7 +8297,7 @@ std::shared_ptr<Entity> Engine::createCloneOfEntity(const std::string &originalE
 
     // 4. Add clone to engine collections
     {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+        std::lock_guard lock(m_engineDataMutex);
         objects_in_order.push_back(cloneObjInfo); // Add to rendering order (usually on top initially)
         // Consider Z-order: clones often appear on top of the original.
         // The default push_back adds to the end, which is rendered first (bottom).
@@ -7528,7 +8368,7 @@ void Engine::deleteEntity(const std::string &entityIdToDelete) {
     // First, mark scripts for termination and get the pointer
 
     {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // Lock for entities map access
+        std::lock_guard lock(m_engineDataMutex); // Lock for entities map access
         auto it = entities.find(entityIdToDelete);
         if (it == entities.end()) {
             EngineStdOut("Cannot delete entity: Entity ID '" + entityIdToDelete + "' not found in 'entities' map.", 1);
@@ -7549,7 +8389,7 @@ void Engine::deleteEntity(const std::string &entityIdToDelete) {
     // from collections to the end of the game loop's update cycle.
     if (entityPtr) {
         // Check if entityPtr was successfully retrieved
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // Lock for all collection modifications
+        std::lock_guard lock(m_engineDataMutex); // Lock for all collection modifications
 
         // Remove from entities map
         auto it_map = entities.find(entityIdToDelete);
@@ -7585,16 +8425,13 @@ void Engine::deleteEntity(const std::string &entityIdToDelete) {
     EngineStdOut(std::format("Entity deletion process for {} completed.", finalLogId), 0);
 }
 
-void Engine::submitTask(std::function<void()> task) {
-    if (m_isShuttingDown.load(std::memory_order_relaxed)) {
+void Engine::submitTask(std::function<void()> task, TaskPriority priority) {
+    if (m_isShuttingDown.load(std::memory_order_relaxed) || !m_workerPool) {
         EngineStdOut("Engine is shutting down. Task not submitted.", 1);
         // Optionally, log the task details if possible, or just ignore.
         return;
-    } {
-        std::lock_guard<std::mutex> lock(m_taskQueueMutex_std);
-        m_taskQueue.push(std::move(task));
     }
-    m_taskQueueCV_std.notify_one();
+    m_workerPool->submit(std::move(task), priority);
 }
 
 void Engine::deleteAllClonesOf(const std::string &originalEntityId) {
@@ -7604,7 +8441,7 @@ void Engine::deleteAllClonesOf(const std::string &originalEntityId) {
     // 1. Collect IDs of all clones originating from originalEntityId
     // Lock entities for reading, but don't modify it yet to avoid iterator invalidation.
     {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+        std::lock_guard lock(m_engineDataMutex);
         for (const auto &pair: entities) {
             // pair.second는 std::shared_ptr<Entity> 타입입니다. 원시 포인터를 얻으려면 .get()을 사용해야 합니다.
             Entity *entity = pair.second.get();
@@ -7636,7 +8473,7 @@ void Engine::setStageClickedThisFrame(bool clicked) {
 }
 
 std::string Engine::getPressedObjectId() const {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // m_pressedObjectId 접근 보호
+    std::lock_guard lock(m_engineDataMutex); // m_pressedObjectId 접근 보호
     return m_pressedObjectId;
 }
 
@@ -7739,7 +8576,7 @@ void Engine::updateEntityTextContent(const std::string &entityId, const std::str
 }
 
 void Engine::updateEntityTextColor(const std::string &entityId, const SDL_Color &newColor) {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+    std::lock_guard lock(m_engineDataMutex);
     bool found = false;
     for (auto &objInfo: objects_in_order) {
         if (objInfo.id == entityId) {
@@ -7761,7 +8598,7 @@ void Engine::updateEntityTextColor(const std::string &entityId, const SDL_Color
 }
 
 void Engine::updateEntityTextBoxBackgroundColor(const std::string &entityId, const SDL_Color &newColor) {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+    std::lock_guard lock(m_engineDataMutex);
     bool found = false;
     for (auto &objInfo: objects_in_order) {
         if (objInfo.id == entityId) {
@@ -7785,7 +8622,7 @@ void Engine::updateEntityTextBoxBackgroundColor(const std::string &entityId, con
 }
 
 void Engine::updateEntityTextEffect(const std::string &entityId, const std::string &effect, bool setOn) {
-    std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // ObjectInfo 접근 보호
+    std::lock_guard lock(m_engineDataMutex); // ObjectInfo 접근 보호
     for (auto &objInfo: objects_in_order) {
         if (objInfo.id == entityId && objInfo.objectType == "textBox") {
             if (effect == "strike") {
@@ -7857,7 +8694,7 @@ void Engine::drawScriptDebuggerUI() {
         contentLayoutY += titleRect.h + lineSpacing;
     }
 
-    std::lock_guard<std::recursive_mutex> engine_lock(m_engineDataMutex);
+    std::lock_guard engine_lock(m_engineDataMutex);
 
     for (const auto &entityPair: entities) {
         if (!entityPair.second) continue;
@@ -7885,7 +8722,7 @@ void Engine::drawScriptDebuggerUI() {
             contentLayoutY += entityNameRect.h + 5.0f;
         }
 
-        std::lock_guard<std::recursive_mutex> entity_state_lock(entity->getStateMutex());
+        std::lock_guard entity_state_lock(entity->getStateMutex());
         if (entity->scriptThreadStates.empty()) {
             SDL_Surface *surfNoThreads = TTF_RenderText_Blended(hudFont, "  (No active script threads)", 0, textColor);
             if (surfNoThreads) {
@@ -7908,9 +8745,9 @@ void Engine::drawScriptDebuggerUI() {
             }
         }
 
-        for (const auto &threadPair: entity->scriptThreadStates) {
-            const std::string &threadId = threadPair.first;
-            const Entity::ScriptThreadState &state = threadPair.second;
+        for (const auto &thread: entity->scriptThreadStates) {
+            const std::string &threadId = thread.id;
+            const Entity::ScriptThreadState &state = thread.state;
             /*std::string info = "  Thread: " + truncate_str_len(threadId, 25); // 스레드 ID 길이 제한
             info += " | Waiting: " + std::string(state.isWaiting ? "Yes" : "No");
             info += " | Type: " + BlockTypeEnumToString(state.currentWaitType);*/
@@ -7964,14 +8801,17 @@ void Engine::drawScriptDebuggerUI() {
                 if (!state.loopCounters.empty()) {
                     std::string loopInfoStr = "    Loop Counters: ";
                     int counter = 0;
-                    for (const auto &loopPair: state.loopCounters) {
+                    for (size_t slot = 0; slot < state.loopCounters.size(); ++slot) {
+                        int value = state.loopCounters.get(static_cast<int>(slot));
+                        if (value == Entity::LoopSlots::kUnused) {
+                            continue;
+                        }
                         if (counter++ > 3) {
                             // 너무 많은 루프 카운터 표시 방지 (예: 최대 4개)
                             loopInfoStr += "...";
                             break;
                         }
-                        loopInfoStr += "[" + truncate_str_len(loopPair.first, 10) + ":" + std::to_string(
-                            loopPair.second) + "] ";
+                        loopInfoStr += "[#" + std::to_string(slot) + ":" + std::to_string(value) + "] ";
                     }
                     SDL_Surface *surfLoop = TTF_RenderText_Blended_Wrapped(
                         hudFont, loopInfoStr.c_str(), 0, textColor,
@@ -8078,11 +8918,11 @@ void Engine::updateExtractValueEvt(double currentSize, double totalSize) {
 
     // 예시: "prog_pct" ID를 가진 전역 변수에 진행률 업데이트
     bool varUpdated = false; {
-        std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex); // m_HUDVariables 접근 보호
+        std::lock_guard lock(m_engineDataMutex); // m_HUDVariables 접근 보호
         for (auto &var: m_HUDVariables) {
             if (var.name == "<OE:PCT>" && var.variableType == "variable" && var.objectId.empty()) {
                 // 전역 변수 확인
-                var.value = std::to_string(static_cast<int>(std::round(percentage)));
+                m_variables.slot(var.slot).value = OperandValue(std::round(percentage));
                 varUpdated = true;
                 break;
             }
@@ -8104,7 +8944,7 @@ void Engine::DecompAndLoadProject(string path) {
 
         std::string targetShowMessageName = "<OE:EX1>";
         bool showMsgIdFound = false; {
-            std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+            std::lock_guard lock(m_engineDataMutex);
             for (const auto &pair: m_messageIdToNameMap) {
                 if (pair.second == targetShowMessageName) {
                     showProgressMsgId = pair.first;
@@ -8146,7 +8986,7 @@ void Engine::DecompAndLoadProject(string path) {
 
         std::string targetHideMessageName = "<OE:EX0>";
         bool hideMsgIdFound = false; {
-            std::lock_guard<std::recursive_mutex> lock(m_engineDataMutex);
+            std::lock_guard lock(m_engineDataMutex);
             for (const auto &pair: m_messageIdToNameMap) {
                 if (pair.second == targetHideMessageName) {
                     hideProgressMsgId = pair.first;
@@ -10,13 +10,19 @@
 #include <nlohmann/json.hpp>
 #include "blocks/blockTypes.h"
 #include "../util/Logger.h"
+#include "../util/WorkStealingPool.h"
+#include "../util/ExecutorMutex.h"
+#include "VariableStore.h"
+#include <array>
 #include <mutex>
 #include <queue>
+#include <deque>
 #include <condition_variable>
 #include <functional>               // For function
 #include <memory>                     // For unique_ptr
 #include <regex>
 #include <set>      // For set
+#include <unordered_map>
 #include <atomic> // For atomic
 #include <SDL3_ttf/SDL_ttf.h>
 using namespace std;
@@ -38,8 +44,6 @@ extern const char *FONT_ASSETS;                                  // Declaration
 extern string PROJECT_NAME;                                      // Declaration only
 extern string WINDOW_TITLE;                                      // Declaration only
 
-// Forward declaration for ThreadPool
-class ThreadPool;
 struct Costume
 {
     string id;
@@ -93,17 +97,12 @@ struct ObjectInfo
     int textAlign;
     nlohmann::json entity; // Store the raw entity JSON object
 };
-struct ListItem
-{
-    string data;     // 리스트 항목의 데이터 (첫 번째 멤버로 변경)
-    string key = ""; // 리스트 항목의 키 (두 번째 멤버로 변경)
-};
-// HUD에 표시될 일반 변수의 정보를 담는 구조체
+// HUD에 표시될 일반 변수의 정보를 담는 구조체 (값은 VariableStore 의 슬롯에 있습니다)
 struct HUDVariableDisplay
 {
     string id;                           // 변수 ID
     string name;                         // 변수 이름
-    string value;                        // 변수 값 (문자열로 표시)
+    uint32_t slot = VariableStore::kNoSlot; // 값이 들어 있는 VariableStore 슬롯
     string objectId;                     // 변수를 표시할 오브젝트 ID 가 null 이면 public 변수
     bool isVisible;                      // HUD에 표시 여부
     float x;                             // HUD에서의 X 좌표
@@ -116,14 +115,16 @@ struct HUDVariableDisplay
     float transient_render_width = 0.0f; // 드래그 클램핑을 위해 마지막으로 계산된 렌더링 너비
     float scrollOffset_Y = 0.0f; // 리스트 스크롤 오프셋
     float calculatedContentHeight = 0.0f; // 리스트 내용 전체 높이
-    vector<ListItem> array;              // 리스트 항목 (리스트 전용)
 };
 class Engine : public TextInputInterface
 {
     map<string, vector<Script>> objectScripts;
+    vector<UserFunction> m_userFunctions;        // 프로젝트 functions 배열 (CALL 명령은 인덱스로 참조)
+    map<string, size_t> m_userFunctionIndex;     // 함수 ID -> m_userFunctions 인덱스
     vector<pair<string, const Script *>> startButtonScripts;                   // <objectId, Script*> 시작 버튼 클릭 시 실행할 스크립트 목록
     map<SDL_Scancode, vector<pair<string, const Script *>>> keyPressedScripts; // <Scancode, vector<objectId, Script*>> 키 눌림 시 실행할 스크립트 목록
     vector<ObjectInfo> objects_in_order; // This stores info, not live entities.
+    ScriptThreadSlab m_scriptThreadSlab; // 스크립트 스레드 상태 (entities 보다 먼저 선언하여 엔티티가 슬롯을 반환한 뒤 해제)
     map<string, shared_ptr<Entity>> entities; // Changed to shared_ptr
     vector<string> m_sceneOrder; // Stores scene IDs in the order they are defined
     SDL_Window *window;          // SDL Window
@@ -158,6 +159,17 @@ class Engine : public TextInputInterface
     string m_lastAnswer;                 // 마지막으로 입력된 답변 (ask_and_wait 블록용)
     mutable mutex m_textInputMutex;
     condition_variable m_textInputCv;    
+    // 워커 스레드를 막지 않는 ask_and_wait 요청 (스크립트는 TEXT_INPUT 대기로 멈춰 있음)
+    struct TextInputRequest
+    {
+        string objectId;
+        string question;
+        string executionThreadId;
+        bool detached = false; // 대답을 기다리는 스크립트 없이 질문만 표시 (인라인 실행기의 동기 ask_and_wait)
+    };
+    TextInputRequest m_textInputWaiter;           // 현재 질문의 대답을 기다리는 스레드 (비어 있으면 activateTextInput 으로 막힌 스레드)
+    deque<TextInputRequest> m_pendingTextInputs; // 다른 질문이 진행 중일 때 들어온 요청 (순서대로 표시)
+    void showTextInputPrompt(const TextInputRequest &request);
     string firstSceneIdInOrder;
     string m_currentProjectFilePath; // 현재 로드된 프로젝트 파일 경로
     SDL_Texture *LoadTextureFromSvgResource(SDL_Renderer *renderer, int resourceID);
@@ -193,6 +205,7 @@ class Engine : public TextInputInterface
         SCROLLING_LIST_HANDLE // 리스트 스크롤바 핸들 드래그 상태 추가
     };
     vector<HUDVariableDisplay> m_HUDVariables;               // HUD에 표시될 변수 목록
+    VariableStore m_variables;                               // 변수/리스트 값 (m_engineDataMutex 로 보호)
     int m_draggedHUDVariableIndex = -1;                      // 드래그 중인 HUD 변수의 인덱스, 없으면 -1
     HUDDragState m_currentHUDDragState = HUDDragState::NONE; // 현재 HUD 드래그 상태
     float m_draggedHUDVariableMouseOffsetX = 0.0f;           // 드래그 중인 변수의 마우스 오프셋 X
@@ -215,16 +228,12 @@ class Engine : public TextInputInterface
     float m_maxVariablesListContentWidth = 180.0f; // 변수 목록의 실제 내용물 최대 너비
 
     void destroyTemporaryScreen();
-    mutex m_commandQueueMutex;
-    condition_variable m_commandQueueCV; // 엔티티 스레드가 커맨드를 추가했음을 알리기 위함 (선택적)
 
-    // Standard C++ Thread Pool members
-    vector<thread> m_workerThreads;
-    queue<function<void()>> m_taskQueue;
-    mutex m_taskQueueMutex_std; // Renamed to avoid conflict if another m_taskQueueMutex exists
-    condition_variable m_taskQueueCV_std;
-    void workerLoop();
-    void processCommands();                   // 메인 루프에서 커맨드를 처리하는 함수
+    // 스크립트 작업자 풀 (작업자별 Chase-Lev 덱 + 작업 훔치기)
+    unique_ptr<WorkStealingPool> m_workerPool;
+    bool m_inlineExecutor = false; // 작업자 풀 없이 메인 스레드에서 스크립트를 실행 중 (selectScriptExecutor)
+    void runPoolTask(function<void()> &task); // 작업자에서 작업 하나를 실행 (예외 처리 포함)
+    void processCommands();                   // 배리어 뒤 메인 스레드에서 이번 프레임의 커맨드를 순서대로 적용
     string getOEparam(string s) const {
         //OmochaEngine 파라미터 캡쳐
         regex OEpat("<OE:(.+?)>");
@@ -252,8 +261,131 @@ class Engine : public TextInputInterface
     void setVisibleHUDVariables(const vector<HUDVariableDisplay> &variables);
     bool m_treeCollapseTargetState = true; // 초기값: 기본적으로 펼침 (true) 또는 접힘 (false)
     bool m_applyGlobalTreeState = false;   // 프레임 단위로 전역 상태 적용 여부 플래그
-    unique_ptr<ThreadPool> threadPool;  // ThreadPool 멤버 추가
-    atomic<uint64_t> m_scriptExecutionCounter{0}; // 스크립트 실행 ID 고유성 확보를 위한 카운터
+    atomic<Uint64> m_boostBudgetDeadlineNs{0}; // 이번 프레임 부스트 예산이 끝나는 시각 (SDL_GetTicksNS 기준)
+    // --- 스크립트 대기 예약 (wait_second, 프레임 양보) ---
+    // 잠든 스레드만 담으므로 매 프레임 비용은 깨어나는 스레드 수에 비례합니다.
+    struct ScriptWake
+    {
+        Uint64 wakeTime = 0; // SDL_GetTicks 기준. 재개 시 스레드의 waitEndTime 과 같아야 유효한 예약입니다.
+        uint64_t sequence = 0; // 같은 시각이면 예약 순서대로 깨웁니다.
+        weak_ptr<Entity> entity;
+        string executionThreadId;
+        Entity::WaitType type = Entity::WaitType::NONE;
+    };
+    struct ScriptWakeLater
+    {
+        bool operator()(const ScriptWake &a, const ScriptWake &b) const
+        {
+            return a.wakeTime != b.wakeTime ? a.wakeTime > b.wakeTime : a.sequence > b.sequence;
+        }
+    };
+    priority_queue<ScriptWake, vector<ScriptWake>, ScriptWakeLater> m_scriptWakeQueue; // 시각이 정해진 대기 (최소 힙)
+    vector<ScriptWake> m_nextFrameWakes; // 시각 없이 다음 프레임에 이어서 실행할 BLOCK_INTERNAL 스레드
+    vector<ScriptWake> m_dueWakes;       // processScriptWakeups 작업 버퍼 (m_nextFrameWakes 와 번갈아 사용)
+    uint64_t m_scriptWakeSequence = 0;
+    ExecutorMutex<mutex> m_scriptWakeMutex;
+    // --- 조건 기다리기 (wait_until_true) ---
+    // 조건이 읽는 입력별 변경 횟수. 잠든 스레드는 잠들기 전의 합을 기억했다가 합이 바뀌면 깨어납니다.
+    static constexpr size_t kConditionVariableBuckets = 64;
+    array<atomic<uint64_t>, kConditionVariableBuckets> m_variableEpochs{};
+    atomic<uint64_t> m_keyboardEpoch{0};
+    atomic<uint64_t> m_mouseEpoch{0};
+    atomic<uint64_t> m_entityEpoch{0};
+    struct ConditionWait
+    {
+        weak_ptr<Entity> entity;
+        string executionThreadId;
+        uint64_t variableBuckets = 0;
+        uint8_t sources = 0;
+        uint64_t stamp = 0; // 잠들기 전에 읽은 conditionInputStamp
+    };
+    vector<ConditionWait> m_conditionWaits; // m_scriptWakeMutex 로 보호
+    // --- 소리 끝까지 기다리기 (sound_something_wait_with_block) ---
+    // AudioEngineHelper 가 끝난 재생 ID 를 큐에 넣으면 그 재생을 기다리는 스레드만 깨웁니다.
+    struct SoundWake
+    {
+        uint64_t playbackId = 0;
+        weak_ptr<Entity> entity;
+        string executionThreadId;
+    };
+    unordered_map<uint64_t, SoundWake> m_soundWaits; // 재생 ID -> 기다리는 스레드 (m_scriptWakeMutex 로 보호)
+    vector<SoundWake> m_nextFrameSoundWakes;         // 아직 멈추지 않은 스레드의 재시도 (m_scriptWakeMutex 로 보호)
+    vector<SoundWake> m_dueSoundWakes;               // processScriptWakeups 작업 버퍼
+public:
+    /**
+     * @brief 스크립트 단계에서 기록해 두었다가 커밋 단계에 적용하는 공유 상태 변경
+     * (렌더링 순서, 복제본 생성/삭제, 장면 전환)
+     */
+    struct EngineCommand
+    {
+        enum class Type : uint8_t
+        {
+            CHANGE_OBJECT_INDEX,
+            CREATE_CLONE,
+            DELETE_ENTITY,
+            DELETE_ALL_CLONES,
+            START_SCENE,
+            START_NEXT_SCENE,
+            START_PREVIOUS_SCENE,
+            SET_ENTITY_STATE // 다른 샤드에 고정된 엔티티의 속성 변경 (Entity::deferCrossShardWrite)
+        };
+        Type type = Type::CHANGE_OBJECT_INDEX;
+        string targetId;          // 엔티티 ID 또는 장면 ID
+        string sceneIdForScripts; // CREATE_CLONE: when_clone_start 를 실행할 장면
+        Omocha::ObjectIndexChangeType indexChange{};
+        Entity::FrameSnapshot cloneState; // CREATE_CLONE: 블록을 실행한 시점의 원본 상태
+        function<void(Entity &)> entityWrite; // SET_ENTITY_STATE: targetId 엔티티에 적용할 setter 호출
+        uint64_t order = 0;               // (프레임 안의 틱 위치 << 24) | 틱 안의 순번
+    };
+private:
+    // --- 프레임 단위 스크립트 틱 ---
+    // 한 프레임에 실행할 스크립트 스레드를 모아 작업자들이 나눠 실행하고, 렌더링 전에 모두 끝날 때까지 기다립니다.
+    struct ScriptTick
+    {
+        shared_ptr<Entity> entity;
+        const Script *script = nullptr;
+        string sceneIdAtDispatch;
+        string executionThreadId;
+        float deltaTime = 0.0f;
+        bool resumed = false;
+        uint64_t sequence = 0; // 같은 엔티티/스크립트 안에서의 등록 순서
+        string shardKey{};     // 엔티티 ID (entityShardMode 2 에서 복제본은 원본 ID)
+        int64_t allowanceNs = 0; // 이번 틱에 쓸 수 있는 CPU 시간 (할당량 + 지난 초과분)
+    };
+    // 한 작업자가 순서대로 실행하는 틱 묶음. 샤드 키(엔티티)마다 하나이고, 엔진 전역 상태를 쓰는 샤드 키는 모두 한 샤드입니다.
+    struct ScriptShard
+    {
+        size_t firstTick = 0;
+        size_t tickCount = 0;
+        uint64_t token = 0; // 엔티티를 고정한 샤드 토큰 (0 이면 고정하지 않음)
+    };
+    struct ScriptFrame
+    {
+        vector<ScriptTick> ticks;   // 정렬된 실행 순서
+        vector<ScriptShard> shards;
+        vector<shared_ptr<Entity>> shardEntities; // 프레임이 끝나면 샤드 고정을 풀 엔티티
+        atomic<size_t> cursor{0};   // 다음에 가져갈 샤드 (작업자들이 fetch_add 로 나눠 가짐)
+        atomic<size_t> remaining{0}; // 배리어에 완료를 알리지 않은 샤드 수
+    };
+    vector<ScriptTick> m_pendingScriptTicks; // 다음 runScriptFrame 에서 실행할 틱
+    uint64_t m_scriptTickSequence = 0;
+    ExecutorMutex<mutex> m_scriptTickMutex;
+    mutex m_scriptFrameMutex;
+    condition_variable m_scriptFrameCv; // 프레임의 마지막 틱이 끝나면 알림
+    static thread_local ScriptFrame *s_openScriptTickFrame; // 이 작업자가 실행 중인 샤드의 프레임 (완료 전)
+    static thread_local ScriptTick *s_runningScriptTick;    // 이 작업자가 실행 중인 틱
+    uint64_t m_nextShardToken = 0;
+    // 작업자별 커맨드 버퍼 (마지막 칸은 풀 없이 메인 스레드가 프레임을 실행할 때). 프레임 중에는 각 작업자만 씁니다.
+    vector<vector<EngineCommand>> m_commandBuffers;
+    static thread_local uint32_t s_tickCommandSequence; // 실행 중인 틱 안에서 기록한 커맨드 순번
+    // --- 스크립트 CPU 예산 (결손 라운드 로빈) ---
+    uint64_t m_scriptFrameIndex = 0;           // runScriptFrame 마다 1 씩 증가 (CPU 사용량 집계 단위)
+    static thread_local Uint64 s_tickDeadlineNs; // 실행 중인 틱이 양보해야 하는 시각 (0 이면 제한 없음)
+    // 틱마다 할당량을 주고, 지난 틱에서 진 빚을 다 갚지 못한 스레드의 틱은 다음 프레임으로 미룹니다.
+    void applyScriptCpuBudget(vector<ScriptTick> &ticks);
+    void applyCommand(EngineCommand &command);
+    void drainScriptFrame(const shared_ptr<ScriptFrame> &frame);
+    void completeScriptTick();
 public:
     string YOUR_GPU;
     atomic<bool> m_projectLoadRequestedViaOFD;
@@ -280,6 +412,10 @@ public:
         int TARGET_FPS = 60;
         int MAX_ENTITY = 100;
         float setZoomfactor = 1.0f;
+        bool boostMode = false;         // 부스트(터보) 모드: 반복문을 프레임 양보 없이 CPU 예산까지 연속 실행
+        int entityShardMode = -1;       // 엔티티 고정: -1 지정 안 함 (1), 0 고정 안 함, 1 엔티티마다 한 작업자, 2 원본과 복제본을 한 작업자
+        float scriptCpuBudget = 0.75f;  // 프레임마다 모든 틱이 나눠 쓰는 목표 프레임 시간 비율
+        int scriptExecutor = 0;         // 스크립트 실행기: 0 자동, 1 작업자 풀, 2 인라인 (메인 스레드에서 잠금 없이)
     };
     SPECIAL_ENGINE_CONFIG specialConfig; // 엔진의 특별 설정을 저장하는 멤버 변수
     struct MsgBoxIconType
@@ -307,6 +443,16 @@ public:
     bool IsSysMenu = false;
     bool IsScriptStart = false; // 스크립트 시작 여부
     bool loadProject(const string &projectFilePath);
+    void loadUserFunctions(const nlohmann::json &document); // functions 배열의 사용자 함수 정의를 읽습니다.
+    void compileAllScripts(); // objectScripts 의 각 스크립트를 ScriptProgram 으로 컴파일
+    /**
+     * @brief 로드한 프로젝트의 컴파일된 스크립트/함수를 AOT C++ 소스(outputDir/omocha_aot.cpp)로 내보냅니다. (--aot)
+     * @return 파일을 쓰지 못하면 false
+     */
+    bool exportAotSource(const string &outputDir);
+    // 사용자 함수 인덱스. 없으면 -1
+    int findUserFunction(const string &functionId) const;
+    const UserFunction *getUserFunction(size_t index) const;
 
     string OFD() const;
 
@@ -351,6 +497,20 @@ public:
     } // LCOV_EXCL_LINE
     float getFps() { return currentFps; };
     int getTargetFps() const { return specialConfig.TARGET_FPS; } // 목표 FPS getter 추가
+    bool isBoostMode() const { return specialConfig.boostMode; }
+    /**
+     * @brief 부스트 모드의 이번 프레임 스크립트 실행 예산을 시작합니다. 메인 루프가 스크립트 처리 전에 매 프레임 호출합니다.
+     * 예산은 목표 프레임 시간의 BOOST_FRAME_BUDGET_RATIO 만큼이며, 나머지는 렌더링에 남겨둡니다.
+     */
+    void beginBoostFrameBudget();
+    // 부스트 모드이고 이번 프레임 예산이 남아 있으면 true. 반복문은 이 값이 false 가 될 때까지 양보하지 않습니다.
+    bool hasBoostBudget() const;
+    // 현재 작업자가 실행 중인 틱이 CPU 할당량을 다 썼으면 true. 반복문은 부스트 중이어도 양보합니다.
+    // (화면 새로 고침 없이 실행 중인 함수는 warpDeadlineNs 까지 계속 실행하고 넘긴 시간을 빚으로 갚습니다)
+    static bool scriptTickQuantumExpired();
+    // 현재 스레드가 프레임 틱을 실행 중이라 submitCommand 가 배리어까지 미뤄 적용하면 true
+    static bool isRecordingCommands();
+    uint64_t getScriptFrameIndex() const { return m_scriptFrameIndex; }
     Entity *getEntityById(const string &id);
     void setTotalItemsToLoad(int count) { totalItemsToLoad = count; }
     void incrementLoadedItemCount() { loadedItemCount++; }
@@ -370,6 +530,15 @@ public:
     void startProjectTimer();
     void stopProjectTimer();
     void activateTextInput(const string &requesterObjectId, const string &question, const string &executionThreadId);
+    /**
+     * @brief ask_and_wait 를 스레드를 막지 않고 요청합니다. 호출한 스크립트는 Entity::suspendForTextInput 으로 멈춰 있어야 합니다.
+     * 다른 질문이 진행 중이면 대기열에 넣고, 대답이 들어오면 resumeTextInputWaiters 가 스크립트를 재개합니다.
+     * detached 이면 재개할 스크립트 없이 질문만 표시합니다.
+     */
+    void requestTextInput(const string &requesterObjectId, const string &question, const string &executionThreadId,
+                          bool detached = false);
+    // 매 프레임 메인 스레드에서 호출: 대답을 받은 스레드를 재개하고 대기 중인 다음 질문을 표시합니다.
+    void resumeTextInputWaiters();
     string getLastAnswer() const;
     void resetProjectTimer();
     double getProjectTimerValue() const; // LCOV_EXCL_LINE
@@ -394,6 +563,7 @@ public:
     // HUD에 표시할 변수 목록을 설정하는 메서드    
     map<string, shared_ptr<Entity>> &getEntities_Modifiable() { return entities; } // Changed to shared_ptr
     vector<HUDVariableDisplay> &getHUDVariables_Editable() { return m_HUDVariables; } // 블록에서 접근하기 위함
+    VariableStore &getVariableStore() { return m_variables; } // 블록의 변수/리스트 값 접근 (m_engineDataMutex 를 잡고 사용)
     // --- Pen Drawing ---
     void engineDrawLineOnStage(SDL_FPoint p1_stage_entry, SDL_FPoint p2_stage_entry_modified_y, SDL_Color color, float thickness);
 
@@ -406,9 +576,17 @@ public:
     bool setEntitySelectedCostume(const string &entityId, const string &costumeId);
     bool setEntitychangeToNextCostume(const string &entityId, const string &asOption);
     void dispatchScriptForExecution(const string &entityId, const Script *scriptPtr, const string &sceneIdAtDispatch, float deltaTime, const string &existingExecutionThreadId = "");
+    /**
+     * @brief 여러 스크립트를 새 스레드로 한 번에 시작합니다. (신호 받기, 시작 버튼, 장면 시작)
+     * 엔티티는 엔진 잠금 한 번으로 찾고, 스레드 상태를 모두 만든 뒤 틱을 한 번에 큐에 넣습니다.
+     * currentSceneOnly 이면 현재 장면이나 전역 오브젝트의 스크립트만 시작합니다. 시작한 스레드 수를 반환합니다.
+     */
+    size_t dispatchScriptBatch(const vector<pair<string, const Script *>> &scripts, const string &sceneIdAtDispatch,
+                               bool currentSceneOnly);
     void raiseMessage(const string &messageId, const string &senderObjectId, const string &executionThreadId);
     string getMessageNameById(const string& messageId) const;
-    shared_ptr<Entity> createCloneOfEntity(const string &originalEntityId, const string &sceneIdForScripts); // Return shared_ptr
+    shared_ptr<Entity> createCloneOfEntity(const string &originalEntityId, const string &sceneIdForScripts,
+                                           const Entity::FrameSnapshot *initialState = nullptr); // Return shared_ptr
     int getNextCloneIdSuffix(const string &originalId);
     void deleteEntity(const string& entityIdToDelete);
     void deleteAllClonesOf(const string& originalEntityId);
@@ -420,11 +598,76 @@ public:
     // Thread pool management
     void startThreadPool(size_t numThreads); // LCOV_EXCL_LINE
     void stopThreadPool();
+    /**
+     * @brief 프로젝트를 불러온 뒤 스크립트 실행기를 고릅니다.
+     * 오브젝트가 INLINE_EXECUTOR_MAX_OBJECTS 개 미만이거나 --executor=inline 이면 작업자 풀을 멈추고
+     * 모든 스크립트 스레드를 메인 스레드에서 실행하며, 엔티티 상태와 스크립트 큐의 잠금을 건너뜁니다.
+     */
+    void selectScriptExecutor();
+    /**
+     * @brief --executor-bench: 같은 프로젝트를 인라인 실행기와 작업자 풀로 각각 처음부터 다시 시작해 frames 프레임씩 돌리고,
+     * runScriptFrame 의 프레임 지연(평균/p95/최대)과 초당 틱 수를 로그로 출력합니다. 렌더링은 하지 않고 목표 FPS 로 맞춰 돕니다.
+     */
+    void runExecutorBenchmark(int frames);
+    bool isInlineExecutor() const { return m_inlineExecutor; }
     atomic<bool> m_isShuttingDown{false};   // 엔진 종료 상태 플래그
     atomic<bool> m_restartRequested{false}; // 프로젝트 다시 시작 요청 플래그
-    mutable recursive_mutex m_engineDataMutex; // 엔진 데이터 보호용 뮤텍스 (entities, objectScripts 등 접근 시)
-    uint64_t getNextScriptExecutionCounter() { return m_scriptExecutionCounter++; } // 카운터 값 증가 및 반환
-    void submitTask(function<void()> task); // Task submission method
+    // 엔진 데이터 보호용 뮤텍스 (entities, objectScripts, 변수/리스트 등 접근 시). 인라인 실행기에서는 잠그지 않습니다.
+    mutable ExecutorMutex<recursive_mutex> m_engineDataMutex;
+    ScriptThreadSlab &getScriptThreadSlab() { return m_scriptThreadSlab; }
+    /**
+     * @brief 대기 중인 스크립트 스레드를 깨울 시각을 예약합니다. (Entity::setScriptWait 가 호출)
+     * BLOCK_INTERNAL 이면서 wakeTime 이 0 이면 다음 프레임에 깨웁니다.
+     */
+    void scheduleScriptWake(weak_ptr<Entity> entity, const string &executionThreadId, Uint64 wakeTime,
+                            Entity::WaitType type);
+    // 매 프레임 메인 스레드에서 호출: 예약 시각이 된 스레드와 조건 입력이 바뀐 스레드만 꺼내 재개합니다.
+    void processScriptWakeups(float deltaTime);
+    // 변수/리스트 ID 의 조건 대기 버킷 (0 ~ 63). 컴파일러와 noteVariableWrite 가 같은 해시를 씁니다.
+    static size_t conditionVariableBucket(const string &variableId);
+    // 변수/리스트 값을 바꾼 뒤 호출합니다.
+    void noteVariableWrite(const string &variableId);
+    // 키보드/마우스/엔티티 입력이 바뀌었음을 알립니다. (kWaitOn* 플래그)
+    void noteConditionInput(uint8_t sources);
+    // 조건이 읽는 입력의 변경 횟수 합. 조건을 평가하기 전에 읽어야 평가 뒤의 변경을 놓치지 않습니다.
+    uint64_t conditionInputStamp(uint64_t variableBuckets, uint8_t sources) const;
+    /**
+     * @brief 조건이 거짓인 wait_until_true 스레드를 입력이 바뀔 때까지 재웁니다. (BLOCK_INTERNAL 대기로 설정된 뒤)
+     * stamp 와 현재 합이 다르면 processScriptWakeups 가 다음 프레임 대기처럼 재개합니다.
+     */
+    void parkConditionWait(weak_ptr<Entity> entity, const string &executionThreadId, uint64_t variableBuckets,
+                           uint8_t sources, uint64_t stamp);
+    /**
+     * @brief SOUND_FINISH 대기를 건 스레드를 재생 ID 의 끝남 알림에 연결합니다.
+     * retry 가 true 이면 이미 끝난 재생이므로 다음 프레임에 바로 다시 재개를 시도합니다.
+     */
+    void watchSoundCompletion(weak_ptr<Entity> entity, const string &executionThreadId, uint64_t playbackId,
+                              bool retry = false);
+    /**
+     * @brief 스크립트 스레드 실행을 다음 프레임 틱 배치에 넣습니다. (Entity::scheduleScriptExecutionOnPool)
+     * 틱을 실행하는 중에 등록된 스레드는 다음 프레임에 실행됩니다.
+     */
+    void enqueueScriptTick(shared_ptr<Entity> entity, const Script *script, const string &sceneIdAtDispatch,
+                           const string &executionThreadId, float deltaTime, bool resumed);
+    /**
+     * @brief 매 프레임 메인 스레드에서 렌더링 전에 호출: 모인 틱을 (엔티티 ID, 스크립트, 등록 순서) 로 정렬해
+     * 작업자들에게 나눠 실행하고 모두 끝날 때까지 기다립니다.
+     * 한 엔티티(entityShardMode 2 이면 원본과 복제본)의 틱은 한 작업자가 순서대로 실행하고, 변수/리스트 등 엔진 전역 상태를
+     * 쓰는 스크립트가 있는 엔티티의 틱은 모두 한 샤드에서 정렬 순서대로 실행합니다. 엔티티는 샤드에 고정되어
+     * 그 작업자는 속성을 잠금 없이, 다른 샤드는 프레임 시작 때의 스냅샷으로 읽고, 구조 변경은 커맨드로 배리어에서 적용합니다.
+     * 그래서 작업자 수와 관계없이 결과가 같습니다. (entityShardMode 0 으로 고정을 끄면 다른 엔티티를 실시간으로 읽으므로 보장하지 않습니다.
+     * 난수와 CPU 예산에 따른 양보 시점은 어느 모드에서도 실행마다 다를 수 있습니다)
+     * @return 이번 프레임에 실행한 틱 수
+     */
+    size_t runScriptFrame();
+    // 실행 중인 틱이 메인 스레드를 기다리며 막힐 때 (ask_and_wait 동기 경로) 먼저 배리어에서 빠집니다.
+    void leaveScriptFrame();
+    /**
+     * @brief 공유 상태 변경을 요청합니다. 프레임 틱 안에서는 작업자 버퍼에 기록했다가 배리어 뒤에
+     * 틱 실행 순서대로 적용하고, 프레임 밖 (배리어에서 빠진 스레드, 메인 스레드) 에서는 바로 적용합니다.
+     */
+    void submitCommand(EngineCommand command);
+    void submitTask(function<void()> task, TaskPriority priority = TaskPriority::NORMAL); // Task submission method
 
     atomic<bool> m_needAnswerUpdate{false};
     void requestAnswerUpdate() { m_needAnswerUpdate = true; }
@@ -9,6 +9,12 @@
 #include "SDL3/SDL_pixels.h"
 #include "blocks/BlockExecutor.h"
 #include "blocks/blockTypes.h"
+#include "blocks/ScriptCompiler.h"
+#include "blocks/AotCompiler.h"
+#include <climits>
+#include <limits>
+#include <charconv>
+#include <optional>
 string THREAD_ID_INTERNAL;
 string BLOCK_ID_INTERNAL;
 
@@ -101,12 +107,262 @@ Entity::Entity(Engine *engine, const std::string &entityId, const std::string &e
     OrigineScaleY = initial_scaleY;
 }
 
-Entity::~Entity() = default;
+Entity::~Entity() {
+    scriptThreadStates.clear();
+}
+
+void Entity::ScriptThreadState::reset() {
+    currentBlockIndex = 0;
+    isWaiting = false;
+    waitEndTime = 0;
+    blockIdForWait.clear();
+    currentWaitType = WaitType::NONE;
+    resumeAtBlockIndex = -1;
+    scriptPtrForResume = nullptr;
+    terminateRequested = false;
+    loopCounters.clear();
+    sceneIdAtDispatchForResume.clear();
+    originalInnerBlockIdForWait.clear();
+    breakLoopRequested = false;
+    continueLoopRequested = false;
+    programCounter = 0;
+    programLoopCounters.clear();
+    callFrames.clear();
+    frameValueTop = 0;
+    warpDeadlineNs = 0;
+    synchronousDepth = 0;
+    soundPlaybackId = 0;
+    cpuDeficitNs = 0;
+    cpuLastTickNs = 0;
+    cpuTotalNs = 0;
+}
+
+Entity::ScriptThreadSlot &Entity::ScriptThreadTable::iterator::operator*() const {
+    return *table->owner->pEngineInstance->getScriptThreadSlab().get(table->handles[position], table->owner);
+}
+
+Entity::ScriptThreadSlot *Entity::ScriptThreadTable::create() {
+    ScriptThreadSlab &slab = owner->pEngineInstance->getScriptThreadSlab();
+    ScriptThreadHandle handle = slab.allocate(owner);
+    if (!handle.isValid()) {
+        return nullptr;
+    }
+    handles.push_back(handle);
+    return slab.get(handle, owner);
+}
+
+Entity::ScriptThreadState *Entity::ScriptThreadTable::find(std::string_view executionThreadId) const {
+    if (!owner->pEngineInstance) {
+        return nullptr;
+    }
+    ScriptThreadSlot *slot = owner->pEngineInstance->getScriptThreadSlab().get(
+        ScriptThreadSlab::parse(executionThreadId), owner);
+    return slot ? &slot->state : nullptr;
+}
+
+bool Entity::ScriptThreadTable::erase(std::string_view executionThreadId) {
+    ScriptThreadHandle handle = ScriptThreadSlab::parse(executionThreadId);
+    auto it = std::find(handles.begin(), handles.end(), handle);
+    if (it == handles.end()) {
+        return false;
+    }
+    // 순서는 의미가 없으므로 마지막 핸들과 바꿔서 제거합니다.
+    *it = handles.back();
+    handles.pop_back();
+    owner->pEngineInstance->getScriptThreadSlab().release(handle);
+    return true;
+}
+
+void Entity::ScriptThreadTable::clear() {
+    if (owner->pEngineInstance) {
+        ScriptThreadSlab &slab = owner->pEngineInstance->getScriptThreadSlab();
+        for (const ScriptThreadHandle &handle: handles) {
+            slab.release(handle);
+        }
+    }
+    handles.clear();
+}
+
+ScriptThreadHandle ScriptThreadSlab::allocate(const Entity *owner) {
+    std::lock_guard lock(m_mutex);
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        uint32_t chunkCount = m_chunkCount.load(std::memory_order_relaxed);
+        if (m_slotCount == chunkCount * kChunkSize) {
+            if (chunkCount == kMaxChunks) {
+                return {};
+            }
+            m_chunks[chunkCount] = std::make_unique<Entry[]>(kChunkSize);
+            m_chunkCount.store(chunkCount + 1, std::memory_order_release);
+        }
+        index = m_slotCount++;
+    }
+
+    Entry *entry = entryAt(index);
+    uint32_t generation = entry->generation.load(std::memory_order_relaxed);
+    // 실행 ID 는 슬롯 버퍼에 바로 씁니다. (대부분 SSO 범위라 할당 없음)
+    char buffer[48] = "script_";
+    char *cursor = std::to_chars(buffer + 7, buffer + sizeof(buffer), index).ptr;
+    *cursor++ = '_';
+    cursor = std::to_chars(cursor, buffer + sizeof(buffer), generation).ptr;
+    entry->slot.id.assign(buffer, cursor);
+    entry->owner.store(owner, std::memory_order_release);
+    m_liveCount.fetch_add(1, std::memory_order_relaxed);
+    return {index, generation};
+}
+
+void ScriptThreadSlab::release(ScriptThreadHandle handle) {
+    Entry *entry = entryAt(handle.index);
+    if (!entry || entry->generation.load(std::memory_order_relaxed) != handle.generation) {
+        return;
+    }
+    // 세대를 먼저 바꿔 남아 있는 실행 ID 로는 더 이상 이 슬롯을 찾지 못하게 합니다.
+    uint32_t nextGeneration = handle.generation + 1;
+    entry->generation.store(nextGeneration == 0 ? 1 : nextGeneration, std::memory_order_release);
+    entry->owner.store(nullptr, std::memory_order_release);
+    entry->slot.state.reset();
+
+    std::lock_guard lock(m_mutex);
+    m_freeSlots.push_back(handle.index);
+    m_liveCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+Entity::ScriptThreadSlot *ScriptThreadSlab::get(ScriptThreadHandle handle, const Entity *owner) const {
+    if (!handle.isValid()) {
+        return nullptr;
+    }
+    Entry *entry = entryAt(handle.index);
+    if (!entry || entry->generation.load(std::memory_order_acquire) != handle.generation ||
+        entry->owner.load(std::memory_order_acquire) != owner) {
+        return nullptr;
+    }
+    return &entry->slot;
+}
+
+ScriptThreadSlab::Entry *ScriptThreadSlab::entryAt(uint32_t index) const {
+    uint32_t chunk = index >> kChunkShift;
+    if (chunk >= m_chunkCount.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &m_chunks[chunk][index & (kChunkSize - 1)];
+}
+
+ScriptThreadHandle ScriptThreadSlab::parse(std::string_view executionThreadId) {
+    constexpr std::string_view prefix = "script_";
+    if (!executionThreadId.starts_with(prefix)) {
+        return {};
+    }
+    const char *end = executionThreadId.data() + executionThreadId.size();
+    ScriptThreadHandle handle;
+    auto [separator, indexError] = std::from_chars(executionThreadId.data() + prefix.size(), end, handle.index);
+    if (indexError != std::errc() || separator == end || *separator != '_') {
+        return {};
+    }
+    auto [last, generationError] = std::from_chars(separator + 1, end, handle.generation);
+    if (generationError != std::errc() || last != end) {
+        return {};
+    }
+    return handle;
+}
+
+thread_local uint64_t Entity::s_currentShardToken = 0;
+thread_local bool Entity::s_stateWritten = false;
+
+// 속성 getter/setter 용 잠금. 이번 프레임에 이 엔티티를 맡은 샤드 작업자는 혼자 접근하므로 잠그지 않습니다.
+// (다른 샤드의 setter 호출은 deferCrossShardWrite 가 커맨드로 돌리므로 여기까지 오지 않습니다)
+class Entity::StateLock
+{
+public:
+    enum Access { READ, WRITE };
+
+    explicit StateLock(const Entity &entity, Access access = READ)
+        : m_mutex(entity.ownsStateUnlocked() ? nullptr : &entity.m_stateMutex) {
+        if (access == WRITE) {
+            markStateWritten();
+        }
+        if (m_mutex) {
+            m_mutex->lock();
+        }
+    }
+    ~StateLock() {
+        if (m_mutex) {
+            m_mutex->unlock();
+        }
+    }
+    StateLock(const StateLock &) = delete;
+    StateLock &operator=(const StateLock &) = delete;
+
+private:
+    StateMutex *m_mutex;
+};
+
+bool Entity::ownsStateUnlocked() const {
+    return s_currentShardToken != 0 && m_shardToken.load(std::memory_order_acquire) == s_currentShardToken;
+}
+
+bool Entity::readsFrameSnapshot() const {
+    const uint64_t token = m_shardToken.load(std::memory_order_acquire);
+    return token != 0 && token != s_currentShardToken;
+}
+
+bool Entity::deferCrossShardWrite(std::function<void(Entity &)> write) {
+    // 고정된 엔티티는 그 샤드 작업자가 잠금 없이 쓰므로, 다른 샤드는 배리어 뒤에 틱 순서대로 적용되도록 커맨드로 넘깁니다.
+    // 배리어에서 빠진 스레드(프레임 틱 밖)는 커맨드를 바로 적용하므로 기록하지 않고 잠금으로 씁니다.
+    if (!readsFrameSnapshot() || !Engine::isRecordingCommands()) {
+        return false;
+    }
+    Engine::EngineCommand command;
+    command.type = Engine::EngineCommand::Type::SET_ENTITY_STATE;
+    command.targetId = id;
+    command.entityWrite = std::move(write);
+    pEngineInstance->submitCommand(std::move(command));
+    return true;
+}
+
+void Entity::beginFrameShard(uint64_t token) {
+    if (m_detachedThreads.load(std::memory_order_acquire) > 0) {
+        return; // 프레임 밖에서 막힌 스레드가 잠금으로 접근하므로 이 엔티티는 샤드에 고정하지 않습니다.
+    } {
+        std::lock_guard lock(m_stateMutex);
+        m_frameSnapshot = {x, y, regX, regY, scaleX, scaleY, rotation, direction,
+                           static_cast<double>(width), static_cast<double>(height),
+                           m_effectBrightness, m_effectAlpha, m_effectHue, rotateMethod,
+                           visible.load(std::memory_order_relaxed)};
+    }
+    m_shardToken.store(token, std::memory_order_release);
+}
+
+Entity::FrameSnapshot Entity::captureState() const {
+    return {getX(), getY(), getRegX(), getRegY(), getScaleX(), getScaleY(), getRotation(), getDirection(),
+            getWidth(), getHeight(), getEffectBrightness(), getEffectAlpha(), getEffectHue(), getRotateMethod(),
+            isVisible()};
+}
+
+void Entity::endFrameShard() {
+    m_shardToken.store(0, std::memory_order_release);
+}
+
+void Entity::detachFromFrameShard() {
+    m_detachedThreads.fetch_add(1, std::memory_order_acq_rel);
+    // 지금까지 잠금 없이 쓴 값은 release 로 공개되고, 이후 다른 스레드는 잠금으로 실제 값을 읽습니다.
+    m_shardToken.store(0, std::memory_order_release);
+}
 
 void Entity::setScriptWait(const std::string &executionThreadId, Uint64 endTime, const std::string &blockId,
-                           WaitType type, const Script* scriptPtr, const std::string& sceneId) { // <<<--- 파라미터 추가
+                           WaitType type, const Script* scriptPtr, const std::string& sceneId, bool scheduleWake) {
     std::lock_guard lock(m_stateMutex);
-    auto &threadState = scriptThreadStates[executionThreadId]; // Get or create
+    ScriptThreadState *pThreadState = scriptThreadStates.find(executionThreadId);
+    if (!pThreadState) {
+        if (pEngineInstance) {
+            pEngineInstance->EngineStdOut("setScriptWait: unknown script thread " + executionThreadId + " for entity " + id,
+                                          1, executionThreadId);
+        }
+        return;
+    }
+    auto &threadState = *pThreadState;
     threadState.isWaiting = true;
     threadState.waitEndTime = endTime;
     threadState.blockIdForWait = blockId;
@@ -116,17 +372,18 @@ void Entity::setScriptWait(const std::string &executionThreadId, Uint64 endTime,
     threadState.scriptPtrForResume = scriptPtr;
     threadState.sceneIdAtDispatchForResume = sceneId;
 
-    // completionPromise/future 로직은 그대로 유지
-    threadState.completionPromise = std::promise<void>();
-    threadState.completionFuture = threadState.completionPromise.get_future();
+    // 시간/프레임 대기는 엔진 예약 큐에 넣어 깨어날 때만 처리합니다. (엔티티마다 매 프레임 훑지 않음)
+    if (scheduleWake && (type == WaitType::BLOCK_INTERNAL || type == WaitType::EXPLICIT_WAIT_SECOND)) {
+        pEngineInstance->scheduleScriptWake(weak_from_this(), executionThreadId, endTime, type);
+    }
 }
 
 bool Entity::isScriptWaiting(const std::string &executionThreadId) const {
     // This function is often called to check if a script *should* pause.
     std::lock_guard lock(m_stateMutex);
-    auto it = scriptThreadStates.find(executionThreadId);
-    if (it != scriptThreadStates.end()) {
-        return it->second.isWaiting;
+    auto *pState = scriptThreadStates.find(executionThreadId);
+    if (pState) {
+        return pState->isWaiting;
     }
     return false;
 }
@@ -146,9 +403,19 @@ void Entity::executeScript(const Script *scriptPtr, const std::string &execution
                                       executionThreadId);
         return;
     }
+    if (scriptPtr->program) {
+        executeCompiledScript(scriptPtr, executionThreadId, sceneIdAtDispatch, deltaTime);
+        return;
+    }
 
-    // 스레드 상태 가져오기 또는 생성
-    auto &threadState = scriptThreadStates[executionThreadId];
+    // 스레드 상태 가져오기 (스케줄할 때 슬랩에 만들어지며, 없으면 이미 끝났거나 정리된 스레드)
+    ScriptThreadState *pThreadState = scriptThreadStates.find(executionThreadId);
+    if (!pThreadState) {
+        pEngineInstance->EngineStdOut("executeScript: script thread " + executionThreadId + " no longer exists for object " + id,
+                                      1, executionThreadId);
+        return;
+    }
+    auto &threadState = *pThreadState;
     // 스레드가 실행될 때마다 현재 스크립트 컨텍스트를 상태에 저장해야 합니다.
     // 이 정보가 있어야 Flow나 다른 함수에서 setScriptWait를 호출할 때
     // 재개에 필요한 정보를 올바르게 전달할 수 있습니다.
@@ -176,8 +443,8 @@ void Entity::executeScript(const Script *scriptPtr, const std::string &execution
         // --- 기존의 씬 변경, 종료 플래그 확인 로직은 그대로 유지 ---
         {
             std::lock_guard lock(m_stateMutex);
-            auto it_thread_state = scriptThreadStates.find(executionThreadId);
-            if (it_thread_state != scriptThreadStates.end() && it_thread_state->second.terminateRequested) {
+            auto *pFoundState = scriptThreadStates.find(executionThreadId);
+            if (pFoundState && pFoundState->terminateRequested) {
                 pEngineInstance->EngineStdOut(
                     "Script thread " + executionThreadId + " for entity " + this->id +
                     " is terminating as requested before block " + scriptPtr->blocks[threadState.currentBlockIndex].id, 0, executionThreadId);
@@ -216,25 +483,17 @@ void Entity::executeScript(const Script *scriptPtr, const std::string &execution
 
         try {
             blockName = block.type;
-            Moving(block.type, *pEngineInstance, this->id, block, executionThreadId,sceneIdAtDispatch, deltaTime);
-            Calculator(block.type, *pEngineInstance, this->id, block, executionThreadId);
-            Looks(block.type, *pEngineInstance, this->id, block, executionThreadId);
-            Sound(block.type, *pEngineInstance, this->id, block, executionThreadId);
-            Variable(block.type, *pEngineInstance, this->id, block, executionThreadId);
-            Function(block.type, *pEngineInstance, this->id, block, executionThreadId);
-            TextBox(block.type, *pEngineInstance, this->id, block, executionThreadId);
-            Event(block.type, *pEngineInstance, this->id, block, executionThreadId);
-            Flow(block.type, *pEngineInstance, this->id, block, executionThreadId, sceneIdAtDispatch, deltaTime);
+            executeBlock(*pEngineInstance, this->id, block, executionThreadId, sceneIdAtDispatch, deltaTime);
         } catch (const ScriptBlockExecutionError &sbee) {
             // 스크립트 블록 실행 중 오류 발생 시 처리
             {
                 std::lock_guard lock(m_stateMutex);
-                auto it_thread_state = scriptThreadStates.find(executionThreadId);
-                if (it_thread_state != scriptThreadStates.end()) {
-                    it_thread_state->second.terminateRequested = true; // 종료 요청 설정
-                    it_thread_state->second.isWaiting = false; // 대기 상태 해제
-                    it_thread_state->second.currentWaitType = WaitType::NONE;
-                    it_thread_state->second.resumeAtBlockIndex = -1; // 오류 발생 시 재개 불가
+                auto *pFoundState = scriptThreadStates.find(executionThreadId);
+                if (pFoundState) {
+                    pFoundState->terminateRequested = true; // 종료 요청 설정
+                    pFoundState->isWaiting = false; // 대기 상태 해제
+                    pFoundState->currentWaitType = WaitType::NONE;
+                    pFoundState->resumeAtBlockIndex = -1; // 오류 발생 시 재개 불가
                     // 다른 상태 (loopCounters 등)는 필요에 따라 오류 핸들러 또는 종료 로직에서 정리
                 }
             }
@@ -244,12 +503,12 @@ void Entity::executeScript(const Script *scriptPtr, const std::string &execution
             // 다른 일반 C++ 예외 발생 시 처리
             {
                 std::lock_guard lock(m_stateMutex);
-                auto it_thread_state = scriptThreadStates.find(executionThreadId);
-                if (it_thread_state != scriptThreadStates.end()) {
-                    it_thread_state->second.terminateRequested = true; // 종료 요청 설정
-                    it_thread_state->second.isWaiting = false; // 대기 상태 해제
-                    it_thread_state->second.currentWaitType = WaitType::NONE;
-                    it_thread_state->second.resumeAtBlockIndex = -1; // 오류 발생 시 재개 불가
+                auto *pFoundState = scriptThreadStates.find(executionThreadId);
+                if (pFoundState) {
+                    pFoundState->terminateRequested = true; // 종료 요청 설정
+                    pFoundState->isWaiting = false; // 대기 상태 해제
+                    pFoundState->currentWaitType = WaitType::NONE;
+                    pFoundState->resumeAtBlockIndex = -1; // 오류 발생 시 재개 불가
                 }
             }
             throw ScriptBlockExecutionError("Error during script block execution in entity.", block.id, block.type,
@@ -260,9 +519,9 @@ void Entity::executeScript(const Script *scriptPtr, const std::string &execution
         bool blockSetWait = false;
         {
             std::lock_guard lock(m_stateMutex);
-            auto it_thread_state = scriptThreadStates.find(executionThreadId);
-            if (it_thread_state != scriptThreadStates.end()) {
-                blockSetWait = it_thread_state->second.isWaiting;
+            auto *pFoundState = scriptThreadStates.find(executionThreadId);
+            if (pFoundState) {
+                blockSetWait = pFoundState->isWaiting;
             } else {
                 return; // 스레드 상태가 사라졌으면 중단
             }
@@ -295,6 +554,645 @@ void Entity::executeScript(const Script *scriptPtr, const std::string &execution
     t_index++;
 }
 
+namespace {
+    // 첫 함수 호출 때 확보하는 호출 프레임 수. 더 깊어지면 두 배씩 늘어나며 줄이지 않습니다.
+    constexpr size_t kInitialCallFrameCapacity = 256;
+    // 무한 재귀로 메모리를 다 쓰지 않도록 하는 호출 깊이 한도
+    constexpr size_t kMaxCallDepth = 10000;
+    // 화면 새로 고침 없이 실행하는 함수가 양보 없이 실행할 수 있는 최대 시간 (응답 없음 방지)
+    // 양보할 수 없는 호출(값 반환 함수 등)은 이 시간을 넘기면 경고만 남기고 끝까지 실행합니다.
+    constexpr Uint64 kNoRefreshTimeSliceNs = 500'000'000;
+
+    // 범위를 벗어나면 FunctionArgsView 를 원래대로 되돌립니다. (값 반환 함수는 실행 중에 중첩 호출됩니다)
+    struct FunctionArgsRestore {
+        FunctionArgsView saved = currentFunctionArgs();
+        ~FunctionArgsRestore() { currentFunctionArgs() = saved; }
+    };
+
+    // 결합 명령의 피연산자. Literal 이면 상수 테이블을 바로 읽고, 아니면 컴파일된 표현식을 평가합니다.
+    template<bool Literal>
+    double fusedNumber(Engine &engine, const std::string &objectId, const ScriptProgram &program, uint32_t index,
+                       const std::string &executionThreadId) {
+        if constexpr (Literal) {
+            return program.constants[index].asNumber();
+        } else {
+            return evaluateCompiledExpr(engine, objectId, program, index, executionThreadId).asNumber();
+        }
+    }
+
+    template<bool Literal>
+    void runMoveBounce(Engine &engine, Entity &entity, const ScriptProgram &program, const VmInstr &instr,
+                       const std::string &executionThreadId) {
+        double dist = fusedNumber<Literal>(engine, entity.getId(), program, instr.a, executionThreadId);
+        moveEntityInDirection(engine, entity, dist, executionThreadId);
+        bounceEntityOffWall(engine, entity, executionThreadId);
+    }
+
+    template<bool Literal>
+    void runLocateXY(Engine &engine, Entity &entity, const ScriptProgram &program, const VmInstr &instr,
+                     const std::string &executionThreadId) {
+        double x = fusedNumber<Literal>(engine, entity.getId(), program, instr.a, executionThreadId);
+        double y = fusedNumber<Literal>(engine, entity.getId(), program, instr.b, executionThreadId);
+        entity.setX(x);
+        entity.setY(y);
+    }
+
+    template<bool Literal>
+    void runChangeVariable(Engine &engine, const std::string &objectId, const ScriptProgram &program,
+                           const VmInstr &instr, const std::string &executionThreadId) {
+        const VariableStore::Ref &variable = program.variables[instr.b];
+        if constexpr (Literal) {
+            changeVariableBy(engine, objectId, variable, program.constants[instr.a], executionThreadId);
+        } else {
+            changeVariableBy(engine, objectId, variable,
+                             evaluateCompiledExpr(engine, objectId, program, instr.a, executionThreadId),
+                             executionThreadId);
+        }
+    }
+}
+
+/**
+ * @brief 로드 시 컴파일된 ScriptProgram 을 실행합니다.
+ * 제어 흐름은 programCounter 로 이어가고, 일반 블록은 executeBlock 으로 위임합니다.
+ * 대기/양보 시에는 resumeAtBlockIndex 에 현재 최상위 블록 인덱스를 기록하여 재개 경로가 스크립트를 다시 스케줄하도록 합니다.
+ */
+void Entity::executeCompiledScript(const Script *scriptPtr, const std::string &executionThreadId,
+                                   const std::string &sceneIdAtDispatch, float deltaTime) {
+    ScriptThreadState *pThreadState = nullptr; {
+        std::lock_guard lock(m_stateMutex);
+        pThreadState = scriptThreadStates.find(executionThreadId);
+        if (!pThreadState) {
+            pEngineInstance->EngineStdOut("executeCompiledScript: script thread " + executionThreadId +
+                                          " no longer exists for object " + id, 1, executionThreadId);
+            return;
+        }
+        pThreadState->scriptPtrForResume = scriptPtr;
+        pThreadState->sceneIdAtDispatchForResume = sceneIdAtDispatch;
+        if (pThreadState->programLoopCounters.size() < scriptPtr->program->loopSlotCount) {
+            pThreadState->programLoopCounters.resize(scriptPtr->program->loopSlotCount, 0);
+        }
+        if (pThreadState->isWaiting) {
+            pThreadState->isWaiting = false;
+            pThreadState->currentWaitType = WaitType::NONE;
+        }
+        pThreadState->resumeAtBlockIndex = -1;
+        if (!pThreadState->callFrames.empty() && pThreadState->callFrames.back().noRefresh) {
+            pThreadState->warpDeadlineNs = SDL_GetTicksNS() + kNoRefreshTimeSliceNs;
+        }
+    }
+
+    VmRunResult result = runCompiledProgram(*pThreadState, scriptPtr, executionThreadId, sceneIdAtDispatch, deltaTime, 0,
+                                            true);
+    if (result == VmRunResult::STOPPED) {
+        // 종료 요청으로 멈춘 스레드는 다시 재개되지 않으므로 슬롯을 바로 반환합니다. (장면 전환 중단은 상태 유지)
+        std::lock_guard lock(m_stateMutex);
+        if (pThreadState->terminateRequested) {
+            scriptThreadStates.erase(executionThreadId);
+        }
+        return;
+    }
+    if (result != VmRunResult::COMPLETED) {
+        return;
+    }
+    pEngineInstance->EngineStdOut("Script for object " + id + " completed all blocks. Cleaning up thread state.", 5,
+                                  executionThreadId); {
+        std::lock_guard lock(m_stateMutex);
+        scriptThreadStates.erase(executionThreadId);
+    }
+}
+
+void Entity::pushCallFrame(ScriptThreadState &threadState, const UserFunction &function, const Block &callBlock,
+                           const ScriptProgram *argProgram, uint32_t firstArgExpr, size_t returnPc,
+                           const std::string &executionThreadId) {
+    if (threadState.callFrames.size() >= kMaxCallDepth) {
+        throw ScriptBlockExecutionError("함수 호출이 너무 깊습니다. 끝나지 않는 재귀 호출이 있는지 확인하세요.", callBlock.id,
+                                        callBlock.type, this->id,
+                                        "User function call depth exceeded " + std::to_string(kMaxCallDepth) + ".");
+    }
+    if (threadState.callFrames.capacity() == 0) {
+        threadState.callFrames.reserve(kInitialCallFrameCapacity);
+        threadState.frameValues.resize(kInitialCallFrameCapacity);
+    }
+
+    // 인자와 지역 변수 자리를 먼저 확보해 두면 인자를 평가하다 중첩 호출된 값 반환 함수는 그 위를 사용합니다.
+    const uint32_t argCount = static_cast<uint32_t>(function.paramTypes.size());
+    const uint32_t argBase = threadState.frameValueTop;
+    threadState.frameValueTop += static_cast<uint32_t>(function.frameSlotCount());
+    if (threadState.frameValues.size() < threadState.frameValueTop) {
+        threadState.frameValues.resize(std::max<size_t>(threadState.frameValueTop, threadState.frameValues.size() * 2));
+    }
+    for (uint32_t i = 0; i < argCount; ++i) {
+        OperandValue arg;
+        if (argProgram) {
+            arg = evaluateCompiledExpr(*pEngineInstance, this->id, *argProgram, firstArgExpr + i, executionThreadId);
+        } else if (i < callBlock.params.size()) {
+            arg = getOperandValue(*pEngineInstance, this->id, callBlock.params[i], executionThreadId);
+        }
+        threadState.frameValues[argBase + i] = std::move(arg); // 평가 중 재할당될 수 있으므로 평가 후에 인덱싱
+    }
+    // 지역 변수는 호출할 때마다 초기값에서 시작합니다.
+    std::ranges::copy(function.localVariableValues, threadState.frameValues.begin() + argBase + argCount);
+
+    // 호출자 프레임의 반복 슬롯 바로 뒤에 이 프레임의 반복 슬롯을 둡니다.
+    const CallFrame *caller = threadState.callFrames.empty() ? nullptr : &threadState.callFrames.back();
+    const ScriptProgram *callerProgram = caller
+                                             ? caller->function->body.program.get()
+                                             : (threadState.scriptPtrForResume
+                                                    ? threadState.scriptPtrForResume->program.get()
+                                                    : nullptr);
+    const bool callerNoRefresh = caller && caller->noRefresh;
+    const uint32_t callerLoopBase = caller ? caller->loopBase : 0;
+    const uint32_t callerLoopSlots = callerProgram ? callerProgram->loopSlotCount : 0;
+    const Script *callerBody = caller ? &caller->function->body : threadState.scriptPtrForResume;
+    const int callerTreeLoopBase = caller ? caller->treeLoopBase : 0;
+
+    CallFrame frame;
+    frame.function = &function;
+    frame.returnPc = returnPc;
+    frame.argBase = argBase;
+    frame.loopBase = callerLoopBase + callerLoopSlots;
+    frame.treeLoopBase = callerTreeLoopBase + (callerBody ? callerBody->treeLoopSlotCount : 0);
+    frame.noRefresh = callerNoRefresh || function.runWithoutScreenRefresh;
+    if (frame.noRefresh && !callerNoRefresh && threadState.synchronousDepth == 0) {
+        // 끝까지 실행하는 호출 안에서는 callUserFunction 이 정한 한도를 늘리지 않습니다.
+        threadState.warpDeadlineNs = SDL_GetTicksNS() + kNoRefreshTimeSliceNs;
+    }
+    const size_t loopEnd = frame.loopBase + function.body.program->loopSlotCount;
+    if (threadState.programLoopCounters.size() < loopEnd) {
+        threadState.programLoopCounters.resize(std::max(loopEnd, threadState.programLoopCounters.size() * 2), 0);
+    }
+    // 중단된 이전 호출이 같은 범위에 남긴 트리 반복 상태를 지웁니다.
+    for (int slot = 0; slot < function.body.treeLoopSlotCount; ++slot) {
+        threadState.loopCounters.release(frame.treeLoopBase + slot);
+    }
+    threadState.callFrames.push_back(frame);
+    threadState.programCounter = 0;
+}
+
+int Entity::ScriptThreadState::treeLoopSlot(const Block &block) const {
+    if (block.loopSlot < 0) {
+        return -1;
+    }
+    return block.loopSlot + (callFrames.empty() ? 0 : callFrames.back().treeLoopBase);
+}
+
+OperandValue Entity::callUserFunction(const Block &callBlock, const std::string &executionThreadId) {
+    int functionIndex = pEngineInstance->findUserFunction(callBlock.type.substr(5)); // "func_" 뒤가 함수 ID
+    const UserFunction *function = functionIndex >= 0 ? pEngineInstance->getUserFunction(functionIndex) : nullptr;
+    if (!function || !function->body.program) {
+        pEngineInstance->EngineStdOut("User function for block " + callBlock.type + " (" + callBlock.id +
+                                      ") is not defined or failed to compile. Skipping.", 1, executionThreadId);
+        return {};
+    }
+
+    ScriptThreadState *pThreadState = nullptr; {
+        std::lock_guard lock(m_stateMutex);
+        auto *pState = scriptThreadStates.find(executionThreadId);
+        if (!pState) {
+            return {};
+        }
+        pThreadState = pState;
+    }
+    ScriptThreadState &threadState = *pThreadState;
+    const Script *scriptPtr = threadState.scriptPtrForResume;
+    if (!scriptPtr) {
+        return {};
+    }
+
+    // 호출자의 위치를 보관해 두었다가 함수가 끝나면(예외로 빠져나가도) 그대로 되돌립니다.
+    struct SynchronousCallScope {
+        ScriptThreadState &state;
+        const size_t pc = state.programCounter;
+        const size_t depth = state.callFrames.size();
+        const uint32_t valueTop = state.frameValueTop;
+        const Uint64 warpDeadline = state.warpDeadlineNs;
+
+        explicit SynchronousCallScope(ScriptThreadState &threadState) : state(threadState) {
+            // 양보할 수 없는 호출은 가장 바깥 호출부터 kNoRefreshTimeSliceNs 가 지나면 경고합니다.
+            if (state.synchronousDepth++ == 0) {
+                state.warpDeadlineNs = SDL_GetTicksNS() + kNoRefreshTimeSliceNs;
+            }
+        }
+
+        ~SynchronousCallScope() {
+            while (state.callFrames.size() > depth) {
+                state.callFrames.pop_back();
+            }
+            state.frameValueTop = valueTop;
+            state.programCounter = pc;
+            state.warpDeadlineNs = warpDeadline;
+            state.synchronousDepth--;
+        }
+    };
+    // 호출 블록은 컴파일되지 않은 리포터/블록이므로 인자는 블록 파라미터에서 평가합니다.
+    FunctionArgsRestore restoreArgs;
+    SynchronousCallScope scope(threadState);
+    pushCallFrame(threadState, *function, callBlock, nullptr, 0, scope.pc, executionThreadId);
+
+    OperandValue result;
+    const std::string sceneIdAtDispatch = threadState.sceneIdAtDispatchForResume;
+    VmRunResult runResult = runCompiledProgram(threadState, scriptPtr, executionThreadId, sceneIdAtDispatch, 0.0f,
+                                               scope.depth + 1, false);
+    if (runResult == VmRunResult::COMPLETED && function->returnsValue) {
+        // 결과값은 호출된 함수의 인자를 참조할 수 있으므로 프레임을 내리기 전에 계산합니다.
+        FunctionArgsView &args = currentFunctionArgs();
+        args.function = function;
+        args.values = &threadState.frameValues;
+        args.base = threadState.callFrames.back().argBase;
+        result = evaluateCompiledExpr(*pEngineInstance, this->id, *function->body.program, function->returnExpr,
+                                      executionThreadId);
+    }
+    return result;
+}
+
+bool Entity::suspendForTextInput(const std::string &executionThreadId, const std::string &blockId) {
+    std::lock_guard lock(m_stateMutex);
+    ScriptThreadState *pState = scriptThreadStates.find(executionThreadId);
+    if (!pState || pState->synchronousDepth > 0 || !pState->scriptPtrForResume ||
+        !pState->scriptPtrForResume->program) {
+        return false;
+    }
+    // VM 은 EXEC 뒤에 대기 상태를 보고 다음 명령 위치를 저장한 채 반환합니다.
+    pState->isWaiting = true;
+    pState->waitEndTime = 0;
+    pState->blockIdForWait = blockId;
+    pState->currentWaitType = WaitType::TEXT_INPUT;
+    return true;
+}
+
+bool Entity::resumeTextInputWait(const std::string &executionThreadId) {
+    const Script *scriptPtr = nullptr;
+    std::string sceneId; {
+        std::lock_guard lock(m_stateMutex);
+        ScriptThreadState *pState = scriptThreadStates.find(executionThreadId);
+        if (!pState || pState->terminateRequested) {
+            return true; // 이미 끝난 스레드: 대답만 남깁니다.
+        }
+        if (!pState->isWaiting || pState->resumeAtBlockIndex == -1) {
+            return false; // 아직 VM 이 멈추기 전
+        }
+        if (pState->currentWaitType != WaitType::TEXT_INPUT) {
+            return true; // 장면 전환 등 다른 대기로 바뀐 스레드는 그쪽 재개 경로가 이어서 실행합니다.
+        }
+        pState->isWaiting = false;
+        pState->currentWaitType = WaitType::NONE;
+        scriptPtr = pState->scriptPtrForResume;
+        sceneId = pState->sceneIdAtDispatchForResume;
+    }
+    pEngineInstance->EngineStdOut("Entity " + id + " (Thread: " + executionThreadId + ") received text input. Resuming.",
+                                  0, executionThreadId);
+    scheduleScriptExecutionOnPool(scriptPtr, sceneId, 0.0f, executionThreadId);
+    return true;
+}
+
+Entity::VmRunResult Entity::runCompiledProgram(ScriptThreadState &threadState, const Script *scriptPtr,
+                                               const std::string &executionThreadId,
+                                               const std::string &sceneIdAtDispatch, float deltaTime, size_t minDepth,
+                                               bool canSuspend) {
+    FunctionArgsRestore restoreArgs;
+    const ScriptProgram *program = nullptr;
+    uint32_t loopBase = 0;
+    bool noRefresh = false;
+    bool guardNext = true; // 실행을 시작하거나 프레임을 바꾼 직후에는 항상 확인합니다.
+    // 현재 호출 프레임의 프로그램과 인자로 전환합니다.
+    auto enterCurrentFrame = [&]() {
+        guardNext = true;
+        FunctionArgsView &args = currentFunctionArgs();
+        if (threadState.callFrames.empty()) {
+            program = scriptPtr->program.get();
+            loopBase = 0;
+            noRefresh = false;
+            args = FunctionArgsView{};
+        } else {
+            const CallFrame &frame = threadState.callFrames.back();
+            program = frame.function->body.program.get();
+            loopBase = frame.loopBase;
+            noRefresh = frame.noRefresh;
+            args.function = frame.function;
+            args.values = &threadState.frameValues;
+            args.base = frame.argBase;
+        }
+    };
+    // 반복문 끝에서 양보하지 않고 바로 다음 반복을 실행할지 결정합니다.
+    auto keepRunning = [&]() {
+        if (!canSuspend) {
+            // 끝까지 실행하는 함수는 양보할 수 없습니다. callUserFunction 이 정한 시각이 지나면 false 를 돌려
+            // 경고하게 합니다. (이번 틱의 할당량을 넘긴 시간은 틱이 끝난 뒤 스레드의 빚으로 정산됩니다)
+            return SDL_GetTicksNS() < threadState.warpDeadlineNs;
+        }
+        if (noRefresh && SDL_GetTicksNS() < threadState.warpDeadlineNs) {
+            // 화면 새로 고침 없이 실행. 이번 틱의 할당량을 넘긴 시간은 틱이 끝난 뒤 스레드의 빚으로 정산됩니다.
+            return true;
+        }
+        if (Engine::scriptTickQuantumExpired()) {
+            return false; // 이번 틱의 CPU 할당량을 다 썼으면 부스트 중이어도 양보합니다.
+        }
+        return pEngineInstance->hasBoostBudget(); // 부스트 모드: 이번 프레임 예산이 남아 있으면 바로 다음 반복 실행
+    };
+    // 반복문 끝에서 다음 프레임까지 양보합니다. (Engine::processScriptWakeups 가 다음 프레임에 이어서 실행)
+    auto yieldToNextFrame = [&](const VmInstr &instr) {
+        setScriptWait(executionThreadId, 0, program->blocks[instr.block].id, WaitType::BLOCK_INTERNAL, scriptPtr,
+                      sceneIdAtDispatch);
+        std::lock_guard lock(m_stateMutex);
+        threadState.resumeAtBlockIndex = static_cast<int>(instr.topLevelIndex);
+    };
+    // 양보할 수 없는 함수가 시간 한도를 넘기면 경고를 한 번 남기고 계속 실행합니다.
+    // (중단하면 호출 블록이 잘못된 결과값을 받으므로 결과를 만들어 내지 않습니다)
+    auto reportSynchronousOverrun = [&](const VmInstr &instr) {
+        pEngineInstance->EngineStdOut(
+            "Entity::runCompiledProgram: " + id + " - a function that must finish in one tick has been running for over " +
+            std::to_string(kNoRefreshTimeSliceNs / 1'000'000) + " ms (at block " + program->blocks[instr.block].id +
+            "). The frame will stall until it returns.", 1, executionThreadId);
+        threadState.warpDeadlineNs = std::numeric_limits<Uint64>::max(); // 호출이 끝나면 SynchronousCallScope 가 되돌립니다.
+    };
+    auto markTerminated = [&]() {
+        std::lock_guard lock(m_stateMutex);
+        auto *pFoundState = scriptThreadStates.find(executionThreadId);
+        if (pFoundState) {
+            pFoundState->terminateRequested = true; // 종료 요청 설정
+            pFoundState->isWaiting = false; // 대기 상태 해제
+            pFoundState->currentWaitType = WaitType::NONE;
+            pFoundState->resumeAtBlockIndex = -1; // 오류 발생 시 재개 불가
+        }
+    };
+
+    enterCurrentFrame();
+    while (true) {
+        if (threadState.programCounter >= program->code.size()) {
+            if (threadState.callFrames.size() <= minDepth) {
+                return VmRunResult::COMPLETED;
+            }
+            // 함수 본문이 끝났으면 호출자에게 돌아갑니다.
+            const CallFrame &frame = threadState.callFrames.back();
+            threadState.programCounter = frame.returnPc;
+            threadState.frameValueTop = frame.argBase;
+            threadState.callFrames.pop_back();
+            enterCurrentFrame();
+            continue;
+        }
+
+        const VmInstr &instr = program->code[threadState.programCounter];
+        const Block &block = program->blocks[instr.block];
+        // 대기 없는 직선 구간 안에서는 종료 요청/장면/엔진 종료를 구간 시작에서 한 번만 확인합니다.
+        // (구간은 점프 대상이나 양보 가능한 명령에서 끊기므로 반복문 한 바퀴마다 최소 한 번은 확인됩니다)
+        if (guardNext || !(instr.flags & kVmInstrUnguarded)) {
+            guardNext = false; {
+                std::lock_guard lock(m_stateMutex);
+                if (threadState.terminateRequested) {
+                    pEngineInstance->EngineStdOut(
+                        "Script thread " + executionThreadId + " for entity " + this->id +
+                        " is terminating as requested before block " + block.id, 0, executionThreadId);
+                    return VmRunResult::STOPPED;
+                }
+            }
+            if (pEngineInstance->m_isShuttingDown.load(std::memory_order_relaxed)) {
+                pEngineInstance->EngineStdOut(
+                    "Script execution cancelled due to engine shutdown for entity: " + this->getId(), 1,
+                    executionThreadId);
+                return VmRunResult::STOPPED;
+            }
+            std::string currentEngineSceneId = pEngineInstance->getCurrentSceneId();
+            const ObjectInfo *objInfo = pEngineInstance->getObjectInfoById(this->id);
+            bool isGlobalEntity = (objInfo && (objInfo->sceneId == "global" || objInfo->sceneId.empty()));
+            if (currentEngineSceneId != sceneIdAtDispatch && !isGlobalEntity) {
+                pEngineInstance->EngineStdOut(
+                    "Script execution for entity " + this->id + " (Block: " + block.type +
+                    ") halted. Scene changed from " + sceneIdAtDispatch + " to " + currentEngineSceneId + ".", 1,
+                    executionThreadId);
+                return VmRunResult::STOPPED;
+            }
+            if (!isGlobalEntity && objInfo && objInfo->sceneId != currentEngineSceneId) {
+                pEngineInstance->EngineStdOut(
+                    "Script execution for entity " + this->id + " (Block: " + block.type +
+                    ") halted. Entity no longer in current scene " + currentEngineSceneId + ".", 1,
+                    executionThreadId);
+                return VmRunResult::STOPPED;
+            }
+        }
+
+        THREAD_ID_INTERNAL = executionThreadId;
+        BLOCK_ID_INTERNAL = block.id;
+
+        try {
+            // AOT 로 생성된 구간이 있으면 구간 전체를 한 번에 실행합니다. (구간 안에는 대기 없는 명령만 있음)
+            if (!program->nativeRegions.empty()) {
+                if (AotRegionFn native = program->nativeRegions[threadState.programCounter]) {
+                    blockName = block.type;
+                    AotRegionContext context{
+                        *pEngineInstance, *this, this->id, *program, executionThreadId, sceneIdAtDispatch, deltaTime,
+                        threadState.programLoopCounters.data() + loopBase
+                    };
+                    threadState.programCounter = native(context);
+                    continue;
+                }
+            }
+            switch (instr.op) {
+                case VmOp::EXEC: {
+                    blockName = block.type;
+                    executeBlock(*pEngineInstance, this->id, block, executionThreadId, sceneIdAtDispatch, deltaTime);
+                    if (instr.flags & kVmInstrNoWait) {
+                        threadState.programCounter++; // 정적 분석상 대기를 걸 수 없는 블록
+                        break;
+                    }
+
+                    bool blockSetWait = false;
+                    WaitType waitType = WaitType::NONE; {
+                        std::lock_guard lock(m_stateMutex);
+                        auto *pFoundState = scriptThreadStates.find(executionThreadId);
+                        if (!pFoundState) {
+                            return VmRunResult::STOPPED; // 스레드 상태가 사라졌으면 중단
+                        }
+                        blockSetWait = pFoundState->isWaiting;
+                        waitType = pFoundState->currentWaitType;
+                    }
+                    if (blockSetWait && !canSuspend) {
+                        // 끝까지 실행해야 하는 함수 안에서는 기다리지 않고 다음 블록으로 넘어갑니다.
+                        std::lock_guard lock(m_stateMutex);
+                        threadState.isWaiting = false;
+                        threadState.currentWaitType = WaitType::NONE;
+                        pEngineInstance->EngineStdOut(
+                            "Entity::runCompiledProgram: " + id + " - wait set by block " + block.id +
+                            " ignored inside a function that must finish in one tick.", 3, executionThreadId);
+                        threadState.programCounter++;
+                        break;
+                    }
+                    if (blockSetWait) {
+                        // BLOCK_INTERNAL 은 같은 블록이 다음 프레임에 이어서 실행되어야 하므로 pc 를 유지하고,
+                        // 그 외(초 기다리기, 소리 재생 완료 등)는 블록이 할 일을 마쳤으므로 다음 명령에서 재개합니다.
+                        std::lock_guard lock(m_stateMutex);
+                        if (waitType != WaitType::BLOCK_INTERNAL) {
+                            threadState.programCounter++;
+                        }
+                        threadState.resumeAtBlockIndex = static_cast<int>(instr.topLevelIndex);
+                        pEngineInstance->EngineStdOut(
+                            "Entity::executeCompiledScript: " + id + " (Thread: " + executionThreadId +
+                            ") - Pausing execution due to wait set by block " + block.id + ". PC: " +
+                            std::to_string(threadState.programCounter), 3, executionThreadId);
+                        return VmRunResult::SUSPENDED;
+                    }
+                    threadState.programCounter++;
+                    break;
+                }
+                case VmOp::JUMP:
+                    threadState.programCounter = instr.a;
+                    break;
+                case VmOp::JUMP_IF_FALSE:
+                case VmOp::JUMP_IF_TRUE: {
+                    bool condition = evaluateCompiledExpr(*pEngineInstance, this->id, *program, instr.a,
+                                                          executionThreadId).asBool();
+                    bool jumpOn = instr.op == VmOp::JUMP_IF_TRUE;
+                    threadState.programCounter = (condition == jumpOn) ? instr.b : threadState.programCounter + 1;
+                    break;
+                }
+                case VmOp::LOOP_INIT: {
+                    double count = std::floor(evaluateCompiledExpr(*pEngineInstance, this->id, *program, instr.a,
+                                                                    executionThreadId).asNumber());
+                    threadState.programLoopCounters[loopBase + instr.b] =
+                            count > 0 ? static_cast<int>(std::min(count, static_cast<double>(INT_MAX))) : 0;
+                    threadState.programCounter++;
+                    break;
+                }
+                case VmOp::LOOP_TEST:
+                    threadState.programCounter = threadState.programLoopCounters[loopBase + instr.a] <= 0
+                                                     ? instr.b
+                                                     : threadState.programCounter + 1;
+                    break;
+                case VmOp::LOOP_NEXT:
+                    threadState.programLoopCounters[loopBase + instr.a]--;
+                    threadState.programCounter = instr.b;
+                    if (keepRunning()) {
+                        break;
+                    }
+                    if (!canSuspend) {
+                        reportSynchronousOverrun(instr);
+                        break;
+                    }
+                    yieldToNextFrame(instr);
+                    return VmRunResult::SUSPENDED;
+                case VmOp::YIELD_JUMP:
+                    threadState.programCounter = instr.a;
+                    if (keepRunning()) {
+                        break;
+                    }
+                    if (!canSuspend) {
+                        reportSynchronousOverrun(instr);
+                        break;
+                    }
+                    yieldToNextFrame(instr);
+                    return VmRunResult::SUSPENDED;
+                case VmOp::WAIT_UNTIL: {
+                    const WaitDependencies &dependencies = program->waitDependencies[instr.b];
+                    const bool parks = canSuspend && !(dependencies.sources & kWaitPolls);
+                    // 평가 전에 읽어 두어야 평가 도중/뒤의 변경으로 깨어납니다.
+                    const uint64_t stamp = parks
+                                               ? pEngineInstance->conditionInputStamp(
+                                                   dependencies.variableBuckets, dependencies.sources)
+                                               : 0;
+                    if (evaluateCompiledExpr(*pEngineInstance, this->id, *program, instr.a, executionThreadId).asBool()) {
+                        threadState.programCounter++;
+                        break;
+                    }
+                    if (!canSuspend) {
+                        pEngineInstance->EngineStdOut(
+                            "Entity::runCompiledProgram: " + id + " - wait_until_true " + block.id +
+                            " skipped inside a function that must finish in one tick.", 1, executionThreadId);
+                        threadState.programCounter++;
+                        break;
+                    }
+                    if (parks) {
+                        // 조건이 읽는 입력이 바뀔 때까지 재웁니다. (깨어나면 이 명령에서 다시 평가)
+                        setScriptWait(executionThreadId, 0, block.id, WaitType::BLOCK_INTERNAL, scriptPtr,
+                                      sceneIdAtDispatch, false); {
+                            std::lock_guard lock(m_stateMutex);
+                            threadState.resumeAtBlockIndex = static_cast<int>(instr.topLevelIndex);
+                        }
+                        pEngineInstance->parkConditionWait(weak_from_this(), executionThreadId,
+                                                           dependencies.variableBuckets, dependencies.sources, stamp);
+                        return VmRunResult::SUSPENDED;
+                    }
+                    // 시간에 따라 바뀌는 조건은 부스트 모드에서도 매 프레임 양보하며 다시 평가합니다.
+                    yieldToNextFrame(instr);
+                    return VmRunResult::SUSPENDED;
+                }
+                case VmOp::CALL: {
+                    const CallSite &call = program->calls[instr.a];
+                    const UserFunction *function = pEngineInstance->getUserFunction(call.function);
+                    if (!function || !function->body.program) {
+                        pEngineInstance->EngineStdOut(
+                            "User function for block " + block.type + " (" + block.id +
+                            ") failed to compile. Skipping.", 1, executionThreadId);
+                        threadState.programCounter++;
+                        break;
+                    }
+                    pushCallFrame(threadState, *function, block, program, call.firstArg,
+                                  threadState.programCounter + 1, executionThreadId);
+                    enterCurrentFrame();
+                    break;
+                }
+                // 결합 명령은 기다리지 않으므로 대기 상태를 확인하지 않고 다음 명령으로 넘어갑니다.
+                case VmOp::MOVE_BOUNCE:
+                    blockName = block.type;
+                    runMoveBounce<false>(*pEngineInstance, *this, *program, instr, executionThreadId);
+                    threadState.programCounter++;
+                    break;
+                case VmOp::MOVE_BOUNCE_CONST:
+                    blockName = block.type;
+                    runMoveBounce<true>(*pEngineInstance, *this, *program, instr, executionThreadId);
+                    threadState.programCounter++;
+                    break;
+                case VmOp::LOCATE_XY:
+                    blockName = block.type;
+                    runLocateXY<false>(*pEngineInstance, *this, *program, instr, executionThreadId);
+                    threadState.programCounter++;
+                    break;
+                case VmOp::LOCATE_XY_CONST:
+                    blockName = block.type;
+                    runLocateXY<true>(*pEngineInstance, *this, *program, instr, executionThreadId);
+                    threadState.programCounter++;
+                    break;
+                case VmOp::CHANGE_VAR:
+                    blockName = block.type;
+                    runChangeVariable<false>(*pEngineInstance, this->id, *program, instr, executionThreadId);
+                    threadState.programCounter++;
+                    break;
+                case VmOp::CHANGE_VAR_CONST:
+                    blockName = block.type;
+                    runChangeVariable<true>(*pEngineInstance, this->id, *program, instr, executionThreadId);
+                    threadState.programCounter++;
+                    break;
+                case VmOp::SET_LOCAL:
+                    blockName = block.type;
+                    setFunctionVariable(*pEngineInstance, this->id, static_cast<int>(instr.b),
+                                        evaluateCompiledExpr(*pEngineInstance, this->id, *program, instr.a,
+                                                             executionThreadId), executionThreadId);
+                    threadState.programCounter++;
+                    break;
+                case VmOp::CHANGE_LOCAL:
+                    blockName = block.type;
+                    changeFunctionVariableBy(*pEngineInstance, this->id, static_cast<int>(instr.b),
+                                             evaluateCompiledExpr(*pEngineInstance, this->id, *program, instr.a,
+                                                                  executionThreadId), executionThreadId);
+                    threadState.programCounter++;
+                    break;
+                case VmOp::JUMP_IF_NOT_REACH: {
+                    bool reached = isEntityReaching(*pEngineInstance, *this, program->constants[instr.a].stringValue(),
+                                                    executionThreadId);
+                    threadState.programCounter = reached ? threadState.programCounter + 1 : instr.b;
+                    break;
+                }
+            }
+        } catch (const ScriptBlockExecutionError &) {
+            markTerminated();
+            throw; // 워커 스레드 루프에서 잡히도록 예외 다시 던지기
+        }
+        catch (const std::exception &e) {
+            markTerminated();
+            throw ScriptBlockExecutionError("Error during script block execution in entity.", block.id, block.type,
+                                            this->id, e.what());
+        }
+    }
+}
+
 // ... (Entity.h에 추가할 BlockTypeEnumToString 헬퍼 함수 선언 예시)
 // namespace EntityHelper { std::string BlockTypeEnumToString(Entity::WaitType type); }
 // Entity.cpp에 구현:
@@ -321,52 +1219,72 @@ const std::string &Entity::getId() const { return id; }
 const std::string &Entity::getName() const { return name; }
 
 double Entity::getX() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.x;
+    StateLock lock(*this);
     return x;
 }
 
 double Entity::getY() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.y;
+    StateLock lock(*this);
     return y;
 }
 
 double Entity::getRegX() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.regX;
+    StateLock lock(*this);
     return regX;
 }
 
 double Entity::getRegY() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.regY;
+    StateLock lock(*this);
     return regY;
 }
 
 double Entity::getScaleX() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.scaleX;
+    StateLock lock(*this);
     return scaleX;
 }
 
 double Entity::getScaleY() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.scaleY;
+    StateLock lock(*this);
     return scaleY;
 }
 
 double Entity::getRotation() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.rotation;
+    StateLock lock(*this);
     return rotation;
 }
 
 double Entity::getDirection() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.direction;
+    StateLock lock(*this);
     return direction;
 }
 
 double Entity::getWidth() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.width;
+    StateLock lock(*this);
     return width;
 }
 
 double Entity::getHeight() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.height;
+    StateLock lock(*this);
     return height;
 }
 
@@ -376,64 +1294,91 @@ bool Entity::isVisible() const {
 }
 
 SDL_FRect Entity::getVisualBounds() const {
-    std::lock_guard lock(m_stateMutex);
-    double actualWidth = width * scaleX;
-    double actualHeight = height * scaleY;
+    double curX, curY, actualWidth, actualHeight;
+    if (readsFrameSnapshot()) {
+        const FrameSnapshot &snapshot = m_frameSnapshot;
+        curX = snapshot.x;
+        curY = snapshot.y;
+        actualWidth = snapshot.width * snapshot.scaleX;
+        actualHeight = snapshot.height * snapshot.scaleY;
+    } else {
+        StateLock lock(*this);
+        curX = x;
+        curY = y;
+        actualWidth = width * scaleX;
+        actualHeight = height * scaleY;
+    }
 
     SDL_FRect bounds;
     // 좌상단 x, y 계산
-    bounds.x = static_cast<float>(x - actualWidth / 2.0);
+    bounds.x = static_cast<float>(curX - actualWidth / 2.0);
     // 엔트리 좌표계에서는 y가 위로 갈수록 크므로, 좌상단 y는 y + height/2 입니다.
     // 하지만 SDL_FRect는 일반적으로 y가 아래로 갈수록 크므로, 변환이 필요할 수 있습니다.
     // 여기서는 Stage 좌표계 (Y 위쪽)를 그대로 사용한다고 가정하고,
     // SDL 렌더링 시점에서 Y축을 뒤집는다고 가정합니다.
-    bounds.y = static_cast<float>(y - actualHeight / 2.0); // Stage 좌표계의 좌하단 y
+    bounds.y = static_cast<float>(curY - actualHeight / 2.0); // Stage 좌표계의 좌하단 y
     bounds.w = static_cast<float>(actualWidth);
     bounds.h = static_cast<float>(actualHeight);
     return bounds;
 }
 
 void Entity::setX(double newX) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newX](Entity &entity) { entity.setX(newX); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     x = newX;
 }
 
 void Entity::setY(double newY) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newY](Entity &entity) { entity.setY(newY); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     y = newY;
 }
 
 void Entity::setRegX(double newRegX) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newRegX](Entity &entity) { entity.setRegX(newRegX); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     regX = newRegX;
 }
 
 void Entity::setRegY(double newRegY) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newRegY](Entity &entity) { entity.setRegY(newRegY); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     regY = newRegY;
 }
 
 void Entity::setScaleX(double newScaleX) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newScaleX](Entity &entity) { entity.setScaleX(newScaleX); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     if (!m_isClone) {
         scaleX = newScaleX;
     }
 }
 
 void Entity::setScaleY(double newScaleY) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newScaleY](Entity &entity) { entity.setScaleY(newScaleY); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     if (!m_isClone) {
         scaleY = newScaleY;
     }
 }
 
 void Entity::setRotation(double newRotation) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newRotation](Entity &entity) { entity.setRotation(newRotation); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     rotation = newRotation;
 }
 
 void Entity::setDirection(double newDirection) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newDirection](Entity &entity) { entity.setDirection(newDirection); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     // 방향 업데이트
     direction = newDirection;
 
@@ -470,7 +1415,9 @@ void Entity::setDirection(double newDirection) {
 }
 
 void Entity::setWidth(double newWidth) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newWidth](Entity &entity) { entity.setWidth(newWidth); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     // 엔티티의 내부 width 값을 업데이트합니다.
     // 이 값은 충돌 감지 등에 사용될 수 있으며, scaleX와 함께 시각적 크기를 결정합니다.
     this->width = newWidth;
@@ -553,7 +1500,9 @@ void Entity::setWidth(double newWidth) {
 }
 
 void Entity::setHeight(double newHeight) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([newHeight](Entity &entity) { entity.setHeight(newHeight); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     this->height = newHeight; // 내부 height 값 업데이트
 
     if (pEngineInstance) {
@@ -614,17 +1563,24 @@ void Entity::setHeight(double newHeight) {
 }
 
 void Entity::setVisible(bool newVisible) {
+    if (deferCrossShardWrite([newVisible](Entity &entity) { entity.setVisible(newVisible); }))
+        return;
     // std::lock_guard lock(m_stateMutex); // Lock removed
+    markStateWritten();
     visible.store(newVisible, std::memory_order_relaxed);
 }
 
 Entity::RotationMethod Entity::getRotateMethod() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.rotateMethod;
+    StateLock lock(*this);
     return rotateMethod;
 }
 
 void Entity::setRotateMethod(RotationMethod method) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([method](Entity &entity) { entity.setRotateMethod(method); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     rotateMethod = method;
 }
 
@@ -669,7 +1625,7 @@ Uint32 get_pixel(SDL_Surface *surface, int x, int y) {
 }
 
 bool Entity::isPointInside(double pX, double pY) const {
-    std::lock_guard lock(m_stateMutex);
+    StateLock lock(*this);
 
     if (!visible.load(std::memory_order_relaxed) || m_effectAlpha < 0.01) {
         return false;
@@ -796,12 +1752,12 @@ bool Entity::isPointInside(double pX, double pY) const {
 }
 
 Entity::CollisionSide Entity::getLastCollisionSide() const {
-    std::lock_guard lock(m_stateMutex);
+    StateLock lock(*this);
     return lastCollisionSide;
 }
 
 void Entity::setLastCollisionSide(CollisionSide side) {
-    std::lock_guard lock(m_stateMutex);
+    StateLock lock(*this);
     lastCollisionSide = side;
 }
 
@@ -860,50 +1816,62 @@ bool Entity::hasActiveDialog() const {
 
 std::string Entity::getWaitingBlockId(const std::string &executionThreadId) const {
     std::lock_guard lock(m_stateMutex);
-    auto it = scriptThreadStates.find(executionThreadId);
-    if (it != scriptThreadStates.end() && it->second.isWaiting) {
-        return it->second.blockIdForWait;
+    auto *pState = scriptThreadStates.find(executionThreadId);
+    if (pState && pState->isWaiting) {
+        return pState->blockIdForWait;
     }
     return "";
 }
 
 Entity::WaitType Entity::getCurrentWaitType(const std::string &executionThreadId) const {
     std::lock_guard lock(m_stateMutex);
-    auto it = scriptThreadStates.find(executionThreadId);
-    if (it != scriptThreadStates.end() && it->second.isWaiting) {
-        return it->second.currentWaitType;
+    auto *pState = scriptThreadStates.find(executionThreadId);
+    if (pState && pState->isWaiting) {
+        return pState->currentWaitType;
     }
     return WaitType::NONE;
 }
 
 // Effect Getters and Setters
 double Entity::getEffectBrightness() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.effectBrightness;
+    StateLock lock(*this);
     return m_effectBrightness;
 }
 
 void Entity::setEffectBrightness(double brightness) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([brightness](Entity &entity) { entity.setEffectBrightness(brightness); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     m_effectBrightness = std::clamp(brightness, -100.0, 100.0);
 }
 
 double Entity::getEffectAlpha() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.effectAlpha;
+    StateLock lock(*this);
     return m_effectAlpha;
 }
 
 void Entity::setEffectAlpha(double alpha) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([alpha](Entity &entity) { entity.setEffectAlpha(alpha); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     m_effectAlpha = std::clamp(alpha, 0.0, 1.0);
 }
 
 double Entity::getEffectHue() const {
-    std::lock_guard lock(m_stateMutex);
+    if (readsFrameSnapshot())
+        return m_frameSnapshot.effectHue;
+    StateLock lock(*this);
     return m_effectHue;
 }
 
 void Entity::setEffectHue(double hue) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([hue](Entity &entity) { entity.setEffectHue(hue); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     m_effectHue = std::fmod(hue, 360.0);
     if (m_effectHue < 0)
         m_effectHue += 360.0;
@@ -950,7 +1918,7 @@ void Entity::playSound(const std::string &soundId) {
 }
 
 void Entity::playSoundWithSeconds(const std::string &soundId, double seconds) {
-    // std::unique_lock<std::recursive_mutex> lock(m_stateMutex); // Lock removed for async wait
+    // std::unique_lock lock(m_stateMutex); // Lock removed for async wait
 
     if (!pEngineInstance) {
         pEngineInstance->EngineStdOut("Entity " + id + " has no pEngineInstance to play sound.", 2);
@@ -1064,9 +2032,9 @@ void Entity::waitforPlaysound(const std::string &soundId, const std::string &exe
         }
 
         // ScriptThreadState에 접근하기 전에 뮤텍스 잠금
-        std::unique_lock<std::recursive_mutex> lock(m_stateMutex);
-        auto it_state = scriptThreadStates.find(executionThreadId);
-        if (it_state == scriptThreadStates.end()) {
+        std::unique_lock lock(m_stateMutex);
+        auto *pState = scriptThreadStates.find(executionThreadId);
+        if (!pState) {
             pEngineInstance->EngineStdOut(
                 "Entity " + id + " (Thread: " + executionThreadId +
                 ") - ScriptThreadState not found for waitforPlaysound. Cannot set wait.", 2, executionThreadId);
@@ -1076,18 +2044,10 @@ void Entity::waitforPlaysound(const std::string &soundId, const std::string &exe
                                           executionThreadId);
             return;
         }
-        ScriptThreadState &threadState = it_state->second;
-
-        // 새로운 promise와 future 생성
-        threadState.completionPromise = {}; // 이전 promise가 있다면 리셋 (기본 생성자로 새 promise 할당)
-        threadState.completionFuture = threadState.completionPromise.get_future();
+        ScriptThreadState &threadState = *pState;
 
-        // AudioEngineHelper의 playSound 함수가 이 promise를 알고, 사운드 완료 시 resolve하도록 수정 필요.
-        // 예를 들어, playSound 함수가 promise의 참조나 포인터를 받을 수 있습니다.
-        // pEngineInstance->aeHelper.playSoundAndNotifyPromise(this->getId(), soundFilePath, threadState.completionPromise);
-        // 위와 같은 함수가 AudioEngineHelper에 구현되어야 합니다.
-        // 현재는 기존 playSound를 호출합니다. AudioEngineHelper 수정 없이는 future가 자동으로 resolve되지 않습니다.
-        pEngineInstance->aeHelper.playSound(this->getId(), soundFilePath);
+        // 재생이 끝나면 AudioEngineHelper 가 이 재생 ID 를 알리고, 엔진이 이 스레드만 깨웁니다.
+        const uint64_t playbackId = pEngineInstance->aeHelper.playSound(this->getId(), soundFilePath);
 
 
         pEngineInstance->EngineStdOut(
@@ -1103,22 +2063,21 @@ void Entity::waitforPlaysound(const std::string &soundId, const std::string &exe
             return; // 컨텍스트 없이는 대기 설정 불가
         }
 
-        // setScriptWait는 ScriptThreadState를 직접 수정하므로, promise/future 설정 후에 호출
-        // SOUND_FINISH 타입으로 대기를 설정합니다.
-        // resumeSoundWaitScripts에서 completionFuture를 확인하여 스크립트를 재개합니다.
-        // waitEndTime은 SOUND_FINISH 타입에서는 직접 사용되지 않을 수 있지만,
-        // 만약 future가 타임아웃되거나 하는 경우를 대비해 사운드 길이를 넣어둘 수 있습니다.
+        if (playbackId == 0) {
+            // 재생하지 못한 소리는 기다리지 않고 바로 다음 블록으로 진행합니다.
+            return;
+        }
+
+        // SOUND_FINISH 타입으로 대기를 설정합니다. waitEndTime 은 참고용 예상 종료 시각입니다.
         double soundDuration = pEngineInstance->aeHelper.getSoundFileDuration(soundFilePath);
         Uint64 estimatedEndTime = SDL_GetTicks() + static_cast<Uint64>(soundDuration * 1000.0);
 
         setScriptWait(executionThreadId, estimatedEndTime, callingBlockId, WaitType::SOUND_FINISH, scriptToResume, sceneToResumeIn);
-
-
-        // ScriptThreadState의 completionFuture는 resumeSoundWaitScripts에서 사용됩니다.
-        // AudioEngineHelper가 사운드 완료 시 threadState.completionPromise.set_value()를 호출해야 합니다.
+        threadState.soundPlaybackId = playbackId;
+        pEngineInstance->watchSoundCompletion(weak_from_this(), executionThreadId, playbackId);
 
         pEngineInstance->EngineStdOut(
-            "Entity " + id + " (Thread: " + executionThreadId + ") waiting for sound (future set): " + soundToPlay->name
+            "Entity " + id + " (Thread: " + executionThreadId + ") waiting for sound: " + soundToPlay->name
             + " (Block: " + callingBlockId + ")", 0, executionThreadId);
     } else {
         pEngineInstance->EngineStdOut(
@@ -1155,8 +2114,9 @@ void Entity::waitforPlaysoundWithSeconds(const std::string &soundId, double seco
         } else {
             soundFilePath = string(BASE_ASSETS) + soundToPlay->fileurl;
         }
-        auto it_state = scriptThreadStates.find(executionThreadId);
-        if (it_state == scriptThreadStates.end()) {
+        std::unique_lock lock(m_stateMutex);
+        auto *pState = scriptThreadStates.find(executionThreadId);
+        if (!pState) {
             pEngineInstance->EngineStdOut(
                 "Entity " + id + " (Thread: " + executionThreadId +
                 ") - ScriptThreadState not found for waitforPlaysoundWithFromTo. Cannot set wait.", 2,
@@ -1169,10 +2129,8 @@ void Entity::waitforPlaysoundWithSeconds(const std::string &soundId, double seco
             return;
         }
 
-        ScriptThreadState &threadState = it_state->second;
-        // 새로운 promise와 future 생성
-        threadState.completionPromise = {}; // 이전 promise가 있다면 리셋
-        threadState.completionFuture = threadState.completionPromise.get_future();
+        ScriptThreadState &threadState = *pState;
+        const uint64_t playbackId = pEngineInstance->aeHelper.playSoundForDuration(this->getId(), soundFilePath, seconds);
         // 재개를 위한 컨텍스트 정보 가져오기
         const Script* scriptToResume = threadState.scriptPtrForResume;
         const std::string& sceneToResumeIn = threadState.sceneIdAtDispatchForResume;
@@ -1182,8 +2140,13 @@ void Entity::waitforPlaysoundWithSeconds(const std::string &soundId, double seco
                 "CRITICAL: Cannot set wait for waitforPlaysound. scriptPtrForResume is null for thread " + executionThreadId, 2, executionThreadId);
             return; // 컨텍스트 없이는 대기 설정 불가
         }
-        // setScriptWait는 ScriptThreadState를 직접 수정하므로, promise/future 설정 후에 호출
-        setScriptWait(executionThreadId, seconds, callingBlockId, WaitType::SOUND_FINISH, scriptToResume, sceneToResumeIn);
+        if (playbackId == 0) {
+            return; // 재생하지 못한 소리는 기다리지 않습니다.
+        }
+        Uint64 estimatedEndTime = SDL_GetTicks() + static_cast<Uint64>((std::max)(seconds, 0.0) * 1000.0);
+        setScriptWait(executionThreadId, estimatedEndTime, callingBlockId, WaitType::SOUND_FINISH, scriptToResume, sceneToResumeIn);
+        threadState.soundPlaybackId = playbackId;
+        pEngineInstance->watchSoundCompletion(weak_from_this(), executionThreadId, playbackId);
         // pEngineInstance->EngineStdOut("Entity " + id + " playing sound: " + soundToPlay->name + " (ID: " + soundId + ", Path: " + soundFilePath + ")", 0);
         pEngineInstance->EngineStdOut(
             "Entity " + id + " playing sound for " + std::to_string(seconds) + "s: " + soundToPlay->name + " (ID: " +
@@ -1198,7 +2161,7 @@ void Entity::waitforPlaysoundWithSeconds(const std::string &soundId, double seco
 void Entity::waitforPlaysoundWithFromTo(const std::string &soundId, double from, double to,
                                         const std::string &executionThreadId, const std::string &callingBlockId) {
     // m_stateMutex는 ScriptThreadState 접근 및 수정을 보호하기 위해 사용됩니다.
-    std::unique_lock<std::recursive_mutex> lock(m_stateMutex);
+    std::unique_lock lock(m_stateMutex);
 
     if (!pEngineInstance) {
         // pEngineInstance가 null인 경우 즉시 반환 (오류 로깅은 생성자 또는 초기화에서 처리)
@@ -1230,8 +2193,8 @@ void Entity::waitforPlaysoundWithFromTo(const std::string &soundId, double from,
             soundFilePath = std::string(BASE_ASSETS) + soundToPlay->fileurl;
         }
 
-        auto it_state = scriptThreadStates.find(executionThreadId);
-        if (it_state == scriptThreadStates.end()) {
+        auto *pState = scriptThreadStates.find(executionThreadId);
+        if (!pState) {
             pEngineInstance->EngineStdOut(
                 "Entity " + id + " (Thread: " + executionThreadId +
                 ") - ScriptThreadState not found for waitforPlaysoundWithFromTo. Cannot set wait.", 2,
@@ -1242,25 +2205,16 @@ void Entity::waitforPlaysoundWithFromTo(const std::string &soundId, double from,
                                           executionThreadId);
             return;
         }
-        ScriptThreadState &threadState = it_state->second;
+        ScriptThreadState &threadState = *pState;
 
-        // 새로운 promise와 future 생성
-        threadState.completionPromise = {}; // 이전 promise가 있다면 리셋
-        threadState.completionFuture = threadState.completionPromise.get_future();
-
-        // AudioEngineHelper의 playSoundFromTo 함수가 이 promise를 알고,
-        // 사운드 재생 완료 시 resolve하도록 수정되어야 합니다.
-        // 예: pEngineInstance->aeHelper.playSoundFromToAndNotifyPromise(this->getId(), soundFilePath, from, to, std::move(threadState.completionPromise));
-        // 현재는 AudioEngineHelper 수정 없이 기존 함수를 호출합니다.
-        // 이 경우 future는 자동으로 resolve되지 않으며, resumeSoundWaitScripts에서 isSoundPlaying을 폴링하거나 타임아웃에 의존해야 합니다.
-        pEngineInstance->aeHelper.playSoundFromTo(this->getId(), soundFilePath, from, to);
+        // 구간 끝에 닿으면 AudioEngineHelper 가 이 재생 ID 를 알리고, 엔진이 이 스레드만 깨웁니다.
+        const uint64_t playbackId = pEngineInstance->aeHelper.playSoundFromTo(this->getId(), soundFilePath, from, to);
 
         pEngineInstance->EngineStdOut(
             "Entity " + id + " playing sound (from " + std::to_string(from) + "s to " + std::to_string(to) + "s): " +
             soundToPlay->name + " (ID: " + soundId + ", Path: " + soundFilePath + ")", 0, executionThreadId);
 
-        // SOUND_FINISH 타입으로 대기를 설정합니다.
-        // waitEndTime은 SOUND_FINISH 타입에서는 future가 주 메커니즘이므로 참고용입니다.
+        // SOUND_FINISH 타입으로 대기를 설정합니다. waitEndTime 은 참고용 예상 종료 시각입니다.
         double durationSeconds = 0.0;
         if (to > from) {
             durationSeconds = to - from;
@@ -1285,13 +2239,15 @@ void Entity::waitforPlaysoundWithFromTo(const std::string &soundId, double from,
                 "CRITICAL: Cannot set wait for waitforPlaysoundWithFromTo. scriptPtrForResume is null for thread " + executionThreadId, 2, executionThreadId);
             return;
         }
-        // setScriptWait는 ScriptThreadState를 직접 수정하므로, promise/future 설정 후에 호출합니다.
+        if (playbackId == 0) {
+            return; // 재생하지 못한 소리는 기다리지 않습니다.
+        }
         setScriptWait(executionThreadId, estimatedEndTime, callingBlockId, WaitType::SOUND_FINISH, scriptToResume, sceneToResumeIn);
-        // ScriptThreadState의 completionFuture는 resumeSoundWaitScripts에서 사용됩니다.
-        // AudioEngineHelper가 사운드 완료 시 threadState.completionPromise.set_value()를 호출해야 합니다.
+        threadState.soundPlaybackId = playbackId;
+        pEngineInstance->watchSoundCompletion(weak_from_this(), executionThreadId, playbackId);
 
         pEngineInstance->EngineStdOut(
-            "Entity " + id + " (Thread: " + executionThreadId + ") waiting for sound (from-to, future set): " +
+            "Entity " + id + " (Thread: " + executionThreadId + ") waiting for sound (from-to): " +
             soundToPlay->name + " (Block: " + callingBlockId + ")", 0, executionThreadId);
     } else {
         pEngineInstance->EngineStdOut(
@@ -1302,9 +2258,9 @@ void Entity::waitforPlaysoundWithFromTo(const std::string &soundId, double from,
 
 void Entity::terminateScriptThread(const std::string &threadId) {
     std::lock_guard lock(m_stateMutex);
-    auto it = scriptThreadStates.find(threadId);
-    if (it != scriptThreadStates.end()) {
-        it->second.terminateRequested = true;
+    auto *pState = scriptThreadStates.find(threadId);
+    if (pState) {
+        pState->terminateRequested = true;
         if (pEngineInstance) {
             // Check pEngineInstance before using
             pEngineInstance->EngineStdOut("Entity " + id + " marked script thread " + threadId + " for termination.", 0,
@@ -1322,16 +2278,16 @@ void Entity::terminateScriptThread(const std::string &threadId) {
 void Entity::terminateAllScriptThread(const std::string &exceptThreadId) {
     std::lock_guard lock(m_stateMutex);
     int markedCount = 0;
-    for (auto &pair: scriptThreadStates) {
-        if (exceptThreadId.empty() || pair.first != exceptThreadId) {
-            if (!pair.second.terminateRequested) {
+    for (auto &thread: scriptThreadStates) {
+        if (exceptThreadId.empty() || thread.id != exceptThreadId) {
+            if (!thread.state.terminateRequested) {
                 // Only mark if not already marked
-                pair.second.terminateRequested = true;
+                thread.state.terminateRequested = true;
                 markedCount++;
                 if (pEngineInstance) {
                     pEngineInstance->EngineStdOut(
-                        "Entity " + id + " marked script thread " + pair.first + " for termination (all/other).", 0,
-                        pair.first);
+                        "Entity " + id + " marked script thread " + thread.id + " for termination (all/other).", 0,
+                        thread.id);
                 }
             }
         }
@@ -1344,7 +2300,7 @@ void Entity::terminateAllScriptThread(const std::string &exceptThreadId) {
     }
 }
 
-void Entity::processInternalContinuations(float deltaTime) {
+void Entity::resumeInternalContinuation(const std::string &executionThreadId, Uint64 wakeTime, float deltaTime) {
     if (!pEngineInstance || pEngineInstance->m_isShuttingDown.load(std::memory_order_relaxed)) {
         return;
     }
@@ -1356,277 +2312,252 @@ void Entity::processInternalContinuations(float deltaTime) {
         std::string sceneIdForRun;
     };
 
-    // Helper lambda to truncate strings safely, defined once
-    auto truncate_string = [](const std::string &str, size_t max_len) {
-        if (str.length() > max_len) {
-            return str.substr(0, max_len) + "...(truncated)";
+    std::optional<ScriptTaskDetails> taskToRun; {
+        std::lock_guard lock(m_stateMutex);
+        ScriptThreadState *pState = scriptThreadStates.find(executionThreadId);
+        // 그 사이 재개되었거나 다른 대기를 건 스레드의 지난 예약은 무시합니다.
+        if (!pState || !pState->isWaiting || pState->currentWaitType != WaitType::BLOCK_INTERNAL ||
+            pState->waitEndTime != wakeTime) {
+            return;
         }
-        return str;
-    };
+        const std::string &execId = executionThreadId;
+        ScriptThreadState &state = *pState;
 
-    std::vector<ScriptTaskDetails> tasksToRunInline; {
-        std::lock_guard lock(m_stateMutex);
-        for (auto it_state = scriptThreadStates.begin(); it_state != scriptThreadStates.end(); /* manual increment */) {
-            auto &execId = it_state->first;
-            auto &state = it_state->second;
+        if (state.scriptPtrForResume && state.scriptPtrForResume->program && state.resumeAtBlockIndex == -1) {
+            // VM 이 양보를 건 뒤 아직 멈추기 전입니다. 다음 프레임에 다시 확인합니다.
+            pEngineInstance->scheduleScriptWake(weak_from_this(), execId, wakeTime, WaitType::BLOCK_INTERNAL);
+            return;
+        }
 
-            if (state.isWaiting && state.currentWaitType == WaitType::BLOCK_INTERNAL) {
-                const ObjectInfo *objInfoCheck = pEngineInstance->getObjectInfoById(this->getId());
-                bool isGlobal = (objInfoCheck && (objInfoCheck->sceneId == "global" || objInfoCheck->sceneId.empty()));
-                std::string engineCurrentScene = pEngineInstance->getCurrentSceneId();
-                const std::string &scriptSceneContext = state.sceneIdAtDispatchForResume;
+        const ObjectInfo *objInfoCheck = pEngineInstance->getObjectInfoById(this->getId());
+        bool isGlobal = (objInfoCheck && (objInfoCheck->sceneId == "global" || objInfoCheck->sceneId.empty()));
+        std::string engineCurrentScene = pEngineInstance->getCurrentSceneId();
+        const std::string &scriptSceneContext = state.sceneIdAtDispatchForResume;
 
-                bool canResume = false;
+        bool canResume = false;
 
-                if (state.waitEndTime > 0 && SDL_GetTicks() < state.waitEndTime) {
-                    ++it_state;
-                    continue; // 아직 대기 시간이므로 재개하지 않음
-                }
-                // 대기 시간이 지났거나, 원래 시간 제한이 없는 BLOCK_INTERNAL 대기였다면, waitEndTime을 초기화합니다.
-                if (state.waitEndTime > 0) {
-                    if (pEngineInstance) {
-                        pEngineInstance->EngineStdOut(
-                            "Entity " + getId() + " script thread " + execId +
-                            " BLOCK_INTERNAL finished inherited wait. Original inner wait on: " + state.
-                            originalInnerBlockIdForWait,
-                            3, execId);
-                    }
-                    state.waitEndTime = 0; // 이 특정 시간 제한 대기는 완료되었으므로 초기화
-                }
+        // 대기 시간이 지났거나, 원래 시간 제한이 없는 BLOCK_INTERNAL 대기였다면, waitEndTime을 초기화합니다.
+        if (state.waitEndTime > 0) {
+            pEngineInstance->EngineStdOut(
+                "Entity " + getId() + " script thread " + execId +
+                " BLOCK_INTERNAL finished inherited wait. Original inner wait on: " + state.
+                originalInnerBlockIdForWait,
+                3, execId);
+            state.waitEndTime = 0; // 이 특정 시간 제한 대기는 완료되었으므로 초기화
+        }
 
-                if (!state.scriptPtrForResume) {
-                    // 스크립트 포인터가 유효하지 않으면 재개 불가
-                    canResume = false;
-                    if (pEngineInstance) {
-                        // pEngineInstance null check before use
-                        pEngineInstance->EngineStdOut(
-                            "WARNING: Entity " + getId() + " script thread " + execId +
-                            " is BLOCK_INTERNAL wait but scriptPtrForResume is null. Clearing wait.", 1, execId);
-                    }
-                } else if (isGlobal) {
-                    canResume = true;
-                } else {
-                    // Not global
-                    canResume = objInfoCheck &&
-                                objInfoCheck->sceneId == scriptSceneContext &&
-                                engineCurrentScene == scriptSceneContext;
-                }
+        if (!state.scriptPtrForResume) {
+            // 스크립트 포인터가 유효하지 않으면 재개 불가
+            canResume = false;
+            pEngineInstance->EngineStdOut(
+                "WARNING: Entity " + getId() + " script thread " + execId +
+                " is BLOCK_INTERNAL wait but scriptPtrForResume is null. Clearing wait.", 1, execId);
+        } else if (isGlobal) {
+            canResume = true;
+        } else {
+            // Not global
+            canResume = objInfoCheck &&
+                        objInfoCheck->sceneId == scriptSceneContext &&
+                        engineCurrentScene == scriptSceneContext;
+        }
 
-                if (canResume) {
-                    tasksToRunInline.emplace_back(ScriptTaskDetails{
-                        execId, state.scriptPtrForResume, scriptSceneContext
-                    });
-                    // tasksToRunInline에 추가했으므로, 여기서는 isWaiting을 false로 바꾸지 않습니다.
-                    // executeScript가 호출될 때 isWaiting이 false로 설정됩니다.
-                    // 만약 executeScript가 BLOCK_INTERNAL을 다시 설정하면 다음 틱에 다시 처리됩니다.
-                    ++it_state;
-                } else {
-                    // 재개할 수 없는 경우, 대기 상태를 해제하여 무한 루프 방지
-                    if (state.scriptPtrForResume && pEngineInstance) {
-                        // pEngineInstance null check
-                        // 로그는 스크립트 포인터가 있을 때만 의미 있음
-                        pEngineInstance->EngineStdOut(
-                            "Internal continuation for " + getId() + " (Thread: " + execId +
-                            ") cancelled. Scene/Context mismatch or invalid script. EntityScene: " + (
-                                objInfoCheck ? objInfoCheck->sceneId : "N/A") + ", ScriptDispatchScene: " +
-                            scriptSceneContext + ", EngineCurrentScene: " + engineCurrentScene, 1, execId);
-                    }
-                    state.isWaiting = false;
-                    state.currentWaitType = WaitType::NONE;
-                    state.scriptPtrForResume = nullptr;
-                    state.sceneIdAtDispatchForResume = "";
-                    state.waitEndTime = 0; // 여기서도 waitEndTime 초기화
-                    state.originalInnerBlockIdForWait = ""; // 관련 정보 초기화
-                    state.resumeAtBlockIndex = -1;
-                    ++it_state;
-                }
-            } else {
-                ++it_state;
+        if (canResume) {
+            // isWaiting 은 executeScript 가 호출될 때 false 로 설정됩니다.
+            // 만약 executeScript 가 BLOCK_INTERNAL 을 다시 설정하면 다음 틱에 다시 예약됩니다.
+            taskToRun = ScriptTaskDetails{execId, state.scriptPtrForResume, scriptSceneContext};
+        } else {
+            // 재개할 수 없는 경우, 대기 상태를 해제하여 무한 루프 방지
+            if (state.scriptPtrForResume) {
+                // 로그는 스크립트 포인터가 있을 때만 의미 있음
+                pEngineInstance->EngineStdOut(
+                    "Internal continuation for " + getId() + " (Thread: " + execId +
+                    ") cancelled. Scene/Context mismatch or invalid script. EntityScene: " + (
+                        objInfoCheck ? objInfoCheck->sceneId : "N/A") + ", ScriptDispatchScene: " +
+                    scriptSceneContext + ", EngineCurrentScene: " + engineCurrentScene, 1, execId);
             }
+            state.isWaiting = false;
+            state.currentWaitType = WaitType::NONE;
+            state.scriptPtrForResume = nullptr;
+            state.sceneIdAtDispatchForResume = "";
+            state.waitEndTime = 0; // 여기서도 waitEndTime 초기화
+            state.originalInnerBlockIdForWait = ""; // 관련 정보 초기화
+            state.resumeAtBlockIndex = -1;
         }
     } // Mutex scope ends
 
-    // 수집된 작업을 현재 스레드에서 직접 실행
-    for (const auto &task: tasksToRunInline) {
-        // pEngineInstance->EngineStdOut("Executing internal continuation for entity: " + getId() + " (Thread: " + task.execId + ")", 5, task.execId);
-
-        try {
-            this->executeScript(task.scriptPtr, task.execId, task.sceneIdForRun, deltaTime);
-        } catch (const ScriptBlockExecutionError &sbee) {
-            Entity *entitiyInfo = pEngineInstance->getEntityById(sbee.entityId);
-            Omocha::BlockTypeEnum blockTypeEnum = Omocha::stringToBlockTypeEnum(sbee.blockType);
-            std::string koreanBlockTypeName = Omocha::blockTypeEnumToKoreanString(blockTypeEnum);
+    // 다른 재개와 마찬가지로 이번 프레임 틱 배치에 넣어 작업자에서 실행합니다.
+    if (taskToRun) {
+        this->scheduleScriptExecutionOnPool(taskToRun->scriptPtr, taskToRun->sceneIdForRun, deltaTime,
+                                            taskToRun->execId);
+    }
+}
 
-            const size_t MAX_ID_LEN = 128;
-            const size_t MAX_MSG_LEN = 512;
-            const size_t MAX_NAME_LEN = 256;
+void Entity::resumeExplicitWait(const std::string &executionThreadId, Uint64 wakeTime, float deltaTime) {
+    if (!pEngineInstance || pEngineInstance->m_isShuttingDown.load(std::memory_order_relaxed)) {
+        return;
+    }
 
-            std::string entityNameStr = "[정보 없음]";
-            if (entitiyInfo) {
-                entityNameStr = truncate_string(entitiyInfo->getName(), MAX_NAME_LEN);
-            } else {
-                entityNameStr = "[객체 ID: " + truncate_string(sbee.entityId, MAX_ID_LEN) + " 찾을 수 없음]";
-            }
+    ScriptTask task{}; {
+        std::lock_guard lock(m_stateMutex);
+        ScriptThreadState *pState = scriptThreadStates.find(executionThreadId);
+        // 그 사이 재개되었거나 다른 대기를 건 스레드의 지난 예약은 무시합니다.
+        if (!pState || !pState->isWaiting || pState->currentWaitType != WaitType::EXPLICIT_WAIT_SECOND ||
+            pState->waitEndTime != wakeTime) {
+            return;
+        }
+        const std::string &execId = executionThreadId;
+        ScriptThreadState &state = *pState;
 
-            std::string detailedErrorMessage = "블럭 을 실행하는데 오류가 발생하였습니다. 블럭ID " + truncate_string(
-                                                   sbee.blockId, MAX_ID_LEN) +
-                                               " 의 타입 " + truncate_string(koreanBlockTypeName, MAX_ID_LEN) +
-                                               (blockTypeEnum == Omocha::BlockTypeEnum::UNKNOWN && !sbee.blockType.
-                                                empty()
-                                                    ? " (원본: " + truncate_string(sbee.blockType, MAX_ID_LEN) + ")"
-                                                    : "") +
-                                               " 에서 사용 하는 객체 " + "(" + entityNameStr + ")" +
-                                               "\n원본 오류: " + truncate_string(sbee.originalMessage, MAX_MSG_LEN);
+        if (state.scriptPtrForResume && state.scriptPtrForResume->program && state.resumeAtBlockIndex == -1) {
+            // VM 이 대기를 건 뒤 아직 멈추기 전입니다. (0초 기다리기) 다음 프레임에 다시 확인합니다.
+            pEngineInstance->scheduleScriptWake(weak_from_this(), execId, wakeTime, WaitType::EXPLICIT_WAIT_SECOND);
+            return;
+        }
 
-            pEngineInstance->EngineStdOut(
-                "Script Execution Error (InternalContinuation, Thread " + task.execId + "): " + detailedErrorMessage, 2,
-                task.execId);
-            if (pEngineInstance->showMessageBox("블럭 처리 오류\n" + detailedErrorMessage,
-                                                pEngineInstance->msgBoxIconType.ICON_ERROR)) {
-                exit(EXIT_FAILURE);
-            }
+        // 대기 시간 종료됨
+        if (!state.scriptPtrForResume || state.resumeAtBlockIndex == -1) {
+            std::ostringstream oss;
+            oss << "WARNING: Entity " << id << " script thread " << execId
+                    << " EXPLICIT_WAIT_SECOND finished but missing resume context. Clearing wait.";
+            pEngineInstance->EngineStdOut(oss.str(), 1, execId);
+
+            // 재개 컨텍스트가 없어 대기를 취소하는 경우, 관련 상태 명시적 초기화
+            state.isWaiting = false;
+            state.waitEndTime = 0;
+            state.currentWaitType = WaitType::NONE;
+            state.scriptPtrForResume = nullptr;
+            state.sceneIdAtDispatchForResume.clear(); // std::string은 clear() 사용
+            state.resumeAtBlockIndex = -1;
+            // blockIdForWait는 원본 로직에 따라 여기서 초기화하지 않음
+            return;
         }
-        catch (const std::exception &e) {
-            const size_t MAX_ID_LEN = 128;
-            const size_t MAX_MSG_LEN = 512;
 
-            std::string entityIdStr = truncate_string(getId(), MAX_ID_LEN);
-            std::string threadIdStr = truncate_string(task.execId, MAX_ID_LEN);
-            std::string exceptionWhatStr = truncate_string(e.what(), MAX_MSG_LEN);
+        std::ostringstream oss;
+        oss << "Entity " << id << " (Thread: " << execId
+                << ") finished EXPLICIT_WAIT_SECOND for block " << state.blockIdForWait
+                << ". Resuming.";
+        pEngineInstance->EngineStdOut(oss.str(), 0, execId);
 
-            std::string detailedErrorMessage = "Generic exception caught in internal continuation for entity " +
-                                               entityIdStr +
-                                               " (Thread: " + threadIdStr + "): " + exceptionWhatStr;
+        task = ScriptTask{execId, state.scriptPtrForResume, state.sceneIdAtDispatchForResume, state.resumeAtBlockIndex};
 
-            pEngineInstance->EngineStdOut(detailedErrorMessage, 2, task.execId);
-        }
-        catch (...) {
-            pEngineInstance->EngineStdOut(
-                "Unknown exception caught in internal continuation for entity " + getId() +
-                " (Thread: " + task.execId + ")",
-                2, task.execId);
-        }
+        // 성공적으로 재개 준비가 된 스크립트의 상태 초기화
+        state.isWaiting = false;
+        state.waitEndTime = 0;
+        state.currentWaitType = WaitType::NONE;
+        // blockIdForWait, scriptPtrForResume 등은 디스패치된 태스크에서 사용되거나
+        // executeScript에 의해 재설정될 것이므로 여기서는 초기화하지 않음 (원본 로직 유지)
     }
+
+    // scheduleScriptExecutionOnPool 호출 시 execId를 전달하여
+    // 해당 스레드의 상태(예: resumeAtBlockIndex)가 executeScript 내에서 설정될 것을 기대
+    this->scheduleScriptExecutionOnPool(task.script, task.sceneId, deltaTime, task.execId);
 }
 
-// 수정된 함수
-void Entity::resumeExplicitWaitScripts(float deltaTime) {
+void Entity::resumeSoundWait(const std::string &executionThreadId, uint64_t playbackId, float deltaTime) {
     if (!pEngineInstance || pEngineInstance->m_isShuttingDown.load(std::memory_order_relaxed)) {
         return;
     }
 
-    std::vector<ScriptTask> tasksToDispatch; {
+    ScriptTask task{}; {
         std::lock_guard lock(m_stateMutex);
-        // 반복자 증가를 루프 선언부로 옮겨 가독성 및 안정성 향상
-        for (auto it = scriptThreadStates.begin(); it != scriptThreadStates.end(); ++it) {
-            auto &execId = it->first;
-            auto &state = it->second;
-
-            // EXPLICIT_WAIT_SECOND 상태가 아니거나 아직 대기 중이면 다음 스레드로 넘어감
-            if (!state.isWaiting || state.currentWaitType != WaitType::EXPLICIT_WAIT_SECOND) {
-                continue;
-            }
-            if (SDL_GetTicks() < state.waitEndTime) {
-                continue; // 아직 대기 시간 남음
-            }
+        ScriptThreadState *pState = scriptThreadStates.find(executionThreadId);
+        // 그 사이 재개되었거나 다른 소리를 기다리는 스레드의 지난 알림은 무시합니다.
+        if (!pState || !pState->isWaiting || pState->currentWaitType != WaitType::SOUND_FINISH ||
+            pState->soundPlaybackId != playbackId) {
+            return;
+        }
+        const std::string &execId = executionThreadId;
+        ScriptThreadState &state = *pState;
 
-            // 대기 시간 종료됨
-            if (state.scriptPtrForResume && state.resumeAtBlockIndex != -1) {
-                // 로그 메시지 구성 시 std::ostringstream 사용으로 효율성 증대
-                std::ostringstream oss;
-                oss << "Entity " << id << " (Thread: " << execId
-                        << ") finished EXPLICIT_WAIT_SECOND for block " << state.blockIdForWait
-                        << ". Resuming.";
-                pEngineInstance->EngineStdOut(oss.str(), 0, execId);
-
-                tasksToDispatch.emplace_back(ScriptTask{
-                    execId, state.scriptPtrForResume, state.sceneIdAtDispatchForResume, state.resumeAtBlockIndex
-                });
-
-                // 성공적으로 재개 준비가 된 스크립트의 상태 초기화
-                state.isWaiting = false;
-                state.waitEndTime = 0;
-                state.currentWaitType = WaitType::NONE;
-                // blockIdForWait, scriptPtrForResume 등은 디스패치된 태스크에서 사용되거나
-                // executeScript에 의해 재설정될 것이므로 여기서는 초기화하지 않음 (원본 로직 유지)
-            } else {
-                std::ostringstream oss;
-                oss << "WARNING: Entity " << id << " script thread " << execId
-                        << " EXPLICIT_WAIT_SECOND finished but missing resume context. Clearing wait.";
-                pEngineInstance->EngineStdOut(oss.str(), 1, execId);
-
-                // 재개 컨텍스트가 없어 대기를 취소하는 경우, 관련 상태 명시적 초기화
-                state.isWaiting = false;
-                state.waitEndTime = 0; // 원본 코드에서 누락되었던 부분 추가
-                state.currentWaitType = WaitType::NONE;
-                state.scriptPtrForResume = nullptr;
-                state.sceneIdAtDispatchForResume.clear(); // std::string은 clear() 사용
-                state.resumeAtBlockIndex = -1;
-                // blockIdForWait는 원본 로직에 따라 여기서 초기화하지 않음
-            }
+        if (state.scriptPtrForResume && state.scriptPtrForResume->program && state.resumeAtBlockIndex == -1) {
+            // VM 이 대기를 건 뒤 아직 멈추기 전입니다. 다음 프레임에 다시 확인합니다.
+            pEngineInstance->watchSoundCompletion(weak_from_this(), execId, playbackId, true);
+            return;
+        }
+
+        if (!state.scriptPtrForResume || state.resumeAtBlockIndex == -1) {
+            pEngineInstance->EngineStdOut(
+                "WARNING: Entity " + id + " script thread " + execId +
+                " SOUND_FINISH finished but missing resume context. Clearing wait.", 1, execId);
+            state.isWaiting = false;
+            state.waitEndTime = 0;
+            state.currentWaitType = WaitType::NONE;
+            state.soundPlaybackId = 0;
+            return;
         }
-    }
 
-    for (const auto &task: tasksToDispatch) {
-        // scheduleScriptExecutionOnPool 호출 시 execId를 전달하여
-        // 해당 스레드의 상태(예: resumeAtBlockIndex)가 executeScript 내에서 설정될 것을 기대
-        this->scheduleScriptExecutionOnPool(task.script, task.sceneId, deltaTime, task.execId);
+        pEngineInstance->EngineStdOut(
+            "Entity " + id + " (Thread: " + execId + ") finished SOUND_FINISH for block " + state.blockIdForWait +
+            ". Resuming.", 0, execId);
+        task = ScriptTask{execId, state.scriptPtrForResume, state.sceneIdAtDispatchForResume, state.resumeAtBlockIndex};
+
+        state.isWaiting = false;
+        state.waitEndTime = 0;
+        state.currentWaitType = WaitType::NONE;
+        state.soundPlaybackId = 0;
+        // blockIdForWait, scriptPtrForResume 등은 디스패치된 태스크에서 사용되거나 executeScript에 의해 재설정됩니다.
     }
+
+    this->scheduleScriptExecutionOnPool(task.script, task.sceneId, deltaTime, task.execId);
 }
 
-void Entity::resumeSoundWaitScripts(float deltaTime) {
-    if (!pEngineInstance || pEngineInstance->m_isShuttingDown.load(std::memory_order_relaxed)) {
-        return;
+int64_t Entity::grantScriptQuantum(const std::string &executionThreadId, int64_t quantumNs) {
+    std::lock_guard lock(m_stateMutex);
+    ScriptThreadState *pState = scriptThreadStates.find(executionThreadId);
+    if (!pState) {
+        return quantumNs;
+    }
+    const int64_t allowance = pState->cpuDeficitNs + quantumNs;
+    if (allowance <= 0) {
+        pState->cpuDeficitNs = allowance; // 이번 프레임의 할당량으로 빚을 갚고 건너뜁니다.
     }
+    return allowance;
+}
 
-    std::vector<std::tuple<std::string, const Script *, std::string, int> > tasksToDispatch;
-    // execId, script, sceneId, resumeIndex
+void Entity::accountScriptTick(const std::string &executionThreadId, uint64_t frameIndex, Uint64 elapsedNs,
+                               int64_t allowanceNs) {
+    std::lock_guard lock(m_stateMutex);
+    if (m_cpuUsage.frameIndex != frameIndex) {
+        m_cpuUsage.frameIndex = frameIndex;
+        m_cpuUsage.frameNs = 0;
+    }
+    m_cpuUsage.frameNs += elapsedNs;
+    m_cpuUsage.totalNs += elapsedNs;
+    ScriptThreadState *pState = scriptThreadStates.find(executionThreadId);
+    if (!pState) {
+        return; // 이번 틱에 끝난 스레드
+    }
+    pState->cpuLastTickNs = elapsedNs;
+    pState->cpuTotalNs += elapsedNs;
+    // 남은 시간은 쌓지 않고 넘긴 시간만 빚으로 남깁니다. (양보한 스레드는 다음 프레임에 새 할당량으로 시작)
+    // 한 번 오래 막힌 블록 때문에 스레드가 너무 오래 멈추지 않도록 빚은 kMaxDebtNs 까지만 남깁니다.
+    constexpr int64_t kMaxDebtNs = 100'000'000;
+    pState->cpuDeficitNs = std::clamp(allowanceNs - static_cast<int64_t>(elapsedNs), -kMaxDebtNs,
+                                      static_cast<int64_t>(0));
+}
+
+Entity::CpuUsage Entity::getCpuUsage() const {
+    std::lock_guard lock(m_stateMutex);
+    return m_cpuUsage;
+}
 
-    {
-        std::lock_guard lock(m_stateMutex);
-        for (auto it = scriptThreadStates.begin(); it != scriptThreadStates.end(); /* no increment here */) {
-            auto &execId = it->first;
-            auto &state = it->second;
-
-            if (state.isWaiting && state.currentWaitType == WaitType::SOUND_FINISH) {
-                // Check if the sound associated with this entity (and potentially this specific wait) has finished.
-                // AudioEngineHelper::isSoundPlaying(this->getId()) checks if *any* sound for this entity is playing.
-                // For more precise control, you might need to store a specific sound handle/ID in ScriptThreadState.
-                if (!pEngineInstance->aeHelper.isSoundPlaying(this->getId())) {
-                    if (state.scriptPtrForResume && state.resumeAtBlockIndex != -1) {
-                        pEngineInstance->EngineStdOut(
-                            "Entity " + id + " (Thread: " + execId + ") finished SOUND_FINISH for block " + state.
-                            blockIdForWait + ". Resuming.", 0, execId);
-                        tasksToDispatch.emplace_back(execId, state.scriptPtrForResume, state.sceneIdAtDispatchForResume,
-                                                     state.resumeAtBlockIndex);
-
-                        state.isWaiting = false;
-                        state.currentWaitType = WaitType::NONE;
-                        // blockIdForWait, scriptPtrForResume, etc., will be used by the dispatched task or reset by executeScript.
-                        ++it;
-                    } else {
-                        pEngineInstance->EngineStdOut(
-                            "WARNING: Entity " + id + " script thread " + execId +
-                            " SOUND_FINISH finished but missing resume context. Clearing wait.", 1, execId);
-                        state.isWaiting = false;
-                        state.currentWaitType = WaitType::NONE;
-                        // Clear other relevant state fields
-                        ++it;
-                    }
-                } else {
-                    ++it; // Still waiting for sound to finish
-                }
-            } else {
-                ++it;
-            }
-        }
+std::string Entity::createScriptThread(const Script *scriptPtr) {
+    // 새 스크립트의 경우, 실행할 블록이 있는지 확인합니다.
+    // (첫 번째 블록은 보통 이벤트 트리거이므로, 1개 초과여야 실행 가능)
+    if (scriptPtr->blocks.size() <= 1) {
+        pEngineInstance->EngineStdOut(
+            "Entity::createScriptThread - Script for entity " + this->id + " has no executable blocks. Skipping.", 1);
+        return {};
     }
-
-    for (const auto &task: tasksToDispatch) {
-        const std::string &execId = std::get<0>(task);
-        // Reschedule the script execution.
-        this->scheduleScriptExecutionOnPool(std::get<1>(task), std::get<2>(task), deltaTime, execId);
+    // 새 스크립트는 엔진 슬랩에 스레드 상태를 할당하고, 그 핸들을 적은 문자열을 실행 ID 로 사용합니다.
+    std::lock_guard lock(m_stateMutex);
+    ScriptThreadSlot *slot = scriptThreadStates.create();
+    if (!slot) {
+        pEngineInstance->EngineStdOut(
+            "Entity::createScriptThread - too many live script threads. Skipping script for entity: " + this->id, 2);
+        return {};
     }
+    return slot->id;
 }
 
 void Entity::scheduleScriptExecutionOnPool(const Script *scriptPtr,
@@ -1650,114 +2581,94 @@ void Entity::scheduleScriptExecutionOnPool(const Script *scriptPtr,
         return;
     }
 
-    // 새 스크립트의 경우, 실행할 블록이 있는지 확인합니다.
-    // (첫 번째 블록은 보통 이벤트 트리거이므로, 1개 초과여야 실행 가능)
-    if (existingExecutionThreadId.empty() && (scriptPtr->blocks.empty() || scriptPtr->blocks.size() <= 1)) {
-        pEngineInstance->EngineStdOut(
-            "Entity::scheduleScriptExecutionOnPool - Script for entity " + this->id +
-            " has no executable blocks. Skipping.", 1, existingExecutionThreadId);
-        return;
-    }
-
     std::string execIdToUse;
     bool isResumedScript = !existingExecutionThreadId.empty();
 
     if (isResumedScript) {
         execIdToUse = existingExecutionThreadId;
     } else {
-        // 새 스크립트 실행을 위한 ID 생성
-        // 이전 Engine::dispatchScriptForExecution의 ID 생성 로직을 따르되, Engine의 카운터를 추가하여 고유성을 강화합니다.
-        // 참고: 이 ID 생성 방식은 호출 스레드의 ID 해시를 사용하므로, 동시에 여러 스크립트가 시작될 경우 완벽한 고유성을 보장하지 않을 수 있습니다.
-        // 더 강력한 고유 ID가 필요하다면 UUID 등의 사용을 고려해야 합니다.
-        std::thread::id physical_thread_id = std::this_thread::get_id();
-        std::stringstream ss_full_hex;
-        ss_full_hex << std::hex << std::hash<std::thread::id>{}(physical_thread_id);
-        std::string full_hex_str = ss_full_hex.str();
-        std::string short_hex_str;
-
-        if (full_hex_str.length() >= 4) {
-            short_hex_str = full_hex_str.substr(0, 4);
-        } else {
-            short_hex_str = std::string(4 - full_hex_str.length(), '0') + full_hex_str;
+        execIdToUse = createScriptThread(scriptPtr);
+        if (execIdToUse.empty()) {
+            return;
         }
-        // Engine의 카운터를 사용하여 ID의 고유성을 더욱 강화합니다.
-        execIdToUse = "script_" + short_hex_str + "_" +
-                      std::to_string(pEngineInstance->getNextScriptExecutionCounter());
     }
 
-    // 스레드 풀에 작업을 게시합니다.
-    // 람다 함수는 필요한 변수들을 캡처합니다. pEngineInstance는 this를 통해 접근 가능합니다.
-    pEngineInstance->submitTask(
-        [self = shared_from_this(), scriptPtr, sceneIdAtDispatch, deltaTime, execIdToUse, isResumedScript]() {
-            if (self->pEngineInstance->m_isShuttingDown.load(std::memory_order_relaxed)) {
-                return;
-            }
+    // 이번 프레임 틱 배치에 넣습니다. 메인 루프의 Engine::runScriptFrame 이 렌더링 전에 작업자에서 모두 실행합니다.
+    pEngineInstance->enqueueScriptTick(shared_from_this(), scriptPtr, sceneIdAtDispatch, execIdToUse, deltaTime,
+                                       isResumedScript);
+}
 
-            // 스크립트 시작 또는 재개 로깅
-            if (isResumedScript) {
-                self->pEngineInstance->EngineStdOut(
-                    "Entity " + self->getId() + " resuming script (Thread: " + execIdToUse + ")", 5, execIdToUse);
-            } else {
-                self->pEngineInstance->EngineStdOut(
-                    "Entity " + self->getId() + " starting new script (Thread: " + execIdToUse + ")", 5, execIdToUse);
-            }
+void Entity::runScriptTick(const Script *scriptPtr, const std::string &executionThreadId,
+                           const std::string &sceneIdAtDispatch, float deltaTime, bool isResumed) {
+    if (pEngineInstance->m_isShuttingDown.load(std::memory_order_relaxed)) {
+        return;
+    }
 
-            try {
-                // 실제 스크립트 실행
-                self->executeScript(scriptPtr, execIdToUse, sceneIdAtDispatch, deltaTime);
-            } catch (const ScriptBlockExecutionError &sbee) {
-                Entity *entity = self->pEngineInstance->getEntityById(sbee.entityId);
-                // Handle script block execution errors
-                Omocha::BlockTypeEnum blockTypeEnum = Omocha::stringToBlockTypeEnum(sbee.blockType);
-                std::string koreanBlockTypeName = Omocha::blockTypeEnumToKoreanString(blockTypeEnum);
-                // Configure error message (sbee.entityId could be the entity referenced by the block where the error occurred,
-                // so explicitly stating self->id for the entity executing the script might be clearer.)
-                std::string detailedErrorMessage = "블록 을 실행하는데 오류가 발생하였습니다.\n(스크립트 소유 객체: " + self->getId() +
-                                                   " 블록ID: " + sbee.blockId +
-                                                   ") 의 타입 (" + koreanBlockTypeName + ")" +
-                                                   (blockTypeEnum == Omocha::BlockTypeEnum::UNKNOWN && !sbee.blockType.
-                                                    empty()
-                                                        ? " (원본: " + sbee.blockType + ")"
-                                                        : "") +
-                                                   " 에서 사용 하는 객체 (" + entity->getName() +
-                                                   // Object ID directly referenced by the error block
-                                                   ")\n원본 오류: " + sbee.originalMessage;
-
-                // EngineStdOut은 이미 상세 메시지를 포함하므로, 여기서는 요약된 메시지 또는 상세 메시지 그대로 사용
-                self->pEngineInstance->EngineStdOut(
-                    "Script Execution Error (Entity: " + self->getId() + ", Thread " + execIdToUse + "): " +
-                    detailedErrorMessage, 2, execIdToUse);
-                self->pEngineInstance->showMessageBox(detailedErrorMessage,
-                                                      self->pEngineInstance->msgBoxIconType.ICON_ERROR);
-                exit(EXIT_FAILURE); // 프로그램 종료
-            }
-            catch (const std::length_error &le) {
-                // Specifically catch std::length_error
-                self->pEngineInstance->EngineStdOut(
-                    "std::length_error caught in script for entity " + self->getId() +
-                    " (Thread: " + execIdToUse + "): " + le.what(),
-                    2, execIdToUse);
-                // Optionally, show a message box or perform other error handling
-                // self->pEngineInstance->showMessageBox("문자열 처리 중 오류가 발생했습니다: " + std::string(le.what()), self->pEngineInstance->msgBoxIconType.ICON_ERROR);
-            }
-            catch (const std::exception &e) {
-                // Handle general C++ exceptions
-                self->pEngineInstance->EngineStdOut(
-                    "Generic exception caught in script for entity " + self->getId() +
-                    " (Thread: " + execIdToUse + "): " + e.what(),
-                    2, execIdToUse);
-            }
-            catch (...) {
-                // Handle other unknown exceptions
-                self->pEngineInstance->EngineStdOut(
-                    "Unknown exception caught in script for entity " + self->getId() +
-                    " (Thread: " + execIdToUse + ")",
-                    2, execIdToUse);
-            }
-        });
+    // 스크립트 시작 또는 재개 로깅
+    if (isResumed) {
+        pEngineInstance->EngineStdOut(
+            "Entity " + getId() + " resuming script (Thread: " + executionThreadId + ")", 5, executionThreadId);
+    } else {
+        pEngineInstance->EngineStdOut(
+            "Entity " + getId() + " starting new script (Thread: " + executionThreadId + ")", 5, executionThreadId);
+    }
+
+    try {
+        // 실제 스크립트 실행
+        executeScript(scriptPtr, executionThreadId, sceneIdAtDispatch, deltaTime);
+    } catch (const ScriptBlockExecutionError &sbee) {
+        Entity *entity = pEngineInstance->getEntityById(sbee.entityId);
+        // Handle script block execution errors
+        Omocha::BlockTypeEnum blockTypeEnum = Omocha::stringToBlockTypeEnum(sbee.blockType);
+        std::string koreanBlockTypeName = Omocha::blockTypeEnumToKoreanString(blockTypeEnum);
+        // Configure error message (sbee.entityId could be the entity referenced by the block where the error occurred,
+        // so explicitly stating this->id for the entity executing the script might be clearer.)
+        std::string detailedErrorMessage = "블록 을 실행하는데 오류가 발생하였습니다.\n(스크립트 소유 객체: " + getId() +
+                                           " 블록ID: " + sbee.blockId +
+                                           ") 의 타입 (" + koreanBlockTypeName + ")" +
+                                           (blockTypeEnum == Omocha::BlockTypeEnum::UNKNOWN && !sbee.blockType.
+                                            empty()
+                                                ? " (원본: " + sbee.blockType + ")"
+                                                : "") +
+                                           " 에서 사용 하는 객체 (" + entity->getName() +
+                                           // Object ID directly referenced by the error block
+                                           ")\n원본 오류: " + sbee.originalMessage;
+
+        // EngineStdOut은 이미 상세 메시지를 포함하므로, 여기서는 요약된 메시지 또는 상세 메시지 그대로 사용
+        pEngineInstance->EngineStdOut(
+            "Script Execution Error (Entity: " + getId() + ", Thread " + executionThreadId + "): " +
+            detailedErrorMessage, 2, executionThreadId);
+        pEngineInstance->showMessageBox(detailedErrorMessage,
+                                    pEngineInstance->msgBoxIconType.ICON_ERROR);
+        exit(EXIT_FAILURE); // 프로그램 종료
+    }
+    catch (const std::length_error &le) {
+        // Specifically catch std::length_error
+        pEngineInstance->EngineStdOut(
+            "std::length_error caught in script for entity " + getId() +
+            " (Thread: " + executionThreadId + "): " + le.what(),
+            2, executionThreadId);
+        // Optionally, show a message box or perform other error handling
+        // pEngineInstance->showMessageBox("문자열 처리 중 오류가 발생했습니다: " + std::string(le.what()), pEngineInstance->msgBoxIconType.ICON_ERROR);
+    }
+    catch (const std::exception &e) {
+        // Handle general C++ exceptions
+        pEngineInstance->EngineStdOut(
+            "Generic exception caught in script for entity " + getId() +
+            " (Thread: " + executionThreadId + "): " + e.what(),
+            2, executionThreadId);
+    }
+    catch (...) {
+        // Handle other unknown exceptions
+        pEngineInstance->EngineStdOut(
+            "Unknown exception caught in script for entity " + getId() +
+            " (Thread: " + executionThreadId + ")",
+            2, executionThreadId);
+    }
 }
 
 void Entity::setText(const std::string &newText) {
+    markStateWritten();
     if (pEngineInstance) {
         std::lock_guard lock(pEngineInstance->m_engineDataMutex);
         // Engine 클래스를 통해 ObjectInfo의 textContent를 업데이트합니다.
@@ -1816,19 +2727,19 @@ void Entity::prependText(const std::string &prependToText) {
  * @param toFixedSize 자리수
  */
 double Entity::getSize(bool toFixedSize) const {
-    std::lock_guard lock(m_stateMutex);
+    StateLock lock(*this);
     // 스테이지 너비를 기준으로 현재 엔티티의 시각적 너비가 차지하는 비율을 계산합니다.
     // this->width는 엔티티의 원본 이미지 너비입니다.
     // this->getScaleX()는 원본 이미지 너비에 대한 스케일 팩터입니다.
     // 따라서 (this->width * std::abs(this->getScaleX())) 가 현재 시각적 너비입니다.
 
-    double visualWidth = this->width * std::abs(this->getScaleX());
+    double visualWidth = this->getWidth() * std::abs(this->getScaleX());
     double stageWidth = Engine::getProjectstageWidth(); // Engine 클래스에서 스테이지 너비 가져오기
     if (pEngineInstance) {
         // 디버깅 로그 추가
         pEngineInstance->EngineStdOut(
             format("Entity::getSize - Debug - visualWidth: {}, stageWidth: {}, this->width: {}, this->getScaleX(): {}",
-                   visualWidth, stageWidth, this->width, this->getScaleX()), 3);
+                   visualWidth, stageWidth, this->getWidth(), this->getScaleX()), 3);
     }
     double current_percentage = 0.0;
     current_percentage = std::abs(this->getScaleX()) * 100.0;
@@ -1854,7 +2765,9 @@ double Entity::getSize(bool toFixedSize) const {
  * @param size 크기
  */
 void Entity::setSize(double size) {
-    std::lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([size](Entity &entity) { entity.setSize(size); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
 
     double stageWidth = Engine::getProjectstageWidth(); // Engine 클래스에서 스테이지 너비 가져오기
     double targetVisualWidth = stageWidth * (size / 100.0);
@@ -1876,7 +2789,9 @@ void Entity::setSize(double size) {
  * @bref 크기 리셋 (엔트리)
  */
 void Entity::resetSize() {
-    lock_guard lock(m_stateMutex);
+    if (deferCrossShardWrite([](Entity &entity) { entity.resetSize(); }))
+        return;
+    StateLock lock(*this, StateLock::WRITE);
     if (!this->m_isClone) {
         // 복제본이 아닌 경우, 저장된 원본 스케일로 복원합니다.
         // 이 원본 스케일은 엔티티 생성 시 project.json에서 로드된 값입니다.
@@ -1886,9 +2801,9 @@ void Entity::resetSize() {
 }
 
 void Entity::clearAllScriptStates() {
-    std::lock_guard<std::recursive_mutex> lock(m_stateMutex); // scriptThreadStates 접근 보호
-    for (auto &pair: scriptThreadStates) {
-        auto &state = pair.second;
+    std::lock_guard lock(m_stateMutex); // scriptThreadStates 접근 보호
+    for (auto &thread: scriptThreadStates) {
+        auto &state = thread.state;
         state.isWaiting = false;
         state.waitEndTime = 0;
         state.blockIdForWait.clear();
@@ -1900,7 +2815,7 @@ void Entity::clearAllScriptStates() {
         state.loopCounters.clear();
         state.breakLoopRequested = false;
         state.continueLoopRequested = false;
-        // completionPromise와 future는 setScriptWait에서 새로 생성되므로 여기서 특별히 리셋할 필요는 없을 수 있습니다.
+        state.soundPlaybackId = 0;
         // terminateRequested 플래그는 terminateAllScriptThread에서 이미 설정되었으므로 여기서는 건드리지 않습니다.
     }
     // scriptThreadStates.clear(); // 맵 자체를 비우는 대신 상태만 초기화하는 것이 더 안전할 수 있습니다.
@@ -7,15 +7,23 @@
 #include "SDL3/SDL_pixels.h" // For SDL_Color (already included)
 #include "SDL3/SDL_rect.h"   // For SDL_FRect, SDL_FPoint
 #include "SDL3/SDL_render.h" // For SDL_Texture, SDL_Vertex
+#include "blocks/OperandValue.h"
+#include "../util/ExecutorMutex.h"
 #include <atomic>            // For std::atomic
+#include <utility>           // For std::exchange
 #include <future>
+#include <array>
 #include <map>               // For std::map
 #include <memory>            // For std::shared_ptr, std::enable_shared_from_this
+#include <functional>
+#include <string_view>
 
 // Forward declaration
 class Engine;
 struct Script; // Forward declaration for Script
 class Block;   // Forward declaration for Block
+struct UserFunction;
+struct ScriptProgram;
 // 사용자 정의 예외: 스크립트 블록 실행 중 발생하는 오류를 위한 클래스
 /**
  * @brief 스크립트 예외
@@ -62,6 +70,21 @@ struct ScriptWaitState
     }
 };
 
+/**
+ * @brief 스크립트 스레드 핸들 (Engine 의 ScriptThreadSlab 슬롯 인덱스 + 세대)
+ * 슬롯을 해제하면 세대가 바뀌므로 끝난 스레드의 핸들로는 같은 슬롯을 재사용한 새 스레드에 접근할 수 없습니다.
+ * 블록 핸들러와 로그가 쓰는 문자열 실행 ID("script_<index>_<generation>")는 이 핸들을 그대로 적은 것이라
+ * 조회할 때 맵 없이 바로 해석됩니다.
+ */
+struct ScriptThreadHandle
+{
+    uint32_t index = 0;
+    uint32_t generation = 0; // 0 은 유효하지 않은 핸들
+
+    bool isValid() const { return generation != 0; }
+    bool operator==(const ScriptThreadHandle &) const = default;
+};
+
 class Entity : public std::enable_shared_from_this<Entity>
 {
 public:
@@ -79,6 +102,81 @@ public:
     };
 
     // 각 스크립트 스레드의 상태를 관리하는 구조체
+    /**
+     * @brief 트리 인터프리터 반복 블록(repeat_basic, repeat_while_true)의 진행 상태
+     * 로드 시 블록마다 정한 Block::loopSlot 으로 접근하므로 반복마다 문자열 키를 만들거나 맵을 조회하지 않습니다.
+     * 한 스크립트의 반복 블록은 대부분 몇 개뿐이므로 앞쪽 슬롯은 스레드 상태 안의 고정 배열에 둡니다.
+     */
+    class LoopSlots
+    {
+    public:
+        static constexpr int kUnused = -1; // 시작하지 않았거나 끝난 반복
+
+        LoopSlots() { inlineSlots.fill(kUnused); }
+
+        int get(int slot) const
+        {
+            if (slot < 0)
+                return kUnused;
+            if (static_cast<size_t>(slot) < kInlineCount)
+                return inlineSlots[slot];
+            size_t index = slot - kInlineCount;
+            return index < overflow.size() ? overflow[index] : kUnused;
+        }
+        void set(int slot, int value)
+        {
+            if (slot < 0)
+                return;
+            if (static_cast<size_t>(slot) < kInlineCount)
+            {
+                inlineSlots[slot] = value;
+                return;
+            }
+            size_t index = slot - kInlineCount;
+            if (index >= overflow.size())
+                overflow.resize(index + 1, kUnused);
+            overflow[index] = value;
+        }
+        void release(int slot) { set(slot, kUnused); }
+        void clear()
+        {
+            inlineSlots.fill(kUnused);
+            overflow.clear();
+        }
+        // 디버거 표시용
+        size_t size() const { return kInlineCount + overflow.size(); }
+        bool empty() const
+        {
+            for (size_t i = 0; i < size(); ++i)
+            {
+                if (get(static_cast<int>(i)) != kUnused)
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        static constexpr size_t kInlineCount = 8;
+        std::array<int, kInlineCount> inlineSlots;
+        std::vector<int> overflow;
+    };
+    // 사용자 함수 호출 프레임
+    struct CallFrame
+    {
+        const UserFunction *function = nullptr;
+        size_t returnPc = 0;    // 함수가 끝나면 이어서 실행할 호출자의 명령 위치
+        uint32_t argBase = 0;   // frameValues 에서 이 호출의 인자가 시작하는 위치
+        uint32_t loopBase = 0;  // programLoopCounters 에서 이 프레임 반복 슬롯이 시작하는 위치
+        int treeLoopBase = 0;   // loopCounters 에서 이 프레임 트리 인터프리터 반복 슬롯이 시작하는 위치
+        bool noRefresh = false; // 화면 새로 고침 없이 실행 (호출한 함수에서 상속)
+    };
+    // 엔티티의 스크립트 CPU 사용량 (스크립트 디버거 표시용)
+    struct CpuUsage
+    {
+        Uint64 frameNs = 0;      // frameIndex 프레임에 이 엔티티의 스레드들이 쓴 CPU 시간
+        uint64_t frameIndex = 0;
+        Uint64 totalNs = 0;
+    };
     struct ScriptThreadState
     {
         size_t currentBlockIndex = 0;
@@ -89,16 +187,80 @@ public:
         int resumeAtBlockIndex = -1;               // executeBlocksSynchronously 내부에서 대기 발생 시 재개할 블록 인덱스 (필요시)
         const Script* scriptPtrForResume = nullptr;      // BLOCK_INTERNAL 재개를 위한 스크립트 포인터
         bool terminateRequested  = false;
-        std::map<std::string, int> loopCounters; // Key: loop block_id, Value: current_iteration_index
+        LoopSlots loopCounters; // Block::loopSlot -> repeat_basic 현재 반복 횟수 / repeat_while_true 내부 블록 위치
         std::string sceneIdAtDispatchForResume = ""; // BLOCK_INTERNAL 재개를 위한 씬 ID
         std::string originalInnerBlockIdForWait = "";
         bool breakLoopRequested = false; // Flag to signal a 'stop_repeat' or break
         bool continueLoopRequested = false; // Flag to signal a 'continue_repeat'
-        std::promise<void> completionPromise;
-        std::future<void> completionFuture;
+        size_t programCounter = 0;             // ScriptProgram 실행 위치 (함수 안이면 함수 본문 기준)
+        std::vector<int> programLoopCounters;  // ScriptProgram 반복 슬롯별 남은 횟수 (호출 프레임마다 loopBase 부터 이어 붙임)
+        std::vector<CallFrame> callFrames;     // 사용자 함수 호출 스택. 처음 호출할 때 확보하고 줄이지 않습니다.
+        std::vector<OperandValue> frameValues; // 호출 프레임들의 인자 저장소 (frameValueTop 까지 사용 중)
+        uint32_t frameValueTop = 0;
+        Uint64 warpDeadlineNs = 0;             // 화면 새로 고침 없이 실행 중인 함수가 양보 없이 실행할 수 있는 시각
+        uint32_t synchronousDepth = 0;         // callUserFunction 으로 끝까지 실행 중인 중첩 수 (0 이 아니면 멈출 수 없음)
+        uint64_t soundPlaybackId = 0;          // SOUND_FINISH 대기가 기다리는 재생 (AudioEngineHelper 재생 ID)
+
+        // 블록의 Block::loopSlot 을 현재 호출 프레임 기준의 loopCounters 슬롯으로 바꿉니다.
+        // (함수 본문과 재귀 호출이 호출자의 반복 상태를 덮어쓰지 않도록 프레임마다 범위를 나눕니다)
+        int treeLoopSlot(const Block &block) const;
+        int64_t cpuDeficitNs = 0;              // 할당량을 넘겨 쓴 CPU 시간 (0 이하). 갚을 때까지 틱을 미룹니다.
+        Uint64 cpuLastTickNs = 0;              // 마지막 틱의 CPU 시간
+        Uint64 cpuTotalNs = 0;
         ScriptThreadState()= default;
+        // 슬롯을 재사용할 때 호출합니다. 벡터/문자열 용량은 그대로 두어 짧은 스크립트를 반복 실행해도 다시 할당하지 않습니다.
+        void reset();
+    };
+    // ScriptThreadSlab 의 한 칸
+    struct ScriptThreadSlot
+    {
+        std::string id; // 로그/디버거/블록 핸들러용 실행 ID (슬롯을 재사용하면 버퍼도 재사용)
+        ScriptThreadState state;
     };
-    std::map<std::string, ScriptThreadState> scriptThreadStates;
+    /**
+     * @brief 이 엔티티가 소유한 스크립트 스레드 목록
+     * 상태는 Engine 의 ScriptThreadSlab 에 있고 여기에는 핸들만 둡니다. m_stateMutex 를 잡고 사용해야 합니다.
+     */
+    class ScriptThreadTable
+    {
+    public:
+        class iterator
+        {
+        public:
+            iterator(const ScriptThreadTable *table, size_t position) : table(table), position(position) {}
+            ScriptThreadSlot &operator*() const;
+            ScriptThreadSlot *operator->() const { return &**this; }
+            iterator &operator++()
+            {
+                ++position;
+                return *this;
+            }
+            bool operator==(const iterator &other) const { return position == other.position; }
+
+        private:
+            const ScriptThreadTable *table;
+            size_t position;
+        };
+
+        explicit ScriptThreadTable(Entity *owner) : owner(owner) {}
+
+        // 새 스레드 슬롯을 할당합니다. 반환한 슬롯의 id 가 실행 ID 입니다. 슬랩이 가득 차면 nullptr
+        ScriptThreadSlot *create();
+        // 실행 ID 를 해석해 이 엔티티의 살아 있는 스레드이면 상태를, 아니면 nullptr 를 반환합니다.
+        ScriptThreadState *find(std::string_view executionThreadId) const;
+        // 스레드를 목록에서 빼고 슬롯을 반환합니다.
+        bool erase(std::string_view executionThreadId);
+        void clear();
+        bool empty() const { return handles.empty(); }
+        size_t size() const { return handles.size(); }
+        iterator begin() const { return iterator(this, 0); }
+        iterator end() const { return iterator(this, handles.size()); }
+
+    private:
+        Entity *owner;
+        std::vector<ScriptThreadHandle> handles;
+    };
+    ScriptThreadTable scriptThreadStates{this};
     enum class RotationMethod
     {
         NONE,       // 회전 없음
@@ -109,6 +271,15 @@ public:
                     // CIRCLE,   // 엔트리에 해당 옵션이 있는지 확인 필요
         UNKNOWN
     };
+    // 위치/모양/효과 상태 사본 (샤드 실행 스냅샷, 지연된 복제본 생성)
+    struct FrameSnapshot
+    {
+        double x = 0, y = 0, regX = 0, regY = 0, scaleX = 1, scaleY = 1, rotation = 0, direction = 0;
+        double width = 0, height = 0;
+        double effectBrightness = 0, effectAlpha = 1, effectHue = 0;
+        RotationMethod rotateMethod = RotationMethod::FREE;
+        bool visible = true;
+    };
 
     // bounce_wall 블록에서 사용될 충돌 방향 열거형
     enum class CollisionSide
@@ -157,8 +328,9 @@ public:
     };
 
     // 스크립트 대기 설정 함수 (시그니처 변경)
+    // scheduleWake 가 false 이면 엔진 예약 큐에 넣지 않습니다. (조건 기다리기처럼 호출한 쪽이 깨울 때)
     void setScriptWait(const std::string &executionThreadId, Uint64 endTime, const std::string &blockId, WaitType type, const Script *
-                       scriptPtr, const std::string &sceneId);
+                       scriptPtr, const std::string &sceneId, bool scheduleWake = true);
 
     // 스크립트 대기 상태 확인 함수 (신규)
     bool isScriptWaiting(const std::string &executionThreadId) const;
@@ -240,7 +412,24 @@ private:
     double m_effectHue;
     // enum class CollisionSide { NONE, UP, DOWN, LEFT, RIGHT }; // 중복 선언 제거, 위로 이동    
     CollisionSide lastCollisionSide = CollisionSide::NONE;
-    mutable std::recursive_mutex m_stateMutex;
+    // 인라인 실행기에서는 잠그지 않습니다. (util/ExecutorMutex.h)
+    using StateMutex = ExecutorMutex<std::recursive_mutex>;
+    mutable StateMutex m_stateMutex;
+    // --- 엔티티 샤드 실행 (Engine::runScriptFrame, specialConfig.entityShardMode) ---
+    // 프레임 동안 다른 샤드가 읽는 위치/모양 상태. 프레임 시작 때 메인 스레드만 씁니다.
+    FrameSnapshot m_frameSnapshot;
+    std::atomic<uint64_t> m_shardToken{0};   // 이번 프레임에 이 엔티티를 맡은 샤드 (0 이면 샤드 실행 아님)
+    std::atomic<int> m_detachedThreads{0};   // 프레임 밖에서 막혀 있는 스레드 수. 0 이 아니면 샤드에 넣지 않습니다.
+    static thread_local uint64_t s_currentShardToken; // 현재 작업자가 실행 중인 샤드
+    static thread_local bool s_stateWritten;          // markStateWritten 이후 consumeStateWritten 전
+    CpuUsage m_cpuUsage; // m_stateMutex 로 보호
+    // 현재 스레드가 이 엔티티를 맡은 샤드 작업자이면 속성 접근에 잠금이 필요 없습니다.
+    bool ownsStateUnlocked() const;
+    // 샤드 실행 중인 프레임에 다른 스레드가 읽는 경우: 스냅샷을 읽습니다.
+    bool readsFrameSnapshot() const;
+    // 다른 샤드의 틱이 이 엔티티의 setter 를 부르면 값을 바꾸지 않고 커맨드로 기록합니다. 기록했으면 true
+    bool deferCrossShardWrite(std::function<void(Entity &)> write);
+    class StateLock;
     bool m_isClone = false;
     std::string m_originalClonedFromId = "";
     // ScriptTask 구조체 정의 (std::tuple 대신 사용)
@@ -250,6 +439,24 @@ private:
         std::string sceneId;
         int resumeIndex;
     };
+    // 컴파일된 스크립트 실행 결과
+    enum class VmRunResult
+    {
+        COMPLETED, // 실행할 명령이 끝남 (callUserFunction 은 호출한 함수 본문이 끝남)
+        SUSPENDED, // 대기/양보를 설정하고 반환
+        STOPPED    // 종료 요청, 엔진 종료, 장면 전환 등으로 중단
+    };
+    /**
+     * @brief ScriptProgram 명령을 실행합니다. 호출 프레임이 minDepth 개 남은 상태에서 현재 본문이 끝나면 COMPLETED 를 반환합니다.
+     * @param canSuspend false 이면 반복문과 대기 블록에서도 양보하지 않습니다.
+     */
+    VmRunResult runCompiledProgram(ScriptThreadState &threadState, const Script *scriptPtr,
+                                   const std::string &executionThreadId, const std::string &sceneIdAtDispatch,
+                                   float deltaTime, size_t minDepth, bool canSuspend);
+    // 인자를 평가해 호출 프레임을 쌓고 programCounter 를 함수 본문 처음으로 옮깁니다.
+    void pushCallFrame(ScriptThreadState &threadState, const UserFunction &function, const Block &callBlock,
+                       const ScriptProgram *callerProgram, uint32_t firstArgExpr, size_t returnPc,
+                       const std::string &executionThreadId);
 public:                      // Made brush and paint public for now for easier access from blocks
     Engine *pEngineInstance; // Store a pointer to the engine instance
     // Explicitly delete copy constructor and copy assignment operator
@@ -267,8 +474,24 @@ public:                      // Made brush and paint public for now for easier a
     PenState paint;
     void clearAllScriptStates();
     // m_stateMutex에 대한 public 접근자 추가 (주의해서 사용) - 반환 타입도 변경
-    std::recursive_mutex& getStateMutex() const { return m_stateMutex; }
+    StateMutex& getStateMutex() const { return m_stateMutex; }
     bool getIsClone() const { return m_isClone; }
+    // getter 로 현재 상태를 복사합니다. (다른 샤드의 엔티티면 프레임 스냅샷)
+    FrameSnapshot captureState() const;
+    /**
+     * @brief 이번 프레임에 이 엔티티를 token 샤드에 고정합니다. (메인 스레드, 틱 실행 전)
+     * 현재 위치/모양 상태를 스냅샷으로 복사합니다. 프레임 밖에서 막힌 스레드가 있으면 아무 것도 하지 않습니다.
+     */
+    void beginFrameShard(uint64_t token);
+    void endFrameShard();
+    // 작업자가 샤드를 실행하는 동안 그 토큰을 설정합니다. (끝나면 0)
+    static void setCurrentShardToken(uint64_t token) { s_currentShardToken = token; }
+    // 현재 스레드가 엔티티 속성을 바꿨는지 (조건 기다리기의 엔티티 입력). 엔진이 틱마다 읽고 지웁니다.
+    static void markStateWritten() { s_stateWritten = true; }
+    static bool consumeStateWritten() { return std::exchange(s_stateWritten, false); }
+    // 프레임 배리어 밖에서 막히는 스레드 (ask_and_wait 동기 경로): 샤드에서 빠지고, 다시 붙을 때까지 잠금으로 접근합니다.
+    void detachFromFrameShard();
+    void reattachFrameShard() { m_detachedThreads.fetch_sub(1, std::memory_order_release); }
     void setIsClone(bool isClone, const std::string& originalId=""){
         m_isClone = isClone;
         m_originalClonedFromId = originalId;
@@ -283,21 +506,49 @@ Entity(Engine *engine, const std::string &entityId, const std::string &entityNam
     DialogState m_currentDialog;
     std::map<std::string, ScriptWaitState> scriptWaitStates;
     CollisionSide getLastCollisionSide() const;
+    // 새 스크립트 스레드 상태를 만들고 실행 ID 를 반환합니다. 실행할 블록이 없거나 만들 수 없으면 빈 문자열
+    std::string createScriptThread(const Script *scriptPtr);
     // In Entity.h
     void scheduleScriptExecutionOnPool(const Script *scriptPtr,
                                        const std::string &sceneIdAtDispatch,
                                        float deltaTime,
                                        const std::string &existingExecutionThreadId = ""
     );
+    // 프레임 틱 배치의 항목 하나를 실행합니다. (Engine::runScriptFrame 작업자에서 호출)
+    void runScriptTick(const Script *scriptPtr, const std::string &executionThreadId,
+                       const std::string &sceneIdAtDispatch, float deltaTime, bool isResumed);
     void executeScript(const Script *scriptPtr, const std::string &executionThreadId, const std::string &sceneIdAtDispatch, float deltaTime, size_t
                        resumeInnerBlockIndex=0);
+    void executeCompiledScript(const Script *scriptPtr, const std::string &executionThreadId, const std::string &sceneIdAtDispatch, float deltaTime);
+    /**
+     * @brief 사용자 함수를 현재 스레드에서 끝까지 실행하고 결과값을 반환합니다. (값 반환 함수 리포터, 트리 인터프리터의 함수 호출)
+     * 인자는 호출자 문맥에서 평가되며, 실행 중에는 프레임을 양보하지 않습니다.
+     */
+    OperandValue callUserFunction(const Block &callBlock, const std::string &executionThreadId);
+    /**
+     * @brief ask_and_wait: 워커 스레드를 막지 않고 현재 스레드를 TEXT_INPUT 대기로 멈춥니다.
+     * VM 이 실행 중이고 끝까지 실행해야 하는 함수 호출 안이 아닐 때만 가능하며, 불가능하면 false 를 반환합니다.
+     * 대답이 들어오면 resumeTextInputWait 가 다음 명령부터 재개합니다.
+     */
+    bool suspendForTextInput(const std::string &executionThreadId, const std::string &blockId);
+    // TEXT_INPUT 대기를 풀고 스레드를 다시 스케줄합니다. VM 이 아직 멈추지 않았으면 false (다음 프레임에 다시 시도)
+    bool resumeTextInputWait(const std::string &executionThreadId);
     void setLastCollisionSide(CollisionSide side);
     void showDialog(const std::string &message, const std::string &dialogType, Uint64 duration);
     void removeDialog();
     void updateDialog(float deltaTime); // Changed from Uint64 currentTimeMs
-    void processInternalContinuations(float deltaTime); // BLOCK_INTERNAL 상태 스크립트 직접 처리
-    void resumeExplicitWaitScripts(float deltaTime);
-    void resumeSoundWaitScripts(float deltaTime);      // 추가: SOUND_FINISH 상태의 스크립트 재개
+    // Engine::processScriptWakeups 가 예약 시각이 된 스레드마다 호출합니다. wakeTime 이 현재 대기와 다르면 지난 예약이므로 무시합니다.
+    void resumeInternalContinuation(const std::string &executionThreadId, Uint64 wakeTime, float deltaTime); // BLOCK_INTERNAL 상태 스크립트 직접 처리
+    void resumeExplicitWait(const std::string &executionThreadId, Uint64 wakeTime, float deltaTime);
+    // Engine::processScriptWakeups 가 재생이 끝난 소리를 기다리는 스레드마다 호출합니다. (SOUND_FINISH)
+    void resumeSoundWait(const std::string &executionThreadId, uint64_t playbackId, float deltaTime);
+    // --- 스크립트 CPU 예산 (Engine::applyScriptCpuBudget) ---
+    // 이번 틱의 할당량을 주고 지난 빚을 뺀 사용 가능 시간을 반환합니다. 0 이하이면 이번 프레임은 건너뜁니다.
+    int64_t grantScriptQuantum(const std::string &executionThreadId, int64_t quantumNs);
+    // 틱이 끝난 뒤 사용 시간을 기록합니다. 할당량을 넘긴 만큼은 다음 틱들에서 갚습니다.
+    void accountScriptTick(const std::string &executionThreadId, uint64_t frameIndex, Uint64 elapsedNs,
+                           int64_t allowanceNs);
+    CpuUsage getCpuUsage() const;
     bool hasActiveDialog() const;
     bool isPointInside(double pX, double pY) const;
     const std::string &getId() const;
@@ -352,5 +603,49 @@ Entity(Engine *engine, const std::string &entityId, const std::string &entityNam
     void terminateAllScriptThread(const std::string& execeptThreadId);
 };
 
+/**
+ * @brief 엔진 전체의 스크립트 스레드 상태 슬랩
+ * 상태는 고정 크기 청크에 놓이고 청크는 한 번 할당하면 옮기지 않으므로, 다른 스레드가 슬롯을 할당해도
+ * 실행 중인 스크립트가 들고 있는 ScriptThreadState 참조는 그대로 유효합니다.
+ * 해제한 슬롯은 LIFO 로 재사용하여 메시지 신호로 짧은 스크립트가 많이 시작돼도 힙 할당이 반복되지 않습니다.
+ * 할당/해제는 슬랩 뮤텍스로, 슬롯 상태 접근은 소유 엔티티의 m_stateMutex 로 보호합니다.
+ */
+class ScriptThreadSlab
+{
+public:
+    ScriptThreadSlab() = default;
+    ScriptThreadSlab(const ScriptThreadSlab &) = delete;
+    ScriptThreadSlab &operator=(const ScriptThreadSlab &) = delete;
+
+    ScriptThreadHandle allocate(const Entity *owner);
+    void release(ScriptThreadHandle handle);
+    // 세대와 소유 엔티티가 일치하면 슬롯, 아니면 nullptr
+    Entity::ScriptThreadSlot *get(ScriptThreadHandle handle, const Entity *owner) const;
+    // 실행 ID 문자열을 핸들로 해석합니다. 형식이 다르면 유효하지 않은 핸들을 반환합니다.
+    static ScriptThreadHandle parse(std::string_view executionThreadId);
+    size_t liveCount() const { return m_liveCount.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kChunkShift = 8;
+    static constexpr uint32_t kChunkSize = 1u << kChunkShift;
+    static constexpr uint32_t kMaxChunks = 4096; // 최대 동시 스레드 약 100만 개
+
+    struct Entry
+    {
+        Entity::ScriptThreadSlot slot;
+        std::atomic<uint32_t> generation{1};
+        std::atomic<const Entity *> owner{nullptr};
+    };
+
+    Entry *entryAt(uint32_t index) const;
+
+    std::array<std::unique_ptr<Entry[]>, kMaxChunks> m_chunks;
+    std::atomic<uint32_t> m_chunkCount{0};
+    std::vector<uint32_t> m_freeSlots;
+    std::atomic<size_t> m_liveCount{0};
+    uint32_t m_slotCount = 0; // 한 번이라도 사용한 슬롯 수
+    mutable std::mutex m_mutex;
+};
+
 // Declare BlockTypeEnumToString as a free function
 std::string BlockTypeEnumToString(Entity::WaitType type);
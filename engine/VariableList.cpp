@@ -0,0 +1,183 @@
+#include "VariableList.h"
+
+#include <algorithm>
+
+using namespace std;
+
+VariableList::Item VariableList::Item::fromValue(const OperandValue &value) {
+    Item item;
+    if (value.type == OperandValue::Type::NUMBER) {
+        item.number = value.numberValue();
+        item.isNumber = true;
+    } else {
+        item.text = value.asString();
+    }
+    return item;
+}
+
+VariableList::Item VariableList::Item::fromString(string text) {
+    Item item;
+    item.text = move(text);
+    return item;
+}
+
+string VariableList::Item::asString() const {
+    return isNumber ? OperandValue(number).asString() : text;
+}
+
+OperandValue VariableList::Item::toValue() const {
+    return isNumber ? OperandValue(number) : OperandValue(text);
+}
+
+pair<size_t, size_t> VariableList::locate(size_t index) const {
+    if (m_appendOnly) {
+        return {index / kChunkSize, index % kChunkSize};
+    }
+    auto it = upper_bound(m_chunkStart.begin(), m_chunkStart.end(), index);
+    const auto chunk = static_cast<size_t>(it - m_chunkStart.begin()) - 1;
+    return {chunk, index - m_chunkStart[chunk]};
+}
+
+void VariableList::shiftStarts(size_t fromChunk, ptrdiff_t delta) {
+    for (size_t c = fromChunk; c < m_chunkStart.size(); ++c) {
+        m_chunkStart[c] = static_cast<size_t>(static_cast<ptrdiff_t>(m_chunkStart[c]) + delta);
+    }
+}
+
+const VariableList::Item &VariableList::at(size_t index) const {
+    const auto [chunk, offset] = locate(index);
+    return m_chunks[chunk][offset];
+}
+
+void VariableList::push_back(Item item) {
+    if (m_chunks.empty() || m_chunks.back().size() >= kChunkSize) {
+        m_chunkStart.push_back(m_size);
+        m_chunks.emplace_back().reserve(kChunkSize);
+    }
+    indexAdd(item);
+    m_chunks.back().push_back(move(item));
+    ++m_size;
+}
+
+void VariableList::insert(size_t index, Item item) {
+    if (index >= m_size) {
+        push_back(move(item));
+        return;
+    }
+    auto [chunk, offset] = locate(index);
+    if (m_chunks[chunk].size() >= kChunkSize) {
+        // 가득 찬 청크는 반으로 나누고 삽입 위치가 속한 쪽에 넣습니다.
+        const size_t half = kChunkSize / 2;
+        vector<Item> upper;
+        upper.reserve(kChunkSize);
+        move(m_chunks[chunk].begin() + half, m_chunks[chunk].end(), back_inserter(upper));
+        m_chunks[chunk].resize(half);
+        m_chunks.insert(m_chunks.begin() + chunk + 1, move(upper));
+        m_chunkStart.insert(m_chunkStart.begin() + chunk + 1, m_chunkStart[chunk] + half);
+        m_appendOnly = false;
+        if (offset >= half) {
+            ++chunk;
+            offset -= half;
+        }
+    }
+    if (chunk + 1 != m_chunks.size()) {
+        m_appendOnly = false;
+    }
+    indexAdd(item);
+    m_chunks[chunk].insert(m_chunks[chunk].begin() + offset, move(item));
+    shiftStarts(chunk + 1, 1);
+    ++m_size;
+}
+
+void VariableList::erase(size_t index) {
+    const auto [chunk, offset] = locate(index);
+    auto &items = m_chunks[chunk];
+    indexRemove(items[offset]);
+    items.erase(items.begin() + offset);
+    shiftStarts(chunk + 1, -1);
+    --m_size;
+
+    if (m_size == 0) {
+        m_chunks.clear();
+        m_chunkStart.clear();
+        m_appendOnly = true;
+        return;
+    }
+    if (chunk + 1 != m_chunks.size()) {
+        m_appendOnly = false;
+    }
+    if (items.empty()) {
+        m_chunks.erase(m_chunks.begin() + chunk);
+        m_chunkStart.erase(m_chunkStart.begin() + chunk);
+    } else if (items.size() < kChunkSize / 4 && chunk + 1 < m_chunks.size() &&
+               items.size() + m_chunks[chunk + 1].size() <= kChunkSize) {
+        // 앞에서부터 지운 청크가 잘게 남지 않도록 뒤 청크와 합칩니다.
+        auto &next = m_chunks[chunk + 1];
+        move(next.begin(), next.end(), back_inserter(items));
+        m_chunks.erase(m_chunks.begin() + chunk + 1);
+        m_chunkStart.erase(m_chunkStart.begin() + chunk + 1);
+    }
+}
+
+void VariableList::set(size_t index, Item item) {
+    const auto [chunk, offset] = locate(index);
+    Item &target = m_chunks[chunk][offset];
+    indexRemove(target);
+    indexAdd(item);
+    target = move(item);
+}
+
+void VariableList::clear() {
+    m_chunks.clear();
+    m_chunkStart.clear();
+    m_size = 0;
+    m_appendOnly = true;
+    m_indexed = false;
+    m_counts.clear();
+}
+
+bool VariableList::contains(string_view text) {
+    if (!m_indexed && m_size >= kIndexThreshold) {
+        m_indexed = true;
+        m_counts.reserve(m_size);
+        forEach([this](const Item &item) { indexAdd(item); });
+    }
+    if (m_indexed) {
+        return m_counts.find(text) != m_counts.end();
+    }
+    for (const auto &chunk: m_chunks) {
+        for (const auto &item: chunk) {
+            if (item.isNumber ? item.asString() == text : item.text == text) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void VariableList::indexAdd(const Item &item) {
+    if (!m_indexed) {
+        return;
+    }
+    if (item.isNumber) {
+        ++m_counts[item.asString()];
+        return;
+    }
+    auto it = m_counts.find(string_view(item.text));
+    if (it != m_counts.end()) {
+        ++it->second;
+    } else {
+        m_counts.emplace(item.text, 1);
+    }
+}
+
+void VariableList::indexRemove(const Item &item) {
+    if (!m_indexed) {
+        return;
+    }
+    const string number = item.isNumber ? item.asString() : string();
+    auto it = m_counts.find(item.isNumber ? string_view(number) : string_view(item.text));
+    if (it != m_counts.end() && --it->second == 0) {
+        m_counts.erase(it);
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "blocks/OperandValue.h"
+
+/*
+ * 리스트 변수의 항목 저장소
+ *
+ * 타일맵, 순위표처럼 항목이 수만 개인 리스트에서도 블록 하나의 비용이 리스트 길이에 비례하지 않도록 합니다.
+ * - 항목은 최대 kChunkSize 개씩 청크에 나눠 담습니다. 끝에 추가하면 마지막 청크에만 쓰고,
+ *   중간 삽입/삭제는 해당 청크 하나만 밀어냅니다. 가득 찬 청크에 삽입하면 반으로 나눕니다.
+ * - 끝에만 추가한 리스트(마지막 청크 외에는 모두 가득 참)는 나눗셈으로 청크를 찾고,
+ *   중간을 고친 뒤에는 청크 시작 위치 표에서 이분 탐색합니다.
+ * - 숫자로 추가한 항목은 문자열로 만들지 않고 double 로 저장합니다.
+ * - "리스트에 포함되어 있는가" 가 처음 불린 시점에 리스트가 kIndexThreshold 개 이상이면
+ *   항목 문자열별 개수 표를 만들고, 이후 변경마다 함께 갱신합니다. 포함 여부 확인은 해시 조회 한 번입니다.
+ *
+ * 항목 비교는 기존과 같이 문자열 표현(OperandValue::asString)으로 합니다.
+ * 접근 보호는 VariableStore 와 같이 Engine::m_engineDataMutex 로 합니다.
+ */
+class VariableList
+{
+public:
+    struct Item
+    {
+        std::string text; // isNumber 이면 비어 있음
+        double number = 0.0;
+        bool isNumber = false;
+
+        // NUMBER 는 숫자 그대로, 나머지는 문자열 표현으로 저장합니다.
+        static Item fromValue(const OperandValue &value);
+        static Item fromString(std::string text);
+
+        std::string asString() const;
+        OperandValue toValue() const;
+    };
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    // index 는 0 기반이며 호출하는 쪽에서 범위를 확인합니다.
+    const Item &at(size_t index) const;
+    OperandValue valueAt(size_t index) const { return at(index).toValue(); }
+    std::string stringAt(size_t index) const { return at(index).asString(); }
+
+    void push_back(Item item);
+    void insert(size_t index, Item item);
+    void erase(size_t index);
+    void set(size_t index, Item item);
+    void clear();
+
+    /**
+     * @brief 문자열 표현이 text 와 같은 항목이 있는지 확인합니다. 필요하면 개수 표를 만듭니다.
+     */
+    bool contains(std::string_view text);
+
+    template<typename Fn>
+    void forEach(Fn &&fn) const
+    {
+        for (const auto &chunk: m_chunks) {
+            for (const auto &item: chunk) {
+                fn(item);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kChunkSize = 512;
+    static constexpr size_t kIndexThreshold = 64;
+
+    struct StringHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    std::vector<std::vector<Item>> m_chunks;
+    std::vector<size_t> m_chunkStart; // 각 청크 첫 항목의 위치
+    size_t m_size = 0;
+    bool m_appendOnly = true; // 마지막 청크를 뺀 모든 청크가 가득 참
+
+    bool m_indexed = false;
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> m_counts;
+
+    // index(< m_size) 가 들어 있는 (청크, 청크 안 위치)
+    std::pair<size_t, size_t> locate(size_t index) const;
+    void shiftStarts(size_t fromChunk, std::ptrdiff_t delta);
+    void indexAdd(const Item &item);
+    void indexRemove(const Item &item);
+};
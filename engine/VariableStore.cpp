@@ -0,0 +1,80 @@
+#include "VariableStore.h"
+
+using namespace std;
+
+uint32_t VariableStore::add(const string &id, const string &objectId, bool isList, bool isCloud) {
+    auto it = m_nameIndex.find(string_view(id));
+    uint32_t name;
+    if (it == m_nameIndex.end()) {
+        name = static_cast<uint32_t>(m_names.size());
+        m_names.emplace_back();
+        m_nameIndex.emplace(id, name);
+    } else {
+        name = it->second;
+        for (const auto &[scope, existing]: m_names[name].scopes) {
+            if (scope == objectId && m_slots[existing].isList == isList) {
+                return existing;
+            }
+        }
+    }
+    const auto index = static_cast<uint32_t>(m_slots.size());
+    Slot slot;
+    slot.id = id;
+    slot.objectId = objectId;
+    slot.isList = isList;
+    slot.isCloud = isCloud;
+    m_slots.push_back(move(slot));
+    m_names[name].scopes.emplace_back(objectId, index);
+    return index;
+}
+
+void VariableStore::clear() {
+    m_slots.clear();
+    m_names.clear();
+    m_nameIndex.clear();
+}
+
+uint32_t VariableStore::findByName(uint32_t name, string_view objectId, const bool *isList) const {
+    if (name >= m_names.size()) {
+        return kNoSlot;
+    }
+    const auto &scopes = m_names[name].scopes;
+    // 지역 변수 우선
+    for (const auto &[scope, index]: scopes) {
+        if (scope == objectId && (!isList || m_slots[index].isList == *isList)) {
+            return index;
+        }
+    }
+    for (const auto &[scope, index]: scopes) {
+        if (scope.empty() && (!isList || m_slots[index].isList == *isList)) {
+            return index;
+        }
+    }
+    return kNoSlot;
+}
+
+uint32_t VariableStore::find(string_view objectId, string_view id) const {
+    auto it = m_nameIndex.find(id);
+    return it == m_nameIndex.end() ? kNoSlot : findByName(it->second, objectId, nullptr);
+}
+
+uint32_t VariableStore::find(string_view objectId, string_view id, bool isList) const {
+    auto it = m_nameIndex.find(id);
+    return it == m_nameIndex.end() ? kNoSlot : findByName(it->second, objectId, &isList);
+}
+
+VariableStore::Ref VariableStore::resolveRef(string_view id) const {
+    Ref ref;
+    ref.id = id;
+    auto it = m_nameIndex.find(id);
+    if (it == m_nameIndex.end()) {
+        return ref;
+    }
+    ref.name = it->second;
+    const auto &scopes = m_names[ref.name].scopes;
+    // 전역 슬롯 하나뿐인 이름은 어느 오브젝트에서 실행해도 같은 슬롯입니다.
+    if (scopes.size() == 1 && scopes.front().first.empty()) {
+        ref.slot = scopes.front().second;
+    }
+    return ref;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "blocks/OperandValue.h"
+#include "VariableList.h"
+
+/*
+ * 변수/리스트 저장소
+ *
+ * 블록이 읽고 쓰는 값만 담고, 위치/크기/표시 여부 같은 HUD 표시 정보는 Engine 의 HUDVariableDisplay 에 둡니다.
+ * 둘은 슬롯 번호(HUDVariableDisplay::slot, Slot::hud)로 서로를 가리킵니다.
+ *
+ * 변수 ID 는 로드 시 이름 번호로 등록되고, 이름마다 전역 슬롯과 오브젝트 지역 슬롯 목록을 가집니다.
+ * - 실행 중 ID 로 찾을 때는 해시 조회 한 번에 이름을 찾고, 지역 -> 전역 순서로 슬롯을 고릅니다.
+ * - 컴파일러는 상수 ID 를 미리 이름 번호로 바꿔 두고(VariableRef), 지역 변수가 없는 이름은 슬롯까지 고정합니다.
+ * 변수 수와 관계없이 조회 비용이 일정합니다.
+ *
+ * 슬롯은 프로젝트를 불러올 때만 추가되며, 값 접근은 Engine::m_engineDataMutex 로 보호합니다.
+ */
+class VariableStore
+{
+public:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+    static constexpr uint32_t kNoName = UINT32_MAX;
+
+    struct Slot
+    {
+        std::string id;
+        std::string objectId; // 비어 있으면 전역
+        bool isList = false;
+        bool isCloud = false;
+        uint32_t hud = kNoSlot; // Engine::m_HUDVariables 인덱스
+        // 숫자/문자열/불리언을 타입 그대로 저장합니다. 문자열 표현은 HUD 표시나 저장 때 asString() 으로 만들고 캐시됩니다.
+        OperandValue value;
+        VariableList items; // 리스트 전용
+    };
+
+    // 컴파일 시 해석한 변수 참조. slot 이 kNoSlot 이 아니면 오브젝트와 관계없이 그 슬롯입니다.
+    struct Ref
+    {
+        uint32_t name = kNoName;
+        uint32_t slot = kNoSlot;
+        std::string id; // 로그와 조건 대기 알림(Engine::noteVariableWrite)용
+    };
+
+    /**
+     * @brief 슬롯을 추가합니다. 같은 범위에 같은 ID 가 이미 있으면 그 슬롯을 반환합니다.
+     */
+    uint32_t add(const std::string &id, const std::string &objectId, bool isList, bool isCloud);
+    void clear();
+
+    // 오브젝트 지역 변수를 먼저, 없으면 전역 변수를 찾습니다. 없으면 kNoSlot
+    uint32_t find(std::string_view objectId, std::string_view id) const;
+    // 위와 같지만 리스트/변수 종류까지 맞아야 합니다.
+    uint32_t find(std::string_view objectId, std::string_view id, bool isList) const;
+
+    // 컴파일러용: ID 를 참조로 해석합니다. 등록되지 않은 ID 면 name 이 kNoName 입니다.
+    Ref resolveRef(std::string_view id) const;
+    uint32_t find(const Ref &ref, std::string_view objectId) const
+    {
+        return ref.slot != kNoSlot ? ref.slot : findByName(ref.name, objectId, nullptr);
+    }
+
+    Slot &slot(uint32_t index) { return m_slots[index]; }
+    const Slot &slot(uint32_t index) const { return m_slots[index]; }
+    Slot *get(uint32_t index) { return index < m_slots.size() ? &m_slots[index] : nullptr; }
+    size_t size() const { return m_slots.size(); }
+
+private:
+    struct StringHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    // 같은 ID 를 쓰는 슬롯들 (오브젝트 ID, 슬롯). 엔트리 ID 는 프로젝트 안에서 고유하므로 보통 하나입니다.
+    struct Name
+    {
+        std::vector<std::pair<std::string, uint32_t>> scopes;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<Name> m_names;
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> m_nameIndex;
+
+    uint32_t findByName(uint32_t name, std::string_view objectId, const bool *isList) const;
+};
@@ -0,0 +1,511 @@
+#include "AotCompiler.h"
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+using Omocha::BlockTypeEnum;
+
+namespace
+{
+    // 생성된 소스의 등록 테이블. 정적 초기화 때만 채워지고 로드 중에는 읽기만 합니다.
+    map<uint64_t, AotProgram> &aotRegistry()
+    {
+        static map<uint64_t, AotProgram> registry;
+        return registry;
+    }
+
+    class Fingerprint
+    {
+    public:
+        template <typename T>
+        void add(T value)
+        {
+            unsigned char bytes[sizeof(T)];
+            memcpy(bytes, &value, sizeof(T));
+            addBytes(bytes, sizeof(T));
+        }
+
+        void add(const string &text)
+        {
+            add(static_cast<uint64_t>(text.size()));
+            addBytes(reinterpret_cast<const unsigned char *>(text.data()), text.size());
+        }
+
+        uint64_t value() const { return hash; }
+
+    private:
+        uint64_t hash = 14695981039346656037ull; // FNV-1a
+
+        void addBytes(const unsigned char *bytes, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+        }
+    };
+
+    const char *calcOperatorName(uint8_t op)
+    {
+        switch (static_cast<CalcBasicOperator>(op))
+        {
+        case CalcBasicOperator::PLUS: return "PLUS";
+        case CalcBasicOperator::MINUS: return "MINUS";
+        case CalcBasicOperator::MULTI: return "MULTI";
+        case CalcBasicOperator::DIVIDE: return "DIVIDE";
+        default: return "UNKNOWN";
+        }
+    }
+
+    const char *compareOperatorName(uint8_t op)
+    {
+        switch (static_cast<CompareOperator>(op))
+        {
+        case CompareOperator::EQUAL: return "EQUAL";
+        case CompareOperator::NOT_EQUAL: return "NOT_EQUAL";
+        case CompareOperator::GREATER: return "GREATER";
+        case CompareOperator::LESS: return "LESS";
+        case CompareOperator::GREATER_OR_EQUAL: return "GREATER_OR_EQUAL";
+        case CompareOperator::LESS_OR_EQUAL: return "LESS_OR_EQUAL";
+        default: return "UNKNOWN";
+        }
+    }
+
+    const char *logicOperatorName(uint8_t op)
+    {
+        switch (static_cast<LogicOperator>(op))
+        {
+        case LogicOperator::AND: return "AND";
+        case LogicOperator::OR: return "OR";
+        default: return "UNKNOWN";
+        }
+    }
+
+    // 주석에 넣을 수 있도록 줄바꿈을 제거합니다.
+    string commentText(string text)
+    {
+        for (char &ch : text)
+        {
+            if (ch == '\n' || ch == '\r')
+                ch = ' ';
+        }
+        return text;
+    }
+
+    string constantRef(uint32_t index)
+    {
+        return format("ctx.program.constants[{}]", index);
+    }
+
+    // 리터럴 숫자는 코드에 바로 넣습니다. (유한하지 않은 값은 ref 가 가리키는 원래 값에서 읽음)
+    string numberLiteral(const OperandValue &literal, const string &ref)
+    {
+        double value = literal.asNumber();
+        if (!isfinite(value))
+            return ref + ".asNumber()";
+        string text = format("{}", value);
+        if (text.find_first_of(".e") == string::npos)
+            text += ".0";
+        return text;
+    }
+
+    string numberLiteral(const ScriptProgram &program, uint32_t index)
+    {
+        return numberLiteral(program.constants[index], constantRef(index));
+    }
+
+    bool isLiteralOperand(const Operand &operand)
+    {
+        switch (operand.kind)
+        {
+        case Operand::Kind::NUMBER:
+        case Operand::Kind::STRING:
+        case Operand::Kind::BOOLEAN:
+        case Operand::Kind::LITERAL:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    class AotEmitter
+    {
+    public:
+        AotEmitter(const ScriptProgram &program, string &out) : program(program), out(out) {}
+
+        // 구간 [begin, end) 를 함수 하나로 생성합니다.
+        void emitRegion(const string &functionName, uint32_t begin, uint32_t end)
+        {
+            out += format("uint32_t {}(AotRegionContext &ctx)\n{{\n", functionName);
+            for (uint32_t pc = begin; pc < end; ++pc)
+            {
+                emitInstruction(pc);
+            }
+            out += format("    return {};\n}}\n\n", end);
+        }
+
+    private:
+        const ScriptProgram &program;
+        string &out;
+
+        // 표현식 계산 코드를 쓰고 결과를 가리키는 C++ 식을 반환합니다.
+        string emitExpr(uint32_t exprIndex, uint32_t pc, const string &indent)
+        {
+            const CompiledExpr &expr = program.exprs[exprIndex];
+            auto ref = [&](uint16_t operand) {
+                if (operand & kExprConstFlag)
+                    return constantRef(operand & ~kExprConstFlag);
+                return format("r{}_{}_{}", pc, exprIndex, operand);
+            };
+            for (uint32_t i = expr.firstInstr; i < expr.firstInstr + expr.instrCount; ++i)
+            {
+                const ExprInstr &instr = program.exprCode[i];
+                string value;
+                switch (instr.op)
+                {
+                case ExprOp::CALC:
+                    value = format("applyCalcBasic(CalcBasicOperator::{}, {}, {}, ctx.program.blocks[{}], ctx.objectId)",
+                                   calcOperatorName(instr.sub), ref(instr.lhs), ref(instr.rhs), instr.operand);
+                    break;
+                case ExprOp::COMPARE:
+                    value = format("applyCompare(CompareOperator::{}, {}, {})", compareOperatorName(instr.sub),
+                                   ref(instr.lhs), ref(instr.rhs));
+                    break;
+                case ExprOp::LOGIC:
+                    value = format("applyLogic(LogicOperator::{}, {}, {})", logicOperatorName(instr.sub),
+                                   ref(instr.lhs), ref(instr.rhs));
+                    break;
+                case ExprOp::NOT:
+                    value = format("OperandValue(!{}.asBool())", ref(instr.lhs));
+                    break;
+                case ExprOp::EVAL_OPERAND:
+                    value = format("getOperandValue(ctx.engine, ctx.objectId, ctx.program.operands[{}], "
+                                   "ctx.executionThreadId)",
+                                   instr.operand);
+                    break;
+                case ExprOp::LOAD_ARG:
+                    value = format("aotLoadArg({})", instr.operand);
+                    break;
+                case ExprOp::LOAD_VAR:
+                    value = format("readVariable(ctx.engine, ctx.objectId, ctx.program.variables[{}], "
+                                   "ctx.executionThreadId)",
+                                   instr.operand);
+                    break;
+                }
+                out += format("{}const OperandValue {} = {};\n", indent, ref(instr.dst), value);
+            }
+            return ref(expr.result);
+        }
+
+        // blocks[blockIndex] 의 index 번째 파라미터를 숫자로 계산하는 C++ 식
+        string paramNumber(uint32_t blockIndex, size_t index)
+        {
+            const string ref = format("ctx.program.blocks[{}].params[{}]", blockIndex, index);
+            const Operand &param = program.blocks[blockIndex].params[index];
+            if (isLiteralOperand(param))
+                return numberLiteral(param.value, ref + ".value");
+            return format("getOperandValue(ctx.engine, ctx.objectId, {}, ctx.executionThreadId).asNumber()", ref);
+        }
+
+        /**
+         * @brief 분류된 명령 블록 중 핸들러와 같은 동작을 엔티티 함수 호출로 바로 쓸 수 있는 블록을 생성합니다.
+         * 파라미터 검사/경고가 필요한 블록과 그 밖의 블록은 false 를 돌려 executeBlock 으로 실행합니다.
+         */
+        bool emitDirectBlock(uint32_t blockIndex, const string &indent)
+        {
+            const Block &block = program.blocks[blockIndex];
+            const size_t paramCount = block.params.size();
+            switch (block.opcode)
+            {
+            case BlockTypeEnum::MOVE_DIRECTION:
+                if (paramCount != 1)
+                    return false;
+                out += format("{}moveEntityInDirection(ctx.engine, ctx.entity, {}, ctx.executionThreadId);\n", indent,
+                              paramNumber(blockIndex, 0));
+                return true;
+            case BlockTypeEnum::BOUNCE_WALL:
+                out += format("{}bounceEntityOffWall(ctx.engine, ctx.entity, ctx.executionThreadId);\n", indent);
+                return true;
+            case BlockTypeEnum::MOVE_X:
+            case BlockTypeEnum::MOVE_Y:
+            {
+                if (paramCount != 1)
+                    return false;
+                const char *axis = block.opcode == BlockTypeEnum::MOVE_X ? "X" : "Y";
+                out += format("{}const double distance = {};\n", indent, paramNumber(blockIndex, 0));
+                out += format("{}ctx.entity.set{}(ctx.entity.get{}() + distance);\n", indent, axis, axis);
+                return true;
+            }
+            case BlockTypeEnum::LOCATE_X:
+            case BlockTypeEnum::LOCATE_Y:
+                if (paramCount < 1)
+                    return false;
+                out += format("{}ctx.entity.set{}({});\n", indent, block.opcode == BlockTypeEnum::LOCATE_X ? "X" : "Y",
+                              paramNumber(blockIndex, 0));
+                return true;
+            case BlockTypeEnum::LOCATE_XY:
+                if (paramCount < 2)
+                    return false;
+                out += format("{}const double x = {};\n{}const double y = {};\n", indent, paramNumber(blockIndex, 0),
+                              indent, paramNumber(blockIndex, 1));
+                out += format("{}ctx.entity.setX(x);\n{}ctx.entity.setY(y);\n", indent, indent);
+                return true;
+            case BlockTypeEnum::ROTATE_RELATIVE:
+            case BlockTypeEnum::DIRECTION_RELATIVE:
+                if (paramCount < 1)
+                    return false;
+                out += format("{}const double angle = {};\n", indent, paramNumber(blockIndex, 0));
+                out += format("{}ctx.entity.setDirection(angle + ctx.entity.getDirection());\n", indent);
+                return true;
+            case BlockTypeEnum::SHOW:
+            case BlockTypeEnum::HIDE:
+                out += format("{}ctx.entity.setVisible({});\n", indent,
+                              block.opcode == BlockTypeEnum::SHOW ? "true" : "false");
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        void emitInstruction(uint32_t pc)
+        {
+            const VmInstr &instr = program.code[pc];
+            const string indent = "        ";
+            out += format("    {{ // {}: {}\n", pc, commentText(program.blocks[instr.block].type));
+            switch (instr.op)
+            {
+            case VmOp::EXEC:
+                if (emitDirectBlock(instr.block, indent))
+                    break;
+                out += format("{}executeBlock(ctx.engine, ctx.objectId, ctx.program.blocks[{}], ctx.executionThreadId, "
+                              "ctx.sceneIdAtDispatch, ctx.deltaTime);\n",
+                              indent, instr.block);
+                break;
+            case VmOp::JUMP_IF_FALSE:
+            case VmOp::JUMP_IF_TRUE:
+            {
+                string condition = emitExpr(instr.a, pc, indent);
+                out += format("{}if ({}{}.asBool())\n{}    return {};\n", indent,
+                              instr.op == VmOp::JUMP_IF_FALSE ? "!" : "", condition, indent, instr.b);
+                break;
+            }
+            case VmOp::LOOP_INIT:
+            {
+                string count = emitExpr(instr.a, pc, indent);
+                out += format("{}const double count = std::floor({}.asNumber());\n", indent, count);
+                out += format("{}ctx.loopCounters[{}] = count > 0 ? static_cast<int>(std::min(count, "
+                              "static_cast<double>(INT_MAX))) : 0;\n",
+                              indent, instr.b);
+                break;
+            }
+            case VmOp::LOOP_TEST:
+                out += format("{}if (ctx.loopCounters[{}] <= 0)\n{}    return {};\n", indent, instr.a, indent, instr.b);
+                break;
+            case VmOp::MOVE_BOUNCE:
+            case VmOp::MOVE_BOUNCE_CONST:
+            {
+                string distance = instr.op == VmOp::MOVE_BOUNCE_CONST ? numberLiteral(program, instr.a)
+                                                                      : emitExpr(instr.a, pc, indent) + ".asNumber()";
+                out += format("{}moveEntityInDirection(ctx.engine, ctx.entity, {}, ctx.executionThreadId);\n", indent,
+                              distance);
+                out += format("{}bounceEntityOffWall(ctx.engine, ctx.entity, ctx.executionThreadId);\n", indent);
+                break;
+            }
+            case VmOp::LOCATE_XY:
+            case VmOp::LOCATE_XY_CONST:
+            {
+                bool literal = instr.op == VmOp::LOCATE_XY_CONST;
+                string x = literal ? numberLiteral(program, instr.a) : emitExpr(instr.a, pc, indent) + ".asNumber()";
+                string y = literal ? numberLiteral(program, instr.b) : emitExpr(instr.b, pc, indent) + ".asNumber()";
+                out += format("{}const double x = {};\n{}const double y = {};\n", indent, x, indent, y);
+                out += format("{}ctx.entity.setX(x);\n{}ctx.entity.setY(y);\n", indent, indent);
+                break;
+            }
+            case VmOp::CHANGE_VAR:
+            case VmOp::CHANGE_VAR_CONST:
+            {
+                string value = instr.op == VmOp::CHANGE_VAR_CONST ? constantRef(instr.a) : emitExpr(instr.a, pc, indent);
+                out += format("{}changeVariableBy(ctx.engine, ctx.objectId, ctx.program.variables[{}], {}, "
+                              "ctx.executionThreadId);\n",
+                              indent, instr.b, value);
+                break;
+            }
+            case VmOp::SET_LOCAL:
+            case VmOp::CHANGE_LOCAL:
+            {
+                string value = emitExpr(instr.a, pc, indent);
+                out += format("{}{}(ctx.engine, ctx.objectId, {}, {}, ctx.executionThreadId);\n", indent,
+                              instr.op == VmOp::SET_LOCAL ? "setFunctionVariable" : "changeFunctionVariableBy",
+                              instr.b, value);
+                break;
+            }
+            case VmOp::JUMP_IF_NOT_REACH:
+                out += format("{}if (!isEntityReaching(ctx.engine, ctx.entity, {}.stringValue(), ctx.executionThreadId))\n"
+                              "{}    return {};\n",
+                              indent, constantRef(instr.a), indent, instr.b);
+                break;
+            default:
+                // 구간에는 대기 없는 명령만 들어오지만, 그 외 명령을 만나면 VM 으로 돌려보냅니다.
+                out += format("{}return {};\n", indent, pc);
+                break;
+            }
+            out += "    }\n";
+        }
+    };
+} // namespace
+
+void registerAotProgram(const AotProgram &program)
+{
+    aotRegistry()[program.fingerprint] = program;
+}
+
+uint64_t programFingerprint(const ScriptProgram &program)
+{
+    Fingerprint fp;
+    fp.add(static_cast<uint64_t>(program.code.size()));
+    for (const VmInstr &instr : program.code)
+    {
+        fp.add(static_cast<uint8_t>(instr.op));
+        fp.add(instr.flags);
+        fp.add(instr.a);
+        fp.add(instr.b);
+        fp.add(instr.block);
+    }
+    fp.add(static_cast<uint64_t>(program.exprCode.size()));
+    for (const ExprInstr &instr : program.exprCode)
+    {
+        fp.add(static_cast<uint8_t>(instr.op));
+        fp.add(instr.sub);
+        fp.add(instr.dst);
+        fp.add(instr.lhs);
+        fp.add(instr.rhs);
+        fp.add(instr.operand);
+    }
+    fp.add(static_cast<uint64_t>(program.exprs.size()));
+    for (const CompiledExpr &expr : program.exprs)
+    {
+        fp.add(expr.firstInstr);
+        fp.add(expr.instrCount);
+        fp.add(expr.result);
+    }
+    fp.add(static_cast<uint64_t>(program.constants.size()));
+    for (const OperandValue &value : program.constants)
+    {
+        // 쓰지 않는 쪽 필드에는 값 캐시가 들어 있을 수 있으므로 타입에 맞는 필드만 반영합니다.
+        const bool isNumber = value.type == OperandValue::Type::NUMBER;
+        fp.add(static_cast<uint8_t>(value.type));
+        fp.add(isNumber ? value.numberValue() : 0.0);
+        fp.add(value.booleanValue());
+        fp.add(value.type == OperandValue::Type::STRING ? value.stringValue() : string());
+    }
+    fp.add(static_cast<uint64_t>(program.blocks.size()));
+    for (const Block &block : program.blocks)
+    {
+        fp.add(static_cast<uint32_t>(block.opcode));
+        // 직접 생성한 블록은 리터럴 파라미터를 코드에 넣으므로 함께 반영합니다.
+        fp.add(static_cast<uint64_t>(block.params.size()));
+        for (const Operand &param : block.params)
+        {
+            fp.add(static_cast<uint8_t>(param.kind));
+            if (isLiteralOperand(param))
+                fp.add(param.value.asString());
+        }
+    }
+    fp.add(static_cast<uint64_t>(program.operands.size()));
+    fp.add(program.loopSlotCount);
+    return fp.value();
+}
+
+void attachAotRegions(ScriptProgram &program)
+{
+    const auto &registry = aotRegistry();
+    if (registry.empty())
+    {
+        return;
+    }
+    auto it = registry.find(programFingerprint(program));
+    if (it == registry.end())
+    {
+        return;
+    }
+    program.nativeRegions.assign(program.code.size(), nullptr);
+    for (uint32_t i = 0; i < it->second.regionCount; ++i)
+    {
+        const AotRegion &region = it->second.regions[i];
+        if (region.startPc < program.code.size())
+        {
+            program.nativeRegions[region.startPc] = region.fn;
+        }
+    }
+}
+
+string generateAotSource(const vector<pair<string, const ScriptProgram *>> &programs, size_t &regionCount)
+{
+    string out;
+    out += "// FastEntry --aot 로 생성된 파일입니다. 직접 수정하지 마세요.\n";
+    out += "// 같은 project.json 으로 빌드한 엔진에서만 연결됩니다. (바이트코드 지문이 다르면 인터프리터로 실행)\n";
+    out += "#include \"engine/blocks/AotCompiler.h\"\n";
+    out += "#include \"engine/blocks/BlockExecutor.h\"\n";
+    out += "#include \"engine/Entity.h\"\n";
+    out += "#include <algorithm>\n#include <climits>\n#include <cmath>\n\n";
+    out += "namespace\n{\n";
+
+    string registrations;
+    regionCount = 0;
+    for (size_t p = 0; p < programs.size(); ++p)
+    {
+        const ScriptProgram &program = *programs[p].second;
+        // 대기 없는 명령이 두 개 이상 이어지는 구간만 함수로 만듭니다.
+        vector<pair<uint32_t, uint32_t>> regions;
+        const uint32_t size = static_cast<uint32_t>(program.code.size());
+        for (uint32_t i = 0; i < size;)
+        {
+            if (!(program.code[i].flags & kVmInstrNoWait))
+            {
+                ++i;
+                continue;
+            }
+            uint32_t end = i + 1;
+            while (end < size && (program.code[end].flags & kVmInstrNoWait) &&
+                   (program.code[end].flags & kVmInstrUnguarded))
+            {
+                ++end;
+            }
+            if (end - i >= 2)
+            {
+                regions.emplace_back(i, end);
+            }
+            i = end;
+        }
+        if (regions.empty())
+        {
+            continue;
+        }
+
+        out += format("// {}\n", commentText(programs[p].first));
+        AotEmitter emitter(program, out);
+        string table = format("const AotRegion aot_p{}_regions[] = {{\n", p);
+        for (const auto &[begin, end] : regions)
+        {
+            string name = format("aot_p{}_r{}", p, begin);
+            emitter.emitRegion(name, begin, end);
+            table += format("    {{{}, {}}},\n", begin, name);
+        }
+        table += "};\n\n";
+        out += table;
+        registrations += format("    registerAotProgram({{0x{:016x}ull, aot_p{}_regions, {}}});\n",
+                                programFingerprint(program), p, regions.size());
+        regionCount += regions.size();
+    }
+
+    out += "[[maybe_unused]] const bool aotRegistered = [] {\n";
+    out += registrations;
+    out += "    return true;\n}();\n";
+    out += "} // namespace\n";
+    return out;
+}
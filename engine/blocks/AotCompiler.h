@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ScriptCompiler.h"
+
+class Engine;
+class Entity;
+
+/*
+ * AOT (ahead-of-time) 컴파일
+ *
+ * FastEntry --aot project.json -o out/ 는 로드 시 만든 ScriptProgram 중 대기 없는 직선 구간
+ * (kVmInstrNoWait / kVmInstrUnguarded 로 표시된 명령들)을 C++ 함수로 옮긴 소스를 생성합니다.
+ * 생성된 소스를 엔진과 함께 빌드하면(cmake -DOMOCHA_AOT_SOURCE=out/omocha_aot.cpp) 정적 초기화 때
+ * registerAotProgram 으로 등록되고, 같은 프로젝트를 로드할 때 바이트코드 지문이 일치하는 프로그램에
+ * 연결되어 VM 은 구간 전체를 명령 디스패치 없이 한 번의 호출로 실행합니다.
+ * 양보/호출/대기가 필요한 명령은 그대로 VM 이 실행하므로 동작은 인터프리터와 같습니다.
+ * 구간 안의 EXEC 는 핸들러와 같은 동작을 엔티티 함수로 바로 쓸 수 있는 블록(이동/위치/방향/보이기)만
+ * 직접 호출로 바뀌고, 나머지는 생성된 코드에서도 executeBlock 을 호출합니다.
+ */
+
+// 생성된 구간 함수가 사용하는 실행 문맥
+struct AotRegionContext
+{
+    Engine &engine;
+    Entity &entity;
+    const std::string &objectId;
+    const ScriptProgram &program;
+    const std::string &executionThreadId;
+    const std::string &sceneIdAtDispatch;
+    float deltaTime;
+    int *loopCounters; // 현재 호출 프레임의 반복 슬롯 (programLoopCounters + loopBase)
+};
+
+struct AotRegion
+{
+    uint32_t startPc;
+    AotRegionFn fn;
+};
+
+struct AotProgram
+{
+    uint64_t fingerprint;
+    const AotRegion *regions;
+    uint32_t regionCount;
+};
+
+// 생성된 소스가 정적 초기화 때 호출합니다.
+void registerAotProgram(const AotProgram &program);
+
+/**
+ * @brief 바이트코드 지문. 생성된 코드가 참조하는 명령/표현식/상수 테이블이 같은지 확인하는 데 사용합니다.
+ */
+uint64_t programFingerprint(const ScriptProgram &program);
+
+/**
+ * @brief 지문이 일치하는 등록된 AOT 프로그램이 있으면 program.nativeRegions 에 연결합니다.
+ */
+void attachAotRegions(ScriptProgram &program);
+
+/**
+ * @brief AOT 소스를 생성합니다.
+ * @param programs <로그/주석용 이름, 프로그램> 목록
+ * @param regionCount 생성한 구간 함수 수
+ */
+std::string generateAotSource(const std::vector<std::pair<std::string, const ScriptProgram *>> &programs,
+                              size_t &regionCount);
+
+// 생성된 코드에서 LOAD_ARG 를 계산합니다.
+inline OperandValue aotLoadArg(int index)
+{
+    const OperandValue *arg = currentFunctionArgs().get(index);
+    return arg ? *arg : OperandValue();
+}
@@ -1,38 +1,77 @@
 #pragma once
 
 #include <iostream> // 임시 로깅을 위해 추가
+#include <memory>
 #include <string>
 #include <vector>
-#include <nlohmann/json.hpp>
+#include "blockTypes.h"
+#include "OperandValue.h"
 #ifdef _WIN32
 #include <windows.h> // OutputDebugStringA를 위해 추가
 #include <string>    // std::string을 위해 추가
 #include <sstream>   // std::ostringstream을 위해 추가
 #endif
 struct Script;
+struct ScriptProgram;
+class Block;
+
+/**
+ * @brief 로드 시 JSON 파라미터를 미리 해석해 둔 피연산자 노드
+ * 리터럴은 최종 OperandValue 로, 리포터 블록은 파라미터까지 해석된 Block 으로 보관하므로
+ * 실행 중에는 JSON 을 다시 읽지 않습니다.
+ */
+struct Operand
+{
+    enum class Kind
+    {
+        NONE,     // null 파라미터
+        NUMBER,   // JSON 숫자
+        STRING,   // JSON 문자열 (드롭다운 값, 변수/리스트/신호 ID 등)
+        BOOLEAN,  // JSON 불리언
+        LITERAL,  // number / text / angle 등 값이 고정된 리터럴 블록
+        REPORTER, // 실행 시 Calculator 로 평가할 리포터 블록
+        INVALID   // 지원하지 않거나 형식이 잘못된 블록 (평가 시 경고 후 value 반환)
+    };
+    Kind kind = Kind::NONE;
+    OperandValue value;                 // NUMBER / STRING / BOOLEAN / LITERAL / INVALID 의 값
+    std::shared_ptr<const Block> block; // REPORTER 블록
+    std::string blockType;              // REPORTER / LITERAL / INVALID 의 원본 블록 타입 (로그용)
+
+    bool isNull() const { return kind == Kind::NONE; }
+    bool isString() const { return kind == Kind::STRING; }
+    bool isNumber() const { return kind == Kind::NUMBER; }
+    bool isBlock() const { return kind == Kind::LITERAL || kind == Kind::REPORTER || kind == Kind::INVALID; }
+    // 로그 출력용 요약 문자열
+    std::string describe() const;
+};
 
 class Block
 {
 public:
     std::string id;
     std::string type;
-    nlohmann::json paramsJson; // Value에서 Document로 변경
+    Omocha::BlockTypeEnum opcode = Omocha::BlockTypeEnum::UNKNOWN; // 로드 시 type 에서 한 번만 해석
+    std::vector<Operand> params; // 로드 시 해석된 파라미터 (null 은 제거됨)
     std::vector<Script> statementScripts;
+    int loopSlot = -1; // 트리 인터프리터 반복 블록의 스크립트/함수 본문 안 슬롯 (로드 시 assignLoopSlots 가 지정, ScriptThreadState::treeLoopSlot 로 변환)
 
-    Block() {} // Document는 기본 생성 시 kNullType 입니다.
-    Block(const std::string &blockType) : type(blockType) {}
+    Block() {}
+    Block(const std::string &blockType) : type(blockType), opcode(Omocha::stringToBlockTypeEnum(blockType)) {}
 
     // 복사 생성자
-    Block(const Block &other) : id(other.id), type(other.type), statementScripts(other.statementScripts)
+    Block(const Block &other) : id(other.id), type(other.type), opcode(other.opcode),
+                                params(other.params), statementScripts(other.statementScripts),
+                                loopSlot(other.loopSlot)
     {
-        paramsJson = other.paramsJson;
     }
     // 이동 생성자 (권장)
     Block(Block &&other) noexcept
         : id(std::move(other.id)),
           type(std::move(other.type)),
-          paramsJson(std::move(other.paramsJson)), // rapidjson::Document도 이동 가능
-          statementScripts(std::move(other.statementScripts))
+          opcode(other.opcode),
+          params(std::move(other.params)),
+          statementScripts(std::move(other.statementScripts)),
+          loopSlot(other.loopSlot)
     {
     }
 
@@ -43,8 +82,10 @@ public:
             return *this;
         id = other.id;
         type = other.type;
-        paramsJson = other.paramsJson;
+        opcode = other.opcode;
+        params = other.params;
         statementScripts = other.statementScripts;
+        loopSlot = other.loopSlot;
         return *this;
     }
     // 이동 대입 연산자
@@ -54,32 +95,61 @@ public:
             return *this;
         id = std::move(other.id);
         type = std::move(other.type);
-        paramsJson = std::move(other.paramsJson);
+        opcode = other.opcode;
+        params = std::move(other.params);
         statementScripts = std::move(other.statementScripts);
+        loopSlot = other.loopSlot;
         return *this;
     }
 
     void printInfo(int indent = 0) const;
+};
 
-    // paramsJson 배열 내의 null 값을 제거하는 메서드
-    void FilterNullsInParamsJsonArray()
+struct Script
+{
+    std::vector<Block> blocks;
+    std::shared_ptr<const ScriptProgram> program; // 로드 시 compileScript 로 생성 (없으면 트리 인터프리터로 실행)
+    int treeLoopSlotCount = 0;                    // assignLoopSlots 가 지정한 Block::loopSlot 수
+    bool usesSharedState = false;                 // 변수/리스트 등 엔진 전역 상태를 읽거나 씀 (로드 시 analyzeSharedState)
+};
+/**
+ * @brief 프로젝트 functions 배열의 사용자 함수 (func_<id> 블록으로 호출)
+ * 본문은 스크립트와 같이 ScriptProgram 으로 컴파일되고, 호출 시 인자는 스레드별 호출 프레임에 저장됩니다.
+ */
+struct UserFunction
+{
+    std::string id;
+    bool returnsValue = false;             // type == "value" (리포터로 호출되어 결과값을 반환)
+    bool runWithoutScreenRefresh = false;  // 화면 새로 고침 없이 실행 (반복문이 프레임마다 양보하지 않음)
+    std::vector<std::string> paramTypes;   // 호출 블록 params 순서의 파라미터 블록 타입 (stringParam_xxx / booleanParam_xxx)
+    std::vector<std::string> localVariableIds;    // 함수 지역 변수 ID. 호출 프레임에서 인자 바로 뒤 자리를 씁니다.
+    std::vector<OperandValue> localVariableValues; // 호출할 때마다 지역 변수에 넣는 초기값 (localVariableIds 순서)
+    Script body;                           // blocks[0] 은 function_create 블록
+    Operand returnValue;                   // 결과값 (returnsValue 일 때)
+    uint32_t returnExpr = 0;               // program->exprs 에서 returnValue 를 계산하는 표현식
+
+    // 파라미터 블록 타입의 인자 인덱스. 없으면 -1
+    int paramIndex(const std::string &paramType) const
     {
-        if (paramsJson.is_array() && !paramsJson.empty())
+        for (size_t i = 0; i < paramTypes.size(); ++i)
         {
-            nlohmann::json filteredArray = nlohmann::json::array();
-            for (const auto &item : paramsJson)
-            {
-                if (!item.is_null())
-                {
-                    filteredArray.push_back(item); // nlohmann::json은 값 복사
-                }
-            }
-            paramsJson = std::move(filteredArray);
+            if (paramTypes[i] == paramType)
+                return static_cast<int>(i);
         }
+        return -1;
     }
-};
 
-struct Script
-{
-    std::vector<Block> blocks;
-};
\ No newline at end of file
+    // 지역 변수의 프레임 자리 (인자 수 + 지역 변수 순번). 없으면 -1
+    int localVariableSlot(const std::string &variableId) const
+    {
+        for (size_t i = 0; i < localVariableIds.size(); ++i)
+        {
+            if (localVariableIds[i] == variableId)
+                return static_cast<int>(paramTypes.size() + i);
+        }
+        return -1;
+    }
+
+    // 호출 프레임 하나가 frameValues 에서 차지하는 자리 수 (인자 + 지역 변수)
+    size_t frameSlotCount() const { return paramTypes.size() + localVariableIds.size(); }
+};
@@ -2,6 +2,7 @@
 #include "util/AEhelper.h"
 #include "../Engine.h"
 #include "../Entity.h"
+#include "ScriptCompiler.h"
 #include <string>
 #include <vector>
 #include <thread>
@@ -13,458 +14,446 @@
 #include <random> // For mt19937 and uniform_real_distribution
 #include <future>
 #include <algorithm> // For clamp
+#include <array>
+#include <charconv>
+#include <string_view>
 #include <format>    // For format
 
 #include "util/TrigValue.h"
 
+using Omocha::BlockTypeEnum;
+
 AudioEngineHelper aeHelper; // 전역 AudioEngineHelper 인스턴스
 
 // Helper function to check if a string can be parsed as a number
 bool is_number(const string &s)
 {
-    string str = s;
-    trim(str);
-    if (str.empty())
-        return false;
-    try
-    {
-        size_t pos;
-        stod(str, &pos); // Use trimmed string
-        // Check if the entire string was consumed by stod and it's not just a prefix
-        return pos == str.length();
-    }
-    catch (const invalid_argument &)
-    {
-        return false;
-    }
-    catch (const out_of_range &)
-    {
-        return false;
-    }
+    double ignored;
+    return parseNumberStrict(s, ignored);
 }
 
-// ThreadPool 생성자 구현
-ThreadPool::ThreadPool(Engine &eng, size_t threads, size_t maxQueueSize)
-    : engine(eng), stop(false), max_queue_size(maxQueueSize)
-{
-    engine.EngineStdOut("ThreadPool initalize.", 3);
-
-    for (size_t i = 0; i < threads; ++i)
-    {
-        workers.emplace_back([this, i]
-                             {
-            engine.EngineStdOut(format("{} WorkerThread Started.", i), 3); // 이 로그는 EngineStdOut의 스레드 안전성에 따라 주의
-
-            while (true) {
-                function<void()> task_fn; // 변수 이름 변경 (task -> task_fn)
-                {
-                    unique_lock<mutex> lock(this->queue_mutex);
-                    this->condition.wait(lock, [this] {
-                        return this->stop || !this->tasks.empty();
-                    });
-
-                    if (this->stop && this->tasks.empty()) {
-                        engine.EngineStdOut(format("{} Ended.", i), 3);
-                        return;
-                    }
-
-                    task_fn = move(this->tasks.top().second);
-                    this->tasks.pop();
-                    this->queue_space_available.notify_one();
-                }
-
-                try {
-                    task_fn();
-                } catch (const exception &e) {
-                    engine.EngineStdOut(format("{} WorkerThread Exception: {}", i, e.what()), 3);
-                }
-            } });
-        engine.EngineStdOut(format("{}WorkerThread Created.", i), 3);
-    }
-    engine.EngineStdOut("ThreadPool initalized.", 0);
-}
+PublicVariable publicVariable; // 전역 PublicVariable 인스턴스
 
-// OperandValue 생성자 및 멤버 함수 구현 (BlockExecutor.h에 선언됨)
-OperandValue::OperandValue() : type(Type::EMPTY), boolean_val(false), number_val(0.0)
+bool isReporterBlockType(BlockTypeEnum type)
 {
+    // 타이머 제어/표시 블록은 Calculator 에서 처리하지만 값을 반환하지 않는 명령 블록입니다.
+    // 사용자 함수 호출은 값 반환 함수일 때 리포터로 쓰입니다.
+    return (Omocha::blockTypeEnumToCategory(type) == Omocha::BlockCategory::CALCULATOR &&
+            type != BlockTypeEnum::CHOOSE_PROJECT_TIMER_ACTION &&
+            type != BlockTypeEnum::SET_VISIBLE_PROJECT_TIMER) ||
+           type == BlockTypeEnum::FUNCTION_CALL;
 }
 
-OperandValue::OperandValue(double val) : type(Type::NUMBER), number_val(val), boolean_val(false)
-{
-}
+// processVariableBlock 선언이 누락된 것 같아 추가 (필요하다면)
+// OperandValue processVariableBlock(Engine &engine, const string &objectId, const Block &block);
 
-OperandValue::OperandValue(const string &val) : type(Type::STRING), string_val(val), boolean_val(false),
-                                                number_val(0.0)
+Operand parseOperand(Engine &engine, const nlohmann::json &paramField, const string &context)
 {
-}
+    Operand operand;
+    if (paramField.is_null())
+    {
+        return operand; // NONE
+    }
+    // 1. 숫자 / 문자열 / 불리언 리터럴
+    if (paramField.is_number())
+    {
+        operand.kind = Operand::Kind::NUMBER;
+        operand.value = OperandValue(paramField.get<double>());
+        return operand;
+    }
+    if (paramField.is_string())
+    {
+        operand.kind = Operand::Kind::STRING;
+        operand.value = OperandValue(paramField.get<string>());
+        return operand;
+    }
+    if (paramField.is_boolean())
+    {
+        operand.kind = Operand::Kind::BOOLEAN;
+        operand.value = OperandValue(paramField.get<bool>());
+        return operand;
+    }
+    if (!paramField.is_object())
+    {
+        // 배열 등은 빈 값으로 평가됩니다.
+        operand.kind = Operand::Kind::LITERAL;
+        return operand;
+    }
 
-OperandValue::OperandValue(bool val) : type(Type::BOOLEAN), boolean_val(val), number_val(0.0)
-{
-}
+    // 2. 객체 타입 (블록 형태)
+    if (!paramField.contains("type") || !paramField["type"].is_string())
+    {
+        engine.EngineStdOut("Parameter field is object but missing 'type' in " + context, 2);
+        operand.kind = Operand::Kind::INVALID;
+        operand.value = OperandValue(nan("")); // 숫자 반환이 기대될 수 있으므로 NaN
+        return operand;
+    }
+    const string fieldType = paramField["type"].get<string>();
+    operand.blockType = fieldType;
+    const nlohmann::json *params = nullptr;
+    if (paramField.contains("params"))
+    {
+        params = &paramField["params"];
+    }
+    const nlohmann::json *firstParam = (params && params->is_array() && !params->empty()) ? &(*params)[0] : nullptr;
 
-PublicVariable publicVariable; // 전역 PublicVariable 인스턴스
-double OperandValue::asNumber() const
-{
-    if (type == Type::NUMBER)
+    // 값이 고정된 리터럴 블록은 로드 시 최종 값으로 변환합니다.
+    operand.kind = Operand::Kind::LITERAL;
+    if (fieldType == "number" || fieldType == "text_reporter_number")
     {
-        return number_val;
+        if (firstParam && firstParam->is_string())
+        {
+            operand.value = OperandValue(OperandValue(firstParam->get<string>()).asNumber());
+            return operand;
+        }
+        if (firstParam && firstParam->is_number())
+        {
+            operand.value = OperandValue(firstParam->get<double>());
+            return operand;
+        }
+        engine.EngineStdOut("Invalid '" + fieldType + "' block structure in " + context +
+                                ". Expected params[0] to be a string or number.",
+                            1);
+        operand.value = OperandValue(0.0);
+        return operand;
     }
-    if (type == Type::STRING)
+    if (fieldType == "text" || fieldType == "text_reporter_string" || fieldType == "text_color" ||
+        fieldType == "get_pictures" || fieldType == "get_sounds")
     {
-        string temp_str = string_val;
-        trim(temp_str); // 앞뒤 공백 제거 (이미 수정된 것으로 확인됨)
-        if (temp_str.empty())
+        if (firstParam && firstParam->is_string())
         {
-            return 0.0;
+            operand.value = OperandValue(firstParam->get<string>());
+            return operand;
         }
-
-        // 1. double로 파싱 시도 (로케일 독립적인 방식)
-        istringstream iss_double(temp_str);
-        iss_double.imbue(locale::classic()); // "C" 로케일 사용
-        double double_val;
-        iss_double >> double_val;
-
-        // 파싱 성공하고 문자열 전체가 소모되었는지 확인
-        // eof는 모든 문자가 소모된 후 다음 읽기 시도 시 설정됨.
-        // 따라서, 파싱 성공 후 추가적인 문자가 없는지 확인하기 위해 iss_double.peek() == EOF 또는 iss_double.rdbuf()->in_avail() == 0 등을 사용할 수 있음.
-        // 더 간단하게는, 파싱 후 스트림의 상태만 확인하고, 남은 문자가 있다면 아래 정수 파싱으로 넘어가지 않도록 처리.
-        if (!iss_double.fail() && iss_double.eof()) // 모든 문자가 성공적으로 double로 변환된 경우
+        engine.EngineStdOut("Invalid '" + fieldType + "' block structure in " + context +
+                                ". Expected params[0] to be a string.",
+                            1);
+        operand.value = OperandValue(string(fieldType == "text_color" ? "#000000" : ""));
+        return operand;
+    }
+    if (fieldType == "angle")
+    {
+        if (firstParam && firstParam->is_number())
         {
-            return double_val;
+            operand.value = OperandValue(firstParam->get<double>());
+            return operand;
         }
-
-        // 파싱 실패 또는 일부만 성공 시 스트림 상태 초기화
-        iss_double.clear();  // 오류 플래그 초기화
-        iss_double.seekg(0); // 스트림 위치 처음으로
-
-        // 2. double 파싱이 완벽하지 않았거나 실패 시, long long (정수)으로 파싱 시도
-        istringstream iss_long_long(temp_str);
-        iss_long_long.imbue(locale::classic()); // "C" 로케일 사용
-        long long ll_val;
-        iss_long_long >> ll_val;
-
-        if (!iss_long_long.fail() && iss_long_long.eof()) // 모든 문자가 성공적으로 long long으로 변환된 경우
+        if (firstParam && firstParam->is_string())
         {
-            return static_cast<double>(ll_val);
+            string angle_str = firstParam->get<string>();
+            if (is_number(angle_str))
+            {
+                try
+                {
+                    operand.value = OperandValue(stod(angle_str));
+                    return operand;
+                }
+                catch (const exception &e)
+                {
+                    engine.EngineStdOut("Error: 'angle' block in " + context + " could not convert \"" + angle_str +
+                                            "\". Error: " + e.what(),
+                                        2);
+                }
+            }
+            else
+            {
+                engine.EngineStdOut("Error: 'angle' block in " + context + " param is string but not a valid number: \"" +
+                                        angle_str + "\". Using NaN.",
+                                    2);
+            }
+            operand.value = OperandValue(nan(""));
+            return operand;
         }
+        operand.kind = Operand::Kind::INVALID;
+        return operand;
+    }
 
-        // 3. 두 방식 모두 실패 시 0.0 반환 (EntryJS 유사 동작)
-        // engine.EngineStdOut("OperandValue::asNumber: String '" + temp_str + "' could not be converted to a number.", 1); // 필요시 로그
-        return 0.0;
+    // 리포터 블록은 파라미터까지 재귀적으로 해석해 둡니다.
+    BlockTypeEnum fieldOpcode = Omocha::stringToBlockTypeEnum(fieldType);
+    if (!isReporterBlockType(fieldOpcode))
+    {
+        engine.EngineStdOut("Unsupported block type in parameter: " + fieldType + " in " + context, 1);
+        operand.kind = Operand::Kind::INVALID;
+        return operand;
     }
-    if (type == Type::BOOLEAN)
+    auto subBlock = make_shared<Block>(fieldType);
+    if (paramField.contains("id") && paramField["id"].is_string())
+        subBlock->id = paramField["id"].get<string>();
+    if (params)
     {
-        return boolean_val ? 1.0 : 0.0;
+        if (!params->is_array())
+        {
+            engine.EngineStdOut("Error: 'params' member of " + fieldType + " in " + context +
+                                    " is not an array. Actual type: " + params->type_name() + ". Value: " + params->dump(),
+                                2);
+            operand.kind = Operand::Kind::INVALID;
+            return operand;
+        }
+        subBlock->params = parseOperands(engine, *params, context + " -> " + fieldType);
     }
-    // EMPTY 또는 처리되지 않은 타입
-    return 0.0;
+    operand.kind = Operand::Kind::REPORTER;
+    operand.block = std::move(subBlock);
+    return operand;
 }
 
-string OperandValue::asString() const
+vector<Operand> parseOperands(Engine &engine, const nlohmann::json &paramsArray, const string &context)
 {
-    if (type == Type::STRING)
-        return string_val;
-    if (type == Type::NUMBER)
+    vector<Operand> operands;
+    if (!paramsArray.is_array())
     {
-        if (isnan(number_val))
-            return "NaN";
-        if (isinf(number_val))
-            return (number_val > 0 ? "Infinity" : "-Infinity");
-
-        string s = to_string(number_val);
-        // Remove trailing zeros and decimal point if it's the last char
-        s.erase(s.find_last_not_of('0') + 1, string::npos);
-        if (!s.empty() && s.back() == '.')
-        {
-            s.pop_back();
-        }
-        return s;
+        return operands;
     }
-    if (type == Type::BOOLEAN)
+    operands.reserve(paramsArray.size());
+    for (const auto &item : paramsArray)
     {
-        return boolean_val ? "true" : "false";
+        if (!item.is_null()) // null 은 미리 제거합니다.
+        {
+            operands.push_back(parseOperand(engine, item, context));
+            // 로드 후에는 여러 스레드가 같은 값을 읽으므로 캐시를 미리 채워 둡니다.
+            operands.back().value.precompute();
+        }
     }
-    return ""; // Default for EMPTY or unhandled types
+    return operands;
 }
 
-bool OperandValue::asBool() const
+string Operand::describe() const
 {
-    if (type == Type::BOOLEAN)
-        return boolean_val;
-    if (type == Type::NUMBER)
-        return number_val != 0.0; // 0 is false, non-zero is true
-    if (type == Type::STRING)
-    {
-        // Mimic JavaScript-like truthiness:
-        // Empty string is false.
-        // "false" (case-insensitive) is false.
-        // "0" is false.
-        // Otherwise, true.
-        string lower_str = string_val;
-        ranges::transform(lower_str, lower_str.begin(), ::tolower);
-        return !string_val.empty() && lower_str != "false" && string_val != "0";
-    }
-    // EMPTY or unhandled types are false
-    return false;
+    switch (kind)
+    {
+    case Kind::NONE:
+        return "null";
+    case Kind::NUMBER:
+    case Kind::BOOLEAN:
+        return value.asString();
+    case Kind::STRING:
+        return "\"" + value.stringValue() + "\"";
+    case Kind::REPORTER:
+        return blockType + "(" + describeOperands(block->params) + ")";
+    default:
+        return blockType + "{" + value.asString() + "}";
+    }
 }
 
-// processVariableBlock 선언이 누락된 것 같아 추가 (필요하다면)
-// OperandValue processVariableBlock(Engine &engine, const string &objectId, const Block &block);
+string describeOperands(const vector<Operand> &operands)
+{
+    string result;
+    for (size_t i = 0; i < operands.size(); ++i)
+    {
+        if (i > 0)
+            result += ", ";
+        result += operands[i].describe();
+    }
+    return "[" + result + "]";
+}
 
-OperandValue getOperandValue(Engine &engine, const string &objectId, const nlohmann::json &paramField,
+OperandValue getOperandValue(Engine &engine, const string &objectId, const Operand &operand,
                              const string &executionThreadId)
 {
-    if (paramField.is_null())
+    switch (operand.kind)
     {
+    case Operand::Kind::REPORTER:
+        return Calculator(operand.block->type, engine, objectId, *operand.block, executionThreadId);
+    case Operand::Kind::NONE:
         engine.EngineStdOut(
             "getOperandValue received a Null paramField for object " + objectId + ". Returning empty OperandValue.", 1,
             executionThreadId);
-        return {}; // Null 값은 빈 OperandValue로 처리
+        return {};
+    case Operand::Kind::INVALID:
+        engine.EngineStdOut("Unsupported block type in parameter: " + operand.blockType + " for " + objectId, 1,
+                            executionThreadId);
+        return operand.value;
+    default:
+        return operand.value;
     }
+}
 
-    // 1. 숫자 타입 직접 확인 (가장 먼저)
-    if (paramField.is_number())
+/**
+ * @brief move_direction 의 이동 처리. 거리는 이미 평가된 값을 받습니다.
+ */
+void moveEntityInDirection(Engine &engine, Entity &entity, double dist, const string &executionThreadId)
+{
+    if (!isfinite(dist))
     {
-        double getNumber = paramField.get<double>();
-        return OperandValue(getNumber); // 숫자 타입 OperandValue 반환
+        // NaN 또는 Infinity 검사
+        engine.EngineStdOut(
+            "Moving block (move_direction) for object " + entity.getId() +
+                ": Distance parameter resolved to non-finite value (" + to_string(dist) +
+                "). Using 0.0 as fallback.",
+            1, executionThreadId);
+        dist = 0.0;
     }
-    // 2. 문자열 타입 확인
-    else if (paramField.is_string())
+
+    // 엔티티의 현재 방향을 가져옵니다 (엔트리 각도: 0도 위, 90도 오른쪽).
+    double dir_entry_degrees = entity.getDirection();
+    double dir_entry_radians = dir_entry_degrees * (SDL_PI_D / 180.0);
+
+    // 엔트리 각도(0도 위) 기준 올바른 X, Y 이동량 계산
+    // X 변화량 = 거리 * sin(엔트리 각도_라디안)
+    // Y 변화량 = 거리 * cos(엔트리 각도_라디안) (Y축이 위로 갈수록 증가하는 좌표계)
+    double deltaX = dist * sin(dir_entry_radians);
+    double deltaY = dist * cos(dir_entry_radians); // 게임 월드 Y 좌표는 위쪽이 양수
+
+    double newX = entity.getX() + deltaX;
+    double newY = entity.getY() + deltaY;
+
+    entity.setX(newX);
+    entity.setY(newY);
+
+    // 펜 업데이트 (필요한 경우)
+    if (entity.paint.isPenDown && !entity.paint.isStopped())
     {
-        // is_number()가 false일 때만 실행됨
-        string str_val_for_op = paramField.get<string>();
-        return OperandValue(str_val_for_op); // OperandValue 생성자 변경에 따라 수정
+        entity.paint.updatePositionAndDraw(entity.getX(), entity.getY());
     }
-    // 3. 객체 타입 확인 (블록 형태)
-    else if (paramField.is_object())
+    if (entity.brush.isPenDown && !entity.brush.isStopped())
     {
-        if (!paramField.contains("type") || !paramField["type"].is_string())
-        {
-            engine.EngineStdOut(format("Parameter field is object but missing 'type' for object {}", objectId), 2,
-                                executionThreadId); // executionThreadId 추가
-            return OperandValue(nan(""));           // 숫자 반환이 기대될 수 있으므로 NaN 또는 오류 처리
-        }
-        string fieldType = paramField["type"].get<string>();
+        entity.brush.updatePositionAndDraw(entity.getX(), entity.getY());
+    }
+}
+
+/**
+ * @brief bounce_wall 의 벽 반사 처리
+ */
+void bounceEntityOffWall(Engine &engine, Entity &entity, const string &executionThreadId)
+{
+    double entityX = entity.getX();
+    double entityY = entity.getY();
+    double entityWidth = entity.getWidth() * abs(entity.getScaleX());
+    double entityHeight = entity.getHeight() * abs(entity.getScaleY());
+
+    double originalDirection = entity.getDirection(); // 0도 위, 90도 오른쪽
+    double newDirection = originalDirection;
+
+    double halfWidth = entityWidth / 2.0;
+    double halfHeight = entityHeight / 2.0;
+
+    double entityTop = entityY + halfHeight;
+    double entityBottom = entityY - halfHeight;
+    double entityRight = entityX + halfWidth;
+    double entityLeft = entityX - halfWidth;
+
+    const double stageTopEdge = PROJECT_STAGE_HEIGHT / 2.0;
+    const double stageBottomEdge = -PROJECT_STAGE_HEIGHT / 2.0;
+    const double stageRightEdge = PROJECT_STAGE_WIDTH / 2.0;
+    const double stageLeftEdge = -PROJECT_STAGE_WIDTH / 2.0;
+
+    // --- 중요: pushBackAmount 값을 충분히 크게 설정해주세요 ---
+    // 엔티티의 크기나 평균 이동 속도보다 큰 값으로 설정하는 것이 좋습니다. (예: 10.0f, 15.0f 또는 그 이상)
+    const float pushBackAmount = 10.0f; // 이전 값(예: 5.0f)보다 더 크게 설정해보세요.
+    bool newCollisionOccurred = false;
+
+    Entity::CollisionSide lastWallHit = entity.getLastCollisionSide();
+    Entity::CollisionSide currentWallHitThisFrame = Entity::CollisionSide::NONE;
+
+    // --- 수정된 방향 조건 ---
+    // 0도: 위, 90도: 오른쪽, 180도: 아래, 270도: 왼쪽
+
+    // 1. 위쪽 벽 충돌 조건: 엔티티가 위쪽으로 이동 중인가? (방향 각도가 270~360 또는 0~90 사이)
+    bool movingTowardsTop = (originalDirection > 270.0 || originalDirection < 90.0);
+    // 2. 아래쪽 벽 충돌 조건: 엔티티가 아래쪽으로 이동 중인가? (방향 각도가 90~270 사이)
+    bool movingTowardsBottom = (originalDirection > 90.0 && originalDirection < 270.0);
 
-        if (fieldType == "number" || fieldType == "text_reporter_number")
+    // 위쪽 벽 충돌 처리
+    if (entityTop > stageTopEdge && movingTowardsTop)
+    {
+        if (lastWallHit != Entity::CollisionSide::UP)
         {
-            if (paramField.contains("params") && paramField["params"].is_array() &&
-                !paramField["params"].empty())
-            {
-                const auto &param_zero = paramField["params"][0];
-                if (param_zero.is_string())
-                {
-                    string num_str_param = param_zero.get<string>();
-                    // OperandValue temp_op_val(num_str_param); // 임시 객체 생성 줄임
-                    // double numeric_value = temp_op_val.asNumber();
-                    return OperandValue(OperandValue(num_str_param).asNumber()); // 직접 변환 후 반환
-                }
-                if (param_zero.is_number())
-                {
-                    return OperandValue(param_zero.get<double>()); // 중괄호 제거
-                }
-            }
-            engine.EngineStdOut(
-                "Invalid 'number' or 'text_reporter_number' block structure in parameter field for " + objectId +
-                    ". Expected params[0] to be a string or number.",
-                1, executionThreadId);
-            return OperandValue(0.0); // 중괄호 제거
+            engine.EngineStdOut(format("bounce_top {}", entity.getId()), 3, executionThreadId);
+            newDirection = 180.0 - originalDirection; // Y축 반사는 (180 - 각도) 또는 (360 - 각도) 중 상황에 맞게
+            // 현재 0도 위쪽 시스템에서는 (360 - 각도) % 360 또는 -각도 % 360 이 더 적합할 수 있으나,
+            // 기존 180 - originalDirection 이 대칭적으로 잘 동작했다면 유지합니다.
+            // (엔트리/스크래치는 180-각도를 사용합니다)
+            entity.setY(stageTopEdge - halfHeight - pushBackAmount);
+            newCollisionOccurred = true;
+            currentWallHitThisFrame = Entity::CollisionSide::UP;
         }
-        else if (fieldType == "text" || fieldType == "text_reporter_string")
+    }
+    // 아래쪽 벽 충돌 처리
+    else if (entityBottom < stageBottomEdge && movingTowardsBottom)
+    {
+        if (lastWallHit != Entity::CollisionSide::DOWN)
         {
-            if (paramField.contains("params") && paramField["params"].is_array() &&
-                !paramField["params"].empty() && paramField["params"][0].is_string())
-            {
-                return OperandValue(paramField["params"][0].get<string>()); // 중괄호 제거
-            }
-            engine.EngineStdOut(
-                "Invalid 'text' or 'text_reporter_string' block structure in parameter field for " + objectId +
-                    ". Expected params[0] to be a string.",
-                1, executionThreadId);
-            return OperandValue("");
+            engine.EngineStdOut(format("bounce_bottom {}", entity.getId()), 3, executionThreadId);
+            newDirection = 180.0 - originalDirection;
+            entity.setY(stageBottomEdge + halfHeight + pushBackAmount);
+            newCollisionOccurred = true;
+            currentWallHitThisFrame = Entity::CollisionSide::DOWN;
         }
-        else if (fieldType == "calc_basic" || fieldType == "calc_rand" || fieldType == "quotient_and_mod" || fieldType == "calc_operation" ||
-                 fieldType == "distance_something" || fieldType == "length_of_string" || fieldType == "reverse_of_string" ||
-                 fieldType == "combine_something" || fieldType == "char_at" || fieldType == "substring" ||
-                 fieldType == "count_match_string" || fieldType == "index_of_string" || fieldType == "replace_string" ||
-                 fieldType == "change_string_case" || fieldType == "get_block_count" || fieldType == "change_rgb_to_hex" ||
-                 fieldType == "change_hex_to_rgb" || fieldType == "get_boolean_value" || fieldType == "get_project_timer_value" ||
-                 fieldType == "get_date" || fieldType == "get_user_name" || fieldType == "get_nickname" ||
-                 fieldType == "get_sound_volume" || fieldType == "get_sound_speed" || fieldType == "get_sound_duration" ||
-                 fieldType == "get_canvas_input_value" || fieldType == "length_of_list" || fieldType == "is_included_in_list" ||
-                 fieldType == "coordinate_mouse" || fieldType == "coordinate_object" || fieldType == "get_variable" ||
-                 fieldType == "reach_something" ||
-                 fieldType == "is_type" ||
-                 fieldType == "boolean_basic_operator" ||
-                 fieldType == "boolean_and_or" ||
-                 fieldType == "boolean_not" ||
-                 fieldType == "is_boost_mode" ||
-                 fieldType == "is_current_device_type" ||
-                 fieldType == "is_touch_supported" ||
-                 fieldType == "text_read" ||
-                 fieldType == "is_clicked" || fieldType == "is_object_clicked" || fieldType == "is_press_some_key" ||
-                 fieldType == "value_of_index_from_list")
-        {
-            Block subBlock;
-            subBlock.type = fieldType;
-            if (paramField.contains("id") && paramField["id"].is_string())
-                subBlock.id = paramField["id"].get<string>();
-            // --- params 필드 유효성 검사 강화 ---
-            if (paramField.contains("params"))
-            {
-                const auto &paramsMember = paramField["params"];
-                if (paramsMember.is_array())
-                {
-                    subBlock.paramsJson = paramsMember;
-                    subBlock.FilterNullsInParamsJsonArray();
-                }
-                else
-                {
-                    // params가 있지만 배열이 아닌 경우 오류 처리
-                    string error_message = "Error: 'params' member in paramField for block type " + fieldType +
-                                           " (object " + objectId +
-                                           ") is not an array. Actual type: " + paramsMember.type_name() +
-                                           ". Value: " + paramsMember.dump();
-                    engine.EngineStdOut(error_message, 2, executionThreadId);
-                    // 여기서 예외를 던지거나, 오류를 나타내는 OperandValue를 반환해야 합니다.
-                    // 현재 코드에서는 runtime_error를 던지도록 되어 있습니다.
-                    throw runtime_error(error_message);
-                }
-            }
-            return Calculator(fieldType, engine, objectId, subBlock, executionThreadId);
-        }
-        else if (fieldType == "text_color")
+    }
+
+    // X축 충돌 검사 시에는 Y축에서 이미 반사되었을 수 있는 newDirection을 사용합니다.
+    double directionForXCheck = newCollisionOccurred ? newDirection : originalDirection;
+    // X축 이동 방향 조건도 업데이트된 newDirection 기준으로 다시 계산해야 할 수 있습니다.
+    // 여기서는 originalDirection 기준으로 X축 충돌 "발생 여부"를 판단하고,
+    // 반사는 directionForXCheck (Y축 반사 후 각도)를 사용합니다.
+    // 더 정확하게는, X축 충돌 조건도 Y축 반사 후의 각도로 판단해야 할 수 있습니다.
+    // 하지만 일단은 originalDirection으로 X축 진입을 판단하고, 반사각만 Y축 결과를 반영합니다.
+
+    bool movingTowardsRight_forXCheck = (originalDirection > 0.0 && originalDirection < 180.0);
+    bool movingTowardsLeft_forXCheck = (originalDirection > 180.0 && originalDirection < 360.0);
+
+    // 오른쪽 벽 충돌 처리
+    if (entityRight > stageRightEdge && movingTowardsRight_forXCheck)
+    {
+        // Y축에서 이미 다른 벽과 충돌했거나, 이전에 오른쪽 벽에 부딪힌 상태가 아닐 때만 반사
+        if ((newCollisionOccurred && currentWallHitThisFrame != Entity::CollisionSide::RIGHT) ||
+            (!newCollisionOccurred && lastWallHit != Entity::CollisionSide::RIGHT))
         {
-            if (paramField.contains("params") && paramField["params"].is_array() &&
-                !paramField["params"].empty() && paramField["params"][0].is_string())
-            {
-                return OperandValue(paramField["params"][0].get<string>());
-            }
-            engine.EngineStdOut(
-                "Invalid 'text_color' block structure in parameter field for " + objectId +
-                    ". Expected params[0] to be a HEX string.",
-                1, executionThreadId);
-            return OperandValue("#000000");
+            engine.EngineStdOut(format("bounce_right {}", entity.getId()), 3, executionThreadId);
+            newDirection = 360.0 - directionForXCheck; // X축 반사는 (360 - 각도)
+            entity.setX(stageRightEdge - halfWidth - pushBackAmount);
+            newCollisionOccurred = true;
+            currentWallHitThisFrame = Entity::CollisionSide::RIGHT;
         }
-        else if (fieldType == "get_pictures")
+    }
+    // 왼쪽 벽 충돌 처리
+    else if (entityLeft < stageLeftEdge && movingTowardsLeft_forXCheck)
+    {
+        if ((newCollisionOccurred && currentWallHitThisFrame != Entity::CollisionSide::LEFT) ||
+            (!newCollisionOccurred && lastWallHit != Entity::CollisionSide::LEFT))
         {
-            if (paramField.contains("params") && paramField["params"].is_array() &&
-                !paramField["params"].empty() && paramField["params"][0].is_string())
-            {
-                string temp_image_id = paramField["params"][0].get<string>();
-                return OperandValue(temp_image_id);
-            }
-            engine.EngineStdOut(
-                "Invalid 'get_pictures' block structure in parameter field for " + objectId +
-                    ". Expected params[0] to be a string (costume ID).",
-                1, executionThreadId); // executionThreadId 추가
-            return OperandValue("");
+            engine.EngineStdOut(format("bounce_left {}", entity.getId()), 3, executionThreadId);
+            newDirection = 360.0 - directionForXCheck;
+            entity.setX(stageLeftEdge + halfWidth + pushBackAmount);
+            newCollisionOccurred = true;
+            currentWallHitThisFrame = Entity::CollisionSide::LEFT;
         }
-        else if (fieldType == "get_sounds")
+    }
+
+    if (newCollisionOccurred)
+    {
+        newDirection = fmod(newDirection, 360.0);
+        if (newDirection < 0)
         {
-            if (paramField.contains("params") && paramField["params"].is_array() &&
-                !paramField["params"].empty() && paramField["params"][0].is_string())
-            {
-                string tem_sound_id = paramField["params"][0].get<string>();
-                return OperandValue(tem_sound_id);
-            }
-            engine.EngineStdOut(
-                "Invalid 'get_sounds' block structure in parameter field for " + objectId +
-                    ". Expected params[0] to be a string (sound ID).",
-                1, executionThreadId); // executionThreadId 추가
-            return OperandValue("");
+            newDirection += 360.0;
         }
-        else if (fieldType == "angle")
+        entity.setDirection(newDirection);
+        entity.setLastCollisionSide(currentWallHitThisFrame);
+        engine.EngineStdOut(format("Entity {} bounced. Original Dir: {}, New Dir: {}. LastCollision: {}",
+                                   entity.getId(), originalDirection, newDirection,
+                                   static_cast<int>(currentWallHitThisFrame)),
+                            3, executionThreadId);
+    }
+    else
+    {
+        if (lastWallHit != Entity::CollisionSide::NONE)
         {
-            if (paramField.contains("params") && paramField["params"].is_array() &&
-                !paramField["params"].empty())
+            bool stillOverlappingLastWall = false;
+            if (lastWallHit == Entity::CollisionSide::UP && entityTop > stageTopEdge)
+                stillOverlappingLastWall = true;
+            else if (lastWallHit == Entity::CollisionSide::DOWN && entityBottom < stageBottomEdge)
+                stillOverlappingLastWall = true;
+            else if (lastWallHit == Entity::CollisionSide::RIGHT && entityRight > stageRightEdge)
+                stillOverlappingLastWall = true;
+            else if (lastWallHit == Entity::CollisionSide::LEFT && entityLeft < stageLeftEdge)
+                stillOverlappingLastWall = true;
+
+            if (!stillOverlappingLastWall)
             {
-                const auto &param_zero = paramField["params"][0];
-                if (param_zero.is_number())
-                {
-                    // 숫자 타입인 경우
-                    double angle_picker = param_zero.get<double>();
-                    engine.EngineStdOut(
-                        format("getOperandValue (angle): Parsed angle_picker (number) = {} for object {}",
-                               angle_picker, objectId),
-                        3, executionThreadId);
-                    return OperandValue(angle_picker);
-                }
-                else if (param_zero.is_string())
-                {
-                    // 문자열 타입인 경우 숫자로 변환 시도
-                    string angle_str = param_zero.get<string>();
-                    try
-                    {
-                        // stod를 사용하여 문자열을 double로 변환
-                        // is_number 헬퍼 함수를 사용하여 더 엄격하게 검사할 수도 있습니다.
-                        if (is_number(angle_str))
-                        {
-                            // is_number 헬퍼 함수 사용
-                            double angle_picker = stod(angle_str);
-                            engine.EngineStdOut(
-                                format(
-                                    "getOperandValue (angle): Parsed angle_picker (string \"{}\" to double) = {} for object {}",
-                                    angle_str, angle_picker, objectId),
-                                3, executionThreadId);
-                            return OperandValue(angle_picker);
-                        }
-                        else
-                        {
-                            engine.EngineStdOut(
-                                "Error: 'angle' block (object " + objectId +
-                                    ") param is string but not a valid number: \"" + angle_str + "\". Params: " + paramField.dump() +
-                                    " --- Returning NaN.",
-                                2, executionThreadId);
-                            return OperandValue(nan(""));
-                        }
-                    }
-                    catch (const invalid_argument &ia)
-                    {
-                        engine.EngineStdOut(
-                            "Error: 'angle' block (object " + objectId +
-                                ") invalid argument for stod (string to double conversion): \"" + angle_str + "\". Params: " + paramField.dump() +
-                                " --- Returning NaN. Error: " + ia.what(),
-                            2, executionThreadId);
-                        return OperandValue(nan(""));
-                    }
-                    catch (const out_of_range &oor)
-                    {
-                        engine.EngineStdOut(
-                            "Error: 'angle' block (object " + objectId +
-                                ") out of range for stod (string to double conversion): \"" + angle_str + "\". Params: " +
-                                paramField.dump() +
-                                " --- Returning NaN. Error: " + oor.what(),
-                            2, executionThreadId);
-                        return OperandValue(nan(""));
-                    }
-                }
+                entity.setLastCollisionSide(Entity::CollisionSide::NONE);
+                engine.EngineStdOut(format("Entity {} separated from wall. LastCollision reset to NONE.", entity.getId()),
+                                    3, executionThreadId);
             }
         }
-        engine.EngineStdOut("Unsupported block type in parameter: " + fieldType + " for " + objectId, 1,
-                            executionThreadId); // executionThreadId 추가
-        return OperandValue();
-    }
-    // 4. 불리언 타입 확인
-    else if (paramField.is_boolean()) // is_number()와 is_object()가 false일 때만 실행됨
-    {
-        bool val = paramField.get<bool>();
-        // 이 로그는 매우 자주 발생할 수 있으므로, 필요에 따라 로그 레벨을 조정하거나 주석 처리하는 것이 좋습니다.
-        // engine.EngineStdOut(
-        //     "Parameter field for " + objectId + " is a direct boolean literal: " + (val ? "true" : "false") +
-        //     ". This might be unexpected if a block (e.g., get_pictures) was intended.",
-        //     1, executionThreadId);
-        return OperandValue(val);
-    }
-    // 5. 모든 타입 확인 후에도 일치하는 것이 없을 경우 (폴백)
-    // 이 부분은 paramField.is_number()가 true인 경우에도 도달해서는 안 됩니다.
-    else
-    {
-        /*engine.EngineStdOut(
-            "Parameter field is not a string, object, number, boolean, or null for " + objectId + ". Actual type: " +
-            paramField.type_name() + ". Value: " + paramField.dump(), // paramField.dump()로 실제 값 확인
-             1, executionThreadId);*/
-        return OperandValue(); // 빈 OperandValue 반환
     }
 }
 
@@ -473,7 +462,7 @@ OperandValue getOperandValue(Engine &engine, const string &objectId, const nlohm
  * @brief 움직이기 블록
  *
  */
-void Moving(string BlockType, Engine &engine, const string &objectId, const Block &block,
+void Moving(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
             const string &executionThreadId, const string &sceneIdAtDispatch,
             float deltaTime) // sceneIdAtDispatch는 이 함수 레벨에서는 직접 사용되지 않음
 {
@@ -484,10 +473,10 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
         return;
     }
 
-    if (BlockType == "move_direction")
+    if (block.opcode == BlockTypeEnum::MOVE_DIRECTION)
     {
         // 파라미터는 이동 거리 하나만 있어야 합니다.
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 1)
+        if (block.params.size() != 1)
         {
             // 파라미터 1개 확인
             engine.EngineStdOut(
@@ -498,192 +487,16 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
                 executionThreadId);
             return;
         }
-        OperandValue distanceOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-
-        double dist = distanceOp.asNumber();
-        if (!isfinite(dist))
-        {
-            // NaN 또는 Infinity 검사
-            engine.EngineStdOut(
-                "Moving block (move_direction) for object " + objectId +
-                    ": Distance parameter resolved to non-finite value (" + to_string(dist) +
-                    "). Using 0.0 as fallback.",
-                1, executionThreadId);
-            dist = 0.0;
-        }
-
-        // 엔티티의 현재 방향을 가져옵니다 (엔트리 각도: 0도 위, 90도 오른쪽).
-        double dir_entry_degrees = entity->getDirection();
-        double dir_entry_radians = dir_entry_degrees * (SDL_PI_D / 180.0);
-
-        // 엔트리 각도(0도 위) 기준 올바른 X, Y 이동량 계산
-        // X 변화량 = 거리 * sin(엔트리 각도_라디안)
-        // Y 변화량 = 거리 * cos(엔트리 각도_라디안) (Y축이 위로 갈수록 증가하는 좌표계)
-        double deltaX = dist * sin(dir_entry_radians);
-        double deltaY = dist * cos(dir_entry_radians); // 게임 월드 Y 좌표는 위쪽이 양수
-
-        double newX = entity->getX() + deltaX;
-        double newY = entity->getY() + deltaY;
-
-        entity->setX(newX);
-        entity->setY(newY);
-
-        // 펜 업데이트 (필요한 경우)
-        if (entity->paint.isPenDown && !entity->paint.isStopped())
-        {
-            entity->paint.updatePositionAndDraw(entity->getX(), entity->getY());
-        }
-        if (entity->brush.isPenDown && !entity->brush.isStopped())
-        {
-            entity->brush.updatePositionAndDraw(entity->getX(), entity->getY());
-        }
+        OperandValue distanceOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        moveEntityInDirection(engine, *entity, distanceOp.asNumber(), executionThreadId);
     }
-    else if (BlockType == "bounce_wall")
+    else if (block.opcode == BlockTypeEnum::BOUNCE_WALL)
     {
-        double entityX = entity->getX();
-        double entityY = entity->getY();
-        double entityWidth = entity->getWidth() * abs(entity->getScaleX());
-        double entityHeight = entity->getHeight() * abs(entity->getScaleY());
-
-        double originalDirection = entity->getDirection(); // 0도 위, 90도 오른쪽
-        double newDirection = originalDirection;
-
-        double halfWidth = entityWidth / 2.0;
-        double halfHeight = entityHeight / 2.0;
-
-        double entityTop = entityY + halfHeight;
-        double entityBottom = entityY - halfHeight;
-        double entityRight = entityX + halfWidth;
-        double entityLeft = entityX - halfWidth;
-
-        const double stageTopEdge = PROJECT_STAGE_HEIGHT / 2.0;
-        const double stageBottomEdge = -PROJECT_STAGE_HEIGHT / 2.0;
-        const double stageRightEdge = PROJECT_STAGE_WIDTH / 2.0;
-        const double stageLeftEdge = -PROJECT_STAGE_WIDTH / 2.0;
-
-        // --- 중요: pushBackAmount 값을 충분히 크게 설정해주세요 ---
-        // 엔티티의 크기나 평균 이동 속도보다 큰 값으로 설정하는 것이 좋습니다. (예: 10.0f, 15.0f 또는 그 이상)
-        const float pushBackAmount = 10.0f; // 이전 값(예: 5.0f)보다 더 크게 설정해보세요.
-        bool newCollisionOccurred = false;
-
-        Entity::CollisionSide lastWallHit = entity->getLastCollisionSide();
-        Entity::CollisionSide currentWallHitThisFrame = Entity::CollisionSide::NONE;
-
-        // --- 수정된 방향 조건 ---
-        // 0도: 위, 90도: 오른쪽, 180도: 아래, 270도: 왼쪽
-
-        // 1. 위쪽 벽 충돌 조건: 엔티티가 위쪽으로 이동 중인가? (방향 각도가 270~360 또는 0~90 사이)
-        bool movingTowardsTop = (originalDirection > 270.0 || originalDirection < 90.0);
-        // 2. 아래쪽 벽 충돌 조건: 엔티티가 아래쪽으로 이동 중인가? (방향 각도가 90~270 사이)
-        bool movingTowardsBottom = (originalDirection > 90.0 && originalDirection < 270.0);
-
-        // 위쪽 벽 충돌 처리
-        if (entityTop > stageTopEdge && movingTowardsTop)
-        {
-            if (lastWallHit != Entity::CollisionSide::UP)
-            {
-                engine.EngineStdOut(format("bounce_top {}", objectId), 3, executionThreadId);
-                newDirection = 180.0 - originalDirection; // Y축 반사는 (180 - 각도) 또는 (360 - 각도) 중 상황에 맞게
-                // 현재 0도 위쪽 시스템에서는 (360 - 각도) % 360 또는 -각도 % 360 이 더 적합할 수 있으나,
-                // 기존 180 - originalDirection 이 대칭적으로 잘 동작했다면 유지합니다.
-                // (엔트리/스크래치는 180-각도를 사용합니다)
-                entity->setY(stageTopEdge - halfHeight - pushBackAmount);
-                newCollisionOccurred = true;
-                currentWallHitThisFrame = Entity::CollisionSide::UP;
-            }
-        }
-        // 아래쪽 벽 충돌 처리
-        else if (entityBottom < stageBottomEdge && movingTowardsBottom)
-        {
-            if (lastWallHit != Entity::CollisionSide::DOWN)
-            {
-                engine.EngineStdOut(format("bounce_bottom {}", objectId), 3, executionThreadId);
-                newDirection = 180.0 - originalDirection;
-                entity->setY(stageBottomEdge + halfHeight + pushBackAmount);
-                newCollisionOccurred = true;
-                currentWallHitThisFrame = Entity::CollisionSide::DOWN;
-            }
-        }
-
-        // X축 충돌 검사 시에는 Y축에서 이미 반사되었을 수 있는 newDirection을 사용합니다.
-        double directionForXCheck = newCollisionOccurred ? newDirection : originalDirection;
-        // X축 이동 방향 조건도 업데이트된 newDirection 기준으로 다시 계산해야 할 수 있습니다.
-        // 여기서는 originalDirection 기준으로 X축 충돌 "발생 여부"를 판단하고,
-        // 반사는 directionForXCheck (Y축 반사 후 각도)를 사용합니다.
-        // 더 정확하게는, X축 충돌 조건도 Y축 반사 후의 각도로 판단해야 할 수 있습니다.
-        // 하지만 일단은 originalDirection으로 X축 진입을 판단하고, 반사각만 Y축 결과를 반영합니다.
-
-        bool movingTowardsRight_forXCheck = (originalDirection > 0.0 && originalDirection < 180.0);
-        bool movingTowardsLeft_forXCheck = (originalDirection > 180.0 && originalDirection < 360.0);
-
-        // 오른쪽 벽 충돌 처리
-        if (entityRight > stageRightEdge && movingTowardsRight_forXCheck)
-        {
-            // Y축에서 이미 다른 벽과 충돌했거나, 이전에 오른쪽 벽에 부딪힌 상태가 아닐 때만 반사
-            if ((newCollisionOccurred && currentWallHitThisFrame != Entity::CollisionSide::RIGHT) ||
-                (!newCollisionOccurred && lastWallHit != Entity::CollisionSide::RIGHT))
-            {
-                engine.EngineStdOut(format("bounce_right {}", objectId), 3, executionThreadId);
-                newDirection = 360.0 - directionForXCheck; // X축 반사는 (360 - 각도)
-                entity->setX(stageRightEdge - halfWidth - pushBackAmount);
-                newCollisionOccurred = true;
-                currentWallHitThisFrame = Entity::CollisionSide::RIGHT;
-            }
-        }
-        // 왼쪽 벽 충돌 처리
-        else if (entityLeft < stageLeftEdge && movingTowardsLeft_forXCheck)
-        {
-            if ((newCollisionOccurred && currentWallHitThisFrame != Entity::CollisionSide::LEFT) ||
-                (!newCollisionOccurred && lastWallHit != Entity::CollisionSide::LEFT))
-            {
-                engine.EngineStdOut(format("bounce_left {}", objectId), 3, executionThreadId);
-                newDirection = 360.0 - directionForXCheck;
-                entity->setX(stageLeftEdge + halfWidth + pushBackAmount);
-                newCollisionOccurred = true;
-                currentWallHitThisFrame = Entity::CollisionSide::LEFT;
-            }
-        }
-
-        if (newCollisionOccurred)
-        {
-            newDirection = fmod(newDirection, 360.0);
-            if (newDirection < 0)
-            {
-                newDirection += 360.0;
-            }
-            entity->setDirection(newDirection);
-            entity->setLastCollisionSide(currentWallHitThisFrame);
-            engine.EngineStdOut(format("Entity {} bounced. Original Dir: {}, New Dir: {}. LastCollision: {}",
-                                       objectId, originalDirection, newDirection,
-                                       static_cast<int>(currentWallHitThisFrame)),
-                                3, executionThreadId);
-        }
-        else
-        {
-            if (lastWallHit != Entity::CollisionSide::NONE)
-            {
-                bool stillOverlappingLastWall = false;
-                if (lastWallHit == Entity::CollisionSide::UP && entityTop > stageTopEdge)
-                    stillOverlappingLastWall = true;
-                else if (lastWallHit == Entity::CollisionSide::DOWN && entityBottom < stageBottomEdge)
-                    stillOverlappingLastWall = true;
-                else if (lastWallHit == Entity::CollisionSide::RIGHT && entityRight > stageRightEdge)
-                    stillOverlappingLastWall = true;
-                else if (lastWallHit == Entity::CollisionSide::LEFT && entityLeft < stageLeftEdge)
-                    stillOverlappingLastWall = true;
-
-                if (!stillOverlappingLastWall)
-                {
-                    entity->setLastCollisionSide(Entity::CollisionSide::NONE);
-                    engine.EngineStdOut(format("Entity {} separated from wall. LastCollision reset to NONE.", objectId),
-                                        3, executionThreadId);
-                }
-            }
-        }
+        bounceEntityOffWall(engine, *entity, executionThreadId);
     }
-    else if (BlockType == "move_x")
+    else if (block.opcode == BlockTypeEnum::MOVE_X)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 1) // 파라미터 개수 확인 수정 (2개 -> 1개)
+        if (block.params.size() != 1) // 파라미터 개수 확인 수정 (2개 -> 1개)
         {
             engine.EngineStdOut(
                 format(
@@ -693,16 +506,16 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
                 executionThreadId);
             return;
         }
-        OperandValue distance = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue distance = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         double dist = distance.asNumber();
         // entity는 함수 시작 시 이미 검증되었습니다.
         double newX = entity->getX() + dist;
         // engine.EngineStdOut("move_x objId: " + objectId + " newX: " + to_string(newX), 0, executionThreadId);
         entity->setX(newX);
     }
-    else if (BlockType == "move_y")
+    else if (block.opcode == BlockTypeEnum::MOVE_Y)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 1) // 파라미터 개수 확인 수정 (2개 -> 1개)
+        if (block.params.size() != 1) // 파라미터 개수 확인 수정 (2개 -> 1개)
         {
             engine.EngineStdOut(
                 format(
@@ -712,21 +525,21 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
                 executionThreadId);
             return;
         }
-        OperandValue distance = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue distance = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         double dist = distance.asNumber();
         // entity는 함수 시작 시 이미 검증되었습니다.
         double newY = entity->getY() + dist;
         // engine.EngineStdOut("move_y objId: " + objectId + " newY: " + to_string(newY), 0, executionThreadId);
         entity->setY(newY);
     }
-    else if (BlockType == "move_xy_time" || BlockType == "locate_xy_time")
+    else if (block.opcode == BlockTypeEnum::MOVE_XY_TIME || block.opcode == BlockTypeEnum::LOCATE_XY_TIME)
     {
         Entity::TimedMoveState &state = entity->timedMoveState;
 
         if (!state.isActive)
         {
             // 블록 처음 실행 시 초기화
-            if (!block.paramsJson.is_array() || block.paramsJson.size() < 3)
+            if (block.params.size() < 3)
             {
                 engine.EngineStdOut(
                     format("move_xy_time block for {} is missing parameters. Expected TIME, X, Y.", objectId), 2,
@@ -734,9 +547,9 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
                 return;
             }
 
-            OperandValue timeOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-            OperandValue xOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-            OperandValue yOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+            OperandValue timeOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+            OperandValue xOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+            OperandValue yOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
 
             state.totalDurationSeconds = static_cast<float>(timeOp.asNumber());
             state.targetX = xOp.asNumber();
@@ -801,13 +614,13 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
                 // <<<--- 중요: 재개를 위한 정보 전달 --- >>>
                 const Script *currentScriptPtr = nullptr;
                 {
-                    lock_guard<recursive_mutex> lock(entity->getStateMutex());
-                    auto it = entity->scriptThreadStates.find(executionThreadId);
-                    if (it != entity->scriptThreadStates.end())
+                    lock_guard lock(entity->getStateMutex());
+                    auto *pState = entity->scriptThreadStates.find(executionThreadId);
+                    if (pState)
                     {
                         // executeScript에서 설정한 포인터를 사용합니다.
                         // 이 포인터는 executeScript가 호출될 때마다 업데이트되어야 합니다.
-                        currentScriptPtr = it->second.scriptPtrForResume;
+                        currentScriptPtr = pState->scriptPtrForResume;
                     }
                 }
 
@@ -827,30 +640,30 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
             }
         }
     }
-    else if (BlockType == "locate_x")
+    else if (block.opcode == BlockTypeEnum::LOCATE_X)
     {
-        OperandValue valueX = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue valueX = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         double x = valueX.asNumber();
         // entity는 함수 시작 시 이미 검증되었습니다.
         // engine.EngineStdOut("locate_x objId: " + objectId + " newX: " + to_string(x), 3, executionThreadId);
         entity->setX(x);
     }
-    else if (BlockType == "locate_y")
+    else if (block.opcode == BlockTypeEnum::LOCATE_Y)
     {
-        OperandValue valueY = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue valueY = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         // entity는 함수 시작 시 이미 검증되었습니다.
         double y = valueY.asNumber();
         // engine.EngineStdOut("locate_y objId: " + objectId + " newX: " + to_string(y), 3, executionThreadId);
         entity->setY(y);
     }
-    else if (BlockType == "locate_xy")
+    else if (block.opcode == BlockTypeEnum::LOCATE_XY)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(format("locate_xy block is Over or Under Param Size for object {}.", objectId), 1);
         }
-        OperandValue valueXOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue valueYOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue valueXOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue valueYOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
 
         // Use asNumber() for type coercion. It returns 0.0 for strings that can't be converted.
         double x = valueXOp.asNumber();
@@ -865,10 +678,10 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
         entity->setY(y);
         // engine.EngineStdOut("locate_xy objId: " + objectId + " newX: " + to_string(x) + " newY: " + to_string(y), 3, executionThreadId);
     }
-    else if (BlockType == "locate")
+    else if (block.opcode == BlockTypeEnum::LOCATE)
     {
         // 이것은 마우스커서 나 오브젝트를 따라갑니다.
-        OperandValue target = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue target = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (target.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(format("locate block for object {} is not a string.", objectId), 2,
@@ -895,12 +708,12 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
             else
             {
                 engine.EngineStdOut(
-                    "locate block for object " + objectId + ": target entity '" + target.string_val + "' not found.", 2,
+                    "locate block for object " + objectId + ": target entity '" + target.stringValue() + "' not found.", 2,
                     executionThreadId);
             }
         }
     }
-    else if (BlockType == "locate_object_time")
+    else if (block.opcode == BlockTypeEnum::LOCATE_OBJECT_TIME)
     {
         // locate_object_time 구현
         // entity는 함수 시작 시 이미 검증되었습니다.
@@ -911,7 +724,7 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
         if (!state.isActive)
         {
             // 블록 처음 실행 시 초기화
-            if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+            if (block.params.size() < 2)
             {
                 // time, target 필요                engine.EngineStdOut(
                 engine.EngineStdOut(
@@ -922,8 +735,8 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
                 return;
             }
 
-            OperandValue timeOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-            OperandValue targetOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+            OperandValue timeOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+            OperandValue targetOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
 
             if (timeOp.type != OperandValue::Type::NUMBER || targetOp.type != OperandValue::Type::STRING)
             {
@@ -1023,13 +836,13 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
                 // <<<--- 중요: 재개를 위한 정보 전달 --- >>>
                 const Script *currentScriptPtr = nullptr;
                 {
-                    lock_guard<recursive_mutex> lock(entity->getStateMutex());
-                    auto it = entity->scriptThreadStates.find(executionThreadId);
-                    if (it != entity->scriptThreadStates.end())
+                    lock_guard lock(entity->getStateMutex());
+                    auto *pState = entity->scriptThreadStates.find(executionThreadId);
+                    if (pState)
                     {
                         // executeScript에서 설정한 포인터를 사용합니다.
                         // 이 포인터는 executeScript가 호출될 때마다 업데이트되어야 합니다.
-                        currentScriptPtr = it->second.scriptPtrForResume;
+                        currentScriptPtr = pState->scriptPtrForResume;
                     }
                 }
                 entity->setScriptWait(executionThreadId, 0, block.id, Entity::WaitType::BLOCK_INTERNAL,
@@ -1037,9 +850,9 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
             }
         }
     }
-    else if (BlockType == "rotate_relative" || BlockType == "direction_relative")
+    else if (block.opcode == BlockTypeEnum::ROTATE_RELATIVE || block.opcode == BlockTypeEnum::DIRECTION_RELATIVE)
     {
-        OperandValue value = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue value = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         /* if (value.type != OperandValue::Type::NUMBER) {
              engine.EngineStdOut("rotate_relative block for object " + objectId + " is not a number.", 2,
                                  executionThreadId);
@@ -1048,10 +861,10 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
         // entity는 함수 시작 시 이미 검증되었습니다.
         entity->setDirection(value.asNumber() + entity->getDirection());
     }
-    else if (BlockType == "rotate_by_time" || BlockType == "direction_relative_duration")
+    else if (block.opcode == BlockTypeEnum::ROTATE_BY_TIME || block.opcode == BlockTypeEnum::DIRECTION_RELATIVE_DURATION)
     {
-        OperandValue timeValue = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue angleValue = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue timeValue = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue angleValue = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (timeValue.type != OperandValue::Type::NUMBER || angleValue.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(format("rotate_by_time block for object {} has non-number parameters.", objectId),
@@ -1091,13 +904,13 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
                 // <<<--- 중요: 재개를 위한 정보 전달 --- >>>
                 const Script *currentScriptPtr = nullptr;
                 {
-                    lock_guard<recursive_mutex> lock(entity->getStateMutex());
-                    auto it = entity->scriptThreadStates.find(executionThreadId);
-                    if (it != entity->scriptThreadStates.end())
+                    lock_guard lock(entity->getStateMutex());
+                    auto *pState = entity->scriptThreadStates.find(executionThreadId);
+                    if (pState)
                     {
                         // executeScript에서 설정한 포인터를 사용합니다.
                         // 이 포인터는 executeScript가 호출될 때마다 업데이트되어야 합니다.
-                        currentScriptPtr = it->second.scriptPtrForResume;
+                        currentScriptPtr = pState->scriptPtrForResume;
                     }
                 }
 
@@ -1107,9 +920,9 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
             }
         }
     }
-    else if (BlockType == "rotate_absolute")
+    else if (block.opcode == BlockTypeEnum::ROTATE_ABSOLUTE)
     {
-        OperandValue angle = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue angle = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (angle.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(format("rotate_absolute block for object {} is not a number.", objectId), 2,
@@ -1119,9 +932,9 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
         // entity는 함수 시작 시 이미 검증되었습니다.
         entity->setRotation(angle.asNumber());
     }
-    else if (BlockType == "direction_absolute")
+    else if (block.opcode == BlockTypeEnum::DIRECTION_ABSOLUTE)
     {
-        OperandValue angle = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue angle = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (angle.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(format("direction_absolute block for object {}is not a number.", objectId), 2,
@@ -1131,16 +944,16 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
         // entity는 함수 시작 시 이미 검증되었습니다.
         entity->setDirection(angle.asNumber());
     }
-    else if (BlockType == "see_angle_object")
+    else if (block.opcode == BlockTypeEnum::SEE_ANGLE_OBJECT)
     {
-        OperandValue hasmouse = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue hasmouse = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (hasmouse.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(format("see_angle_object block for object {}is not a string.", objectId), 2,
                                 executionThreadId);
             return;
         }
-        if (hasmouse.string_val == "mouse")
+        if (hasmouse.stringValue() == "mouse")
         {
             if (engine.isMouseCurrentlyOnStage())
             {
@@ -1150,7 +963,7 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
         }
         else
         {
-            Entity *targetEntity = engine.getEntityById(hasmouse.string_val);
+            Entity *targetEntity = engine.getEntityById(hasmouse.stringValue());
             // entity (현재 객체)는 함수 시작 시 이미 검증되었습니다.
             if (targetEntity)
             {
@@ -1160,15 +973,15 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
             else
             {
                 engine.EngineStdOut(format("see_angle_object block for object {}: target entity '{}' not found.",
-                                           objectId, hasmouse.string_val),
+                                           objectId, hasmouse.stringValue()),
                                     2, executionThreadId);
             }
         }
     }
-    else if (BlockType == "move_to_angle")
+    else if (block.opcode == BlockTypeEnum::MOVE_TO_ANGLE)
     {
-        OperandValue setAngle = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue setDesnitance = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue setAngle = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue setDesnitance = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (setAngle.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut("move_to_angle block for object " + objectId + "is not a number.", 2,
@@ -1183,16 +996,181 @@ void Moving(string BlockType, Engine &engine, const string &objectId, const Bloc
     }
 }
 
+/**
+ * @brief reach_something 의 충돌 판정. 대상 ID 는 이미 평가되어 비어 있지 않은 값이어야 합니다.
+ */
+bool isEntityReaching(Engine &engine, const Entity &self, const string &targetId, const string &executionThreadId)
+{
+    // Wall collision
+    if (targetId == "wall" || targetId == "wall_up" || targetId == "wall_down" || targetId == "wall_left" ||
+        targetId == "wall_right")
+    {
+        // Engine에 벽 충돌 확인 로직 필요 (engine.checkCollisionWithWall(self, targetId))
+        // 여기서는 Entity의 경계와 스테이지 경계를 비교하는 단순화된 로직을 사용합니다.
+        float selfX = self.getX();
+        float selfY = self.getY();
+        float scaledWidth = self.getWidth() * self.getScaleX();
+        float scaledHeight = self.getHeight() * self.getScaleY();
+
+        float selfTop = selfY + scaledHeight / 2.0f;
+        float selfBottom = selfY - scaledHeight / 2.0f;
+        float selfRight = selfX + scaledWidth / 2.0f;
+        float selfLeft = selfX - scaledWidth / 2.0f;
+
+        const float stageTop = PROJECT_STAGE_HEIGHT / 2.0f;
+        const float stageBottom = -PROJECT_STAGE_HEIGHT / 2.0f;
+        const float stageRight = PROJECT_STAGE_WIDTH / 2.0f;
+        const float stageLeft = -PROJECT_STAGE_WIDTH / 2.0f;
+
+        bool collided = false;
+        if ((targetId == "wall" || targetId == "wall_up") && selfTop > stageTop)
+            collided = true;
+        if (!collided && (targetId == "wall" || targetId == "wall_down") && selfBottom < stageBottom)
+            collided = true;
+        if (!collided && (targetId == "wall" || targetId == "wall_right") && selfRight > stageRight)
+            collided = true;
+        if (!collided && (targetId == "wall" || targetId == "wall_left") && selfLeft < stageLeft)
+            collided = true;
+
+        return collided;
+    }
+
+    // Mouse collision
+    if (targetId == "mouse")
+    {
+        if (!engine.isMouseCurrentlyOnStage())
+            return false;
+
+        SDL_FPoint mousePos = {
+            (engine.getCurrentStageMouseX()),
+            (engine.getCurrentStageMouseY())};
+        engine.EngineStdOut(format("object touched {}", self.isPointInside(mousePos.x, mousePos.y)), 3);
+        return self.isPointInside(mousePos.x, mousePos.y); // isPointInside 사용
+    }
+
+    // Sprite collision
+    vector<Entity *> entitiesToTest;
+    auto *mainTargetSprite = engine.getEntityById(targetId);
+
+    if (mainTargetSprite)
+    {
+        if (mainTargetSprite->isVisible() /*&& !mainTargetSprite->isStamp() 엔트리는 스탬프도 충돌대상*/)
+        {
+            entitiesToTest.push_back(mainTargetSprite);
+        }
+        // 클론 가져오기 (Engine에 getClones(targetId) 또는 Entity에 getMyClones() 필요)
+        // vector<Entity*> clones = engine.getClones(targetId);
+        // for (Entity* clone : clones) {
+        //    if (clone->getVisible() /*&& !clone->isStamp()*/) {
+        //        entitiesToTest.push_back(clone);
+        //    }
+        // }
+        // 임시: 클론 로직은 Engine에 구현 필요. 여기서는 주석 처리.
+    }
+    else
+    {
+        // ID로 못찾으면 이름으로 찾아 시도 (엔트리는 ID 기반)
+        // 현재 구현에서는 ID로만 찾음
+        engine.EngineStdOut("reach_something: Target sprite ID '" + targetId + "' not found.", 1,
+                            executionThreadId);
+        return false;
+    }
+
+    if (entitiesToTest.empty() && !mainTargetSprite)
+    {
+        // mainTargetSprite도 없고 entitiesToTest도 비었으면 대상 없음
+        engine.EngineStdOut("reach_something: No target entities to test against for ID '" + targetId + "'.", 1,
+                            executionThreadId);
+        return false;
+    } // mainTargetSprite->isVisible() 로 변경
+    if (entitiesToTest.empty() && mainTargetSprite && !mainTargetSprite->isVisible())
+    {
+        // 대상은 있으나 보이지 않음
+        // 엔트리는 보이지 않는 대상과도 충돌 판정하므로 이 케이스는 실제로는 발생하면 안됨 (위의 getVisible 체크 때문)
+        // 만약 getVisible 체크를 제거한다면 이 로그가 유용할 수 있음
+        // engine.EngineStdOut("reach_something: Target sprite '" + targetId + "' is not visible and has no visible clones.", 0, executionThreadId);
+        // return false; // 엔트리 동작과 맞추려면 이 부분도 수정 필요
+    }
+
+    SDL_FRect selfBounds = self.getVisualBounds();
+
+    for (Entity *testEntity : entitiesToTest)
+    {
+        if (!testEntity)
+            continue; // 혹시 모를 null 체크
+        SDL_FRect targetBounds = testEntity->getVisualBounds();
+        if (SDL_HasRectIntersectionFloat(&selfBounds, &targetBounds))
+        {
+            // 함수 이름 변경
+            // 엔트리는 텍스트 박스 간, 텍스트 박스와 다른 오브젝트 간 충돌은 항상 사각 충돌 사용
+            // 일반 오브젝트 간에는 픽셀 충돌 (여기서는 경계 상자로 단순화) - SDL_HasRectIntersectionFloat 사용
+            // if (self.isTextbox() || testEntity->isTextbox()) {
+            //    return true; // 사각 충돌로 충분
+            // } else {
+            //    // 픽셀 충돌 로직 (여기서는 경계 상자로 대체됨)
+            //    return true;
+            // }
+            return true; // 단순화된 경계 상자 충돌
+        } // SDL_HasIntersectionF 대신 SDL_HasRectIntersectionFloat 사용
+    }
+    return false;
+}
+
+VariableStore::Slot *findVariableSlot(Engine &engine, const string &objectId, const string &variableId)
+{
+    VariableStore &store = engine.getVariableStore();
+    return store.get(store.find(objectId, variableId));
+}
+
+VariableStore::Slot *findListSlot(Engine &engine, const string &objectId, const string &listId)
+{
+    VariableStore &store = engine.getVariableStore();
+    return store.get(store.find(objectId, listId, true));
+}
+
+/**
+ * @brief 변수 값을 읽습니다. m_engineDataMutex 를 잡고 호출합니다.
+ */
+static OperandValue readVariableSlot(Engine &engine, const string &objectId, VariableStore::Slot *targetVarPtr,
+                                     const string &variableIdToFind, const string &executionThreadId)
+{
+    if (!targetVarPtr)
+    {
+        engine.EngineStdOut(
+            "get_variable block for " + objectId + ": Variable '" + variableIdToFind + "' not found.", 1,
+            executionThreadId);
+        return OperandValue(0.0);
+    }
+    if (targetVarPtr->isCloud)
+    {
+        engine.loadCloudVariablesFromJson();
+    }
+    return targetVarPtr->value;
+}
+
+// 지역 변수는 호출 프레임에 있어 실행 중인 스레드만 쓰므로 엔진 데이터 잠금이 필요 없습니다.
+static OperandValue *functionVariableSlot(Engine &engine, const string &objectId, int slot,
+                                          const string &executionThreadId)
+{
+    OperandValue *value = currentFunctionArgs().get(slot);
+    if (!value)
+    {
+        engine.EngineStdOut(format("Function local variable used outside of its function by object {}.", objectId), 1,
+                            executionThreadId);
+    }
+    return value;
+}
+
 /**
  * @brief 계산 블록
  *
  */
-OperandValue Calculator(string BlockType, Engine &engine, const string &objectId, const Block &block,
+OperandValue Calculator(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
                         const string &executionThreadId)
 {
-    if (BlockType == "calc_basic")
+    if (block.opcode == BlockTypeEnum::CALC_BASIC)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 3)
+        if (block.params.size() != 3)
         {
             engine.EngineStdOut(
                 format("calc_basic block for object {} has invalid params structure. Expected 3 params.",
@@ -1202,64 +1180,35 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue();
         }
 
-        OperandValue leftOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue opVal = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue rightOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue leftOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue opVal = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue rightOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
 
         string anOperator = opVal.asString();
-
-        // EntryJS-like behavior: PLUS can be string concatenation or numeric addition
-        if (anOperator == "PLUS")
+        CalcBasicOperator calcOp = toCalcBasicOperator(anOperator);
+        if (calcOp != CalcBasicOperator::UNKNOWN)
         {
-            // If both can be strictly interpreted as numbers, add them. Otherwise, concatenate as strings.
-            // This mimics Scratch/EntryJS behavior where "1" + "2" is 3, but "1" + "a" is "1a".
-            bool leftIsNumeric = (leftOp.type == OperandValue::Type::NUMBER || (leftOp.type == OperandValue::Type::STRING && !leftOp.string_val.empty() &&
-                                                                                is_number(leftOp.string_val)));
-            bool rightIsNumeric = (rightOp.type == OperandValue::Type::NUMBER || (rightOp.type == OperandValue::Type::STRING && !rightOp.string_val.empty() &&
-                                                                                  is_number(rightOp.string_val)));
-
-            if (leftIsNumeric && rightIsNumeric)
-            {
-                return OperandValue(leftOp.asNumber() + rightOp.asNumber());
-            }
-            else
+            if (calcOp == CalcBasicOperator::DIVIDE && rightOp.asNumber() == 0.0)
             {
-                return OperandValue(leftOp.asString() + rightOp.asString());
+                engine.EngineStdOut(format("Division by zero in calc_basic for {}", objectId), 2, executionThreadId);
             }
-        }
-
-        double numLeft = leftOp.asNumber();
-        double numRight = rightOp.asNumber();
-
-        if (anOperator == "MINUS")
-            return OperandValue(numLeft - numRight);
-        if (anOperator == "MULTI")
-            return OperandValue(numLeft * numRight);
-        if (anOperator == "DIVIDE")
-        {
-            if (numRight == 0.0)
-            {
-                string errMsg = format("Division by zero in calc_basic for {}", objectId);
-                engine.EngineStdOut(errMsg, 2, executionThreadId);
-                throw ScriptBlockExecutionError("0으로 나눌 수 없습니다.", block.id, BlockType, objectId, "Division by zero.");
-            }
-            return OperandValue(numLeft / numRight);
+            return applyCalcBasic(calcOp, leftOp, rightOp, block, objectId);
         }
         engine.EngineStdOut(format("Unknown operator in calc_basic: {} for {}", anOperator, objectId), 2,
                             executionThreadId);
         return OperandValue();
     }
-    else if (BlockType == "calc_rand")
+    else if (block.opcode == BlockTypeEnum::CALC_RAND)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 2)
+        if (block.params.size() != 2)
         {
             engine.EngineStdOut(
                 "calc_rand block for object " + objectId + " has invalid params structure. Expected 2 params.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue minVal = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue maxVal = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue minVal = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue maxVal = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (minVal.type != OperandValue::Type::NUMBER || maxVal.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut("calc_rand block for object " + objectId + " has non-numeric params.", 2,
@@ -1296,11 +1245,11 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(min_val);
         }
     }
-    else if (BlockType == "coordinate_mouse")
+    else if (block.opcode == BlockTypeEnum::COORDINATE_MOUSE)
     {
         // paramsKeyMap: { VALUE: 1 }
-        // 드롭다운 값 ("x" 또는 "y")은 null 필터링 후 paramsJson[0]에 있습니다.
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        // 드롭다운 값 ("x" 또는 "y")은 null 필터링 후 params[0]에 있습니다.
+        if (block.params.size() < 1)
         {
             // 인덱스 0에 접근하려면 크기가 최소 1이어야 함
             engine.EngineStdOut(
@@ -1310,7 +1259,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(0.0);
         }
 
-        OperandValue coordTypeOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue coordTypeOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         string coord_type_str;
 
         if (coordTypeOp.type == OperandValue::Type::STRING)
@@ -1369,12 +1318,12 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(0.0);
         }
     }
-    else if (BlockType == "coordinate_object")
+    else if (block.opcode == BlockTypeEnum::COORDINATE_OBJECT)
     {
-        // FilterNullsInParamsJsonArray가 null을 제거하므로, 유효한 파라미터는 2개여야 합니다.
+        // 로드 시 null 이 제거되므로, 유효한 파라미터는 2개여야 합니다.
         // (원래 params: [null, TARGET_OBJECT_ID, null, COORDINATE_TYPE])
         // 필터링 후: [TARGET_OBJECT_ID_VALUE, COORDINATE_TYPE_VALUE]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "coordinate_object block for object " + objectId +
@@ -1384,7 +1333,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
 
         // 필터링 후 첫 번째 파라미터 (원래 인덱스 1)가 대상 객체 ID입니다.
-        OperandValue targetIdOpVal = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue targetIdOpVal = getOperandValue(engine, objectId, block.params[0], executionThreadId);
 
         if (targetIdOpVal.type != OperandValue::Type::STRING)
         {
@@ -1398,7 +1347,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         string targetObjectIdStr = targetIdOpVal.asString();
 
         // 필터링 후 두 번째 파라미터 (원래 인덱스 3)가 좌표 유형입니다.
-        OperandValue coordinateTypeOpVal = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue coordinateTypeOpVal = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (coordinateTypeOpVal.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -1523,9 +1472,9 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(0.0);
         }
     }
-    else if (BlockType == "quotient_and_mod")
+    else if (block.opcode == BlockTypeEnum::QUOTIENT_AND_MOD)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 3)
+        if (block.params.size() != 3)
         {
             engine.EngineStdOut("quotient_and_mod block for " + objectId + " parameter is invalid. Expected 3 params.",
                                 2, executionThreadId);
@@ -1534,9 +1483,9 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                 "Invalid parameter count for quotient_and_mod block. Expected 3 params.");
         }
 
-        OperandValue left_op = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue operator_op = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue right_op = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue left_op = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue operator_op = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue right_op = getOperandValue(engine, objectId, block.params[2], executionThreadId);
         string anOperator = operator_op.asString();
 
         double left_val = left_op.asNumber();
@@ -1566,7 +1515,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(left_val - right_val * floor(left_val / right_val));
         }
     }
-    else if (BlockType == "calc_operation")
+    else if (block.opcode == BlockTypeEnum::CALC_OPERATION)
     {
         // EntryJS: get_value_of_operator
         // switch 문에서 사용할 수학 연산 열거형
@@ -1619,7 +1568,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return MathOperationType::UNKNOWN;
         };
 
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 2)
+        if (block.params.size() != 2)
         {
             engine.EngineStdOut(
                 "calc_operation block for " + objectId + " has invalid params. Expected 2 params (LEFTHAND, OPERATOR).",
@@ -1627,8 +1576,8 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(nan(""));
         }
 
-        OperandValue leftOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue opVal = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue leftOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue opVal = getOperandValue(engine, objectId, block.params[1], executionThreadId);
 
         if (leftOp.type != OperandValue::Type::NUMBER)
         {
@@ -1787,19 +1736,19 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
         return OperandValue(result);
     }
-    else if (BlockType == "get_project_timer_value")
+    else if (block.opcode == BlockTypeEnum::GET_PROJECT_TIMER_VALUE)
     {
         // 파라미터 없음, 엔진에서 직접 타이머 값을 가져옴
         double timer = engine.getProjectTimerValue();
         engine.EngineStdOut(format("object {} getTimer {}", objectId, timer), 3);
         return OperandValue(timer);
     } // choose_project_timer_action은 Behavior 함수로 이동했으므로 여기서 제거합니다.
-    else if (BlockType == "get_date")
+    else if (block.opcode == BlockTypeEnum::GET_DATE)
     {
         time_t now = time(nullptr);
         // paramsKeyMap: { VALUE: 0 }
-        // 드롭다운 값은 block.paramsJson[0]에 문자열로 저장되어 있을 것으로 예상합니다.
-        if (!block.paramsJson.is_array() || block.paramsJson.empty() || !block.paramsJson[0].is_string())
+        // 드롭다운 값은 block.params[0]에 문자열로 저장되어 있을 것으로 예상합니다.
+        if (block.params.empty() || !block.params[0].isString())
         {
             engine.EngineStdOut("get_date block for " + objectId + " has invalid or missing action parameter.", 2,
                                 executionThreadId);
@@ -1807,7 +1756,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
 
         // 이 블록의 파라미터는 항상 단순 문자열 드롭다운 값이므로 직접 접근합니다.
-        OperandValue actionOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue actionOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         string action = actionOp.asString(); // OperandValue에서 문자열 가져오기
         struct tm timeinfo_s;                // localtime_s 및 localtime_r을 위한 구조체
         struct tm *timeinfo_ptr = nullptr;
@@ -1849,9 +1798,9 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue();
         }
     }
-    else if (BlockType == "distance_something")
+    else if (block.opcode == BlockTypeEnum::DISTANCE_SOMETHING)
     {
-        OperandValue targetIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue targetIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (targetIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -1889,34 +1838,34 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(sqrt(dx * dx + dy * dy));
         }
     }
-    else if (BlockType == "length_of_string")
+    else if (block.opcode == BlockTypeEnum::LENGTH_OF_STRING)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 1)
+        if (block.params.size() != 1)
         {
             engine.EngineStdOut(
                 "length_of_string block for " + objectId + " has invalid params structure. Expected 1 param.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue strOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (strOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("length_of_string block for " + objectId + " has non-string parameter.", 2,
                                 executionThreadId);
             return OperandValue();
         }
-        return OperandValue(static_cast<double>(strOp.string_val.length()));
+        return OperandValue(static_cast<double>(strOp.stringValue().length()));
     }
-    else if (BlockType == "reverse_of_string")
+    else if (block.opcode == BlockTypeEnum::REVERSE_OF_STRING)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 1)
+        if (block.params.size() != 1)
         {
             engine.EngineStdOut(
                 "reverse_of_string block for " + objectId + " has invalid params structure. Expected 1 param.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue strOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (strOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("reverse_of_string block for " + objectId + " has non-string parameter.", 2,
@@ -1927,90 +1876,90 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         reverse(reversedStr.begin(), reversedStr.end());
         return OperandValue(reversedStr);
     }
-    else if (BlockType == "combine_something") // Corrected typo
+    else if (block.opcode == BlockTypeEnum::COMBINE_SOMETHING) // Corrected typo
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 2)
+        if (block.params.size() != 2)
         {
             engine.EngineStdOut(
                 "combie_something block for " + objectId + " has invalid params structure. Expected 2 params.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp1 = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue strOp2 = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue strOp1 = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue strOp2 = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         // Always concatenate as strings, as per typical block-based language behavior
         string combinedStr = strOp1.asString() + strOp2.asString();
         return OperandValue(combinedStr);
     }
-    else if (BlockType == "char_at")
+    else if (block.opcode == BlockTypeEnum::CHAR_AT)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 2)
+        if (block.params.size() != 2)
         {
             engine.EngineStdOut("char_at block for " + objectId + " has invalid params structure. Expected 2 params.",
                                 2, executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue indexOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue strOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue indexOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (strOp.type != OperandValue::Type::STRING || indexOp.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut("char_at block for " + objectId + " has non-string or non-number parameter.", 2,
                                 executionThreadId);
             return OperandValue();
         }
-        int index = static_cast<int>(indexOp.number_val);
-        if (index < 0 || index >= static_cast<int>(strOp.string_val.length()))
+        int index = static_cast<int>(indexOp.numberValue());
+        if (index < 0 || index >= static_cast<int>(strOp.stringValue().length()))
         {
             engine.EngineStdOut("char_at block for " + objectId + " has index out of range.", 2, executionThreadId);
             return OperandValue();
         }
-        return OperandValue(string(1, strOp.string_val[index]));
+        return OperandValue(string(1, strOp.stringValue()[index]));
     }
-    else if (BlockType == "substring")
+    else if (block.opcode == BlockTypeEnum::SUBSTRING)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 3)
+        if (block.params.size() != 3)
         {
             engine.EngineStdOut("substring block for " + objectId + " has invalid params structure. Expected 3 params.",
                                 2, executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue startOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue endOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue strOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue startOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue endOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
         if (strOp.type != OperandValue::Type::STRING || startOp.type != OperandValue::Type::NUMBER || endOp.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut("substring block for " + objectId + " has non-string or non-number parameter.", 2,
                                 executionThreadId);
             return OperandValue();
         }
-        int startIndex = static_cast<int>(startOp.number_val);
-        int endIndex = static_cast<int>(endOp.number_val);
-        if (startIndex < 0 || endIndex > static_cast<int>(strOp.string_val.length()) || startIndex > endIndex)
+        int startIndex = static_cast<int>(startOp.numberValue());
+        int endIndex = static_cast<int>(endOp.numberValue());
+        if (startIndex < 0 || endIndex > static_cast<int>(strOp.stringValue().length()) || startIndex > endIndex)
         {
             engine.EngineStdOut("substring block for " + objectId + " has index out of range.", 2, executionThreadId);
             return OperandValue();
         }
-        return OperandValue(strOp.string_val.substr(startIndex, endIndex - startIndex));
+        return OperandValue(strOp.stringValue().substr(startIndex, endIndex - startIndex));
     }
-    else if (BlockType == "count_match_string")
+    else if (block.opcode == BlockTypeEnum::COUNT_MATCH_STRING)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 2)
+        if (block.params.size() != 2)
         {
             engine.EngineStdOut(
                 "count_match_string block for " + objectId + " has invalid params structure. Expected 2 params.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue subStrOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue strOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue subStrOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (strOp.type != OperandValue::Type::STRING || subStrOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("count_match_string block for " + objectId + " has non-string parameter.", 2,
                                 executionThreadId);
             return OperandValue();
         }
-        string str = strOp.string_val;
-        string subStr = subStrOp.string_val;
+        string str = strOp.stringValue();
+        string subStr = subStrOp.stringValue();
         size_t count = 0;
         size_t pos = str.find(subStr);
         while (pos != string::npos)
@@ -2020,25 +1969,25 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
         return OperandValue(static_cast<double>(count));
     }
-    else if (BlockType == "index_of_string")
+    else if (block.opcode == BlockTypeEnum::INDEX_OF_STRING)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 2)
+        if (block.params.size() != 2)
         {
             engine.EngineStdOut(
                 "index_of_string block for " + objectId + " has invalid params structure. Expected 2 params.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue subStrOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue strOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue subStrOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (strOp.type != OperandValue::Type::STRING || subStrOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("index_of_string block for " + objectId + " has non-string parameter.", 2,
                                 executionThreadId);
             return OperandValue();
         }
-        string str = strOp.string_val;
-        string subStr = subStrOp.string_val;
+        string str = strOp.stringValue();
+        string subStr = subStrOp.stringValue();
         size_t pos = str.find(subStr);
         if (pos != string::npos)
         {
@@ -2049,27 +1998,27 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(-1.0); // Not found
         }
     }
-    else if (BlockType == "replace_string")
+    else if (block.opcode == BlockTypeEnum::REPLACE_STRING)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 3)
+        if (block.params.size() != 3)
         {
             engine.EngineStdOut(
                 "replace_string block for " + objectId + " has invalid params structure. Expected 3 params.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue oldStrOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue newStrOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue strOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue oldStrOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue newStrOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
         if (strOp.type != OperandValue::Type::STRING || oldStrOp.type != OperandValue::Type::STRING || newStrOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("replace_string block for " + objectId + " has non-string parameter.", 2,
                                 executionThreadId);
             return OperandValue();
         }
-        string str = strOp.string_val;
-        string oldStr = oldStrOp.string_val;
-        string newStr = newStrOp.string_val;
+        string str = strOp.stringValue();
+        string oldStr = oldStrOp.stringValue();
+        string newStr = newStrOp.stringValue();
         size_t pos = str.find(oldStr);
         if (pos != string::npos)
         {
@@ -2081,25 +2030,25 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(str); // Not found, return original string
         }
     }
-    else if (BlockType == "change_string_case")
+    else if (block.opcode == BlockTypeEnum::CHANGE_STRING_CASE)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 2)
+        if (block.params.size() != 2)
         {
             engine.EngineStdOut(
                 "change_string_case block for " + objectId + " has invalid params structure. Expected 2 params.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue strOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue caseOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue strOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue caseOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (strOp.type != OperandValue::Type::STRING || caseOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("change_string_case block for " + objectId + " has non-string parameter.", 2,
                                 executionThreadId);
             return OperandValue();
         }
-        string str = strOp.string_val;
-        string caseType = caseOp.string_val;
+        string str = strOp.stringValue();
+        string caseType = caseOp.stringValue();
         if (caseType == "upper")
         {
             transform(str.begin(), str.end(), str.begin(), ::toupper);
@@ -2116,16 +2065,16 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
         return OperandValue(str);
     }
-    else if (BlockType == "get_block_count")
+    else if (block.opcode == BlockTypeEnum::GET_BLOCK_COUNT)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 1)
+        if (block.params.size() != 1)
         {
             engine.EngineStdOut(
                 "get_block_count block for " + objectId + " has invalid params structure. Expected 1 param (OBJECT).",
                 2, executionThreadId);
             return OperandValue(0.0);
         }
-        OperandValue objectKeyOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue objectKeyOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (objectKeyOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -2133,7 +2082,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                 executionThreadId);
             return OperandValue(0.0);
         }
-        string objectKey = objectKeyOp.string_val;
+        string objectKey = objectKeyOp.stringValue();
 
         if (objectKey.empty())
         {
@@ -2172,18 +2121,18 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
         return OperandValue(static_cast<double>(count));
     }
-    else if (BlockType == "change_rgb_to_hex")
+    else if (block.opcode == BlockTypeEnum::CHANGE_RGB_TO_HEX)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 3)
+        if (block.params.size() != 3)
         {
             engine.EngineStdOut(
                 "change_rgb_to_hex block for " + objectId + " has invalid params structure. Expected 3 params.", 2,
                 executionThreadId);
             return OperandValue("#000000");
         }
-        OperandValue redOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue greenOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue blueOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue redOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue greenOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue blueOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
         double r_double = redOp.asNumber();
         double g_double = greenOp.asNumber();
         double b_double = blueOp.asNumber();
@@ -2199,17 +2148,17 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                   << setw(2) << hex << blue;
         return OperandValue(hexStream.str());
     }
-    else if (BlockType == "change_hex_to_rgb")
+    else if (block.opcode == BlockTypeEnum::CHANGE_HEX_TO_RGB)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "change_hex_to_rgb block for " + objectId + " has invalid params structure. Expected 2 params (HEX, CHANNEL).", 2,
                 executionThreadId);
             return OperandValue(0.0);
         }
-        OperandValue hexOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue channelOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue hexOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue channelOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
 
         if (hexOp.type != OperandValue::Type::STRING || channelOp.type != OperandValue::Type::STRING)
         {
@@ -2217,8 +2166,8 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                                 executionThreadId);
             return OperandValue(0.0);
         }
-        string hexStr = hexOp.string_val;
-        string channel = channelOp.string_val;
+        string hexStr = hexOp.stringValue();
+        string channel = channelOp.stringValue();
 
         if (hexStr.length() != 7 || hexStr[0] != '#')
         {
@@ -2261,44 +2210,44 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                                             "HEX string value out of range: " + hexStr + ". Error: " + oor.what());
         }
     }
-    else if (BlockType == "get_boolean_value")
+    else if (block.opcode == BlockTypeEnum::GET_BOOLEAN_VALUE)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() != 1)
+        if (block.params.size() != 1)
         {
             engine.EngineStdOut(
                 "get_boolean_value block for " + objectId + " has invalid params structure. Expected 1 param.", 2,
                 executionThreadId);
             return OperandValue();
         }
-        OperandValue boolOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue boolOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (boolOp.type != OperandValue::Type::BOOLEAN)
         {
             engine.EngineStdOut("get_boolean_value block for " + objectId + " has non-boolean parameter.", 2,
                                 executionThreadId);
             return OperandValue();
         }
-        return OperandValue(boolOp.boolean_val);
+        return OperandValue(boolOp.booleanValue());
     }
-    else if (BlockType == "is_clicked")
+    else if (block.opcode == BlockTypeEnum::IS_CLICKED)
     {
         // 이 블록은 현재 프레임에서 스테이지가 클릭되었는지 여부를 반환합니다.
-        // block.paramsJson에서 별도의 파라미터를 사용하지 않습니다.
+        // block.params에서 별도의 파라미터를 사용하지 않습니다.
         bool isClick = engine.getStageWasClickedThisFrame();
         engine.EngineStdOut(format("Object {} is Clicked {}", objectId, isClick), 3);
         return OperandValue(isClick);
     }
-    else if (BlockType == "is_object_clicked")
+    else if (block.opcode == BlockTypeEnum::IS_OBJECT_CLICKED_JUDGE)
     {
         // 이 블록은 현재 스크립트를 실행 중인 오브젝트(objectId)가
         // 엔진에 마지막으로 눌린 오브젝트 ID와 일치하는지 확인합니다.
-        // block.paramsJson에서 별도의 파라미터를 사용하지 않습니다.
+        // block.params에서 별도의 파라미터를 사용하지 않습니다.
         return OperandValue(engine.getPressedObjectId() == objectId);
     }
-    else if (BlockType == "is_press_some_key")
+    else if (block.opcode == BlockTypeEnum::IS_KEY_PRESSED_JUDGE)
     {
         // 파라미터: [KEY_IDENTIFIER_STRING (키 식별자 문자열), null]
         // paramsKeyMap: { VALUE: 0 }
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "is_press_some_key block for " + objectId +
@@ -2309,7 +2258,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
 
         // 첫 번째 파라미터 (키 식별자 문자열)를 가져옵니다.
         // 이 파라미터는 직접 문자열 값이거나, 문자열을 반환하는 다른 블록일 수 있습니다.
-        const nlohmann::json &keyParamValue = block.paramsJson[0];
+        const Operand &keyParamValue = block.params[0];
         OperandValue keyIdentifierOp = getOperandValue(engine, objectId, keyParamValue, executionThreadId);
 
         if (keyIdentifierOp.type != OperandValue::Type::STRING || keyIdentifierOp.asString().empty())
@@ -2325,13 +2274,11 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         SDL_Scancode scancode = engine.mapStringToSDLScancode(keyIdentifierStr);
         return OperandValue(engine.isKeyPressed(scancode));
     }
-    else if (BlockType == "choose_project_timer_action")
+    else if (block.opcode == BlockTypeEnum::CHOOSE_PROJECT_TIMER_ACTION)
     {
         // paramsKeyMap: { ACTION: 0 }
-        // 드롭다운 값은 block.paramsJson[0]에 문자열로 저장되어 있을 것으로 예상합니다.
-        // Block.h에서 paramsJson이 rapidjson::Value 타입이고,
-        // 이 값은 loadProject 시점에 engine.m_blockParamsAllocatorDoc를 사용하여 할당됩니다.
-        if (!block.paramsJson.is_array() || block.paramsJson.empty() || !block.paramsJson[0].is_string())
+        // 드롭다운 값은 block.params[0]에 문자열로 저장되어 있을 것으로 예상합니다.
+        if (block.params.empty() || !block.params[0].isString())
         {
             engine.EngineStdOut(
                 "choose_project_timer_action block for " + objectId + " has invalid or missing action parameter.", 2,
@@ -2340,7 +2287,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
 
         // 이 블록의 파라미터는 항상 단순 문자열 드롭다운 값이므로 직접 접근합니다.
-        OperandValue actionOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue actionOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         string action = actionOp.asString();
 
         if (action == "START")
@@ -2360,9 +2307,9 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
         return OperandValue();
     }
-    else if (BlockType == "set_visible_project_timer")
+    else if (block.opcode == BlockTypeEnum::SET_VISIBLE_PROJECT_TIMER)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "set_visible_project_timer block for " + objectId +
@@ -2371,21 +2318,21 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             engine.showProjectTimer(false); // Default action
             return OperandValue();
         }
-        OperandValue actionValue = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue actionValue = getOperandValue(engine, objectId, block.params[0], executionThreadId);
 
         if (actionValue.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
                 "set_visible_project_timer parameter for object " + objectId +
-                    " did not resolve to a string. Interpreted as: '" + actionValue.string_val + "'",
+                    " did not resolve to a string. Interpreted as: '" + actionValue.stringValue() + "'",
                 1, executionThreadId);
         }
 
-        if (actionValue.string_val == "SHOW")
+        if (actionValue.stringValue() == "SHOW")
         {
             engine.showProjectTimer(true);
         }
-        else if (actionValue.string_val == "HIDE")
+        else if (actionValue.stringValue() == "HIDE")
         {
             engine.showProjectTimer(false);
         }
@@ -2393,45 +2340,45 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         {
             engine.EngineStdOut(
                 "set_visible_project_timer block for " + objectId + " has unknown or non-string action value: '" +
-                    actionValue.string_val + "'. Defaulting to HIDE.",
+                    actionValue.stringValue() + "'. Defaulting to HIDE.",
                 1, executionThreadId);
             // 기본적으로 숨김 처리 또는 아무것도 안 함
         }
         return OperandValue();
     }
-    else if (BlockType == "get_user_name")
+    else if (block.opcode == BlockTypeEnum::GET_USER_NAME)
     {
         // 네이버 클라우드 플랫폼에서 제공하는 사용자 이름을 가져오는 블록
         // 엔트리쪽 에서 API 를 제공하지 못하기에 플레이스 홀더 로 사용
         return OperandValue(publicVariable.user_id);
     }
-    else if (BlockType == "get_nickname")
+    else if (block.opcode == BlockTypeEnum::GET_NICKNAME)
     {
         // 네이버 클라우드 플랫폼에서 제공하는 사용자 ID를 가져오는 블록
         // 엔트리쪽 에서 API 를 제공하지 못하기에 플레이스 홀더 로 사용
         return OperandValue(publicVariable.user_name);
     }
-    else if (BlockType == "get_sound_volume")
+    else if (block.opcode == BlockTypeEnum::GET_SOUND_VOLUME)
     {
         // engine.aeHelper.getGlobalVolume()이 0.0f ~ 1.0f 범위의 float 값을 반환한다고 가정
         double volume = static_cast<double>(engine.aeHelper.getGlobalVolume()) * 100.0; // 백분율로 변환
         return OperandValue(volume);
     }
-    else if (BlockType == "get_sound_speed")
+    else if (block.opcode == BlockTypeEnum::GET_SOUND_SPEED)
     {
         float speed = engine.aeHelper.getGlobalPlaybackSpeed(); // 전역 재생 속도 가져오기 (0.0f ~ N.Nf)
         return OperandValue(static_cast<double>(speed));
     }
-    else if (BlockType == "get_sound_duration")
+    else if (block.opcode == BlockTypeEnum::GET_SOUND_DURATION)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "get_sound_duration block for " + objectId + " has insufficient parameters. Expected sound ID.", 2,
                 executionThreadId);
             return OperandValue(0.0); // 오류 시 기본값 반환
         }
-        OperandValue soundIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue soundIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (soundIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -2471,18 +2418,18 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             executionThreadId);
         return OperandValue(0.0); // 해당 ID의 사운드를 찾지 못한 경우
     }
-    else if (BlockType == "get_canvas_input_value")
+    else if (block.opcode == BlockTypeEnum::GET_CANVAS_INPUT_VALUE)
     {
         // 이 블록은 OperandValue를 반환해야 하므로, Variable 함수가 아닌 Calculator 함수에서 처리합니다.
         // Variable 함수는 void 반환형을 가집니다.
         // engine.getLastAnswer()는 가장 최근에 ask_and_wait을 통해 입력된 값을 반환해야 합니다.
         return OperandValue(engine.getLastAnswer());
     }
-    else if (BlockType == "get_variable")
+    else if (block.opcode == BlockTypeEnum::GET_VARIABLE)
     {
         // EntryJS: get_variable
         // params: [VARIABLE_ID_STRING, null, null] (VARIABLE_ID_STRING 는 드롭다운 메뉴 항목이다.)
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "get_variable block for " + objectId + " has insufficient parameters. Expected VARIABLE_ID.", 2,
@@ -2490,7 +2437,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(0.0);
         }
 
-        OperandValue variableIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue variableIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (variableIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -2509,76 +2456,14 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(0.0);
         }
 
-        // --- 추가된 뮤텍스 잠금 범위 시작 ---
-        std::string valueToReturn_str = "0"; // 기본값 또는 오류 시 반환될 값
-        bool foundVar = false;
-        {
-            // lock_guard의 범위를 명확히 하기 위한 스코프
-            lock_guard lock(engine.m_engineDataMutex);  // <--- 뮤텍스 잠금 추가
-            HUDVariableDisplay *targetVarPtr = nullptr; // targetListPtr에서 targetVarPtr로 이름 변경 (일관성)
-            // 1. Search for a local variable (associated with the current objectId)
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                // Compare with hudVar.id instead of hudVar.id
-                if (hudVar.id == variableIdToFind && hudVar.objectId == objectId)
-                {
-                    targetVarPtr = &hudVar;
-                    engine.EngineStdOut(format("Found Value from local ID {} Value {}", hudVar.id, hudVar.value),
-                                        3);
-                    break; // Found local, no need to search further
-                }
-            }
-
-            // 2. If not found locally, search for a global variable
-            if (!targetVarPtr)
-            {
-                for (auto &hudVar : engine.getHUDVariables_Editable())
-                {
-                    // Compare with hudVar.id instead of hudVar.id
-                    if (hudVar.id == variableIdToFind && hudVar.objectId.empty())
-                    {
-                        targetVarPtr = &hudVar;
-                        engine.EngineStdOut(format("Found Value from Global ID {} Value {}", hudVar.id,
-                                                   hudVar.value),
-                                            3);
-                        break; // Found global
-                    }
-                }
-            }
-
-            if (!targetVarPtr)
-            {
-                engine.EngineStdOut(
-                    "get_variable block for " + objectId + ": Variable '" + variableIdToFind + "' not found.",
-                    1, executionThreadId);
-                // return OperandValue(0.0); // 잠금 해제 전에 반환하지 않도록 수정
-            }
-            else
-            {
-                if (targetVarPtr->isCloud)
-                {
-                    // 중요: loadCloudVariablesFromJson이 m_engineDataMutex를 내부적으로 또 잠그려 한다면 교착 상태 발생 가능.
-                    // loadCloudVariablesFromJson이 m_hudVariables를 수정한다면 이 잠금 내에서 호출하는 것이 맞지만,
-                    // 아니라면 잠금 밖에서 호출하거나, 해당 함수가 스레드 안전한지 확인 필요.
-                    // 현재는 잠금 내에 두지만, 교착 상태 발생 시 이 부분 검토 필요.
-                    engine.loadCloudVariablesFromJson();
-                }
-                valueToReturn_str = targetVarPtr->value;
-                foundVar = true;
-            }
-        } // --- 뮤텍스 잠금 범위 끝 ---
-
-        if (!foundVar)
-        {
-            return OperandValue(0.0); // 변수를 찾지 못한 경우
-        }
-        // OperandValue 생성은 잠금 해제 후 수행
-        return OperandValue(valueToReturn_str);
+        lock_guard lock(engine.m_engineDataMutex);
+        return readVariableSlot(engine, objectId, findVariableSlot(engine, objectId, variableIdToFind),
+                                variableIdToFind, executionThreadId);
     }
-    else if (BlockType == "value_of_index_from_list")
+    else if (block.opcode == BlockTypeEnum::VALUE_OF_INDEX_FROM_LIST)
     {
         // params: [LIST_ID_STRING, INDEX_VALUE_OR_BLOCK, null, null]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "value_of_index_from_list block for " + objectId +
@@ -2588,7 +2473,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
 
         // 1. 리스트 ID 가져오기 (항상 드롭다운 메뉴의 문자열)
-        OperandValue listIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue listIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (listIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -2597,7 +2482,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                 2, executionThreadId);
             return OperandValue("");
         }
-        string listIdToFind = block.paramsJson[0].get<string>();
+        string listIdToFind = block.params[0].value.stringValue();
         if (listIdToFind.empty())
         {
             engine.EngineStdOut("value_of_index_from_list block for " + objectId + ": received an empty LIST_ID.",
@@ -2607,26 +2492,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
 
         // 2. 리스트 찾기 (로컬 리스트 우선, 없으면 전역 리스트)
-        HUDVariableDisplay *targetListPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listIdToFind && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetListPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listIdToFind && hudVar.objectId.empty())
-                {
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
-        }
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listIdToFind);
 
         if (!targetListPtr)
         {
@@ -2643,7 +2509,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             }
         }
 
-        vector<ListItem> &listArray = targetListPtr->array;
+        const VariableList &listArray = targetListPtr->items;
         if (listArray.empty())
         {
             engine.EngineStdOut(
@@ -2653,7 +2519,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
         }
 
         // 3. 인덱스 값 가져오기 및 처리
-        OperandValue indexOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue indexOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         double resolvedIndex_1based = 0.0; // 처리 후 1기반 인덱스
 
         if (indexOp.type == OperandValue::Type::STRING)
@@ -2744,15 +2610,15 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
 
         size_t finalIndex_0based = static_cast<size_t>(finalIndex_1based - 1);
 
-        // 5. 데이터 반환
-        return OperandValue(listArray[finalIndex_0based].data);
+        // 5. 데이터 반환 (숫자로 추가한 항목은 NUMBER 로 반환)
+        return listArray.valueAt(finalIndex_0based);
     }
-    else if (BlockType == "length_of_list")
+    else if (block.opcode == BlockTypeEnum::LENGTH_OF_LIST)
     {
         // 리스트의 길이를 반환
-        OperandValue listId = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue listId = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         // params: [LIST_ID_STRING, INDEX_VALUE_OR_BLOCK, null, null]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "value_of_index_from_list block for " + objectId +
@@ -2769,34 +2635,15 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(0.0);
         }
 
-        HUDVariableDisplay *targetListPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listId.asString() && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetListPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listId.asString() && hudVar.objectId.empty())
-                {
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
-        }
-        double itemCount = targetListPtr->array.size();
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listId.asString());
+        double itemCount = static_cast<double>(targetListPtr->items.size());
         return OperandValue(itemCount);
     }
-    else if (BlockType == "is_included_in_list")
+    else if (block.opcode == BlockTypeEnum::IS_INCLUDED_IN_LIST)
     {
         // 리스트에 해당 항목이 들어있는지 확인
-        OperandValue listId = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue dataOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue listId = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue dataOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (listId.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -2804,7 +2651,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                 executionThreadId);
             return OperandValue(0.0);
         }
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "is_included_in_list block for " + objectId +
@@ -2812,26 +2659,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                 2, executionThreadId);
             return OperandValue(false);
         }
-        HUDVariableDisplay *targetListPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listId.asString() && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetListPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listId.asString() && hudVar.objectId.empty())
-                {
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
-        }
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listId.asString());
         if (!targetListPtr)
         {
             engine.EngineStdOut(
@@ -2840,7 +2668,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false);
         }
 
-        if (targetListPtr->variableType != "list")
+        if (!targetListPtr->isList)
         {
             engine.EngineStdOut(
                 "is_included_in_list block for " + objectId + ": Variable '" + listId.asString() +
@@ -2855,18 +2683,11 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             engine.loadCloudVariablesFromJson(); // 클라우드 변수인 경우 최신 데이터 로드
         }
 
-        bool finded = false;
-        for (auto &item : targetListPtr->array)
-        {
-            if (item.data == dataOp.asString())
-            {
-                finded = true;
-                break; // 항목을 찾으면 루프 종료
-            }
-        }
-        return OperandValue(finded);
+        // 긴 리스트는 처음 확인할 때 항목 개수 표를 만들므로 쓰기와 같은 잠금 아래에서 확인합니다.
+        lock_guard lock(engine.m_engineDataMutex);
+        return OperandValue(targetListPtr->items.contains(dataOp.asString()));
     }
-    else if (BlockType == "reach_something")
+    else if (block.opcode == BlockTypeEnum::REACH_SOMETHING)
     {
         // ~에 닿았는가?
         auto *self = engine.getEntityById(objectId);
@@ -2876,7 +2697,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false);
         }
 
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "reach_something block for " + objectId +
@@ -2885,7 +2706,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false);
         }
 
-        OperandValue targetIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue targetIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (targetIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -2903,127 +2724,15 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false);
         }
 
-        // Wall collision
-        if (targetId == "wall" || targetId == "wall_up" || targetId == "wall_down" || targetId == "wall_left" ||
-            targetId == "wall_right")
-        {
-            // Engine에 벽 충돌 확인 로직 필요 (engine.checkCollisionWithWall(self, targetId))
-            // 여기서는 Entity의 경계와 스테이지 경계를 비교하는 단순화된 로직을 사용합니다.
-            float selfX = self->getX();
-            float selfY = self->getY();
-            float scaledWidth = self->getWidth() * self->getScaleX();
-            float scaledHeight = self->getHeight() * self->getScaleY();
-
-            float selfTop = selfY + scaledHeight / 2.0f;
-            float selfBottom = selfY - scaledHeight / 2.0f;
-            float selfRight = selfX + scaledWidth / 2.0f;
-            float selfLeft = selfX - scaledWidth / 2.0f;
-
-            const float stageTop = PROJECT_STAGE_HEIGHT / 2.0f;
-            const float stageBottom = -PROJECT_STAGE_HEIGHT / 2.0f;
-            const float stageRight = PROJECT_STAGE_WIDTH / 2.0f;
-            const float stageLeft = -PROJECT_STAGE_WIDTH / 2.0f;
-
-            bool collided = false;
-            if ((targetId == "wall" || targetId == "wall_up") && selfTop > stageTop)
-                collided = true;
-            if (!collided && (targetId == "wall" || targetId == "wall_down") && selfBottom < stageBottom)
-                collided = true;
-            if (!collided && (targetId == "wall" || targetId == "wall_right") && selfRight > stageRight)
-                collided = true;
-            if (!collided && (targetId == "wall" || targetId == "wall_left") && selfLeft < stageLeft)
-                collided = true;
-
-            return OperandValue(collided);
-        }
-
-        // Mouse collision
-        if (targetId == "mouse")
-        {
-            if (!engine.isMouseCurrentlyOnStage())
-                return OperandValue(false);
-
-            SDL_FPoint mousePos = {
-                (engine.getCurrentStageMouseX()),
-                (engine.getCurrentStageMouseY())};
-            engine.EngineStdOut(format("object touched {}", self->isPointInside(mousePos.x, mousePos.y)), 3);
-            return OperandValue(self->isPointInside(mousePos.x, mousePos.y)); // isPointInside 사용
-        }
-
-        // Sprite collision
-        vector<Entity *> entitiesToTest;
-        auto *mainTargetSprite = engine.getEntityById(targetId);
-
-        if (mainTargetSprite)
-        {
-            if (mainTargetSprite->isVisible() /*&& !mainTargetSprite->isStamp() 엔트리는 스탬프도 충돌대상*/)
-            {
-                entitiesToTest.push_back(mainTargetSprite);
-            }
-            // 클론 가져오기 (Engine에 getClones(targetId) 또는 Entity에 getMyClones() 필요)
-            // vector<Entity*> clones = engine.getClones(targetId);
-            // for (Entity* clone : clones) {
-            //    if (clone->getVisible() /*&& !clone->isStamp()*/) {
-            //        entitiesToTest.push_back(clone);
-            //    }
-            // }
-            // 임시: 클론 로직은 Engine에 구현 필요. 여기서는 주석 처리.
-        }
-        else
-        {
-            // ID로 못찾으면 이름으로 찾아 시도 (엔트리는 ID 기반)
-            // 현재 구현에서는 ID로만 찾음
-            engine.EngineStdOut("reach_something: Target sprite ID '" + targetId + "' not found.", 1,
-                                executionThreadId);
-            return OperandValue(false);
-        }
-
-        if (entitiesToTest.empty() && !mainTargetSprite)
-        {
-            // mainTargetSprite도 없고 entitiesToTest도 비었으면 대상 없음
-            engine.EngineStdOut("reach_something: No target entities to test against for ID '" + targetId + "'.", 1,
-                                executionThreadId);
-            return OperandValue(false);
-        } // mainTargetSprite->isVisible() 로 변경
-        if (entitiesToTest.empty() && mainTargetSprite && !mainTargetSprite->isVisible())
-        {
-            // 대상은 있으나 보이지 않음
-            // 엔트리는 보이지 않는 대상과도 충돌 판정하므로 이 케이스는 실제로는 발생하면 안됨 (위의 getVisible 체크 때문)
-            // 만약 getVisible 체크를 제거한다면 이 로그가 유용할 수 있음
-            // engine.EngineStdOut("reach_something: Target sprite '" + targetId + "' is not visible and has no visible clones.", 0, executionThreadId);
-            // return OperandValue(false); // 엔트리 동작과 맞추려면 이 부분도 수정 필요
-        }
-
-        SDL_FRect selfBounds = self->getVisualBounds();
-
-        for (Entity *testEntity : entitiesToTest)
-        {
-            if (!testEntity)
-                continue; // 혹시 모를 null 체크
-            SDL_FRect targetBounds = testEntity->getVisualBounds();
-            if (SDL_HasRectIntersectionFloat(&selfBounds, &targetBounds))
-            {
-                // 함수 이름 변경
-                // 엔트리는 텍스트 박스 간, 텍스트 박스와 다른 오브젝트 간 충돌은 항상 사각 충돌 사용
-                // 일반 오브젝트 간에는 픽셀 충돌 (여기서는 경계 상자로 단순화) - SDL_HasRectIntersectionFloat 사용
-                // if (self->isTextbox() || testEntity->isTextbox()) {
-                //    return OperandValue(true); // 사각 충돌로 충분
-                // } else {
-                //    // 픽셀 충돌 로직 (여기서는 경계 상자로 대체됨)
-                //    return OperandValue(true);
-                // }
-                return OperandValue(true); // 단순화된 경계 상자 충돌
-            } // SDL_HasIntersectionF 대신 SDL_HasRectIntersectionFloat 사용
-        }
-        return OperandValue(false);
+        return OperandValue(isEntityReaching(engine, *self, targetId, executionThreadId));
     }
-    else if (BlockType == "is_type")
+    else if (block.opcode == BlockTypeEnum::IS_TYPE)
     {
         // ~ 타입인가?
         // params: [VALUE_TO_CHECK (any type), TYPE_STRING_DROPDOWN (string: "number", "en", "ko")]
         // paramsKeyMap: { VALUE: 0, TYPE: 1 } (가정)
 
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "is_type block for " + objectId + " has insufficient parameters. Expected VALUE and TYPE.", 2,
@@ -3031,8 +2740,8 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false);
         }
 
-        OperandValue valueOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue typeOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue valueOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue typeOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
 
         string valueStr = valueOp.asString(); // 검사를 위해 입력값을 문자열로 변환
 
@@ -3082,10 +2791,10 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false);
         }
     }
-    else if (BlockType == "boolean_basic_operator")
+    else if (block.opcode == BlockTypeEnum::BOOLEAN_BASIC_OPERATOR)
     {
         // 두 값의 관계 비교
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 3)
+        if (block.params.size() < 3)
         {
             engine.EngineStdOut(
                 "boolean_basic_operator block for " + objectId +
@@ -3094,9 +2803,9 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false);
         }
 
-        OperandValue leftOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue operatorOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue rightOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue leftOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue operatorOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue rightOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
 
         if (operatorOp.type != OperandValue::Type::STRING)
         {
@@ -3107,63 +2816,10 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false);
         }
         string opStr = operatorOp.asString();
-        // 1. 먼저 양쪽 모두 엄격한 숫자인지 확인
-        bool leftIsNumber = (leftOp.type == OperandValue::Type::NUMBER) ||
-                            (leftOp.type == OperandValue::Type::STRING && is_number(leftOp.string_val));
-        bool rightIsNumber = (rightOp.type == OperandValue::Type::NUMBER) ||
-                             (rightOp.type == OperandValue::Type::STRING && is_number(rightOp.string_val));
-
-        engine.EngineStdOut(
-            format("boolean_basic_operator ({}): leftIsNumber={}, rightIsNumber={}",
-                   objectId, leftIsNumber, rightIsNumber),
-            3, executionThreadId);
-
-        // 2. 둘 다 숫자로 처리 가능한 경우
-        if (leftIsNumber && rightIsNumber)
-        {
-            double leftNum = leftOp.asNumber();
-            double rightNum = rightOp.asNumber();
-            engine.EngineStdOut(format("boolean_basic_operator ({}): Numeric compare: {} {} {}", objectId, leftNum,
-                                       opStr, rightNum),
-                                3, executionThreadId);
-            if (opStr == "EQUAL")
-                return OperandValue(leftNum == rightNum);
-            else if (opStr == "NOT_EQUAL")
-                return OperandValue(leftNum != rightNum);
-            else if (opStr == "GREATER")
-                return OperandValue(leftNum > rightNum);
-            else if (opStr == "LESS")
-                return OperandValue(leftNum < rightNum);
-            else if (opStr == "GREATER_OR_EQUAL")
-                return OperandValue(leftNum >= rightNum);
-            else if (opStr == "LESS_OR_EQUAL")
-                return OperandValue(leftNum <= rightNum);
-        }
-        // 3. 숫자가 아닌 경우 문자열로 비교
-        else
+        CompareOperator compareOp = toCompareOperator(opStr);
+        if (compareOp != CompareOperator::UNKNOWN)
         {
-            string leftStr = leftOp.asString();
-            string rightStr = rightOp.asString();
-            engine.EngineStdOut(format("boolean_basic_operator ({}): String compare: \"{}\" {} \"{}\"", objectId,
-                                       leftStr, opStr, rightStr),
-                                3, executionThreadId);
-            if (opStr == "EQUAL")
-                return OperandValue(leftStr == rightStr);
-            if (opStr == "NOT_EQUAL")
-                return OperandValue(leftStr != rightStr);
-
-            // 숫자가 아닌 값들에 대한 비교는 문자열을 0으로 취급
-            double leftVal = leftIsNumber ? leftOp.asNumber() : 0.0;
-            double rightVal = rightIsNumber ? rightOp.asNumber() : 0.0;
-
-            if (opStr == "GREATER")
-                return OperandValue(leftVal > rightVal);
-            if (opStr == "LESS")
-                return OperandValue(leftVal < rightVal);
-            if (opStr == "GREATER_OR_EQUAL")
-                return OperandValue(leftVal >= rightVal);
-            if (opStr == "LESS_OR_EQUAL")
-                return OperandValue(leftVal <= rightVal);
+            return applyCompare(compareOp, leftOp, rightOp);
         }
 
         engine.EngineStdOut("boolean_basic_operator block for " + objectId + ": Unknown operator '" + opStr + "'.",
@@ -3171,28 +2827,88 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
                             executionThreadId);
         return OperandValue(false);
     }
-    else if (BlockType == "boolean_not")
+    else if (block.opcode == BlockTypeEnum::BOOLEAN_AND_OR)
+    {
+        // params: [LEFTHAND, OPERATOR ("AND" | "OR"), RIGHTHAND]
+        if (block.params.size() < 3)
+        {
+            engine.EngineStdOut(
+                "boolean_and_or block for " + objectId +
+                    " has insufficient parameters. Expected LEFTHAND, OPERATOR, RIGHTHAND.",
+                2, executionThreadId);
+            return OperandValue(false);
+        }
+        OperandValue leftOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue operatorOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue rightOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
+        LogicOperator logicOp = toLogicOperator(operatorOp.asString());
+        if (logicOp == LogicOperator::UNKNOWN)
+        {
+            engine.EngineStdOut("boolean_and_or block for " + objectId + ": Unknown operator '" +
+                                    operatorOp.asString() + "'.",
+                                2, executionThreadId);
+            return OperandValue(false);
+        }
+        return applyLogic(logicOp, leftOp, rightOp);
+    }
+    else if (block.opcode == BlockTypeEnum::BOOLEAN_NOT)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "boolean_not block for " + objectId + " has insufficient parameters. Expected VALUE.",
                 2, executionThreadId);
             return OperandValue(false);
         }
-        OperandValue ValueOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue ValueOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         return OperandValue(!ValueOp.asBool());
     }
-    else if (BlockType == "is_boost_mode")
+    else if (block.opcode == BlockTypeEnum::IS_BOOST_MODE)
     {
-        // C++ 기반 엔진 은 SDL 을 사용합니다 (하드코딩)
-        return OperandValue(true);
+        // --boost 명령줄 옵션 또는 specialConfig.boostMode
+        return OperandValue(engine.isBoostMode());
     }
-    else if (BlockType == "is_current_device_type")
+    else if (block.opcode == BlockTypeEnum::FUNCTION_PARAM)
+    {
+        // 컴파일된 함수 본문에서는 LOAD_ARG 로 바로 읽고, 여기는 일반 블록의 파라미터로 쓰인 경우입니다.
+        const FunctionArgsView &args = currentFunctionArgs();
+        const OperandValue *arg = args.function ? args.get(args.function->paramIndex(block.type)) : nullptr;
+        if (!arg)
+        {
+            engine.EngineStdOut(format("Function parameter {} used outside of its function by object {}.",
+                                       block.type, objectId),
+                                1, executionThreadId);
+            return OperandValue();
+        }
+        return *arg;
+    }
+    else if (block.opcode == BlockTypeEnum::GET_FUNC_VARIABLE)
+    {
+        // 컴파일된 함수 본문에서는 LOAD_ARG 로 바로 읽습니다.
+        const FunctionArgsView &args = currentFunctionArgs();
+        const int slot = args.function && !block.params.empty() && block.params[0].isString()
+                             ? args.function->localVariableSlot(block.params[0].value.stringValue())
+                             : -1;
+        const OperandValue *value = functionVariableSlot(engine, objectId, slot, executionThreadId);
+        return value ? *value : OperandValue();
+    }
+    else if (block.opcode == BlockTypeEnum::FUNCTION_CALL)
+    {
+        // 값 반환 함수: 결과값이 필요하므로 한 틱 안에 끝까지 실행합니다.
+        auto entity = engine.getEntityByIdShared(objectId);
+        if (!entity)
+        {
+            engine.EngineStdOut(format("Function call {} failed: Entity {} not found.", block.type, objectId), 2,
+                                executionThreadId);
+            return OperandValue();
+        }
+        return entity->callUserFunction(block, executionThreadId);
+    }
+    else if (block.opcode == BlockTypeEnum::IS_CURRENT_DEVICE_TYPE)
     {
         // params: [DEVICE_TYPE_DROPDOWN (string: "desktop", "tablet", "mobile")]
         // paramsKeyMap: { DEVICE: 0 }
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "is_current_device_type block for " + objectId +
@@ -3201,7 +2917,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(false); // 오류 시 false 반환
         }
 
-        OperandValue deviceParamOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue deviceParamOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (deviceParamOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -3223,16 +2939,16 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(actualDeviceType != "mobile" && actualDeviceType != "tablet");
         }
     }
-    else if (BlockType == "is_touch_supported")
+    else if (block.opcode == BlockTypeEnum::IS_TOUCH_SUPPORTED)
     {
         // 미지원
         return OperandValue(engine.isTouchSupported());
     }
-    else if (BlockType == "text_read")
+    else if (block.opcode == BlockTypeEnum::TEXT_READ)
     {
         // paramsKeyMap: { VALUE: 0 }
         // 파라미터는 글상자 ID 또는 "self"를 가리키는 드롭다운입니다.
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "text_read block for " + objectId + " has invalid or missing params. Expected target textBox ID.",
@@ -3241,7 +2957,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
             return OperandValue(""); // 오류 시 빈 문자열 반환
         }
 
-        OperandValue targetIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue targetIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (targetIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -3295,7 +3011,7 @@ OperandValue Calculator(string BlockType, Engine &engine, const string &objectId
  * @brief 모양새 블록
  *
  */
-void Looks(string BlockType, Engine &engine, const string &objectId, const Block &block,
+void Looks(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
            const string &executionThreadId)
 {
     auto entity = engine.getEntityByIdShared(objectId);
@@ -3305,18 +3021,18 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
         return;
     }
 
-    if (BlockType == "show")
+    if (block.opcode == BlockTypeEnum::SHOW)
     {
         entity->setVisible(true);
     }
-    else if (BlockType == "hide")
+    else if (block.opcode == BlockTypeEnum::HIDE)
     {
         entity->setVisible(false);
     }
-    else if (BlockType == "dialog_time")
+    else if (block.opcode == BlockTypeEnum::DIALOG_TIME)
     {
         // params: VALUE (message), SECOND, OPTION (speak/think)
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 3)
+        if (block.params.size() < 3)
         {
             // 인디케이터 포함하면 4개일 수 있음
             engine.EngineStdOut(
@@ -3325,9 +3041,9 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
                 2, executionThreadId);
             return;
         }
-        OperandValue messageOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue timeOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue optionOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue messageOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue timeOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue optionOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
         // Dropdown value
 
         if (timeOp.type != OperandValue::Type::NUMBER)
@@ -3349,10 +3065,10 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
         string dialogType = optionOp.asString();
         entity->showDialog(message, dialogType, durationMs);
     }
-    else if (BlockType == "dialog")
+    else if (block.opcode == BlockTypeEnum::DIALOG)
     {
         // params: VALUE (message), OPTION (speak/think)
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             // 인디케이터 포함하면 3개일 수 있음
             engine.EngineStdOut(
@@ -3360,8 +3076,8 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
             return;
         }
-        OperandValue messageOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue optionOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue messageOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue optionOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         // Dropdown value
 
         if (optionOp.type != OperandValue::Type::STRING)
@@ -3376,20 +3092,20 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
         string dialogType = optionOp.asString();
         entity->showDialog(message, dialogType, 0);
     }
-    else if (BlockType == "remove_dialog")
+    else if (block.opcode == BlockTypeEnum::REMOVE_DIALOG)
     {
         entity->removeDialog();
     }
-    else if (BlockType == "change_to_some_shape")
+    else if (block.opcode == BlockTypeEnum::CHANGE_TO_SOME_SHAPE)
     {
         // 이미지 url 묶음에서 해당 모양의 ID를 (사용자 는 모양의 이름이 정의된 드롭다운이 나온다) 선택 한 것으로 바꾼다.
         // --- DEBUG START ---
-        if (block.paramsJson.is_array() && !block.paramsJson.empty())
+        if (!block.params.empty())
         {
             string params_json_dump = "null";
-            if (!block.paramsJson[0].is_null())
+            if (!block.params[0].isNull())
             {
-                params_json_dump = block.paramsJson[0].dump();
+                params_json_dump = block.params[0].describe();
             }
             engine.EngineStdOut(
                 "change_to_some_shape for " + objectId + ": Raw paramField[0] before getOperandValue: " +
@@ -3399,12 +3115,12 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
         else
         {
             engine.EngineStdOut(
-                "change_to_some_shape for " + objectId + ": paramsJson is not an array or is empty.", 3,
+                "change_to_some_shape for " + objectId + ": params is not an array or is empty.", 3,
                 executionThreadId);
         }
         // --- DEBUG END ---
 
-        OperandValue imageDropdown = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue imageDropdown = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         // getOperandValue는 get_pictures 블록의 params[0] (모양 ID 문자열)을 반환해야 합니다.
         // getOperandValue 내부에서 get_pictures 타입 처리가 필요합니다.
 
@@ -3449,9 +3165,9 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
                                 executionThreadId);
         }
     }
-    else if (BlockType == "change_to_next_shape")
+    else if (block.opcode == BlockTypeEnum::CHANGE_TO_NEXT_SHAPE)
     {
-        OperandValue nextorprev = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue nextorprev = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (nextorprev.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -3471,10 +3187,10 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
             engine.setEntitychangeToNextCostume(objectId, "prev");
         }
     }
-    else if (BlockType == "add_effect_amount")
+    else if (block.opcode == BlockTypeEnum::ADD_EFFECT_AMOUNT)
     {
         // params: EFFECT (dropdown: "color", "brightness", "transparency"), VALUE (number)
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             // 인디케이터 포함 시 3개일 수 있음
             engine.EngineStdOut(
@@ -3483,9 +3199,9 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
             return;
         }
-        OperandValue effectTypeOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue effectTypeOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         // EFFECT dropdown
-        OperandValue effectValueOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue effectValueOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         // VALUE number
 
         if (effectTypeOp.type != OperandValue::Type::STRING)
@@ -3535,9 +3251,9 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
         }
     }
-    else if (BlockType == "change_effect_amount")
+    else if (block.opcode == BlockTypeEnum::CHANGE_EFFECT_AMOUNT)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "change_effect_amount block for " + objectId +
@@ -3545,9 +3261,9 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
                 2, executionThreadId);
             return;
         }
-        OperandValue effectTypeOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue effectTypeOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         // EFFECT dropdown
-        OperandValue effectValueOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue effectValueOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         // VALUE number
 
         if (effectTypeOp.type != OperandValue::Type::STRING)
@@ -3581,21 +3297,21 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
                 "Entity " + objectId + " effect 'transparency' (alpha) changed to " + to_string(value), 3);
         }
     }
-    else if (BlockType == "erase_all_effects")
+    else if (block.opcode == BlockTypeEnum::ERASE_ALL_EFFECTS)
     {
         entity->setEffectBrightness(0.0); // 밝기 효과 초기화 (0.0이 기본값)
         entity->setEffectAlpha(1.0);      // 투명도 효과 초기화 (1.0이 기본값, 완전 불투명)
         entity->setEffectHue(0.0);        // 색깔 효과 (색조) 초기화 (0.0이 기본값)
         engine.EngineStdOut("Entity " + objectId + " all graphic effects erased.", 0, executionThreadId);
     }
-    else if (BlockType == "change_scale_size")
+    else if (block.opcode == BlockTypeEnum::CHANGE_SCALE_SIZE)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "change_scale_size block for" + objectId + "has insufficient parameters. Expected VALUE.", 2);
         }
-        OperandValue size = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue size = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (size.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -3605,15 +3321,15 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
         entity->setSize(entity->getSize() + changePercent);
         engine.EngineStdOut(format("FACTOR: {}", changePercent), 3);
     }
-    else if (BlockType == "set_scale_size")
+    else if (block.opcode == BlockTypeEnum::SET_SCALE_SIZE)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "set_scale_size block for" + objectId + "has insufficient parameters. Expected VALUE.",
                 2);
         }
-        OperandValue setSize = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue setSize = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (setSize.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -3623,7 +3339,7 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
         entity->setSize(percent);
         engine.EngineStdOut(format("FACTOR: {}", percent), 3);
     }
-    else if (BlockType == "stretch_scale_size")
+    else if (block.opcode == BlockTypeEnum::STRETCH_SCALE_SIZE)
     {
         /**
         func(sprite, script) {
@@ -3637,15 +3353,15 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
                     return script.callReturn();
                 },
          */
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "stretch_scale_size block for" + objectId +
                     "has insufficient parameters. Expected [DIMENSION, SIZE].",
                 2);
         }
-        OperandValue dimensionDropdown = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue sizeValue = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue dimensionDropdown = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue sizeValue = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (dimensionDropdown.type != OperandValue::Type::NUMBER && sizeValue.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -3667,30 +3383,33 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
             "STRETCH SCALE: " + to_string(entity->getScaleX()) + ", " + to_string(entity->getScaleY()),
             3);
     }
-    else if (BlockType == "reset_scale_size")
+    else if (block.opcode == BlockTypeEnum::RESET_SCALE_SIZE)
     {
         entity->resetSize();
     }
-    else if (BlockType == "flip_x")
+    else if (block.opcode == BlockTypeEnum::FLIP_X)
     {
         entity->setScaleX(-1 * entity->getScaleX());
     }
-    else if (BlockType == "flip_y")
+    else if (block.opcode == BlockTypeEnum::FLIP_Y)
     {
         entity->setScaleY(-1 * entity->getScaleY());
     }
-    else if (BlockType == "change_object_index")
+    else if (block.opcode == BlockTypeEnum::CHANGE_OBJECT_INDEX)
     {
         // 이 엔진은 역순으로 스프라이트를 렌더링 하고있음
-        OperandValue zindexEnumDropdown = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue zindexEnumDropdown = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (zindexEnumDropdown.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("change_object_index object is not String", 2, executionThreadId);
             return;
         }
         string zindexEnumStr = zindexEnumDropdown.asString();
-        Omocha::ObjectIndexChangeType changeType = Omocha::stringToObjectIndexChangeType(zindexEnumStr);
-        engine.changeObjectIndex(objectId, changeType);
+        Engine::EngineCommand command;
+        command.type = Engine::EngineCommand::Type::CHANGE_OBJECT_INDEX;
+        command.targetId = objectId;
+        command.indexChange = Omocha::stringToObjectIndexChangeType(zindexEnumStr);
+        engine.submitCommand(move(command));
     }
 }
 
@@ -3698,13 +3417,13 @@ void Looks(string BlockType, Engine &engine, const string &objectId, const Block
  * @brief 사운드 블록
  *
  */
-void Sound(string BlockType, Engine &engine, const string &objectId, const Block &block,
+void Sound(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
            const string &executionThreadId)
 {
     auto entity = engine.getEntityByIdShared(objectId);
-    if (BlockType == "sound_something_with_block")
+    if (block.opcode == BlockTypeEnum::SOUND_SOMETHING_WITH_BLOCK)
     {
-        OperandValue soundType = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue soundType = getOperandValue(engine, objectId, block.params[0], executionThreadId);
 
         if (soundType.type != OperandValue::Type::STRING)
         {
@@ -3727,10 +3446,10 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
 
         entity->playSound(soundIdToPlay);
     }
-    else if (BlockType == "sound_something_second_with_block")
+    else if (block.opcode == BlockTypeEnum::SOUND_SOMETHING_SECOND_WITH_BLOCK)
     {
-        OperandValue soundType = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue soundTime = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue soundType = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue soundTime = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (soundType.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -3760,11 +3479,11 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
 
         entity->playSoundWithSeconds(soundIdToPlay, soundTime.asNumber());
     }
-    else if (BlockType == "sound_from_to")
+    else if (block.opcode == BlockTypeEnum::SOUND_FROM_TO)
     {
-        OperandValue soundId = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue from = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue to = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue soundId = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue from = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue to = getOperandValue(engine, objectId, block.params[2], executionThreadId);
         if (soundId.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -3793,10 +3512,10 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
         }
         entity->playSoundWithFromTo(soundIdToPlay, fromTime, toTime);
     }
-    else if (BlockType == "sound_something_wait_with_block")
+    else if (block.opcode == BlockTypeEnum::SOUND_SOMETHING_WAIT_WITH_BLOCK)
     {
         // 소리 를 재생하고 기다리기. (재생이 끝날때까지 기다리는것)
-        OperandValue soundId = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue soundId = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (soundId.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -3809,10 +3528,10 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
         // 1. Play the sound (non-blocking)
         entity->waitforPlaysound(soundIdToPlay, executionThreadId, block.id);
     }
-    else if (BlockType == "sound_something_second_wait_with_block")
+    else if (block.opcode == BlockTypeEnum::SOUND_SOMETHING_SECOND_WAIT_WITH_BLOCK)
     {
-        OperandValue soundId = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue soundTime = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue soundId = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue soundTime = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (soundId.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -3832,11 +3551,11 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
 
         entity->waitforPlaysoundWithSeconds(soundIdToPlay, soundTimeValue, executionThreadId, block.id);
     }
-    else if (BlockType == "sound_from_to_and_wait")
+    else if (block.opcode == BlockTypeEnum::SOUND_FROM_TO_AND_WAIT)
     {
-        OperandValue soundId = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue from = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue to = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue soundId = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue from = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue to = getOperandValue(engine, objectId, block.params[2], executionThreadId);
         if (soundId.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("sound_from_to_and_wait for object" + objectId + ": received an empty sound ID", 2,
@@ -3856,10 +3575,10 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
 
         entity->waitforPlaysoundWithFromTo(soundIdToPlay, fromTime, toTime, executionThreadId, block.id);
     }
-    else if (BlockType == "sound_volume_change")
+    else if (block.opcode == BlockTypeEnum::SOUND_VOLUME_CHANGE)
     {
         // 파라미터는 하나 (VALUE) - 볼륨 변경량 (예: 10, -20)
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             // VALUE 파라미터 확인
             engine.EngineStdOut(
@@ -3869,7 +3588,7 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
             return;
         }
-        OperandValue volumeChangeOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue volumeChangeOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (volumeChangeOp.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -3894,10 +3613,10 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
                 to_string(newGlobalVolume) + " (triggered by object " + objectId + ")",
             0, executionThreadId);
     }
-    else if (BlockType == "sound_volume_set")
+    else if (block.opcode == BlockTypeEnum::SOUND_VOLUME_SET)
     {
         // 파라미터는 하나 (VALUE) - 볼륨 변경량 (예: 10, -20)
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             // VALUE 파라미터 확인
             engine.EngineStdOut(
@@ -3907,7 +3626,7 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
             return;
         }
-        OperandValue volumeChangeOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue volumeChangeOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (volumeChangeOp.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -3921,9 +3640,9 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
         float volumeChangeRatio = static_cast<float>(volumeChangePercentage) / 100.0f; // 비율로 변환 (예: 0.1, -0.2)
         engine.aeHelper.setGlobalVolume(volumeChangeRatio);
     }
-    else if (BlockType == "sound_speed_change")
+    else if (block.opcode == BlockTypeEnum::SOUND_SPEED_CHANGE)
     {
-        OperandValue speed = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue speed = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (speed.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -3940,9 +3659,9 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
         double clampedSpeed = clamp(static_cast<double>(newSpeedFactor), 0.5, 2.0); // 엔트리와 동일하게 0.5 ~ 2.0 범위로 제한
         engine.aeHelper.setGlobalPlaybackSpeed(static_cast<float>(clampedSpeed));
     }
-    else if (BlockType == "sound_speed_set")
+    else if (block.opcode == BlockTypeEnum::SOUND_SPEED_SET)
     {
-        OperandValue speed = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue speed = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (speed.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -3954,17 +3673,17 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
         float speedChangeAmount = static_cast<float>(valueFromBlock) / 100.0f;
         engine.aeHelper.setGlobalPlaybackSpeed(static_cast<float>(speedChangeAmount));
     }
-    else if (BlockType == "sound_silent_all")
+    else if (block.opcode == BlockTypeEnum::SOUND_SILENT_ALL)
     {
         // 파라미터는 하나 (TARGET) - "all", "thisOnly", "other_objects"
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "sound_silent_all for object " + objectId + ": TARGET parameter is missing.", 2,
                 executionThreadId);
             return;
         }
-        OperandValue targetOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue targetOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (targetOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -3998,11 +3717,11 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
         }
     }
-    else if (BlockType == "play_bgm")
+    else if (block.opcode == BlockTypeEnum::PLAY_BGM)
     {
         // EntryJS에서는 'VALUE' 필드 하나만 사용하며, 이것이 get_sounds 블록을 통해 사운드 ID를 가져옵니다.
-        // block.paramsJson[0]이 get_sounds 블록일 것으로 예상합니다.
-        OperandValue soundIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        // block.params[0]이 get_sounds 블록일 것으로 예상합니다.
+        OperandValue soundIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (soundIdOp.type != OperandValue::Type::STRING) // getOperandValue가 get_sounds를 처리하여 문자열 ID를 반환해야 함
         {
             engine.EngineStdOut(
@@ -4063,24 +3782,104 @@ void Sound(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
         }
     }
-    else if (BlockType == "stop_bgm")
+    else if (block.opcode == BlockTypeEnum::STOP_BGM)
+    {
+        // 배경음악 끄기.
+        // 이걸 빼먹었네
+        engine.aeHelper.stopBackgroundMusic();
+    }
+}
+
+/**
+ * @brief change_variable 의 값 변경 처리. 둘 다 숫자면 더하고 아니면 문자열로 이어 붙입니다.
+ * m_engineDataMutex 를 잡고 호출합니다.
+ */
+// change_variable 의 더하기: 둘 다 숫자면 더하고, 하나라도 숫자가 아니면 문자열로 이어붙입니다.
+static OperandValue addToVariableValue(const OperandValue &current, const OperandValue &valueToAdd)
+{
+    if (current.isNumeric() && valueToAdd.isNumeric() && isfinite(current.asNumber()) &&
+        isfinite(valueToAdd.asNumber()))
+    {
+        return OperandValue(current.asNumber() + valueToAdd.asNumber());
+    }
+    return OperandValue(current.asString() + valueToAdd.asString());
+}
+
+static void applyVariableChange(Engine &engine, const string &objectId, VariableStore::Slot *targetVarPtr,
+                                const string &variableIdToFind, const OperandValue &valueToAddOp,
+                                const string &executionThreadId)
+{
+    if (!targetVarPtr)
+    {
+        engine.EngineStdOut(
+            "change_variable block for " + objectId + ": Variable '" + variableIdToFind + "' not found.", 1,
+            executionThreadId);
+        return;
+    }
+
+    // 숫자 변수는 숫자 그대로 더하므로 문자열 변환/할당이 없습니다. (HUD 가 표시할 때만 문자열로 만듭니다)
+    targetVarPtr->value = addToVariableValue(targetVarPtr->value, valueToAddOp);
+    engine.noteVariableWrite(variableIdToFind);
+    if (targetVarPtr->isCloud)
     {
-        // 배경음악 끄기.
-        // 이걸 빼먹었네
-        engine.aeHelper.stopBackgroundMusic();
+        engine.saveCloudVariablesToJson();
+    }
+}
+
+void changeVariableBy(Engine &engine, const string &objectId, const string &variableIdToFind,
+                      const OperandValue &valueToAddOp, const string &executionThreadId)
+{
+    lock_guard lock(engine.m_engineDataMutex);
+    applyVariableChange(engine, objectId, findVariableSlot(engine, objectId, variableIdToFind), variableIdToFind,
+                        valueToAddOp, executionThreadId);
+}
+
+void changeVariableBy(Engine &engine, const string &objectId, const VariableStore::Ref &variable,
+                      const OperandValue &valueToAddOp, const string &executionThreadId)
+{
+    lock_guard lock(engine.m_engineDataMutex);
+    VariableStore &store = engine.getVariableStore();
+    applyVariableChange(engine, objectId, store.get(store.find(variable, objectId)), variable.id, valueToAddOp,
+                        executionThreadId);
+}
+
+void setFunctionVariable(Engine &engine, const string &objectId, int slot, OperandValue value,
+                         const string &executionThreadId)
+{
+    if (OperandValue *target = functionVariableSlot(engine, objectId, slot, executionThreadId))
+    {
+        *target = value.type == OperandValue::Type::EMPTY ? OperandValue("") : std::move(value); // set_variable 과 같음
+    }
+}
+
+void changeFunctionVariableBy(Engine &engine, const string &objectId, int slot, const OperandValue &valueToAdd,
+                              const string &executionThreadId)
+{
+    if (OperandValue *target = functionVariableSlot(engine, objectId, slot, executionThreadId))
+    {
+        *target = addToVariableValue(*target, valueToAdd);
     }
 }
 
+OperandValue readVariable(Engine &engine, const string &objectId, const VariableStore::Ref &variable,
+                          const string &executionThreadId)
+{
+    lock_guard lock(engine.m_engineDataMutex);
+    VariableStore &store = engine.getVariableStore();
+    return readVariableSlot(engine, objectId, store.get(store.find(variable, objectId)), variable.id,
+                            executionThreadId);
+}
+
 /**
  * @brief 변수 블록
  *
  */
-void Variable(string BlockType, Engine &engine, const string &objectId, const Block &block,
+void Variable(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
               const string &executionThreadId)
 {
-    if (BlockType == "set_visible_answer")
+    if (block.opcode == BlockTypeEnum::SET_VISIBLE_ANSWER)
     {
-        OperandValue visibleDropdown = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue visibleDropdown = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (visibleDropdown.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -4099,10 +3898,10 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             engine.showAnswerValue(true);
         }
     }
-    else if (BlockType == "ask_and_wait")
+    else if (block.opcode == BlockTypeEnum::ASK_AND_WAIT)
     {
         // params: [VALUE (question_string_block), null (indicator)]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "ask_and_wait block for " + objectId + " has insufficient parameters. Expected question.", 2,
@@ -4111,7 +3910,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
                                             "Insufficient parameters for ask_and_wait.");
         }
 
-        OperandValue questionOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue questionOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         string questionMessage = questionOp.asString();
 
         if (questionMessage.empty())
@@ -4137,15 +3936,22 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         // Engine의 activateTextInput 내부에서 Dialog를 띄우거나, 여기서 직접 호출할 수 있습니다.
         // entity->showDialog(questionMessage, "ask", 0); // Engine에서 처리하도록 변경
 
-        // Engine에 텍스트 입력을 요청하고, 사용자 입력이 완료될 때까지 이 스크립트 스레드는 대기합니다.
+        // VM 이 실행 중인 스레드는 TEXT_INPUT 대기로 그 자리에서 멈추고, 대답이 들어오면 다음 블록부터 재개됩니다.
+        // (워커 스레드를 입력이 끝날 때까지 붙잡지 않습니다)
+        if (entity->suspendForTextInput(executionThreadId, block.id))
+        {
+            engine.requestTextInput(objectId, questionMessage, executionThreadId);
+            return;
+        }
+        // 멈출 수 없는 스레드(트리 인터프리터, 끝까지 실행해야 하는 함수 호출)는 입력이 끝날 때까지 이 스레드에서 기다립니다.
         // engine.activateTextInput은 내부적으로 m_lastAnswer를 설정해야 합니다.
         engine.activateTextInput(objectId, questionMessage, executionThreadId);
     }
-    else if (BlockType == "change_variable")
+    else if (block.opcode == BlockTypeEnum::CHANGE_VARIABLE)
     {
         lock_guard lock(engine.m_engineDataMutex);
         // params: [VARIABLE_ID_STRING, VALUE_TO_ADD_OR_CONCAT, null, null]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "change_variable block for " + objectId +
@@ -4155,7 +3961,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         }
 
         // 1. 변수 ID 가져오기 (항상 문자열 드롭다운)
-        OperandValue variableIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue variableIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (variableIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -4173,125 +3979,15 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         }
 
         // 2. 더하거나 이어붙일 값 가져오기
-        OperandValue valueToAddOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-
-        // 3. 변수 찾기 (로컬 우선, 없으면 전역)
-        HUDVariableDisplay *targetVarPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.id == variableIdToFind && hudVar.objectId == objectId)
-            {
-                targetVarPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetVarPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.id == variableIdToFind && hudVar.objectId.empty())
-                {
-                    targetVarPtr = &hudVar;
-                    break;
-                }
-            }
-        }
-
-        if (!targetVarPtr)
-        {
-            engine.EngineStdOut(
-                "change_variable block for " + objectId + ": Variable '" + variableIdToFind + "' not found.", 1,
-                executionThreadId);
-            return;
-        }
-
-        // 4. 연산 수행
-        // 현재 변수 값(문자열)을 숫자로 변환 시도
-        double currentVarNumericValue = 0.0;
-        bool currentVarIsNumeric = false;
-        try
-        {
-            size_t idx = 0;
-            currentVarNumericValue = stod(targetVarPtr->value, &idx);
-            if (idx == targetVarPtr->value.length() && isfinite(currentVarNumericValue))
-            {
-                // 전체 문자열이 파싱되었고 유한한 숫자인지 확인
-                currentVarIsNumeric = true;
-            }
-        }
-        catch (const exception &)
-        {
-            // 파싱 실패 시 currentVarIsNumeric는 false로 유지
-        }
-
-        // 더할 값도 숫자인지 확인
-        // bool valueToAddIsNumeric = (valueToAddOp.type == OperandValue::Type::NUMBER && isfinite(valueToAddOp.asNumber()));
-        // Let's make this more robust:
-        double valueToAddNumVal = 0.0;
-        bool valueToAddIsActuallyNumeric = false;
-        if (valueToAddOp.type == OperandValue::Type::NUMBER)
-        {
-            valueToAddNumVal = valueToAddOp.number_val;
-            valueToAddIsActuallyNumeric = isfinite(valueToAddNumVal);
-        }
-        else if (valueToAddOp.type == OperandValue::Type::STRING)
-        {
-            if (!valueToAddOp.string_val.empty())
-            {
-                // Avoid stod on empty string
-                try
-                {
-                    size_t add_idx = 0;
-                    valueToAddNumVal = stod(valueToAddOp.string_val, &add_idx);
-                    if (add_idx == valueToAddOp.string_val.length() && isfinite(valueToAddNumVal))
-                    {
-                        valueToAddIsActuallyNumeric = true;
-                    }
-                }
-                catch (const exception &)
-                {
-                    // valueToAddIsActuallyNumeric remains false
-                }
-            }
-        }
+        OperandValue valueToAddOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
 
-        if (currentVarIsNumeric && valueToAddIsActuallyNumeric)
-        {
-            // 둘 다 숫자면 덧셈
-            double sumValue = currentVarNumericValue + valueToAddNumVal;
-
-            // EntryJS의 toFixed와 유사한 효과를 내기 위해 to_string 사용 후 후처리
-            string resultStr = to_string(sumValue);
-            resultStr.erase(resultStr.find_last_not_of('0') + 1, string::npos);
-            if (!resultStr.empty() && resultStr.back() == '.')
-            {
-                resultStr.pop_back();
-            }
-            targetVarPtr->value = resultStr;
-            engine.EngineStdOut(
-                "Variable '" + variableIdToFind + "' (numeric) changed by " + valueToAddOp.asString() + " to " +
-                    targetVarPtr->value,
-                3, executionThreadId);
-        }
-        else
-        {
-            // 하나라도 숫자가 아니면 문자열 이어붙이기
-            targetVarPtr->value = targetVarPtr->value + valueToAddOp.asString();
-            engine.EngineStdOut(
-                "Variable '" + variableIdToFind + "' (string) concatenated with " + valueToAddOp.asString() + " to " +
-                    targetVarPtr->value,
-                3, executionThreadId);
-        }
-        if (targetVarPtr->isCloud)
-        {
-            engine.saveCloudVariablesToJson();
-        }
+        changeVariableBy(engine, objectId, variableIdToFind, valueToAddOp, executionThreadId);
     }
-    else if (BlockType == "set_variable")
+    else if (block.opcode == BlockTypeEnum::SET_VARIABLE)
     {
         lock_guard lock(engine.m_engineDataMutex);
         // params: [VARIABLE_ID_STRING, VALUE_TO_ADD_OR_CONCAT, null, null]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "change_variable block for " + objectId +
@@ -4299,7 +3995,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
                 2, executionThreadId);
             return;
         } // 1. 변수 ID 가져오기 (항상 문자열 드롭다운)
-        OperandValue variableIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue variableIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (variableIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -4318,29 +4014,10 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         }
 
         // 2. 설정 할 값 가져오기
-        OperandValue valueToSet = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue valueToSet = getOperandValue(engine, objectId, block.params[1], executionThreadId);
 
         // 3. 변수 찾기 (로컬 우선, 없으면 전역)
-        HUDVariableDisplay *targetVarPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.id == variableIdToFind && hudVar.objectId == objectId)
-            {
-                targetVarPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetVarPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.id == variableIdToFind && hudVar.objectId.empty())
-                {
-                    targetVarPtr = &hudVar;
-                    break;
-                }
-            }
-        }
+        VariableStore::Slot *targetVarPtr = findVariableSlot(engine, objectId, variableIdToFind);
 
         if (!targetVarPtr)
         {
@@ -4350,30 +4027,25 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
 
-        if (valueToSet.type == OperandValue::Type::NUMBER)
-        {
-            // 숫자인 경우, OperandValue::asString()을 통해 포맷팅된 문자열로 변환
-            targetVarPtr->value = valueToSet.asString(); // OperandValue::asString()이 숫자 포맷팅을 담당
-        }
-        else if (valueToSet.type == OperandValue::Type::BOOLEAN)
+        if (valueToSet.type == OperandValue::Type::EMPTY)
         {
-            // 불리언도 asString()을 통해 "true" 또는 "false"로 변환
-            targetVarPtr->value = valueToSet.asString();
+            targetVarPtr->value = OperandValue(""); // 빈 값은 빈 문자열로 저장
         }
         else
         {
-            // STRING 또는 EMPTY 등
-            targetVarPtr->value = valueToSet.asString(); // 기본적으로 문자열로 저장
+            // 숫자/문자열/불리언은 타입 그대로 저장하고, 문자열 표현은 HUD 가 표시할 때 만듭니다.
+            targetVarPtr->value = std::move(valueToSet);
         }
+        engine.noteVariableWrite(variableIdToFind);
 
         if (targetVarPtr->isCloud)
         {
             engine.saveCloudVariablesToJson();
         }
     }
-    else if (BlockType == "show_variable")
+    else if (block.opcode == BlockTypeEnum::SHOW_VARIABLE)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "show_variable block for " + objectId +
@@ -4382,7 +4054,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
 
-        OperandValue variableIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue variableIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (variableIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -4400,31 +4072,15 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
 
-        HUDVariableDisplay *targetVarPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.id == variableIdToFind && hudVar.objectId == objectId)
-            {
-                targetVarPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetVarPtr)
+        VariableStore::Slot *targetVarPtr = findVariableSlot(engine, objectId, variableIdToFind);
+        if (targetVarPtr)
         {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.id == variableIdToFind && hudVar.objectId.empty())
-                {
-                    targetVarPtr = &hudVar;
-                    break;
-                }
-            }
+            engine.getHUDVariables_Editable()[targetVarPtr->hud].isVisible = true;
         }
-        targetVarPtr->isVisible = true;
     }
-    else if (BlockType == "hide_variable")
+    else if (block.opcode == BlockTypeEnum::HIDE_VARIABLE)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "hide_variable block for " + objectId +
@@ -4433,7 +4089,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
 
-        OperandValue variableIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue variableIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (variableIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -4451,34 +4107,18 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
 
-        HUDVariableDisplay *targetVarPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.id == variableIdToFind && hudVar.objectId == objectId)
-            {
-                targetVarPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetVarPtr)
+        VariableStore::Slot *targetVarPtr = findVariableSlot(engine, objectId, variableIdToFind);
+        if (targetVarPtr)
         {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.id == variableIdToFind && hudVar.objectId.empty())
-                {
-                    targetVarPtr = &hudVar;
-                    break;
-                }
-            }
+            engine.getHUDVariables_Editable()[targetVarPtr->hud].isVisible = false;
         }
-        targetVarPtr->isVisible = false;
     }
-    else if (BlockType == "add_value_to_list")
+    else if (block.opcode == BlockTypeEnum::ADD_VALUE_TO_LIST)
     {
         lock_guard lock(engine.m_engineDataMutex);
         // 리스트에 항목을 추가합니다.
         // 파라미터: [LIST_ID_STRING (드롭다운), VALUE_TO_ADD (모든 타입 가능)]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             // LIST_ID와 VALUE, 총 2개의 파라미터 필요
             engine.EngineStdOut(
@@ -4487,8 +4127,8 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
                 2, executionThreadId);
             return;
         } // 1. 리스트 ID 가져오기 (항상 드롭다운 메뉴의 문자열)
-        OperandValue listIdOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        // 실제 리스트 ID는 paramsJson[1]에서 가져옴
+        OperandValue listIdOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        // 실제 리스트 ID는 params[1]에서 가져옴
         if (listIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -4505,12 +4145,10 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
                                 executionThreadId);
             return;
         } // 2. 리스트에 추가할 값 가져오기
-        OperandValue valueOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        // 실제 추가할 값은 paramsJson[0]에서 가져옴
-        string valueToAdd = valueOp.asString(); // 모든 Operand 타입을 문자열로 변환하여 리스트에 저장
-
+        OperandValue valueOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        // 실제 추가할 값은 params[0]에서 가져옴
         // 빈 문자열 체크
-        if (valueToAdd.empty() && valueOp.type == OperandValue::Type::STRING)
+        if (valueOp.type == OperandValue::Type::STRING && valueOp.stringValue().empty())
         {
             engine.EngineStdOut("add_value_to_list block for " + objectId + ": Cannot add empty value to list.", 1,
                                 executionThreadId);
@@ -4518,37 +4156,13 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         }
 
         // 3. 대상 리스트 찾기 (지역 리스트 우선, 없으면 전역 리스트)
-        HUDVariableDisplay *targetListPtr = nullptr;
-
-        // 지역 리스트 검색 (현재 오브젝트에 속한 리스트)
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listIdToFind && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-
-        // 지역 리스트가 없으면 전역 리스트 검색
-        if (!targetListPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listIdToFind && hudVar.objectId.empty())
-                {
-                    // 전역 리스트 조건 확인
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
-        }
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listIdToFind);
 
         // 4. 리스트를 찾았는지 확인 후 값 추가
         if (targetListPtr)
         {
             // 혹시라도 타입이 list가 아닌 경우를 대비한 안전장치 (정상적이라면 발생하지 않음)
-            if (targetListPtr->variableType != "list")
+            if (!targetListPtr->isList)
             {
                 engine.EngineStdOut(
                     "add_value_to_list block for " + objectId + ": Variable '" + listIdToFind +
@@ -4557,12 +4171,13 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
                 return;
             }
 
-            targetListPtr->array.push_back({valueToAdd}); // 새로운 ListItem으로 추가
+            targetListPtr->items.push_back(VariableList::Item::fromValue(valueOp)); // 숫자는 숫자 그대로 추가
+            engine.noteVariableWrite(listIdToFind);
             if (targetListPtr->isCloud)                   // 클라우드 저장 흉내
             {
                 engine.saveCloudVariablesToJson();
             }
-            engine.EngineStdOut("DEBUG: add_value_to_list - block.paramsJson: " + block.paramsJson.dump(), 3,
+            engine.EngineStdOut("DEBUG: add_value_to_list - block.params: " + describeOperands(block.params), 3,
                                 executionThreadId);
         }
         else
@@ -4572,12 +4187,12 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
                 1, executionThreadId);
         }
     }
-    else if (BlockType == "remove_value_from_list")
+    else if (block.opcode == BlockTypeEnum::REMOVE_VALUE_FROM_LIST)
     {
         lock_guard lock(engine.m_engineDataMutex);
         // 리스트에서 특정 인덱스의 항목을 삭제합니다.
         // 파라미터: [LIST_ID_STRING (드롭다운), INDEX_TO_REMOVE (숫자 또는 숫자 반환 블록)]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "remove_value_from_list block for " + objectId +
@@ -4587,7 +4202,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         }
 
         // 1. 리스트 ID 가져오기 (항상 드롭다운 메뉴의 문자열)
-        OperandValue listIdOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue listIdOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         if (listIdOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -4607,7 +4222,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         }
 
         // 2. 삭제할 인덱스 값 가져오기
-        OperandValue indexOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue indexOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (indexOp.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -4630,29 +4245,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         auto index_1_based = static_cast<long long>(index_1_based_double);
 
         // 3. 대상 리스트 찾기 (지역 리스트 우선, 없으면 전역 리스트)
-        HUDVariableDisplay *targetListPtr = nullptr;
-        // 지역 리스트 검색 (현재 오브젝트에 속한 리스트)
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listIdToFind && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-        // 지역 리스트가 없으면 전역 리스트 검색
-        if (!targetListPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listIdToFind && hudVar.objectId.empty())
-                {
-                    // 전역 리스트 조건 확인
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
-        }
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listIdToFind);
 
         if (!targetListPtr)
         {
@@ -4663,7 +4256,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         }
 
         // 혹시라도 타입이 list가 아닌 경우를 대비한 안전장치
-        if (targetListPtr->variableType != "list")
+        if (!targetListPtr->isList)
         {
             engine.EngineStdOut(
                 "remove_value_from_list block for " + objectId + ": Variable '" + listIdToFind +
@@ -4672,7 +4265,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
 
-        vector<ListItem> &listArray = targetListPtr->array;
+        VariableList &listArray = targetListPtr->items;
 
         // 4. 리스트가 비어있는지 확인
         if (listArray.empty())
@@ -4698,8 +4291,9 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
         // 6. 0기반 인덱스로 변환하여 항목 삭제
         size_t index_0_based = static_cast<size_t>(index_1_based - 1);
 
-        string removedItemData = listArray[index_0_based].data; // 로깅을 위해 삭제될 데이터 저장
-        listArray.erase(listArray.begin() + index_0_based);
+        string removedItemData = listArray.stringAt(index_0_based); // 로깅을 위해 삭제될 데이터 저장
+        listArray.erase(index_0_based);
+        engine.noteVariableWrite(listIdToFind);
 
         engine.EngineStdOut(
             "Removed item at index " + to_string(index_1_based) + " (value: '" + removedItemData + "') from list '" +
@@ -4710,18 +4304,18 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             engine.saveCloudVariablesToJson();
         }
     }
-    else if (BlockType == "insert_value_to_list")
+    else if (block.opcode == BlockTypeEnum::INSERT_VALUE_TO_LIST)
     {
         lock_guard lock(engine.m_engineDataMutex);
         // 특정 인덱스에 항목 삽입
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 3)
+        if (block.params.size() < 3)
         {
             engine.EngineStdOut("insert_value_to_list block for " + objectId + ": insufficient parameters", 2);
             return;
         }
-        OperandValue indexOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue listIdToFindOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue valueOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue indexOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue listIdToFindOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue valueOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
 
         // 빈 문자열 체크
         if (valueOp.asString().empty() && valueOp.type == OperandValue::Type::STRING)
@@ -4745,32 +4339,10 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
         auto index_1_based = static_cast<long long>(index_1_based_double);
-        HUDVariableDisplay *targetListPtr = nullptr;
-        // 지역 리스트 검색 (현재 오브젝트에 속한 리스트)
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listIdToFindOp.asString() && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-        // 지역 리스트가 없으면 전역 리스트 검색
-        if (!targetListPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listIdToFindOp.asString() && hudVar.objectId.empty())
-                {
-                    // 전역 리스트 조건 확인
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
-        }
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listIdToFindOp.asString());
 
         // 혹시라도 타입이 list가 아닌 경우를 대비한 안전장치
-        if (targetListPtr->variableType != "list")
+        if (!targetListPtr->isList)
         {
             engine.EngineStdOut(
                 "remove_value_from_list block for " + objectId + ": Variable '" + listIdToFindOp.asString() +
@@ -4778,7 +4350,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
                 2, executionThreadId);
             return;
         }
-        vector<ListItem> &listArray = targetListPtr->array;
+        VariableList &listArray = targetListPtr->items;
         if (index_1_based < 1 || index_1_based > static_cast<long long>(listArray.size()))
         {
             engine.EngineStdOut(
@@ -4789,7 +4361,8 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
         size_t index_0_based = static_cast<size_t>(index_1_based - 1);
-        listArray.insert(listArray.begin() + index_0_based, {valueOp.asString()});
+        listArray.insert(index_0_based, VariableList::Item::fromValue(valueOp));
+        engine.noteVariableWrite(listIdToFindOp.asString());
         if (targetListPtr->isCloud)
         {
             engine.saveCloudVariablesToJson();
@@ -4798,18 +4371,18 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             "Inserted value '" + valueOp.asString() + "' at index " + to_string(index_1_based) + " (value: '" +
             valueOp.asString() + "') to list '");
     }
-    else if (BlockType == "change_value_list_index")
+    else if (block.opcode == BlockTypeEnum::CHANGE_VALUE_LIST_INDEX)
     {
         lock_guard lock(engine.m_engineDataMutex);
         // 특정 인덱스에 항목 변경
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 3)
+        if (block.params.size() < 3)
         {
             engine.EngineStdOut("insert_value_to_list block for " + objectId + ": insufficient parameters", 2);
             return;
         }
-        OperandValue indexOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
-        OperandValue listIdToFindOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue valueOp = getOperandValue(engine, objectId, block.paramsJson[2], executionThreadId);
+        OperandValue indexOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        OperandValue listIdToFindOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue valueOp = getOperandValue(engine, objectId, block.params[2], executionThreadId);
 
         // 빈 문자열 체크
         if (valueOp.asString().empty() && valueOp.type == OperandValue::Type::STRING)
@@ -4832,32 +4405,10 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
         auto index_1_based = static_cast<long long>(index_1_based_double);
-        HUDVariableDisplay *targetListPtr = nullptr;
-        // 지역 리스트 검색 (현재 오브젝트에 속한 리스트)
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listIdToFindOp.asString() && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-        // 지역 리스트가 없으면 전역 리스트 검색
-        if (!targetListPtr)
-        {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listIdToFindOp.asString() && hudVar.objectId.empty())
-                {
-                    // 전역 리스트 조건 확인
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
-        }
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listIdToFindOp.asString());
 
         // 혹시라도 타입이 list가 아닌 경우를 대비한 안전장치
-        if (targetListPtr->variableType != "list")
+        if (!targetListPtr->isList)
         {
             engine.EngineStdOut(
                 "remove_value_from_list block for " + objectId + ": Variable '" + listIdToFindOp.asString() +
@@ -4865,7 +4416,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
                 2, executionThreadId);
             return;
         }
-        vector<ListItem> &listArray = targetListPtr->array;
+        VariableList &listArray = targetListPtr->items;
         if (index_1_based < 1 || index_1_based > static_cast<long long>(listArray.size()))
         {
             engine.EngineStdOut(
@@ -4876,77 +4427,46 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
             return;
         }
         size_t index_0_based = static_cast<size_t>(index_1_based - 1);
-        listArray[index_0_based].data = valueOp.asString();
+        listArray.set(index_0_based, VariableList::Item::fromValue(valueOp));
+        engine.noteVariableWrite(listIdToFindOp.asString());
     }
-    else if (BlockType == "show_list")
+    else if (block.opcode == BlockTypeEnum::SHOW_LIST)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut("insert_value_to_list block for " + objectId + ": insufficient parameters", 2);
             return;
         }
-        OperandValue listIdtofindOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue listIdtofindOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (listIdtofindOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("listId is not a string objId:" + objectId, 2);
             return;
         }
-        HUDVariableDisplay *targetListPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listIdtofindOp.asString() && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetListPtr)
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listIdtofindOp.asString());
+        if (targetListPtr)
         {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listIdtofindOp.asString() && hudVar.objectId.empty())
-                {
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
+            engine.getHUDVariables_Editable()[targetListPtr->hud].isVisible = true;
         }
-        targetListPtr->isVisible = true;
     }
-    else if (BlockType == "hide_list")
+    else if (block.opcode == BlockTypeEnum::HIDE_LIST)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut("insert_value_to_list block for " + objectId + ": insufficient parameters", 2);
             return;
         }
-        OperandValue listIdtofindOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue listIdtofindOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (listIdtofindOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut("listId is not a string objId:" + objectId, 2);
             return;
         }
-        HUDVariableDisplay *targetListPtr = nullptr;
-        for (auto &hudVar : engine.getHUDVariables_Editable())
-        {
-            if (hudVar.variableType == "list" && hudVar.id == listIdtofindOp.asString() && hudVar.objectId == objectId)
-            {
-                targetListPtr = &hudVar;
-                break;
-            }
-        }
-        if (!targetListPtr)
+        VariableStore::Slot *targetListPtr = findListSlot(engine, objectId, listIdtofindOp.asString());
+        if (targetListPtr)
         {
-            for (auto &hudVar : engine.getHUDVariables_Editable())
-            {
-                if (hudVar.variableType == "list" && hudVar.id == listIdtofindOp.asString() && hudVar.objectId.empty())
-                {
-                    targetListPtr = &hudVar;
-                    break;
-                }
-            }
+            engine.getHUDVariables_Editable()[targetListPtr->hud].isVisible = false;
         }
-        targetListPtr->isVisible = false;
     }
 }
 
@@ -4954,7 +4474,7 @@ void Variable(string BlockType, Engine &engine, const string &objectId, const Bl
  * @brief 흐름 블록
  *
  */
-void Flow(string BlockType, Engine &engine, const string &objectId, const Block &block,
+void Flow(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
           const string &executionThreadId, const string &sceneIdAtDispatch, float deltaTime)
 {
     auto entity = engine.getEntityByIdShared(objectId);
@@ -4963,18 +4483,18 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         engine.EngineStdOut("Flow 'wait_second': Entity " + objectId + " not found.", 2, executionThreadId);
         return;
     }
-    if (BlockType == "wait_second")
+    if (block.opcode == BlockTypeEnum::WAIT_SECOND)
     {
         // Flow 함수는 Entity의 setScriptWait를 호출하여 대기 상태 설정을 요청합니다.
         // 실제 대기는 메인 루프에서 비동기적으로 처리됩니다.
-        if (!block.paramsJson.is_array() || block.paramsJson.empty() || block.paramsJson[0].is_null())
+        if (block.params.empty() || block.params[0].isNull())
         {
             engine.EngineStdOut("Flow 'wait_second' for " + objectId + ": Missing or invalid time parameter.", 2,
                                 executionThreadId);
             return;
         }
 
-        OperandValue secondsOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue secondsOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (secondsOp.type != OperandValue::Type::NUMBER)
         {
             engine.EngineStdOut(
@@ -4994,11 +4514,11 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         // 재개를 위한 스크립트 컨텍스트를 가져옵니다.
         const Script *currentScriptPtr = nullptr;
         {
-            lock_guard<recursive_mutex> lock(entity->getStateMutex());
-            auto it = entity->scriptThreadStates.find(executionThreadId);
-            if (it != entity->scriptThreadStates.end())
+            lock_guard lock(entity->getStateMutex());
+            auto *pState = entity->scriptThreadStates.find(executionThreadId);
+            if (pState)
             {
-                currentScriptPtr = it->second.scriptPtrForResume;
+                currentScriptPtr = pState->scriptPtrForResume;
             }
         }
 
@@ -5023,9 +4543,9 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                 to_string(secondsToWait) + "s. Script will pause.",
             3, executionThreadId);
         // Entity::executeScript가 EXPLICIT_WAIT_SECOND 타입을 보고 스크립트 실행을 일시 중지합니다.
-        // 이후 Entity::resumeExplicitWaitScripts가 시간이 되면 스크립트를 재개합니다.
+        // 이후 Engine::processScriptWakeups 가 시간이 되면 Entity::resumeExplicitWait 로 스크립트를 재개합니다.
     }
-    else if (BlockType == "repeat_basic")
+    else if (block.opcode == BlockTypeEnum::REPEAT_BASIC)
     {
         // Entity 유효성 검사
         if (!entity)
@@ -5035,12 +4555,12 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         }
 
         // 반복 횟수 파라미터 가져오기
-        if (!block.paramsJson.is_array() || block.paramsJson.empty() || block.paramsJson[0].is_null())
+        if (block.params.empty() || block.params[0].isNull())
         {
             throw ScriptBlockExecutionError("반복 횟수 파라미터가 부족하거나 유효하지 않습니다.", block.id, BlockType, objectId,
                                             "Missing or invalid iteration count parameter.");
         }
-        OperandValue iterOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue iterOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         int iterCount = static_cast<int>(floor(iterOp.asNumber()));
 
         if (iterCount <= 0)
@@ -5058,11 +4578,11 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         // 스레드 상태 가져오기
         Entity::ScriptThreadState *pThreadState = nullptr;
         {
-            lock_guard<recursive_mutex> lock(entity->getStateMutex());
-            auto it = entity->scriptThreadStates.find(executionThreadId);
-            if (it != entity->scriptThreadStates.end())
+            lock_guard lock(entity->getStateMutex());
+            auto *pState = entity->scriptThreadStates.find(executionThreadId);
+            if (pState)
             {
-                pThreadState = &it->second;
+                pThreadState = pState;
             }
         }
         if (!pThreadState)
@@ -5071,19 +4591,20 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                                 2, executionThreadId);
             return;
         }
+        const int loopSlot = pThreadState->treeLoopSlot(block); // 함수 본문이면 호출 프레임 기준 슬롯
 
         // 현재 반복 횟수 가져오기 또는 초기화
-        int currentIteration = 0;
-        if (pThreadState->loopCounters.count(block.id))
+        int currentIteration = pThreadState->loopCounters.get(loopSlot);
+        if (currentIteration == Entity::LoopSlots::kUnused)
         {
-            currentIteration = pThreadState->loopCounters[block.id];
+            currentIteration = 0;
         }
 
         // --- 루프 실행 또는 종료 ---
         if (currentIteration < iterCount)
         {
             // 아직 반복이 남았음
-            pThreadState->loopCounters[block.id] = currentIteration; // 현재 반복 횟수 저장
+            pThreadState->loopCounters.set(loopSlot, currentIteration); // 현재 반복 횟수 저장
 
             engine.EngineStdOut(
                 "repeat_basic: " + objectId + " executing iteration " + to_string(currentIteration) + "/" +
@@ -5108,7 +4629,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             if (pThreadState->breakLoopRequested)
             {
                 pThreadState->breakLoopRequested = false;
-                pThreadState->loopCounters.erase(block.id); // 루프 중단 시 즉시 상태 정리
+                pThreadState->loopCounters.release(loopSlot); // 루프 중단 시 즉시 상태 정리
                 engine.EngineStdOut(
                     "repeat_basic: " + objectId + " breaking loop due to stop_repeat. Block ID: " + block.id, 0,
                     executionThreadId);
@@ -5124,7 +4645,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             }
 
             // --- 다음 반복 준비 ---
-            pThreadState->loopCounters[block.id] = currentIteration + 1;
+            pThreadState->loopCounters.set(loopSlot, currentIteration + 1);
 
             Uint32 frameDelay = static_cast<Uint32>(clamp(1000.0 / engine.getTargetFps(),
                                                           static_cast<double>(MIN_LOOP_WAIT_MS), 33.0));
@@ -5135,11 +4656,11 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             // Entity의 ScriptThreadState에서 가져와야 합니다.
             const Script *currentScriptPtr = nullptr;
             {
-                lock_guard<recursive_mutex> lock(entity->getStateMutex());
-                auto it = entity->scriptThreadStates.find(executionThreadId);
-                if (it != entity->scriptThreadStates.end())
+                lock_guard lock(entity->getStateMutex());
+                auto *pState = entity->scriptThreadStates.find(executionThreadId);
+                if (pState)
                 {
-                    currentScriptPtr = it->second.scriptPtrForResume; // executeScript에서 설정한 포인터 사용
+                    currentScriptPtr = pState->scriptPtrForResume; // executeScript에서 설정한 포인터 사용
                 }
             }
             if (currentScriptPtr)
@@ -5153,23 +4674,29 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             }
             return; // 대기 설정을 위해 즉시 반환
         }
-        pThreadState->loopCounters.erase(block.id);
+        pThreadState->loopCounters.release(loopSlot);
         engine.EngineStdOut(
             "repeat_basic: " + objectId + " loop finished all iterations and state cleared. Block ID: " + block.id,
             3, executionThreadId);
     }
-    else if (BlockType == "repeat_inf")
+    else if (block.opcode == BlockTypeEnum::REPEAT_INF)
     {
         if (block.statementScripts.empty() || block.statementScripts[0].blocks.empty())
         {
+            const Entity::ScriptThreadState *pState = entity->scriptThreadStates.find(executionThreadId);
             entity->setScriptWait(executionThreadId, 0, block.id, Entity::WaitType::BLOCK_INTERNAL,
-                                  entity->scriptThreadStates[executionThreadId].scriptPtrForResume,
+                                  pState ? pState->scriptPtrForResume : nullptr,
                                   sceneIdAtDispatch);
             return;
         }
 
         const auto &innerBlocks = block.statementScripts[0].blocks;
-        auto &threadState = entity->scriptThreadStates[executionThreadId];
+        Entity::ScriptThreadState *pThreadState = entity->scriptThreadStates.find(executionThreadId);
+        if (!pThreadState)
+        {
+            return;
+        }
+        auto &threadState = *pThreadState;
 
         size_t &innerBlockIndex = threadState.loopBlockIndices[block.id];
         if (innerBlockIndex >= innerBlocks.size())
@@ -5181,15 +4708,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
 
         try
         {
-            Moving(innerBlock.type, engine, objectId, innerBlock, executionThreadId, sceneIdAtDispatch, deltaTime);
-            Calculator(innerBlock.type, engine, objectId, innerBlock, executionThreadId);
-            Looks(innerBlock.type, engine, objectId, innerBlock, executionThreadId);
-            Sound(innerBlock.type, engine, objectId, innerBlock, executionThreadId);
-            Variable(innerBlock.type, engine, objectId, innerBlock, executionThreadId);
-            Function(innerBlock.type, engine, objectId, innerBlock, executionThreadId);
-            TextBox(innerBlock.type, engine, objectId, innerBlock, executionThreadId);
-            Event(innerBlock.type, engine, objectId, innerBlock, executionThreadId);
-            Flow(innerBlock.type, engine, objectId, innerBlock, executionThreadId, sceneIdAtDispatch, deltaTime);
+            executeBlock(engine, objectId, innerBlock, executionThreadId, sceneIdAtDispatch, deltaTime);
         }
         catch (...)
         {
@@ -5237,13 +4756,13 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                               threadState.scriptPtrForResume,
                               sceneIdAtDispatch);
     }
-    else if (BlockType == "repeat_while_true")
+    else if (block.opcode == BlockTypeEnum::REPEAT_WHILE_TRUE)
     {
         // params: [CONDITION_BLOCK, OPTION_DROPDOWN, INDICATOR]
         // statements: [DO_SCRIPT]
 
         // 파라미터 및 스레드 상태 유효성 검사
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             string msg = "Flow 'repeat_while_true' for " + objectId +
                          ": Missing parameters. Expected CONDITION and OPTION. Block ID: " + block.id;
@@ -5257,11 +4776,11 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
 
         Entity::ScriptThreadState *pThreadState = nullptr;
         {
-            lock_guard<recursive_mutex> lock(entity->getStateMutex());
-            auto it = entity->scriptThreadStates.find(executionThreadId);
-            if (it != entity->scriptThreadStates.end())
+            lock_guard lock(entity->getStateMutex());
+            auto *pState = entity->scriptThreadStates.find(executionThreadId);
+            if (pState)
             {
-                pThreadState = &it->second;
+                pThreadState = pState;
             }
         }
         if (!pThreadState)
@@ -5271,14 +4790,15 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
             return;
         }
+        const int loopSlot = pThreadState->treeLoopSlot(block); // 함수 본문이면 호출 프레임 기준 슬롯
 
         // --- 조건 평가 ---
-        OperandValue optionOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue optionOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
         string loopMode = (optionOp.type == OperandValue::Type::STRING && !optionOp.asString().empty())
                               ? optionOp.asString()
                               : "until";
 
-        OperandValue conditionResult = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue conditionResult = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         bool loopExecutionCondition = (loopMode == "until") ? !conditionResult.asBool() : conditionResult.asBool();
 
         // --- 루프 실행 또는 종료 ---
@@ -5286,18 +4806,17 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         {
             // 루프를 실행해야 하는 조건
 
-            // 이 루프의 내부 실행 위치(PC)를 저장하기 위한 고유 키
-            string inner_pc_key = block.id + "_inner_pc";
-
+            // 이 루프의 내부 실행 위치(PC)는 로드 시 지정된 슬롯에 저장합니다.
             // 현재 내부 블록 인덱스를 가져오거나, 첫 실행 시 0으로 초기화
             size_t currentInnerBlockIndex = 0;
-            if (pThreadState->loopCounters.count(inner_pc_key))
+            int storedInnerIndex = pThreadState->loopCounters.get(loopSlot);
+            if (storedInnerIndex != Entity::LoopSlots::kUnused)
             {
-                currentInnerBlockIndex = pThreadState->loopCounters[inner_pc_key];
+                currentInnerBlockIndex = static_cast<size_t>(storedInnerIndex);
             }
             else
             {
-                pThreadState->loopCounters[inner_pc_key] = 0;
+                pThreadState->loopCounters.set(loopSlot, 0);
             }
 
             const Script &doScript = block.statementScripts[0];
@@ -5310,12 +4829,12 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             bool innerBlockIsWaiting = false;
             size_t resumeIndexFromInnerExec = 0;
             {
-                lock_guard<recursive_mutex> lock(entity->getStateMutex());
+                lock_guard lock(entity->getStateMutex());
                 // pThreadState 포인터가 유효한지 다시 확인 (재할당될 수 있으므로)
-                auto it_state_after_exec = entity->scriptThreadStates.find(executionThreadId);
-                if (it_state_after_exec != entity->scriptThreadStates.end())
+                auto *pStateAfterExec = entity->scriptThreadStates.find(executionThreadId);
+                if (pStateAfterExec)
                 {
-                    Entity::ScriptThreadState &currentState = it_state_after_exec->second;
+                    Entity::ScriptThreadState &currentState = *pStateAfterExec;
                     if (currentState.isWaiting)
                     {
                         innerBlockIsWaiting = true;
@@ -5328,7 +4847,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             {
                 // 내부 블록이 대기 상태를 설정함
                 // 다음 재개 시, 중단된 내부 블록부터 시작하도록 PC 업데이트
-                pThreadState->loopCounters[inner_pc_key] = resumeIndexFromInnerExec;
+                pThreadState->loopCounters.set(loopSlot, static_cast<int>(resumeIndexFromInnerExec));
                 engine.EngineStdOut(
                     "Flow 'repeat_while_true' for " + objectId + ": Inner block set wait. Storing resume index " +
                         to_string(resumeIndexFromInnerExec) + ".",
@@ -5338,7 +4857,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             {
                 // 내부 스크립트가 대기 없이 모두 완료됨
                 // 다음 반복을 위해 내부 PC를 0으로 리셋
-                pThreadState->loopCounters[inner_pc_key] = 0;
+                pThreadState->loopCounters.set(loopSlot, 0);
                 engine.EngineStdOut(
                     "Flow 'repeat_while_true' for " + objectId + ": Inner blocks completed. Resetting inner PC to 0.",
                     3, executionThreadId);
@@ -5359,24 +4878,23 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                 executionThreadId);
 
             // 루프가 종료되었으므로, 저장했던 내부 PC 상태를 정리
-            string inner_pc_key = block.id + "_inner_pc";
-            pThreadState->loopCounters.erase(inner_pc_key);
+            pThreadState->loopCounters.release(loopSlot);
 
             // 대기를 설정하지 않고 return하여 executeScript의 while 루프가 다음 블록으로 넘어가도록 함
         }
     }
-    else if (BlockType == "stop_repeat")
+    else if (block.opcode == BlockTypeEnum::STOP_REPEAT)
     {
         // This block signals that the current innermost loop should terminate.
         Entity::ScriptThreadState *pThreadState = nullptr;
         if (entity)
         {
             // entity pointer 유효성 검사
-            lock_guard<recursive_mutex> lock(entity->getStateMutex());
-            auto it = entity->scriptThreadStates.find(executionThreadId);
-            if (it != entity->scriptThreadStates.end())
+            lock_guard lock(entity->getStateMutex());
+            auto *pState = entity->scriptThreadStates.find(executionThreadId);
+            if (pState)
             {
-                pThreadState = &it->second;
+                pThreadState = pState;
             }
         }
 
@@ -5399,17 +4917,17 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         // If this block is executed, and it's not inside a loop that checks the flag,
         // the flag will be set but have no immediate effect, which is acceptable.
     }
-    else if (BlockType == "continue_repeat")
+    else if (block.opcode == BlockTypeEnum::CONTINUE_REPEAT)
     {
         Entity::ScriptThreadState *pThreadState = nullptr;
         if (entity)
         {
             // entity 포인터 유효성 검사
-            lock_guard<recursive_mutex> lock(entity->getStateMutex());
-            auto it = entity->scriptThreadStates.find(executionThreadId);
-            if (it != entity->scriptThreadStates.end())
+            lock_guard lock(entity->getStateMutex());
+            auto *pState = entity->scriptThreadStates.find(executionThreadId);
+            if (pState)
             {
-                pThreadState = &it->second;
+                pThreadState = pState;
             }
         }
 
@@ -5430,15 +4948,15 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         }
         // 이 블록은 대기를 설정하지 않습니다. 플래그는 루프 구문에서 확인합니다.
     }
-    else if (BlockType == "_if")
+    else if (block.opcode == BlockTypeEnum::_IF)
     {
         engine.EngineStdOut(
             format("Flow (_if): Evaluating _if block (ID: {}) for object '{}'. Condition param JSON: {}",
                    block.id, objectId,
-                   block.paramsJson.is_array() && !block.paramsJson.empty() ? block.paramsJson[0].dump() : "N/A"),
+                   !block.params.empty() ? block.params[0].describe() : "N/A"),
             3, executionThreadId);
 
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "Flow '_if' for " + objectId + ": Missing condition parameter (BOOL). Block ID: " + block.id, 2,
@@ -5447,14 +4965,14 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                                             "Missing condition parameter.");
         }
 
-        OperandValue conditionResult = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue conditionResult = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         bool conditionIsTrue = conditionResult.asBool();
 
         engine.EngineStdOut(format(
                                 "Flow (_if) for object '{}', block ID '{}': Condition evaluated to {}. (OperandValue type: {}, string: \"{}\", number: {}, bool: {})",
                                 objectId, block.id, (conditionIsTrue ? "TRUE" : "FALSE"),
-                                static_cast<int>(conditionResult.type), conditionResult.string_val,
-                                conditionResult.number_val, conditionResult.boolean_val),
+                                static_cast<int>(conditionResult.type), conditionResult.stringValue(),
+                                conditionResult.numberValue(), conditionResult.booleanValue()),
                             3, executionThreadId);
 
         if (conditionIsTrue)
@@ -5512,15 +5030,15 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         // 별도의 프레임 동기화 대기는 일반적으로 _if 블록 자체에는 필요하지 않습니다.
         // engine.EngineStdOut("Flow '_if' (" + block.id + ") for " + objectId + " completed.", 3, executionThreadId);
     }
-    else if (BlockType == "if_else")
+    else if (block.opcode == BlockTypeEnum::IF_ELSE)
     {
         engine.EngineStdOut(
             format("Flow (if_else): Evaluating if_else block (ID: {}) for object '{}'. Condition param JSON: {}",
                    block.id, objectId,
-                   block.paramsJson.is_array() && !block.paramsJson.empty() ? block.paramsJson[0].dump() : "N/A"),
+                   !block.params.empty() ? block.params[0].describe() : "N/A"),
             3, executionThreadId);
 
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "Flow 'if_else' for " + objectId + ": Missing condition parameter (BOOL). Block ID: " + block.id, 2,
@@ -5529,14 +5047,14 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                                             "Missing condition parameter.");
         }
 
-        OperandValue conditionResult = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue conditionResult = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         bool conditionIsTrue = conditionResult.asBool();
 
         engine.EngineStdOut(format(
                                 "Flow 'if_else' for object '{}', block ID '{}': Condition evaluated to {}. (OperandValue type: {}, string: \"{}\", number: {}, bool: {})",
                                 objectId, block.id, (conditionIsTrue ? "TRUE" : "FALSE"),
-                                static_cast<int>(conditionResult.type), conditionResult.string_val,
-                                conditionResult.number_val, conditionResult.boolean_val),
+                                static_cast<int>(conditionResult.type), conditionResult.stringValue(),
+                                conditionResult.numberValue(), conditionResult.booleanValue()),
                             3, executionThreadId);
 
         const Script *scriptToExecute = nullptr;
@@ -5610,9 +5128,9 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         // if_else 블록은 완료된 것으로 간주하고 다음 블록으로 진행합니다.
         // engine.EngineStdOut("Flow 'if_else' (" + block.id + ") for " + objectId + " completed.", 3, executionThreadId);
     }
-    else if (BlockType == "wait_until_true")
+    else if (block.opcode == BlockTypeEnum::WAIT_UNTIL_TRUE)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "Flow 'wait_until_true' for " + objectId + ": Missing condition parameter (BOOL). Block ID: " +
@@ -5621,7 +5139,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             throw ScriptBlockExecutionError("조건 파라미터가 누락되었습니다.", block.id, BlockType, objectId,
                                             "Missing condition parameter.");
         }
-        OperandValue conditionResult = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue conditionResult = getOperandValue(engine, objectId, block.params[0], executionThreadId);
 
         if (!conditionResult.asBool())
         {
@@ -5635,11 +5153,11 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             // <<<--- scriptPtr와 sceneIdAtDispatch 전달 --- >>>
             const Script *currentScriptPtr = nullptr;
             {
-                lock_guard<recursive_mutex> lock(entity->getStateMutex());
-                auto it = entity->scriptThreadStates.find(executionThreadId);
-                if (it != entity->scriptThreadStates.end())
+                lock_guard lock(entity->getStateMutex());
+                auto *pState = entity->scriptThreadStates.find(executionThreadId);
+                if (pState)
                 {
-                    currentScriptPtr = it->second.scriptPtrForResume;
+                    currentScriptPtr = pState->scriptPtrForResume;
                 }
             }
             if (currentScriptPtr)
@@ -5653,11 +5171,11 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             }
         }
     }
-    else if (BlockType == "stop_object")
+    else if (block.opcode == BlockTypeEnum::STOP_OBJECT)
     {
         // params: [TARGET_DROPDOWN (string), Indicator]
         // paramsKeyMap: { TARGET: 0 }
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             // Check for array and emptiness first
             engine.EngineStdOut(
@@ -5666,7 +5184,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             throw ScriptBlockExecutionError("TARGET 파라미터가 누락되었거나 유효하지 않습니다.", block.id, BlockType, objectId,
                                             "Missing or invalid TARGET parameter.");
         }
-        OperandValue targetOptionOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue targetOptionOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (targetOptionOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -5686,7 +5204,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         // The Entity::executeScript loop will check this flag after this Flow function returns and handle the actual termination of the thread(s).
         // No explicit "return this.die()" equivalent is needed here in Flow; the flag mechanism handles it.
     }
-    else if (BlockType == "restart_project")
+    else if (block.opcode == BlockTypeEnum::RESTART_PROJECT)
     {
         engine.EngineStdOut("Flow 'restart_project': Requesting project restart for " + objectId, 0,
                             executionThreadId);
@@ -5694,11 +5212,11 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         // The Entity::executeScript loop will check this flag after this Flow function returns and handle the actual termination of the thread(s).
         // No explicit "return this.die()" equivalent is needed here in Flow; the flag mechanism handles it.
     }
-    else if (BlockType == "create_clone")
+    else if (block.opcode == BlockTypeEnum::CREATE_CLONE)
     {
         // params: [VALUE (DropdownDynamic with menuName 'clone'), Indicator]
         // VALUE will be the ID of the object to clone, or "self"
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "Flow 'create_clone' for " + objectId + ": Missing target parameter. Block ID: " + block.id, 2,
@@ -5707,7 +5225,7 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                                             "Missing target parameter.");
         }
 
-        OperandValue targetOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue targetOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (targetOp.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
@@ -5797,10 +5315,18 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
                 block.id,
             3, executionThreadId);
 
-        // engine.createCloneOfEntity 호출 시 baseObjectIdForCloning 사용
-        engine.createCloneOfEntity(baseObjectIdForCloning, sceneIdAtDispatch);
+        // 복제본은 커밋 단계에서 만들어지므로 지금의 원본 상태를 함께 기록합니다.
+        Engine::EngineCommand command;
+        command.type = Engine::EngineCommand::Type::CREATE_CLONE;
+        command.targetId = baseObjectIdForCloning;
+        command.sceneIdForScripts = sceneIdAtDispatch;
+        if (auto original = engine.getEntityByIdShared(baseObjectIdForCloning))
+        {
+            command.cloneState = original->captureState();
+        }
+        engine.submitCommand(move(command));
     }
-    else if (BlockType == "delete_clone")
+    else if (block.opcode == BlockTypeEnum::DELETE_CLONE)
     {
         // 이 블록은 자신(복제본)을 삭제합니다. 파라미터는 보통 없습니다.
         auto entity = engine.getEntityByIdShared(objectId); // objectId는 이 스크립트를 실행하는 엔티티의 ID입니다.
@@ -5826,12 +5352,16 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
         engine.EngineStdOut(
             "Flow 'delete_clone': Clone " + objectId + " is requesting self-deletion. Block ID: " + block.id, 0,
             executionThreadId);
-        // Engine의 deleteEntity 메소드는 해당 엔티티의 스크립트 종료 처리도 담당해야 합니다.
+        // 스크립트는 지금 종료 표시하고, 컬렉션에서의 제거는 커밋 단계에서 합니다.
         // 이 블록이 실행된 후, 현재 스크립트 스레드는 Entity::executeScript 루프 내에서 종료 플래그를 확인하고 중단됩니다.
-        engine.deleteEntity(objectId);
+        entity->terminateAllScriptThread("");
+        Engine::EngineCommand command;
+        command.type = Engine::EngineCommand::Type::DELETE_ENTITY;
+        command.targetId = objectId;
+        engine.submitCommand(move(command));
         // 이 블록 이후에 오는 블록은 실행되지 않아야 합니다 (해당 스크립트 스레드가 종료되므로).
     }
-    else if (BlockType == "remove_all_clones")
+    else if (block.opcode == BlockTypeEnum::REMOVE_ALL_CLONES)
     {
         // 이 블록은 현재 오브젝트(objectId)가 생성한 모든 복제본을 삭제합니다.
         // 파라미터는 보통 없습니다 (인디케이터만 있을 수 있음).
@@ -5839,12 +5369,15 @@ void Flow(string BlockType, Engine &engine, const string &objectId, const Block
             "Flow 'remove_all_clones': Object " + objectId + " is requesting deletion of all its clones. Block ID: " +
                 block.id,
             0, executionThreadId);
-        engine.deleteAllClonesOf(objectId);
+        Engine::EngineCommand command;
+        command.type = Engine::EngineCommand::Type::DELETE_ALL_CLONES;
+        command.targetId = objectId;
+        engine.submitCommand(move(command));
         // 이 블록은 실행 흐름을 중단시키지 않고, 다음 블록으로 계속 진행됩니다.
     }
 }
 
-void TextBox(string BlockType, Engine &engine, const string &objectId, const Block &block,
+void TextBox(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
              const string &executionThreadId)
 {
     auto entity = engine.getEntityByIdShared(objectId);
@@ -5862,11 +5395,11 @@ void TextBox(string BlockType, Engine &engine, const string &objectId, const Blo
         return;
     }
 
-    if (BlockType == "text_write")
+    if (block.opcode == BlockTypeEnum::TEXT_WRITE)
     {
         // paramsKeyMap: { VALUE: 0 }
         // 파라미터는 쓰여질 텍스트 값입니다.
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "text_write block for " + objectId + " has invalid or missing params. Expected text VALUE.",
@@ -5874,43 +5407,43 @@ void TextBox(string BlockType, Engine &engine, const string &objectId, const Blo
             return;
         }
 
-        OperandValue textValueOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue textValueOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         string textToWrite = textValueOp.asString(); // 모든 타입을 문자열로 변환
 
         entity->setText(textToWrite); // 새로 추가된 Entity::setText 메소드 호출
         engine.EngineStdOut("TextBox " + objectId + " executed text_write with: \"" + textToWrite + "\"", 3,
                             executionThreadId);
     }
-    else if (BlockType == "text_append")
+    else if (block.opcode == BlockTypeEnum::TEXT_APPEND)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "text_append block for " + objectId + " has invalid or missing params. Expected text VALUE.",
                 2, executionThreadId);
             return;
         }
-        OperandValue textValue = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue textValue = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         string textToAppend = textValue.asString(); // 모든 타입을 문자열로 변환
         entity->appendText(textToAppend);
     }
-    else if (BlockType == "text_prepend")
+    else if (block.opcode == BlockTypeEnum::TEXT_PREPEND)
     {
-        if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "text_append block for " + objectId + " has invalid or missing params. Expected text VALUE.",
                 2, executionThreadId);
             return;
         }
-        OperandValue textValue = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue textValue = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         string textToAppend = textValue.asString(); // 모든 타입을 문자열로 변환
         entity->prependText(textToAppend);
     }
-    else if (BlockType == "text_change_font_color")
+    else if (block.opcode == BlockTypeEnum::TEXT_SET_FONT_COLOR)
     {
         // params: [TARGET_TEXTBOX_ID_STRING, COLOR_HEX_STRING]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "text_set_font_color block for " + objectId + " has insufficient parameters. Expected COLOR_HEX.",
@@ -5919,7 +5452,7 @@ void TextBox(string BlockType, Engine &engine, const string &objectId, const Blo
             return;
         }
 
-        OperandValue colorHexOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue colorHexOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
 
         if (colorHexOp.type != OperandValue::Type::STRING)
         {
@@ -5955,10 +5488,10 @@ void TextBox(string BlockType, Engine &engine, const string &objectId, const Blo
                 executionThreadId);
         }
     }
-    else if (BlockType == "text_change_bg_color")
+    else if (block.opcode == BlockTypeEnum::TEXT_SET_BG_COLOR)
     {
         // params: [TARGET_TEXTBOX_ID_STRING, COLOR_HEX_STRING]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1) // JavaScript 코드에서는 파라미터가 하나 (색상 값)
+        if (block.params.size() < 1) // JavaScript 코드에서는 파라미터가 하나 (색상 값)
         {
             engine.EngineStdOut(
                 "text_change_bg_color block for " + objectId + " has insufficient parameters. Expected COLOR_HEX.",
@@ -5967,7 +5500,7 @@ void TextBox(string BlockType, Engine &engine, const string &objectId, const Blo
             return;
         }
 
-        OperandValue colorHexOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue colorHexOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         // 색상 값은 첫 번째 파라미터
 
         if (colorHexOp.type != OperandValue::Type::STRING)
@@ -6013,18 +5546,18 @@ void TextBox(string BlockType, Engine &engine, const string &objectId, const Blo
                 executionThreadId);
         }
     }
-    else if (BlockType == "text_change_effect")
+    else if (block.opcode == BlockTypeEnum::TEXT_CHANGE_EFFECT)
     {
         // params: [EFFECT_DROPDOWN, MODE_DROPDOWN]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 2)
+        if (block.params.size() < 2)
         {
             engine.EngineStdOut(
                 "text_change_effect for " + objectId + " has insufficient params. Expected EFFECT and MODE.", 2,
                 executionThreadId);
             return;
         }
-        OperandValue effectOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
-        OperandValue modeOp = getOperandValue(engine, objectId, block.paramsJson[1], executionThreadId);
+        OperandValue effectOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
+        OperandValue modeOp = getOperandValue(engine, objectId, block.params[1], executionThreadId);
 
         if (effectOp.type != OperandValue::Type::STRING || modeOp.type != OperandValue::Type::STRING)
         {
@@ -6045,22 +5578,54 @@ void TextBox(string BlockType, Engine &engine, const string &objectId, const Blo
  * @brief 함수 블록
  *
  */
-void Function(string BlockType, Engine &engine, const string &objectId, const Block &block,
+void Function(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
               const string &executionThreadId)
 {
+    if (block.opcode == BlockTypeEnum::FUNCTION_CALL)
+    {
+        // 컴파일된 스크립트의 호출은 VM 의 CALL 명령이 처리합니다.
+        // 여기로 오는 호출(트리 인터프리터로 실행되는 블록 안의 호출)은 끝까지 실행한 뒤 돌아갑니다.
+        auto entity = engine.getEntityByIdShared(objectId);
+        if (!entity)
+        {
+            engine.EngineStdOut(format("Function call {} failed: Entity {} not found.", BlockType, objectId), 2,
+                                executionThreadId);
+            return;
+        }
+        entity->callUserFunction(block, executionThreadId);
+    }
+    else if (block.opcode == BlockTypeEnum::SET_FUNC_VARIABLE || block.opcode == BlockTypeEnum::CHANGE_FUNC_VARIABLE)
+    {
+        // 컴파일된 함수 본문에서는 SET_LOCAL/CHANGE_LOCAL 이 처리하고, 여기는 트리 인터프리터로 실행되는 경우입니다.
+        // params: [VARIABLE_ID_STRING, VALUE]
+        if (block.params.size() < 2 || !block.params[0].isString())
+        {
+            engine.EngineStdOut(format("{} block for {} has invalid parameters. Expected VARIABLE_ID and VALUE.",
+                                       BlockType, objectId),
+                                2, executionThreadId);
+            return;
+        }
+        const FunctionArgsView &args = currentFunctionArgs();
+        const int slot = args.function ? args.function->localVariableSlot(block.params[0].value.stringValue()) : -1;
+        OperandValue value = getOperandValue(engine, objectId, block.params[1], executionThreadId);
+        if (block.opcode == BlockTypeEnum::SET_FUNC_VARIABLE)
+            setFunctionVariable(engine, objectId, slot, std::move(value), executionThreadId);
+        else
+            changeFunctionVariableBy(engine, objectId, slot, value, executionThreadId);
+    }
 }
 
 /**
  * @brief 이벤트 (기타 제어) 블록
  *
  */
-void Event(string BlockType, Engine &engine, const string &objectId, const Block &block,
+void Event(const string &BlockType, Engine &engine, const string &objectId, const Block &block,
            const string &executionThreadId)
 {
-    if (BlockType == "message_cast")
+    if (block.opcode == BlockTypeEnum::MESSAGE_CAST_ACTION)
     {
         // params: [MESSAGE_ID_INPUT_OR_BLOCK, null, null]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "message_cast block for object " + objectId + " has insufficient parameters. Expected message ID.",
@@ -6070,7 +5635,7 @@ void Event(string BlockType, Engine &engine, const string &objectId, const Block
                                             "Insufficient parameters for message_cast.");
         }
 
-        OperandValue messageIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue messageIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         // messageIdOp.asString() will handle conversion if messageIdOp is a number or boolean.
         string messageId = messageIdOp.asString();
         engine.EngineStdOut(
@@ -6094,10 +5659,10 @@ void Event(string BlockType, Engine &engine, const string &objectId, const Block
         engine.raiseMessage(messageId, objectId, executionThreadId);
         // Pass sender info (objectId and current threadId)
     }
-    else if (BlockType == "start_scene")
+    else if (block.opcode == BlockTypeEnum::START_SCENE)
     {
         // params: [scene_id_string, null, null]
-        if (!block.paramsJson.is_array() || block.paramsJson.size() < 1)
+        if (block.params.size() < 1)
         {
             engine.EngineStdOut(
                 "start_scene block for object " + objectId + " has invalid or missing scene ID parameter.", 2,
@@ -6106,7 +5671,7 @@ void Event(string BlockType, Engine &engine, const string &objectId, const Block
                 "장면 ID 파라미터가 유효하지 않습니다.",
                 block.id, BlockType, objectId, "Invalid or missing scene ID parameter.");
         }
-        OperandValue sceneIdOp = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue sceneIdOp = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (sceneIdOp.type != OperandValue::Type::STRING || sceneIdOp.asString().empty() || sceneIdOp.asString() == "null")
         {
             string errMsg = "장면 ID가 유효한 문자열이 아니거나 비어있거나 null입니다. 장면을 전환할 수 없습니다. 값: " + sceneIdOp.asString();
@@ -6118,53 +5683,95 @@ void Event(string BlockType, Engine &engine, const string &objectId, const Block
         string sceneId = sceneIdOp.asString();
         engine.EngineStdOut("Object " + objectId + " is requesting to start scene: '" + sceneId + "'", 3,
                             executionThreadId);
-        engine.goToScene(sceneId); // goToScene 내부에서 scene 존재 여부 확인 및 when_scene_start 이벤트 트리거
+        // goToScene 내부에서 scene 존재 여부 확인 및 when_scene_start 이벤트 트리거 (커밋 단계)
+        Engine::EngineCommand command;
+        command.type = Engine::EngineCommand::Type::START_SCENE;
+        command.targetId = sceneId;
+        engine.submitCommand(move(command));
     }
-    else if (BlockType == "start_neighbor_scene")
+    else if (block.opcode == BlockTypeEnum::START_NEIGHBOR_SCENE)
     {
-        // 1. paramsJson 자체가 null인지 명시적으로 확인
-        if (block.paramsJson.is_null())
-        {
-            engine.EngineStdOut(
-                "start_neighbor_scene block for object " + objectId +
-                    " has null paramsJson. Expected one parameter (next/prev).",
-                2,
-                executionThreadId);
-            throw ScriptBlockExecutionError(
-                "다음/이전 장면 시작하기 블록의 파라미터가 존재하지 않습니다 (null).",
-                block.id, BlockType, objectId, "paramsJson is null for start_neighbor_scene block.");
-        }
-        // 2. null이 아니라면, 배열이 아니거나 비어있는지 확인
-        else if (!block.paramsJson.is_array() || block.paramsJson.empty())
+        if (block.params.empty())
         {
             engine.EngineStdOut(
                 "start_neighbor_scene block for object " + objectId +
-                    " has invalid (not an array or empty) paramsJson. Expected one parameter (next/prev). Type: " +
-                    block.paramsJson.type_name(),
+                    " has empty params. Expected one parameter (next/prev).",
                 2,
                 executionThreadId);
             throw ScriptBlockExecutionError(
                 "다음/이전 장면 시작하기 블록의 파라미터가 유효하지 않습니다.",
                 block.id, BlockType, objectId,
-                "Invalid or non-array/empty paramsJson for start_neighbor_scene block.");
+                "Empty params for start_neighbor_scene block.");
         }
 
-        OperandValue o = getOperandValue(engine, objectId, block.paramsJson[0], executionThreadId);
+        OperandValue o = getOperandValue(engine, objectId, block.params[0], executionThreadId);
         if (o.type != OperandValue::Type::STRING)
         {
             engine.EngineStdOut(
                 "start_neighbor_scene block for object " + objectId + ": parameter is not a string. Value: " + o.asString(), 2, executionThreadId);
             return;
         }
-        if (o.string_val == "next")
-        {
-            engine.goToNextScene();
-        }
-        else
-        {
-            engine.goToPreviousScene();
-        }
+        Engine::EngineCommand command;
+        command.type = o.stringValue() == "next" ? Engine::EngineCommand::Type::START_NEXT_SCENE
+                                              : Engine::EngineCommand::Type::START_PREVIOUS_SCENE;
+        engine.submitCommand(move(command));
+    }
+}
+
+namespace
+{
+    using BlockHandlerFn = void (*)(Engine &, const string &, const Block &, const string &, const string &, float);
+
+    // 카테고리별 핸들러. Omocha::BlockCategory 순서와 같아야 합니다.
+    constexpr array<BlockHandlerFn, static_cast<size_t>(Omocha::BlockCategory::COUNT)> kCategoryHandlers = {
+        nullptr, // NONE
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &s, float dt)
+        { Moving(b.type, e, o, b, t, s, dt); },
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &, float)
+        { Calculator(b.type, e, o, b, t); },
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &, float)
+        { Looks(b.type, e, o, b, t); },
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &, float)
+        { Sound(b.type, e, o, b, t); },
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &, float)
+        { Variable(b.type, e, o, b, t); },
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &, float)
+        { Function(b.type, e, o, b, t); },
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &, float)
+        { TextBox(b.type, e, o, b, t); },
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &, float)
+        { Event(b.type, e, o, b, t); },
+        [](Engine &e, const string &o, const Block &b, const string &t, const string &s, float dt)
+        { Flow(b.type, e, o, b, t, s, dt); },
+    };
+
+    // opcode -> 핸들러 테이블. 처음 사용할 때 한 번만 만듭니다.
+    const array<BlockHandlerFn, static_cast<size_t>(BlockTypeEnum::COUNT)> &opcodeHandlerTable()
+    {
+        static const auto table = []
+        {
+            array<BlockHandlerFn, static_cast<size_t>(BlockTypeEnum::COUNT)> t{};
+            for (size_t i = 0; i < t.size(); ++i)
+            {
+                auto category = Omocha::blockTypeEnumToCategory(static_cast<BlockTypeEnum>(i));
+                t[i] = kCategoryHandlers[static_cast<size_t>(category)];
+            }
+            return t;
+        }();
+        return table;
+    }
+}
+
+void executeBlock(Engine &engine, const string &objectId, const Block &block, const string &executionThreadId,
+                  const string &sceneIdAtDispatch, float deltaTime)
+{
+    const auto index = static_cast<size_t>(block.opcode);
+    const auto &table = opcodeHandlerTable();
+    if (index >= table.size() || table[index] == nullptr)
+    {
+        return;
     }
+    table[index](engine, objectId, block, executionThreadId, sceneIdAtDispatch, deltaTime);
 }
 
 // 이 함수는 주어진 블록 목록을 순차적으로 실행하며, wait_second를 만나면 해당 스레드를 블록합니다.
@@ -6229,15 +5836,7 @@ void executeBlocksSynchronously(Engine &engine, const string &objectId, const ve
         // 다른 블록 타입 실행
         try
         {
-            Moving(block.type, engine, objectId, block, executionThreadId, sceneIdAtDispatch, deltaTime);
-            Calculator(block.type, engine, objectId, block, executionThreadId);
-            Looks(block.type, engine, objectId, block, executionThreadId);
-            Sound(block.type, engine, objectId, block, executionThreadId);
-            Variable(block.type, engine, objectId, block, executionThreadId);
-            Function(block.type, engine, objectId, block, executionThreadId);
-            TextBox(block.type, engine, objectId, block, executionThreadId);
-            Event(block.type, engine, objectId, block, executionThreadId);
-            Flow(block.type, engine, objectId, block, executionThreadId, sceneIdAtDispatch, deltaTime);
+            executeBlock(engine, objectId, block, executionThreadId, sceneIdAtDispatch, deltaTime);
         }
         catch (const ScriptBlockExecutionError &)
         {
@@ -3,6 +3,8 @@
 
 #include <string>
 #include "Block.h"
+#include "OperandValue.h"
+#include "../VariableStore.h"
 #include <nlohmann/json.hpp>
 #include <vector> // For std::vector
 #include <thread> // For std::thread
@@ -36,99 +38,86 @@ namespace { // Anonymous namespace for local helpers
 } // namespace
 // 전방 선언 (순환 참조 방지)
 class Engine;
+class Entity;
 class PublicVariable{
  public:
   // TODO: Consider making these configurable or loaded from a file
   std::string user_name="ミケ愛団";
   std::string user_id="mikeaidan351";
 };
-// OperandValue 구조체 선언
-struct OperandValue
-{
-    enum class Type
-    {
-        EMPTY,
-        NUMBER,
-        STRING,
-        BOOLEAN,
-    };
-    Type type = Type::EMPTY;
-    bool boolean_val = false;
-    std::string string_val = "";
-    double number_val = 0.0;
+// calc_basic / boolean_basic_operator / boolean_and_or 의 연산자 드롭다운.
+// Calculator 와 ScriptProgram VM 이 같은 연산 구현을 공유하기 위해 사용합니다.
+enum class CalcBasicOperator { PLUS, MINUS, MULTI, DIVIDE, UNKNOWN };
+enum class CompareOperator { EQUAL, NOT_EQUAL, GREATER, LESS, GREATER_OR_EQUAL, LESS_OR_EQUAL, UNKNOWN };
+enum class LogicOperator { AND, OR, UNKNOWN };
 
-    OperandValue(); // 기본 생성자
-    OperandValue(double val);
-    OperandValue(const std::string &val);
-    OperandValue(bool val);
+CalcBasicOperator toCalcBasicOperator(const std::string &op);
+CompareOperator toCompareOperator(const std::string &op);
+LogicOperator toLogicOperator(const std::string &op);
 
-    double asNumber() const;
-    std::string asString() const;
-    bool asBool() const;
-};
-
-const Uint32 MIN_LOOP_WAIT_MS = 1; // Minimum wait time in milliseconds for loops
-
-class ThreadPool {
-    struct TaskPriorityCompare {
-        bool operator()(
-            const std::pair<int, std::function<void()>>& a,
-            const std::pair<int, std::function<void()>>& b) const {
-            return a.first > b.first;  // 낮은 숫자가 높은 우선순위
-        }
-    };
-
-    std::vector<std::thread> workers;
-    std::priority_queue<
-        std::pair<int, std::function<void()>>,
-        std::vector<std::pair<int, std::function<void()>>>,
-        TaskPriorityCompare> tasks;
-    std::mutex queue_mutex;
-    std::condition_variable condition;
-    std::atomic<bool> stop;
-    const size_t max_queue_size;
-    std::condition_variable queue_space_available;
-    Engine& engine; // Engine 참조를 멤버로 가짐
+/**
+ * @brief calc_basic 연산. DIVIDE 에서 0 으로 나누면 ScriptBlockExecutionError 를 던집니다.
+ * @param block 오류 보고에 사용할 블록
+ */
+OperandValue applyCalcBasic(CalcBasicOperator op, const OperandValue &left, const OperandValue &right,
+                            const Block &block, const std::string &objectId);
+OperandValue applyCompare(CompareOperator op, const OperandValue &left, const OperandValue &right);
+OperandValue applyLogic(LogicOperator op, const OperandValue &left, const OperandValue &right);
 
-public:
-    // Engine 참조를 받는 생성자
-    ThreadPool(Engine& eng, size_t threads, size_t maxQueueSize = 1000);
+/**
+ * @brief 파라미터 자리에 올 수 있는 리포터 블록(Calculator 가 값을 반환하는 블록)인지 확인합니다.
+ */
+bool isReporterBlockType(Omocha::BlockTypeEnum type);
 
-    template<class F>
-    void enqueue(F&& f, int priority = 0) {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        queue_space_available.wait(lock, [this] {
-            return tasks.size() < max_queue_size || stop;
-        });
-        if (stop) return;
-        tasks.emplace(priority, std::forward<F>(f));
-        condition.notify_one();
-    }
-
-    ~ThreadPool() {
-        stop = true;
-        condition.notify_all();
-        queue_space_available.notify_all(); // 깨워서 종료 확인하도록
-        for(std::thread &worker : workers) {
-            if(worker.joinable()) worker.join();
-        }
-    }
-};
+const Uint32 MIN_LOOP_WAIT_MS = 1; // Minimum wait time in milliseconds for loops
 
+/**
+ * @brief 블록 하나를 로드 시 해석된 opcode 에 해당하는 핸들러로 바로 디스패치합니다.
+ * 알 수 없는 블록(opcode UNKNOWN) 이나 실행 대상이 아닌 블록은 아무 것도 하지 않습니다.
+ */
+void executeBlock(Engine &engine, const std::string &objectId, const Block &block,
+                  const std::string &executionThreadId, const std::string &sceneIdAtDispatch, float deltaTime);
 void executeBlocksSynchronously(Engine &engine, const std::string &objectId, const std::vector<Block> &blocks,
                             const std::string &executionThreadId, const std::string &sceneIdAtDispatch, float deltaTime,
                             size_t start_index=0);
 // 블록 처리 함수 선언
-OperandValue getOperandValue(Engine &engine, const std::string &objectId, const nlohmann::json &paramField, const std::string &executionThreadId);
-void Moving(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId,const std::string& sceneIdAtDispatch, float deltaTime);
-OperandValue Calculator(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
-void Looks(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
-void Sound(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
-void Variable(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
-void Function(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
-void Event(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
-void Flow(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string &executionThreadId, const std::string& sceneIdAtDispatch, float deltaTime);
-void TextBox(std::string BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string &executionThreadId);
+OperandValue getOperandValue(Engine &engine, const std::string &objectId, const Operand &operand, const std::string &executionThreadId);
+/**
+ * @brief 블록 JSON 의 파라미터 하나를 Operand 로 변환합니다. 리터럴은 최종 값으로 계산되고 리포터 블록은 재귀적으로 해석됩니다.
+ * @param context 로드 중 경고 로그에 사용할 위치 설명
+ */
+Operand parseOperand(Engine &engine, const nlohmann::json &paramField, const std::string &context);
+// params 배열 전체를 변환합니다. null 항목은 제외됩니다.
+std::vector<Operand> parseOperands(Engine &engine, const nlohmann::json &paramsArray, const std::string &context);
+std::string describeOperands(const std::vector<Operand> &operands);
+// 블록 핸들러와 ScriptProgram 의 결합 명령이 같이 쓰는 동작 구현. 파라미터는 이미 평가된 값을 받습니다.
+void moveEntityInDirection(Engine &engine, Entity &entity, double dist, const std::string &executionThreadId);
+void bounceEntityOffWall(Engine &engine, Entity &entity, const std::string &executionThreadId);
+bool isEntityReaching(Engine &engine, const Entity &self, const std::string &targetId, const std::string &executionThreadId);
+void changeVariableBy(Engine &engine, const std::string &objectId, const std::string &variableId,
+                      const OperandValue &valueToAdd, const std::string &executionThreadId);
+void changeVariableBy(Engine &engine, const std::string &objectId, const VariableStore::Ref &variable,
+                      const OperandValue &valueToAdd, const std::string &executionThreadId);
+// set_func_variable/change_func_variable. slot 은 현재 호출 프레임의 자리 (UserFunction::localVariableSlot)
+void setFunctionVariable(Engine &engine, const std::string &objectId, int slot, OperandValue value,
+                         const std::string &executionThreadId);
+void changeFunctionVariableBy(Engine &engine, const std::string &objectId, int slot, const OperandValue &valueToAdd,
+                              const std::string &executionThreadId);
+// get_variable. 컴파일된 표현식(LOAD_VAR)은 로드 시 해석한 참조로 바로 읽습니다.
+OperandValue readVariable(Engine &engine, const std::string &objectId, const VariableStore::Ref &variable,
+                          const std::string &executionThreadId);
+// 변수/리스트 슬롯 찾기 (로컬 우선, 없으면 전역). 없으면 nullptr. m_engineDataMutex 를 잡고 사용합니다.
+VariableStore::Slot *findVariableSlot(Engine &engine, const std::string &objectId, const std::string &variableId);
+VariableStore::Slot *findListSlot(Engine &engine, const std::string &objectId, const std::string &listId);
+void Moving(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId,const std::string& sceneIdAtDispatch, float deltaTime);
+OperandValue Calculator(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
+void Looks(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
+void Sound(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
+void Variable(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
+void Function(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
+void Event(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string& executionThreadId);
+void Flow(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string &executionThreadId, const std::string& sceneIdAtDispatch, float deltaTime);
+void TextBox(const std::string &BlockType, Engine &engine, const std::string &objectId, const Block &block, const std::string &executionThreadId);
 // 스크립트를 실행하는 함수 선언 (Entity의 멤버 함수로 이동 예정이므로 주석 처리 또는 삭제)
 // void executeScript(Engine& engine, const std::string& objectId, const Script* script);
 #endif // OMOCHA_BLOCK_EXECUTOR_H
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "OperandValue.h"
+#include "BlockExecutor.h"
+#include "../Entity.h" // ScriptBlockExecutionError
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// 블록 값과 calc_basic / 비교 / 논리 연산. 엔진 없이 링크할 수 있도록 BlockExecutor.cpp 에서 분리했습니다. (bench/operand_value_bench)
+
+bool parseNumberStrict(string_view text, double &out)
+{
+    // 앞뒤 공백 제거 (복사 없이)
+    while (!text.empty() && isspace(static_cast<unsigned char>(text.front())))
+        text.remove_prefix(1);
+    while (!text.empty() && isspace(static_cast<unsigned char>(text.back())))
+        text.remove_suffix(1);
+    if (text.empty())
+        return false;
+    // from_chars 는 '+' 부호를 받지 않으므로 직접 건너뜁니다.
+    if (text.front() == '+')
+    {
+        text.remove_prefix(1);
+        if (text.empty() || text.front() == '-')
+            return false;
+    }
+    // "inf", "nan" 등은 숫자로 취급하지 않습니다. (EntryJS 와 동일하게 10진 표기만 허용)
+    char lead = (text.front() == '-' && text.size() > 1) ? text[1] : text.front();
+    if (!isdigit(static_cast<unsigned char>(lead)) && lead != '.')
+        return false;
+    const char *end = text.data() + text.size();
+    auto [ptr, ec] = from_chars(text.data(), end, out);
+    return ec == errc() && ptr == end;
+}
+
+// OperandValue 생성자 및 멤버 함수 구현 (OperandValue.h에 선언됨)
+OperandValue::OperandValue() : type(Type::EMPTY), m_boolean(false), m_number(0.0)
+{
+}
+
+OperandValue::OperandValue(double val) : type(Type::NUMBER), m_boolean(false), m_number(val)
+{
+}
+
+OperandValue::OperandValue(const string &val) : type(Type::STRING), m_boolean(false), m_string(val),
+                                                m_number(0.0)
+{
+}
+
+OperandValue::OperandValue(string &&val) : type(Type::STRING), m_boolean(false), m_string(move(val)),
+                                           m_number(0.0)
+{
+}
+
+OperandValue::OperandValue(const char *val) : type(Type::STRING), m_boolean(false), m_string(val ? val : ""),
+                                              m_number(0.0)
+{
+}
+
+OperandValue::OperandValue(bool val) : type(Type::BOOLEAN), m_boolean(val), m_number(0.0)
+{
+}
+
+const string &OperandValue::stringValue() const
+{
+    static const string empty;
+    return type == Type::STRING ? m_string : empty;
+}
+
+void OperandValue::parseNumberCache() const
+{
+    double parsed = 0.0;
+    bool valid = parseNumberStrict(m_string, parsed);
+    // 두 방식 모두 실패 시 0.0 (EntryJS 유사 동작)
+    m_number = valid ? parsed : 0.0;
+    cacheFlags |= CACHE_NUMBER_PARSED | (valid ? CACHE_NUMBER_VALID : 0);
+}
+
+double OperandValue::asNumber() const
+{
+    if (type == Type::NUMBER)
+    {
+        return m_number;
+    }
+    if (type == Type::STRING)
+    {
+        if (!(cacheFlags & CACHE_NUMBER_PARSED))
+            parseNumberCache();
+        return m_number;
+    }
+    if (type == Type::BOOLEAN)
+    {
+        return m_boolean ? 1.0 : 0.0;
+    }
+    // EMPTY 또는 처리되지 않은 타입
+    return 0.0;
+}
+
+bool OperandValue::isNumeric() const
+{
+    if (type == Type::NUMBER)
+        return true;
+    if (type != Type::STRING)
+        return false;
+    if (!(cacheFlags & CACHE_NUMBER_PARSED))
+        parseNumberCache();
+    return (cacheFlags & CACHE_NUMBER_VALID) != 0;
+}
+
+string OperandValue::asString() const
+{
+    if (type == Type::STRING)
+        return m_string;
+    if (type == Type::NUMBER)
+    {
+        if (cacheFlags & CACHE_STRING)
+            return m_string;
+        if (isnan(m_number))
+            m_string = "NaN";
+        else if (isinf(m_number))
+            m_string = m_number > 0 ? "Infinity" : "-Infinity";
+        else
+        {
+            // to_string 과 같은 "%f" 형식 (소수점 6자리) 을 할당 없이 만든 뒤 끝의 0 과 소수점을 제거합니다.
+            char buffer[400];
+            auto [ptr, ec] = to_chars(buffer, buffer + sizeof(buffer), m_number, chars_format::fixed, 6);
+            string_view text(buffer, ec == errc() ? ptr - buffer : 0);
+            size_t last = text.find_last_not_of('0');
+            text = text.substr(0, last == string_view::npos ? 0 : last + 1);
+            if (!text.empty() && text.back() == '.')
+                text.remove_suffix(1);
+            m_string.assign(text);
+        }
+        cacheFlags |= CACHE_STRING;
+        return m_string;
+    }
+    if (type == Type::BOOLEAN)
+    {
+        return m_boolean ? "true" : "false";
+    }
+    return ""; // Default for EMPTY or unhandled types
+}
+
+bool OperandValue::asBool() const
+{
+    if (type == Type::BOOLEAN)
+        return m_boolean;
+    if (type == Type::NUMBER)
+        return m_number != 0.0; // 0 is false, non-zero is true
+    if (type == Type::STRING)
+    {
+        // Mimic JavaScript-like truthiness:
+        // Empty string is false.
+        // "false" (case-insensitive) is false.
+        // "0" is false.
+        // Otherwise, true.
+        if (m_string.empty() || m_string == "0")
+            return false;
+        static constexpr string_view falseText = "false";
+        return !ranges::equal(m_string, falseText, [](char a, char b) {
+            return tolower(static_cast<unsigned char>(a)) == b;
+        });
+    }
+    // EMPTY or unhandled types are false
+    return false;
+}
+
+void OperandValue::precompute() const
+{
+    if (type == Type::STRING)
+        isNumeric();
+    else if (type == Type::NUMBER)
+        asString();
+}
+
+CalcBasicOperator toCalcBasicOperator(const string &op)
+{
+    if (op == "PLUS")
+        return CalcBasicOperator::PLUS;
+    if (op == "MINUS")
+        return CalcBasicOperator::MINUS;
+    if (op == "MULTI")
+        return CalcBasicOperator::MULTI;
+    if (op == "DIVIDE")
+        return CalcBasicOperator::DIVIDE;
+    return CalcBasicOperator::UNKNOWN;
+}
+
+CompareOperator toCompareOperator(const string &op)
+{
+    if (op == "EQUAL")
+        return CompareOperator::EQUAL;
+    if (op == "NOT_EQUAL")
+        return CompareOperator::NOT_EQUAL;
+    if (op == "GREATER")
+        return CompareOperator::GREATER;
+    if (op == "LESS")
+        return CompareOperator::LESS;
+    if (op == "GREATER_OR_EQUAL")
+        return CompareOperator::GREATER_OR_EQUAL;
+    if (op == "LESS_OR_EQUAL")
+        return CompareOperator::LESS_OR_EQUAL;
+    return CompareOperator::UNKNOWN;
+}
+
+LogicOperator toLogicOperator(const string &op)
+{
+    if (op == "AND")
+        return LogicOperator::AND;
+    if (op == "OR")
+        return LogicOperator::OR;
+    return LogicOperator::UNKNOWN;
+}
+
+OperandValue applyCalcBasic(CalcBasicOperator op, const OperandValue &leftOp, const OperandValue &rightOp,
+                            const Block &block, const string &objectId)
+{
+    // EntryJS-like behavior: PLUS can be string concatenation or numeric addition
+    if (op == CalcBasicOperator::PLUS)
+    {
+        // If both can be strictly interpreted as numbers, add them. Otherwise, concatenate as strings.
+        // This mimics Scratch/EntryJS behavior where "1" + "2" is 3, but "1" + "a" is "1a".
+        bool leftIsNumeric = leftOp.isNumeric();
+        bool rightIsNumeric = rightOp.isNumeric();
+
+        if (leftIsNumeric && rightIsNumeric)
+        {
+            return OperandValue(leftOp.asNumber() + rightOp.asNumber());
+        }
+        return OperandValue(leftOp.asString() + rightOp.asString());
+    }
+
+    double numLeft = leftOp.asNumber();
+    double numRight = rightOp.asNumber();
+    switch (op)
+    {
+    case CalcBasicOperator::MINUS:
+        return OperandValue(numLeft - numRight);
+    case CalcBasicOperator::MULTI:
+        return OperandValue(numLeft * numRight);
+    case CalcBasicOperator::DIVIDE:
+        if (numRight == 0.0)
+        {
+            throw ScriptBlockExecutionError("0으로 나눌 수 없습니다.", block.id, block.type, objectId, "Division by zero.");
+        }
+        return OperandValue(numLeft / numRight);
+    default:
+        return OperandValue();
+    }
+}
+
+OperandValue applyCompare(CompareOperator op, const OperandValue &leftOp, const OperandValue &rightOp)
+{
+    // 1. 먼저 양쪽 모두 엄격한 숫자인지 확인
+    bool leftIsNumber = leftOp.isNumeric();
+    bool rightIsNumber = rightOp.isNumeric();
+
+    double leftNum;
+    double rightNum;
+    if (leftIsNumber && rightIsNumber)
+    {
+        // 2. 둘 다 숫자로 처리 가능한 경우
+        leftNum = leftOp.asNumber();
+        rightNum = rightOp.asNumber();
+        if (op == CompareOperator::EQUAL)
+            return OperandValue(leftNum == rightNum);
+        if (op == CompareOperator::NOT_EQUAL)
+            return OperandValue(leftNum != rightNum);
+    }
+    else
+    {
+        // 3. 숫자가 아닌 경우 문자열로 비교
+        if (op == CompareOperator::EQUAL)
+            return OperandValue(leftOp.asString() == rightOp.asString());
+        if (op == CompareOperator::NOT_EQUAL)
+            return OperandValue(leftOp.asString() != rightOp.asString());
+
+        // 숫자가 아닌 값들에 대한 대소 비교는 문자열을 0으로 취급
+        leftNum = leftIsNumber ? leftOp.asNumber() : 0.0;
+        rightNum = rightIsNumber ? rightOp.asNumber() : 0.0;
+    }
+
+    switch (op)
+    {
+    case CompareOperator::GREATER:
+        return OperandValue(leftNum > rightNum);
+    case CompareOperator::LESS:
+        return OperandValue(leftNum < rightNum);
+    case CompareOperator::GREATER_OR_EQUAL:
+        return OperandValue(leftNum >= rightNum);
+    case CompareOperator::LESS_OR_EQUAL:
+        return OperandValue(leftNum <= rightNum);
+    default:
+        return OperandValue(false);
+    }
+}
+
+OperandValue applyLogic(LogicOperator op, const OperandValue &left, const OperandValue &right)
+{
+    if (op == LogicOperator::AND)
+        return OperandValue(left.asBool() && right.asBool());
+    if (op == LogicOperator::OR)
+        return OperandValue(left.asBool() || right.asBool());
+    return OperandValue(false);
+}
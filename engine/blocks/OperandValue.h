@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief 블록 평가 결과 값 (구현은 OperandValue.cpp)
+ *
+ * 변수 슬롯(VariableStore::Slot::value)도 이 타입으로 저장하므로 숫자 변수는 연산 중 문자열을 만들지 않습니다.
+ * 문자열 변수와 HUD 표시처럼 값이 두 표현 사이를 오갈 때는
+ * STRING 의 숫자 해석 결과와 NUMBER 의 문자열 표현을 처음 계산할 때 한 번만 만들어 캐시합니다.
+ * 캐시는 별도 멤버 없이 쓰지 않는 쪽 필드에 둡니다. (STRING 은 m_number, NUMBER 는 m_string)
+ * 그래서 값 필드는 감춰 두고, 타입에 맞는 값만 돌려주는 stringValue() / numberValue() / booleanValue() 로 읽습니다.
+ * 값은 생성자로만 정해지므로 캐시가 값과 어긋나지 않습니다.
+ * 여러 스레드가 공유하는 값(로드 시 만든 리터럴, 컴파일된 상수)은 precompute() 로 캐시를 미리 채워
+ * 이후에는 읽기만 일어나도록 합니다.
+ */
+struct OperandValue
+{
+    enum class Type : uint8_t
+    {
+        EMPTY,
+        NUMBER,
+        STRING,
+        BOOLEAN,
+    };
+    Type type = Type::EMPTY;
+
+private:
+    enum : uint8_t
+    {
+        CACHE_NUMBER_PARSED = 1 << 0, // m_number 에 해석 결과가 있음 (STRING)
+        CACHE_NUMBER_VALID = 1 << 1,  // 문자열 전체가 숫자였음
+        CACHE_STRING = 1 << 2         // m_string 에 문자열 표현이 있음 (NUMBER)
+    };
+    // type 뒤의 패딩에 들어가도록 여기에 둡니다.
+    bool m_boolean = false;
+    mutable uint8_t cacheFlags = 0;
+    mutable std::string m_string; // STRING 값 (NUMBER 이면 문자열 표현 캐시)
+    mutable double m_number = 0.0; // NUMBER 값 (STRING 이면 숫자 해석 캐시)
+
+public:
+    OperandValue(); // 기본 생성자
+    OperandValue(double val);
+    OperandValue(const std::string &val);
+    OperandValue(std::string &&val);
+    OperandValue(const char *val); // 문자열 리터럴이 bool 생성자로 변환되지 않도록 합니다.
+    OperandValue(bool val);
+
+    // 타입에 맞는 값을 그대로 돌려줍니다. 타입이 다르면 빈 문자열 / 0 / false 입니다. (변환은 as* 를 씁니다)
+    const std::string &stringValue() const;
+    double numberValue() const { return type == Type::NUMBER ? m_number : 0.0; }
+    bool booleanValue() const { return type == Type::BOOLEAN && m_boolean; }
+
+    double asNumber() const;
+    std::string asString() const;
+    bool asBool() const;
+    // NUMBER 이거나, 전체가 숫자로 해석되는 STRING 인지 확인합니다.
+    bool isNumeric() const;
+    // 두 표현의 캐시를 미리 채웁니다.
+    void precompute() const;
+
+private:
+    void parseNumberCache() const;
+};
+
+/**
+ * @brief 앞뒤 공백을 제외한 문자열 전체가 10진 실수인지 확인하고 값을 돌려줍니다. (로케일 무관, 할당 없음)
+ */
+bool parseNumberStrict(std::string_view text, double &out);
@@ -0,0 +1,1008 @@
+#include "ScriptCompiler.h"
+#include "AotCompiler.h"
+#include "../Engine.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <format>
+
+using namespace std;
+using Omocha::BlockTypeEnum;
+
+namespace
+{
+    class ScriptCompilerImpl
+    {
+    public:
+        ScriptCompilerImpl(ScriptProgram &program, Engine &engine, const UserFunction *function)
+            : program(program), engine(engine), function(function)
+        {
+        }
+
+        void compileTopLevel(const vector<Block> &blocks)
+        {
+            // blocks[0] 은 이벤트(트리거) 블록이므로 실행 대상이 아닙니다.
+            compileSequence(blocks, 1, true);
+        }
+
+        // 최상위 블록과 무관한 값 하나를 표현식으로 컴파일합니다. (함수 결과값)
+        uint32_t compileValue(const Operand &operand)
+        {
+            return compileExpr(operand);
+        }
+
+    private:
+        struct LoopContext
+        {
+            vector<size_t> breakJumps;
+            vector<size_t> continueJumps;
+        };
+
+        ScriptProgram &program;
+        Engine &engine;
+        const UserFunction *function; // 함수 본문을 컴파일 중이면 그 함수 (파라미터/지역 변수 해석용)
+        vector<LoopContext> loops;
+        uint32_t currentTopLevel = 0;
+        uint16_t nextRegister = 0;
+
+        uint32_t here() const { return static_cast<uint32_t>(program.code.size()); }
+
+        uint32_t addBlock(const Block &block, bool keepStatements)
+        {
+            program.blocks.push_back(block);
+            if (!keepStatements)
+            {
+                program.blocks.back().statementScripts.clear();
+            }
+            return static_cast<uint32_t>(program.blocks.size() - 1);
+        }
+
+        size_t emit(VmOp op, uint32_t a, uint32_t b, uint32_t blockIndex)
+        {
+            VmInstr instr;
+            instr.op = op;
+            instr.a = a;
+            instr.b = b;
+            instr.block = blockIndex;
+            instr.topLevelIndex = currentTopLevel;
+            program.code.push_back(instr);
+            return program.code.size() - 1;
+        }
+
+        void setJumpTarget(size_t at, uint32_t target)
+        {
+            VmInstr &instr = program.code[at];
+            if (instr.op == VmOp::JUMP || instr.op == VmOp::YIELD_JUMP)
+                instr.a = target;
+            else
+                instr.b = target;
+        }
+
+        void compileStatement(const Block &block, size_t statementIndex)
+        {
+            if (statementIndex < block.statementScripts.size())
+            {
+                compileSequence(block.statementScripts[statementIndex].blocks, 0, false);
+            }
+        }
+
+        void compileSequence(const vector<Block> &blocks, size_t begin, bool topLevel)
+        {
+            for (size_t i = begin; i < blocks.size(); ++i)
+            {
+                if (topLevel)
+                    currentTopLevel = static_cast<uint32_t>(i);
+                if (i + 1 < blocks.size() && tryFuseMoveBounce(blocks[i], blocks[i + 1]))
+                {
+                    ++i; // bounce_wall 은 결합 명령에 포함됨
+                    continue;
+                }
+                compileBlock(blocks[i]);
+            }
+        }
+
+        // --- 결합 명령 ---
+
+        static bool isLiteral(const Operand &operand)
+        {
+            switch (operand.kind)
+            {
+            case Operand::Kind::NUMBER:
+            case Operand::Kind::STRING:
+            case Operand::Kind::BOOLEAN:
+            case Operand::Kind::LITERAL:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // 리터럴이면 상수 테이블 인덱스, 아니면 표현식 인덱스를 돌려줍니다.
+        uint32_t compileFusedOperand(const Operand &operand, bool literal)
+        {
+            return literal ? addRawConstant(operand.value) : compileExpr(operand);
+        }
+
+        bool tryFuseMoveBounce(const Block &move, const Block &bounce)
+        {
+            // 파라미터 구조가 잘못된 move_direction 은 기존 핸들러가 보고합니다.
+            if (move.opcode != BlockTypeEnum::MOVE_DIRECTION || bounce.opcode != BlockTypeEnum::BOUNCE_WALL ||
+                move.params.size() != 1)
+                return false;
+            bool literal = isLiteral(move.params[0]);
+            uint32_t blockIndex = addBlock(move, false);
+            emit(literal ? VmOp::MOVE_BOUNCE_CONST : VmOp::MOVE_BOUNCE, compileFusedOperand(move.params[0], literal),
+                 0, blockIndex);
+            return true;
+        }
+
+        // 조건이 거짓이면 점프하는 명령을 만듭니다. 대상이 리터럴인 reach_something 은 충돌 판정을 바로 호출합니다.
+        size_t emitJumpIfFalse(const Operand &condition, uint32_t blockIndex)
+        {
+            if (condition.kind == Operand::Kind::REPORTER &&
+                condition.block->opcode == BlockTypeEnum::REACH_SOMETHING && !condition.block->params.empty() &&
+                condition.block->params[0].isString() && !condition.block->params[0].value.stringValue().empty())
+            {
+                return emit(VmOp::JUMP_IF_NOT_REACH, addRawConstant(condition.block->params[0].value), 0, blockIndex);
+            }
+            return emit(VmOp::JUMP_IF_FALSE, compileExpr(condition), 0, blockIndex);
+        }
+
+        void closeLoop(uint32_t continueTarget, uint32_t exitTarget)
+        {
+            LoopContext &loop = loops.back();
+            for (size_t at : loop.continueJumps)
+                setJumpTarget(at, continueTarget);
+            for (size_t at : loop.breakJumps)
+                setJumpTarget(at, exitTarget);
+            loops.pop_back();
+        }
+
+        void compileBlock(const Block &block)
+        {
+            const vector<Operand> &params = block.params;
+            switch (block.opcode)
+            {
+            case BlockTypeEnum::_IF:
+            {
+                if (params.empty())
+                    break; // 파라미터 오류는 기존 Flow 핸들러가 보고합니다.
+                uint32_t blockIndex = addBlock(block, false);
+                size_t skip = emitJumpIfFalse(params[0], blockIndex);
+                compileStatement(block, 0);
+                setJumpTarget(skip, here());
+                return;
+            }
+            case BlockTypeEnum::IF_ELSE:
+            {
+                if (params.empty())
+                    break;
+                uint32_t blockIndex = addBlock(block, false);
+                size_t toElse = emitJumpIfFalse(params[0], blockIndex);
+                compileStatement(block, 0);
+                size_t toEnd = emit(VmOp::JUMP, 0, 0, blockIndex);
+                setJumpTarget(toElse, here());
+                compileStatement(block, 1);
+                setJumpTarget(toEnd, here());
+                return;
+            }
+            case BlockTypeEnum::REPEAT_BASIC:
+            {
+                if (params.empty() || params[0].isNull())
+                    break;
+                if (block.statementScripts.empty())
+                    return; // 반복할 내용이 없으면 기존 구현처럼 아무것도 하지 않습니다.
+                uint32_t blockIndex = addBlock(block, false);
+                uint32_t slot = program.loopSlotCount++;
+                emit(VmOp::LOOP_INIT, compileExpr(params[0]), slot, blockIndex);
+                uint32_t head = here();
+                size_t test = emit(VmOp::LOOP_TEST, slot, 0, blockIndex);
+                loops.emplace_back();
+                compileStatement(block, 0);
+                uint32_t next = here();
+                emit(VmOp::LOOP_NEXT, slot, head, blockIndex);
+                setJumpTarget(test, here());
+                closeLoop(next, here());
+                return;
+            }
+            case BlockTypeEnum::REPEAT_INF:
+            {
+                uint32_t blockIndex = addBlock(block, false);
+                uint32_t head = here();
+                loops.emplace_back();
+                compileStatement(block, 0);
+                uint32_t next = here();
+                emit(VmOp::YIELD_JUMP, head, 0, blockIndex);
+                closeLoop(next, here());
+                return;
+            }
+            case BlockTypeEnum::REPEAT_WHILE_TRUE:
+            {
+                // 옵션(until/while)이 상수일 때만 풀어냅니다.
+                if (params.size() < 2 || !params[1].isString())
+                    break;
+                if (block.statementScripts.empty())
+                    return;
+                string loopMode = params[1].value.stringValue();
+                if (loopMode.empty())
+                    loopMode = "until";
+                uint32_t blockIndex = addBlock(block, false);
+                if (block.statementScripts[0].blocks.empty())
+                {
+                    // 빈 반복은 조건 기다리기와 같습니다. (while 이면 조건이 거짓이 될 때까지)
+                    emit(VmOp::WAIT_UNTIL, compileExpr(params[0], loopMode != "until"), addWaitDependencies(params[0]),
+                         blockIndex);
+                    return;
+                }
+                uint32_t head = here();
+                uint32_t cond = compileExpr(params[0]);
+                size_t exit = emit(loopMode == "until" ? VmOp::JUMP_IF_TRUE : VmOp::JUMP_IF_FALSE, cond, 0,
+                                   blockIndex);
+                loops.emplace_back();
+                compileStatement(block, 0);
+                uint32_t next = here();
+                emit(VmOp::YIELD_JUMP, head, 0, blockIndex);
+                setJumpTarget(exit, here());
+                closeLoop(next, here());
+                return;
+            }
+            case BlockTypeEnum::WAIT_UNTIL_TRUE:
+            {
+                if (params.empty())
+                    break;
+                uint32_t blockIndex = addBlock(block, false);
+                emit(VmOp::WAIT_UNTIL, compileExpr(params[0]), addWaitDependencies(params[0]), blockIndex);
+                return;
+            }
+            case BlockTypeEnum::STOP_REPEAT:
+            case BlockTypeEnum::CONTINUE_REPEAT:
+            {
+                if (loops.empty())
+                    break; // 반복문 밖에서는 기존 플래그 방식 그대로 둡니다.
+                uint32_t blockIndex = addBlock(block, false);
+                size_t jump = emit(VmOp::JUMP, 0, 0, blockIndex);
+                if (block.opcode == BlockTypeEnum::STOP_REPEAT)
+                    loops.back().breakJumps.push_back(jump);
+                else
+                    loops.back().continueJumps.push_back(jump);
+                return;
+            }
+            case BlockTypeEnum::FUNCTION_CALL:
+            {
+                int functionIndex = engine.findUserFunction(block.type.substr(5)); // "func_" 뒤가 함수 ID
+                if (functionIndex < 0)
+                    break; // 정의되지 않은 함수는 Function 핸들러가 경고합니다.
+                const UserFunction *callee = engine.getUserFunction(functionIndex);
+                uint32_t blockIndex = addBlock(block, false);
+                CallSite call;
+                call.function = static_cast<uint32_t>(functionIndex);
+                call.firstArg = static_cast<uint32_t>(program.exprs.size());
+                call.argCount = static_cast<uint32_t>(callee->paramTypes.size());
+                Operand missingArg;
+                missingArg.kind = Operand::Kind::LITERAL; // 빠진 인자는 빈 값
+                for (uint32_t i = 0; i < call.argCount; ++i)
+                {
+                    compileExpr(i < params.size() ? params[i] : missingArg);
+                }
+                program.calls.push_back(call);
+                emit(VmOp::CALL, static_cast<uint32_t>(program.calls.size() - 1), 0, blockIndex);
+                return;
+            }
+            case BlockTypeEnum::LOCATE_XY:
+            {
+                if (params.size() < 2)
+                    break;
+                bool literal = isLiteral(params[0]) && isLiteral(params[1]);
+                uint32_t blockIndex = addBlock(block, false);
+                uint32_t x = compileFusedOperand(params[0], literal);
+                uint32_t y = compileFusedOperand(params[1], literal);
+                emit(literal ? VmOp::LOCATE_XY_CONST : VmOp::LOCATE_XY, x, y, blockIndex);
+                return;
+            }
+            case BlockTypeEnum::CHANGE_VARIABLE:
+            {
+                // 변수 ID 가 상수 드롭다운일 때만 결합합니다.
+                if (params.size() < 2 || !params[0].isString() || params[0].value.stringValue().empty())
+                    break;
+                bool literal = isLiteral(params[1]);
+                uint32_t blockIndex = addBlock(block, false);
+                uint32_t value = compileFusedOperand(params[1], literal);
+                emit(literal ? VmOp::CHANGE_VAR_CONST : VmOp::CHANGE_VAR, value,
+                     addVariable(params[0].value.stringValue()), blockIndex);
+                return;
+            }
+            case BlockTypeEnum::SET_FUNC_VARIABLE:
+            case BlockTypeEnum::CHANGE_FUNC_VARIABLE:
+            {
+                int slot = localVariableSlot(params);
+                if (slot < 0 || params.size() < 2)
+                    break; // 함수 밖이나 알 수 없는 지역 변수는 Function 핸들러가 경고합니다.
+                uint32_t blockIndex = addBlock(block, false);
+                uint32_t value = compileExpr(params[1]);
+                emit(block.opcode == BlockTypeEnum::SET_FUNC_VARIABLE ? VmOp::SET_LOCAL : VmOp::CHANGE_LOCAL, value,
+                     static_cast<uint32_t>(slot), blockIndex);
+                return;
+            }
+            default:
+                break;
+            }
+            // 풀어내지 않은 블록은 기존 핸들러로 실행합니다. (statement 를 가진 블록은 트리 인터프리터가 처리)
+            emit(VmOp::EXEC, 0, 0, addBlock(block, true));
+        }
+
+        // --- 표현식 ---
+
+        uint32_t compileExpr(const Operand &operand, bool negate = false)
+        {
+            CompiledExpr expr;
+            expr.firstInstr = static_cast<uint32_t>(program.exprCode.size());
+            nextRegister = 0;
+            expr.result = compileOperand(operand);
+            if (negate)
+                expr.result = emitExpr(ExprOp::NOT, 0, expr.result, 0, 0);
+            expr.instrCount = static_cast<uint32_t>(program.exprCode.size()) - expr.firstInstr;
+            expr.registerCount = nextRegister;
+            program.exprs.push_back(expr);
+            return static_cast<uint32_t>(program.exprs.size() - 1);
+        }
+
+        uint32_t addWaitDependencies(const Operand &condition)
+        {
+            program.waitDependencies.push_back(analyzeWaitDependencies(condition));
+            return static_cast<uint32_t>(program.waitDependencies.size() - 1);
+        }
+
+        uint32_t addVariable(const string &variableId)
+        {
+            program.variables.push_back(engine.getVariableStore().resolveRef(variableId));
+            return static_cast<uint32_t>(program.variables.size() - 1);
+        }
+
+        // 함수 지역 변수 블록(params[0] 이 변수 ID 드롭다운)의 프레임 자리. 함수 밖이거나 찾지 못하면 -1
+        int localVariableSlot(const vector<Operand> &params) const
+        {
+            if (!function || params.empty() || !params[0].isString())
+                return -1;
+            return function->localVariableSlot(params[0].value.stringValue());
+        }
+
+        uint32_t addRawConstant(OperandValue value)
+        {
+            value.precompute(); // 상수는 여러 스레드가 동시에 읽습니다.
+            program.constants.push_back(std::move(value));
+            return static_cast<uint32_t>(program.constants.size() - 1);
+        }
+
+        uint16_t addConstant(OperandValue value)
+        {
+            return static_cast<uint16_t>(addRawConstant(std::move(value)) | kExprConstFlag);
+        }
+
+        uint16_t emitExpr(ExprOp op, uint8_t sub, uint16_t lhs, uint16_t rhs, uint32_t operand)
+        {
+            ExprInstr instr;
+            instr.op = op;
+            instr.sub = sub;
+            instr.dst = nextRegister++;
+            instr.lhs = lhs;
+            instr.rhs = rhs;
+            instr.operand = operand;
+            program.exprCode.push_back(instr);
+            return instr.dst;
+        }
+
+        uint16_t emitOperand(const Operand &operand)
+        {
+            program.operands.push_back(operand);
+            return emitExpr(ExprOp::EVAL_OPERAND, 0, 0, 0, static_cast<uint32_t>(program.operands.size() - 1));
+        }
+
+        // 0 으로 나누기 오류 보고에 사용할 블록 (파라미터는 필요 없음)
+        uint32_t addOperatorBlock(const Block &reporter)
+        {
+            Block opBlock(reporter.type);
+            opBlock.id = reporter.id;
+            program.blocks.push_back(std::move(opBlock));
+            return static_cast<uint32_t>(program.blocks.size() - 1);
+        }
+
+        uint16_t compileOperand(const Operand &operand)
+        {
+            // 레지스터/상수 인덱스가 15비트를 넘으면 더 이상 풀어내지 않습니다.
+            if (nextRegister >= kExprConstFlag - 1 || program.constants.size() >= kExprConstFlag - 1)
+                return emitOperand(operand);
+
+            switch (operand.kind)
+            {
+            case Operand::Kind::NUMBER:
+            case Operand::Kind::STRING:
+            case Operand::Kind::BOOLEAN:
+            case Operand::Kind::LITERAL:
+                return addConstant(operand.value);
+            case Operand::Kind::REPORTER:
+                break;
+            default:
+                return emitOperand(operand); // 경고 로그는 getOperandValue 가 남깁니다.
+            }
+
+            // 연산자가 상수인 기본 연산은 Calculator 를 거치지 않고 바로 계산합니다.
+            const Block &reporter = *operand.block;
+            const vector<Operand> &params = reporter.params;
+            if (function && reporter.opcode == BlockTypeEnum::FUNCTION_PARAM)
+            {
+                int argIndex = function->paramIndex(reporter.type);
+                if (argIndex >= 0)
+                    return emitExpr(ExprOp::LOAD_ARG, 0, 0, 0, static_cast<uint32_t>(argIndex));
+            }
+            if (reporter.opcode == BlockTypeEnum::GET_FUNC_VARIABLE)
+            {
+                int slot = localVariableSlot(params);
+                if (slot >= 0)
+                    return emitExpr(ExprOp::LOAD_ARG, 0, 0, 0, static_cast<uint32_t>(slot));
+            }
+            if (params.size() >= 3 && params[1].isString())
+            {
+                const string &opStr = params[1].value.stringValue();
+                if (reporter.opcode == BlockTypeEnum::CALC_BASIC && params.size() == 3)
+                {
+                    CalcBasicOperator op = toCalcBasicOperator(opStr);
+                    if (op != CalcBasicOperator::UNKNOWN)
+                    {
+                        uint16_t lhs = compileOperand(params[0]);
+                        uint16_t rhs = compileOperand(params[2]);
+                        return emitExpr(ExprOp::CALC, static_cast<uint8_t>(op), lhs, rhs, addOperatorBlock(reporter));
+                    }
+                }
+                else if (reporter.opcode == BlockTypeEnum::BOOLEAN_BASIC_OPERATOR)
+                {
+                    CompareOperator op = toCompareOperator(opStr);
+                    if (op != CompareOperator::UNKNOWN)
+                    {
+                        uint16_t lhs = compileOperand(params[0]);
+                        uint16_t rhs = compileOperand(params[2]);
+                        return emitExpr(ExprOp::COMPARE, static_cast<uint8_t>(op), lhs, rhs, 0);
+                    }
+                }
+                else if (reporter.opcode == BlockTypeEnum::BOOLEAN_AND_OR)
+                {
+                    LogicOperator op = toLogicOperator(opStr);
+                    if (op != LogicOperator::UNKNOWN)
+                    {
+                        uint16_t lhs = compileOperand(params[0]);
+                        uint16_t rhs = compileOperand(params[2]);
+                        return emitExpr(ExprOp::LOGIC, static_cast<uint8_t>(op), lhs, rhs, 0);
+                    }
+                }
+            }
+            if (reporter.opcode == BlockTypeEnum::BOOLEAN_NOT && !params.empty())
+            {
+                uint16_t value = compileOperand(params[0]);
+                return emitExpr(ExprOp::NOT, 0, value, 0, 0);
+            }
+            if (reporter.opcode == BlockTypeEnum::GET_VARIABLE && !params.empty() && params[0].isString() &&
+                !params[0].value.stringValue().empty())
+            {
+                return emitExpr(ExprOp::LOAD_VAR, 0, 0, 0, addVariable(params[0].value.stringValue()));
+            }
+
+            // 나머지 리포터는 Calculator 로 평가합니다.
+            return emitOperand(operand);
+        }
+    };
+} // namespace
+
+namespace
+{
+    void assignLoopSlotsRecursive(vector<Block> &blocks, int &nextSlot)
+    {
+        for (Block &block : blocks)
+        {
+            if (block.opcode == BlockTypeEnum::REPEAT_BASIC || block.opcode == BlockTypeEnum::REPEAT_WHILE_TRUE)
+            {
+                block.loopSlot = nextSlot++;
+            }
+            for (Script &inner : block.statementScripts)
+            {
+                assignLoopSlotsRecursive(inner.blocks, nextSlot);
+            }
+        }
+    }
+} // namespace
+
+BlockEffect classifyBlockEffect(BlockTypeEnum type)
+{
+    switch (type)
+    {
+    // 입력값만으로 결과가 정해지는 리포터
+    case BlockTypeEnum::NUMBER:
+    case BlockTypeEnum::TEXT:
+    case BlockTypeEnum::TEXT_COLOR:
+    case BlockTypeEnum::ANGLE:
+    case BlockTypeEnum::GET_PICTURES:
+    case BlockTypeEnum::GET_SOUNDS:
+    case BlockTypeEnum::TEXT_REPORTER_NUMBER:
+    case BlockTypeEnum::TEXT_REPORTER_STRING:
+    case BlockTypeEnum::CALC_BASIC:
+    case BlockTypeEnum::CALC_OPERATION:
+    case BlockTypeEnum::QUOTIENT_AND_MOD:
+    case BlockTypeEnum::LENGTH_OF_STRING:
+    case BlockTypeEnum::REVERSE_OF_STRING:
+    case BlockTypeEnum::COMBINE_SOMETHING:
+    case BlockTypeEnum::CHAR_AT:
+    case BlockTypeEnum::SUBSTRING:
+    case BlockTypeEnum::COUNT_MATCH_STRING:
+    case BlockTypeEnum::INDEX_OF_STRING:
+    case BlockTypeEnum::REPLACE_STRING:
+    case BlockTypeEnum::CHANGE_STRING_CASE:
+    case BlockTypeEnum::CHANGE_RGB_TO_HEX:
+    case BlockTypeEnum::CHANGE_HEX_TO_RGB:
+    case BlockTypeEnum::GET_BOOLEAN_VALUE:
+    case BlockTypeEnum::IS_TYPE:
+    case BlockTypeEnum::BOOLEAN_BASIC_OPERATOR:
+    case BlockTypeEnum::BOOLEAN_AND_OR:
+    case BlockTypeEnum::BOOLEAN_NOT:
+    case BlockTypeEnum::FUNCTION_PARAM:
+        return BlockEffect::PURE;
+
+    // 시간/입력/변수/다른 엔티티를 읽는 리포터
+    case BlockTypeEnum::CALC_RAND:
+    case BlockTypeEnum::COORDINATE_MOUSE:
+    case BlockTypeEnum::COORDINATE_OBJECT:
+    case BlockTypeEnum::GET_PROJECT_TIMER_VALUE:
+    case BlockTypeEnum::GET_DATE:
+    case BlockTypeEnum::DISTANCE_SOMETHING:
+    case BlockTypeEnum::GET_BLOCK_COUNT:
+    case BlockTypeEnum::GET_USER_NAME:
+    case BlockTypeEnum::GET_NICKNAME:
+    case BlockTypeEnum::GET_SOUND_VOLUME:
+    case BlockTypeEnum::GET_SOUND_SPEED:
+    case BlockTypeEnum::GET_SOUND_DURATION:
+    case BlockTypeEnum::GET_CANVAS_INPUT_VALUE:
+    case BlockTypeEnum::LENGTH_OF_LIST:
+    case BlockTypeEnum::IS_INCLUDED_IN_LIST:
+    case BlockTypeEnum::IS_TOUCH_SUPPORTED:
+    case BlockTypeEnum::TEXT_READ:
+    case BlockTypeEnum::GET_VARIABLE:
+    case BlockTypeEnum::VALUE_OF_INDEX_FROM_LIST:
+    case BlockTypeEnum::IS_CLICKED:
+    case BlockTypeEnum::IS_OBJECT_CLICKED_JUDGE:
+    case BlockTypeEnum::IS_KEY_PRESSED_JUDGE:
+    case BlockTypeEnum::REACH_SOMETHING:
+    case BlockTypeEnum::IS_BOOST_MODE:
+    case BlockTypeEnum::IS_CURRENT_DEVICE_TYPE:
+    case BlockTypeEnum::GET_FUNC_VARIABLE:
+    // 대기를 걸지 않는 명령 블록
+    case BlockTypeEnum::MOVE_DIRECTION:
+    case BlockTypeEnum::BOUNCE_WALL:
+    case BlockTypeEnum::MOVE_X:
+    case BlockTypeEnum::MOVE_Y:
+    case BlockTypeEnum::LOCATE_X:
+    case BlockTypeEnum::LOCATE_Y:
+    case BlockTypeEnum::LOCATE_XY:
+    case BlockTypeEnum::LOCATE:
+    case BlockTypeEnum::ROTATE_RELATIVE:
+    case BlockTypeEnum::DIRECTION_RELATIVE:
+    case BlockTypeEnum::ROTATE_ABSOLUTE:
+    case BlockTypeEnum::DIRECTION_ABSOLUTE:
+    case BlockTypeEnum::SEE_ANGLE_OBJECT:
+    case BlockTypeEnum::MOVE_TO_ANGLE:
+    case BlockTypeEnum::CHOOSE_PROJECT_TIMER_ACTION:
+    case BlockTypeEnum::SET_VISIBLE_PROJECT_TIMER:
+    case BlockTypeEnum::SHOW:
+    case BlockTypeEnum::HIDE:
+    case BlockTypeEnum::DIALOG_TIME:
+    case BlockTypeEnum::DIALOG:
+    case BlockTypeEnum::REMOVE_DIALOG:
+    case BlockTypeEnum::CHANGE_TO_SOME_SHAPE:
+    case BlockTypeEnum::CHANGE_TO_NEXT_SHAPE:
+    case BlockTypeEnum::ADD_EFFECT_AMOUNT:
+    case BlockTypeEnum::CHANGE_EFFECT_AMOUNT:
+    case BlockTypeEnum::ERASE_ALL_EFFECTS:
+    case BlockTypeEnum::CHANGE_SCALE_SIZE:
+    case BlockTypeEnum::SET_SCALE_SIZE:
+    case BlockTypeEnum::STRETCH_SCALE_SIZE:
+    case BlockTypeEnum::RESET_SCALE_SIZE:
+    case BlockTypeEnum::FLIP_X:
+    case BlockTypeEnum::FLIP_Y:
+    case BlockTypeEnum::CHANGE_OBJECT_INDEX:
+    case BlockTypeEnum::SOUND_SOMETHING_WITH_BLOCK:
+    case BlockTypeEnum::SOUND_SOMETHING_SECOND_WITH_BLOCK:
+    case BlockTypeEnum::SOUND_FROM_TO:
+    case BlockTypeEnum::SOUND_VOLUME_CHANGE:
+    case BlockTypeEnum::SOUND_VOLUME_SET:
+    case BlockTypeEnum::SOUND_SPEED_CHANGE:
+    case BlockTypeEnum::SOUND_SPEED_SET:
+    case BlockTypeEnum::SOUND_SILENT_ALL:
+    case BlockTypeEnum::PLAY_BGM:
+    case BlockTypeEnum::STOP_BGM:
+    case BlockTypeEnum::MESSAGE_CAST_ACTION:
+    case BlockTypeEnum::SET_VISIBLE_ANSWER:
+    case BlockTypeEnum::CHANGE_VARIABLE:
+    case BlockTypeEnum::SET_VARIABLE:
+    case BlockTypeEnum::SHOW_VARIABLE:
+    case BlockTypeEnum::HIDE_VARIABLE:
+    case BlockTypeEnum::ADD_VALUE_TO_LIST:
+    case BlockTypeEnum::REMOVE_VALUE_FROM_LIST:
+    case BlockTypeEnum::INSERT_VALUE_TO_LIST:
+    case BlockTypeEnum::CHANGE_VALUE_LIST_INDEX:
+    case BlockTypeEnum::SHOW_LIST:
+    case BlockTypeEnum::HIDE_LIST:
+    case BlockTypeEnum::CREATE_CLONE:
+    case BlockTypeEnum::TEXT_WRITE:
+    case BlockTypeEnum::TEXT_APPEND:
+    case BlockTypeEnum::TEXT_PREPEND:
+    case BlockTypeEnum::TEXT_SET_FONT_COLOR:
+    case BlockTypeEnum::TEXT_SET_BG_COLOR:
+    case BlockTypeEnum::TEXT_CHANGE_EFFECT:
+    case BlockTypeEnum::_IF:
+    case BlockTypeEnum::IF_ELSE:
+        return BlockEffect::SIDE_EFFECT;
+
+    // ~동안 움직이기/소리 재생 후 기다리기/묻고 기다리기/반복/장면 전환/멈추기/복제본 삭제, 사용자 함수 호출 등
+    default:
+        return BlockEffect::YIELDS;
+    }
+}
+
+BlockEffect analyzeBlockEffect(const Block &block)
+{
+    BlockEffect effect = classifyBlockEffect(block.opcode);
+    for (const Operand &param : block.params)
+    {
+        if (effect == BlockEffect::YIELDS)
+            return effect;
+        if (param.kind == Operand::Kind::REPORTER && param.block)
+            effect = max(effect, analyzeBlockEffect(*param.block));
+    }
+    for (const Script &inner : block.statementScripts)
+    {
+        for (const Block &innerBlock : inner.blocks)
+        {
+            if (effect == BlockEffect::YIELDS)
+                return effect;
+            effect = max(effect, analyzeBlockEffect(innerBlock));
+        }
+    }
+    return effect;
+}
+
+WaitDependencies analyzeWaitDependencies(const Operand &condition)
+{
+    WaitDependencies dependencies;
+    if (condition.kind != Operand::Kind::REPORTER || !condition.block)
+        return dependencies; // 리터럴 조건은 바뀌지 않습니다.
+    const Block &block = *condition.block;
+    switch (block.opcode)
+    {
+    case BlockTypeEnum::GET_VARIABLE:
+    case BlockTypeEnum::VALUE_OF_INDEX_FROM_LIST:
+    case BlockTypeEnum::LENGTH_OF_LIST:
+    case BlockTypeEnum::IS_INCLUDED_IN_LIST:
+    {
+        // 변수/리스트 ID 는 문자열 드롭다운입니다. 찾지 못하면 모든 변수에 반응합니다.
+        uint64_t buckets = 0;
+        for (const Operand &param : block.params)
+        {
+            if (param.isString() && !param.value.stringValue().empty())
+                buckets |= uint64_t{1} << Engine::conditionVariableBucket(param.value.stringValue());
+        }
+        dependencies.variableBuckets |= buckets != 0 ? buckets : ~uint64_t{0};
+        break;
+    }
+    case BlockTypeEnum::IS_KEY_PRESSED_JUDGE:
+    case BlockTypeEnum::GET_CANVAS_INPUT_VALUE:
+        dependencies.sources |= kWaitOnKeyboard;
+        break;
+    case BlockTypeEnum::COORDINATE_MOUSE:
+    case BlockTypeEnum::IS_CLICKED:
+        dependencies.sources |= kWaitOnMouse;
+        break;
+    case BlockTypeEnum::IS_OBJECT_CLICKED_JUDGE:
+        dependencies.sources |= kWaitOnMouse | kWaitOnEntity;
+        break;
+    case BlockTypeEnum::COORDINATE_OBJECT:
+    case BlockTypeEnum::DISTANCE_SOMETHING:
+    case BlockTypeEnum::REACH_SOMETHING:
+    case BlockTypeEnum::TEXT_READ:
+    case BlockTypeEnum::GET_BLOCK_COUNT:
+        dependencies.sources |= kWaitOnEntity;
+        break;
+    // 실행 중에 바뀌지 않는 값
+    case BlockTypeEnum::IS_BOOST_MODE:
+    case BlockTypeEnum::IS_TOUCH_SUPPORTED:
+    case BlockTypeEnum::IS_CURRENT_DEVICE_TYPE:
+    case BlockTypeEnum::GET_USER_NAME:
+    case BlockTypeEnum::GET_NICKNAME:
+        break;
+    default:
+        // 계산 블록은 입력값만 따라갑니다. 시간/난수/소리/사용자 함수 등은 매 프레임 다시 평가합니다.
+        if (classifyBlockEffect(block.opcode) != BlockEffect::PURE)
+            dependencies.sources |= kWaitPolls;
+        break;
+    }
+    for (const Operand &param : block.params)
+    {
+        WaitDependencies inner = analyzeWaitDependencies(param);
+        dependencies.variableBuckets |= inner.variableBuckets;
+        dependencies.sources |= inner.sources;
+    }
+    return dependencies;
+}
+
+namespace
+{
+    bool blockUsesSharedState(const Block &block, const function<bool(const Block &)> &calleeUsesSharedState)
+    {
+        switch (block.opcode)
+        {
+        case BlockTypeEnum::GET_VARIABLE:
+        case BlockTypeEnum::SET_VARIABLE:
+        case BlockTypeEnum::CHANGE_VARIABLE:
+        case BlockTypeEnum::SHOW_VARIABLE:
+        case BlockTypeEnum::HIDE_VARIABLE:
+        case BlockTypeEnum::VALUE_OF_INDEX_FROM_LIST:
+        case BlockTypeEnum::LENGTH_OF_LIST:
+        case BlockTypeEnum::IS_INCLUDED_IN_LIST:
+        case BlockTypeEnum::ADD_VALUE_TO_LIST:
+        case BlockTypeEnum::REMOVE_VALUE_FROM_LIST:
+        case BlockTypeEnum::INSERT_VALUE_TO_LIST:
+        case BlockTypeEnum::CHANGE_VALUE_LIST_INDEX:
+        case BlockTypeEnum::SHOW_LIST:
+        case BlockTypeEnum::HIDE_LIST:
+        case BlockTypeEnum::ASK_AND_WAIT:
+        case BlockTypeEnum::GET_CANVAS_INPUT_VALUE:
+        case BlockTypeEnum::SET_VISIBLE_ANSWER:
+        case BlockTypeEnum::GET_PROJECT_TIMER_VALUE:
+        case BlockTypeEnum::CHOOSE_PROJECT_TIMER_ACTION:
+        case BlockTypeEnum::SET_VISIBLE_PROJECT_TIMER:
+        case BlockTypeEnum::GET_SOUND_VOLUME:
+        case BlockTypeEnum::GET_SOUND_SPEED:
+        case BlockTypeEnum::SOUND_VOLUME_CHANGE:
+        case BlockTypeEnum::SOUND_VOLUME_SET:
+        case BlockTypeEnum::SOUND_SPEED_CHANGE:
+        case BlockTypeEnum::SOUND_SPEED_SET:
+        case BlockTypeEnum::SOUND_SILENT_ALL:
+        case BlockTypeEnum::PLAY_BGM:
+        case BlockTypeEnum::STOP_BGM:
+        case BlockTypeEnum::MESSAGE_CAST_ACTION:
+            return true;
+        case BlockTypeEnum::FUNCTION_CALL:
+            if (calleeUsesSharedState(block))
+                return true;
+            break;
+        default:
+            break;
+        }
+        for (const Operand &param : block.params)
+        {
+            if (param.kind == Operand::Kind::REPORTER && param.block &&
+                blockUsesSharedState(*param.block, calleeUsesSharedState))
+                return true;
+        }
+        for (const Script &inner : block.statementScripts)
+        {
+            for (const Block &innerBlock : inner.blocks)
+            {
+                if (blockUsesSharedState(innerBlock, calleeUsesSharedState))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool exprMayYield(const ScriptProgram &program, uint32_t exprIndex)
+    {
+        const CompiledExpr &expr = program.exprs[exprIndex];
+        for (uint32_t i = expr.firstInstr; i < expr.firstInstr + expr.instrCount; ++i)
+        {
+            const ExprInstr &instr = program.exprCode[i];
+            if (instr.op != ExprOp::EVAL_OPERAND)
+                continue;
+            const Operand &operand = program.operands[instr.operand];
+            if (operand.kind == Operand::Kind::REPORTER && operand.block &&
+                analyzeBlockEffect(*operand.block) == BlockEffect::YIELDS)
+                return true;
+        }
+        return false;
+    }
+
+    // 명령이 대기를 걸거나 스크립트/장면을 멈출 수 없으면 true
+    bool isYieldFree(const ScriptProgram &program, const VmInstr &instr)
+    {
+        switch (instr.op)
+        {
+        case VmOp::EXEC:
+            return analyzeBlockEffect(program.blocks[instr.block]) != BlockEffect::YIELDS;
+        case VmOp::JUMP_IF_FALSE:
+        case VmOp::JUMP_IF_TRUE:
+        case VmOp::LOOP_INIT:
+        case VmOp::MOVE_BOUNCE:
+        case VmOp::CHANGE_VAR:
+        case VmOp::SET_LOCAL:
+        case VmOp::CHANGE_LOCAL:
+            return !exprMayYield(program, instr.a);
+        case VmOp::LOCATE_XY:
+            return !exprMayYield(program, instr.a) && !exprMayYield(program, instr.b);
+        case VmOp::LOOP_TEST:
+        case VmOp::MOVE_BOUNCE_CONST:
+        case VmOp::LOCATE_XY_CONST:
+        case VmOp::CHANGE_VAR_CONST:
+        case VmOp::JUMP_IF_NOT_REACH:
+            return true;
+        default:
+            return false; // 양보, 호출, 무조건 점프
+        }
+    }
+
+    /**
+     * @brief 대기 없는 명령이 이어지는 직선 구간을 찾아 플래그를 지정합니다.
+     * 구간의 첫 명령(점프 대상 포함)만 실행 전 확인을 하고, 대기 없는 명령은 실행 후 대기 상태 확인을 생략합니다.
+     */
+    void markYieldFreeRegions(ScriptProgram &program)
+    {
+        vector<bool> isJumpTarget(program.code.size() + 1, false);
+        for (const VmInstr &instr : program.code)
+        {
+            switch (instr.op)
+            {
+            case VmOp::JUMP:
+            case VmOp::YIELD_JUMP:
+                isJumpTarget[instr.a] = true;
+                break;
+            case VmOp::JUMP_IF_FALSE:
+            case VmOp::JUMP_IF_TRUE:
+            case VmOp::LOOP_TEST:
+            case VmOp::LOOP_NEXT:
+            case VmOp::JUMP_IF_NOT_REACH:
+                isJumpTarget[instr.b] = true;
+                break;
+            default:
+                break;
+            }
+        }
+        bool previousYieldFree = false;
+        for (size_t i = 0; i < program.code.size(); ++i)
+        {
+            VmInstr &instr = program.code[i];
+            bool yieldFree = isYieldFree(program, instr);
+            instr.flags = 0;
+            if (yieldFree)
+                instr.flags |= kVmInstrNoWait;
+            if (previousYieldFree && !isJumpTarget[i])
+                instr.flags |= kVmInstrUnguarded;
+            previousYieldFree = yieldFree;
+        }
+    }
+} // namespace
+
+bool analyzeSharedState(const Script &script, const function<bool(const Block &)> &calleeUsesSharedState)
+{
+    for (const Block &block : script.blocks)
+    {
+        if (blockUsesSharedState(block, calleeUsesSharedState))
+            return true;
+    }
+    return false;
+}
+
+bool analyzeSharedState(const Block &block, const function<bool(const Block &)> &calleeUsesSharedState)
+{
+    return blockUsesSharedState(block, calleeUsesSharedState);
+}
+
+int assignLoopSlots(Script &script)
+{
+    int nextSlot = 0;
+    assignLoopSlotsRecursive(script.blocks, nextSlot);
+    script.treeLoopSlotCount = nextSlot;
+    return nextSlot;
+}
+
+shared_ptr<const ScriptProgram> compileScript(Engine &engine, const string &, const Script &script)
+{
+    if (script.blocks.size() <= 1)
+    {
+        return nullptr;
+    }
+    auto program = make_shared<ScriptProgram>();
+    ScriptCompilerImpl compiler(*program, engine, nullptr);
+    compiler.compileTopLevel(script.blocks);
+    markYieldFreeRegions(*program);
+    attachAotRegions(*program);
+    return program;
+}
+
+void compileUserFunction(Engine &engine, UserFunction &function)
+{
+    // 본문이 비어 있어도 호출할 수 있도록 항상 프로그램을 만듭니다.
+    auto program = make_shared<ScriptProgram>();
+    ScriptCompilerImpl compiler(*program, engine, &function);
+    compiler.compileTopLevel(function.body.blocks);
+    if (function.returnsValue)
+    {
+        function.returnExpr = compiler.compileValue(function.returnValue);
+    }
+    markYieldFreeRegions(*program);
+    attachAotRegions(*program);
+    function.body.program = std::move(program);
+}
+
+FunctionArgsView &currentFunctionArgs()
+{
+    thread_local FunctionArgsView view;
+    return view;
+}
+
+OperandValue *FunctionArgsView::get(int index) const
+{
+    if (!function || !values || index < 0 || index >= static_cast<int>(function->frameSlotCount()))
+    {
+        return nullptr;
+    }
+    return &(*values)[base + index];
+}
+
+OperandValue evaluateCompiledExpr(Engine &engine, const string &objectId, const ScriptProgram &program,
+                                  uint32_t exprIndex, const string &executionThreadId)
+{
+    const CompiledExpr &expr = program.exprs[exprIndex];
+    if (expr.result & kExprConstFlag)
+    {
+        return program.constants[expr.result & ~kExprConstFlag];
+    }
+
+    // 리포터 안에서 다시 컴파일된 표현식을 평가할 수 있으므로 레지스터는 스택처럼 쌓았다가 되돌립니다.
+    thread_local vector<OperandValue> registerStack;
+    const size_t base = registerStack.size();
+    registerStack.resize(base + expr.registerCount);
+    struct StackRestore
+    {
+        vector<OperandValue> &stack;
+        size_t size;
+        ~StackRestore() { stack.resize(size); }
+    } restore{registerStack, base};
+
+    auto load = [&](uint16_t operand) -> const OperandValue & {
+        if (operand & kExprConstFlag)
+            return program.constants[operand & ~kExprConstFlag];
+        return registerStack[base + operand];
+    };
+
+    const uint32_t end = expr.firstInstr + expr.instrCount;
+    for (uint32_t i = expr.firstInstr; i < end; ++i)
+    {
+        const ExprInstr &instr = program.exprCode[i];
+        OperandValue result;
+        switch (instr.op)
+        {
+        case ExprOp::CALC:
+            result = applyCalcBasic(static_cast<CalcBasicOperator>(instr.sub), load(instr.lhs), load(instr.rhs),
+                                    program.blocks[instr.operand], objectId);
+            break;
+        case ExprOp::COMPARE:
+            result = applyCompare(static_cast<CompareOperator>(instr.sub), load(instr.lhs), load(instr.rhs));
+            break;
+        case ExprOp::LOGIC:
+            result = applyLogic(static_cast<LogicOperator>(instr.sub), load(instr.lhs), load(instr.rhs));
+            break;
+        case ExprOp::NOT:
+            result = OperandValue(!load(instr.lhs).asBool());
+            break;
+        case ExprOp::EVAL_OPERAND:
+            result = getOperandValue(engine, objectId, program.operands[instr.operand], executionThreadId);
+            break;
+        case ExprOp::LOAD_ARG:
+            if (const OperandValue *arg = currentFunctionArgs().get(static_cast<int>(instr.operand)))
+                result = *arg;
+            break;
+        case ExprOp::LOAD_VAR:
+            result = readVariable(engine, objectId, program.variables[instr.operand], executionThreadId);
+            break;
+        }
+        // 재진입으로 스택이 재할당될 수 있으므로 결과는 마지막에 기록합니다.
+        registerStack[base + instr.dst] = std::move(result);
+    }
+    return registerStack[base + expr.result];
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Block.h"
+#include "BlockExecutor.h"
+
+class Engine;
+
+/*
+ * 스크립트 바이트코드
+ *
+ * 로드 시 Script 의 블록 트리를 평탄한 명령 배열(ScriptProgram)로 한 번만 변환합니다.
+ * - 제어 블록(_if, if_else, repeat_*, wait_until_true, stop/continue_repeat)은 점프 명령으로 풀어서
+ *   매 프레임 statementScripts 를 다시 훑거나 loopCounters 맵을 조회하지 않습니다.
+ * - 조건/반복 횟수 같은 표현식은 레지스터 기반 명령(ExprInstr)으로 컴파일되어
+ *   상수는 미리 계산되고, calc_basic / 비교 / 논리 연산은 Calculator 를 거치지 않고 바로 계산됩니다.
+ * - 사용자 함수 호출(func_*)은 CALL 명령으로 스레드의 호출 프레임을 쌓고 함수 본문 프로그램으로 이동합니다.
+ * - 자주 쓰이는 블록 조합(move_direction + bounce_wall, locate_xy, change_variable, reach_something 조건)은
+ *   결합 명령 하나로 바꿔 executeBlock 디스패치와 파라미터 재평가 없이 바로 실행합니다.
+ *   리터럴 피연산자는 *_CONST 명령으로 상수 테이블을 직접 읽습니다.
+ * - 상수 ID 로 읽고 바꾸는 변수는 VariableStore 참조로 미리 해석해 실행 중 ID 검색을 하지 않습니다.
+ * - 그 외 일반 블록은 EXEC 명령으로 기존 핸들러(executeBlock)에 그대로 위임합니다.
+ * - 컴파일 후 블록별 영향(BlockEffect)을 분석해 대기를 걸 수 없는 직선 구간을 표시하고,
+ *   VM 은 그 구간 안에서 블록마다 하던 종료 요청/장면/대기 상태 확인을 생략합니다.
+ */
+
+// 표현식 명령 피연산자의 최상위 비트가 켜져 있으면 레지스터가 아닌 상수 테이블 인덱스입니다.
+constexpr uint16_t kExprConstFlag = 0x8000;
+
+enum class ExprOp : uint8_t
+{
+    CALC,          // sub = CalcBasicOperator, operand = 오류 보고용 blocks 인덱스
+    COMPARE,       // sub = CompareOperator
+    LOGIC,         // sub = LogicOperator
+    NOT,           // lhs 만 사용
+    EVAL_OPERAND,  // operand = operands 인덱스, getOperandValue 로 위임 (리포터 블록은 Calculator 호출)
+    LOAD_ARG,      // operand = 현재 사용자 함수 호출 프레임의 자리 (인자, 그 뒤로 지역 변수)
+    LOAD_VAR       // operand = variables 인덱스 (get_variable, 로드 시 해석한 변수 참조로 바로 읽음)
+};
+
+struct ExprInstr
+{
+    ExprOp op = ExprOp::EVAL_OPERAND;
+    uint8_t sub = 0;
+    uint16_t dst = 0;
+    uint16_t lhs = 0;
+    uint16_t rhs = 0;
+    uint32_t operand = 0;
+};
+
+struct CompiledExpr
+{
+    uint32_t firstInstr = 0;
+    uint32_t instrCount = 0;
+    uint16_t result = 0;        // 레지스터 또는 상수 (kExprConstFlag)
+    uint16_t registerCount = 0;
+};
+
+enum class VmOp : uint8_t
+{
+    EXEC,          // blocks[block] 을 executeBlock 으로 실행
+    JUMP,          // pc = a
+    JUMP_IF_FALSE, // exprs[a] 가 거짓이면 pc = b
+    JUMP_IF_TRUE,  // exprs[a] 가 참이면 pc = b
+    LOOP_INIT,     // loopCounters[b] = floor(exprs[a])
+    LOOP_TEST,     // loopCounters[a] <= 0 이면 pc = b
+    LOOP_NEXT,     // loopCounters[a]--, 프레임 양보 후 pc = b
+    YIELD_JUMP,    // 프레임 양보 후 pc = a
+    WAIT_UNTIL,    // exprs[a] 가 참이 될 때까지 양보 (waitDependencies[b] 의 입력이 바뀔 때만 다시 평가)
+    CALL,          // calls[a] 의 사용자 함수를 호출 프레임을 쌓아 실행
+
+    // 결합 명령 (block 은 첫 번째 블록)
+    MOVE_BOUNCE,       // move_direction(exprs[a]) 후 bounce_wall
+    MOVE_BOUNCE_CONST, // move_direction(constants[a]) 후 bounce_wall
+    LOCATE_XY,         // locate_xy(exprs[a], exprs[b])
+    LOCATE_XY_CONST,   // locate_xy(constants[a], constants[b])
+    CHANGE_VAR,        // change_variable(변수 variables[b], exprs[a])
+    CHANGE_VAR_CONST,  // change_variable(변수 variables[b], constants[a])
+    SET_LOCAL,         // set_func_variable(호출 프레임 자리 b, exprs[a])
+    CHANGE_LOCAL,      // change_func_variable(호출 프레임 자리 b, exprs[a])
+    JUMP_IF_NOT_REACH  // reach_something(constants[a]) 가 거짓이면 pc = b
+};
+
+// VmInstr::flags (로드 시 정적 분석이 지정)
+constexpr uint8_t kVmInstrNoWait = 1 << 0;    // 대기를 걸거나 스크립트를 멈출 수 없는 명령: 실행 후 대기 상태 확인 생략
+constexpr uint8_t kVmInstrUnguarded = 1 << 1; // 대기 없는 직선 구간의 중간: 실행 전 종료 요청/장면/엔진 종료 확인 생략
+
+struct VmInstr
+{
+    VmOp op = VmOp::EXEC;
+    uint8_t flags = 0;
+    uint32_t a = 0;
+    uint32_t b = 0;
+    uint32_t block = 0;         // 로그/오류 보고에 사용할 blocks 인덱스
+    uint32_t topLevelIndex = 0; // 이 명령이 속한 최상위 Script::blocks 인덱스 (디버거 표시/재개 게이트용)
+};
+
+// 사용자 함수 호출 지점. 인자 표현식은 exprs[firstArg] 부터 argCount 개가 연속으로 놓입니다.
+struct CallSite
+{
+    uint32_t function = 0; // Engine 의 사용자 함수 인덱스
+    uint32_t firstArg = 0;
+    uint32_t argCount = 0;
+};
+
+// WaitDependencies::sources
+constexpr uint8_t kWaitOnKeyboard = 1 << 0; // 키 상태, 대답
+constexpr uint8_t kWaitOnMouse = 1 << 1;    // 마우스 좌표/클릭
+constexpr uint8_t kWaitOnEntity = 1 << 2;   // 엔티티 속성, 충돌, 복제본/장면 (마우스 드래그로도 바뀜)
+constexpr uint8_t kWaitPolls = 1 << 3;      // 시간/난수/소리처럼 입력 없이 바뀌거나 분석할 수 없음: 매 프레임 다시 평가
+
+/**
+ * @brief wait_until_true 조건이 읽는 입력 (로드 시 분석)
+ * 기다리는 스레드는 이 입력 중 하나가 바뀔 때까지 잠들고, kWaitPolls 가 있으면 예전처럼 매 프레임 다시 평가합니다.
+ */
+struct WaitDependencies
+{
+    uint64_t variableBuckets = 0; // 읽는 변수/리스트 ID 의 해시 버킷 (Engine::conditionVariableBucket)
+    uint8_t sources = 0;
+};
+
+struct AotRegionContext;
+// AOT 로 생성된 구간 함수. 구간을 실행하고 다음 pc 를 반환합니다. (AotCompiler.h)
+using AotRegionFn = uint32_t (*)(AotRegionContext &ctx);
+
+struct ScriptProgram
+{
+    std::vector<VmInstr> code;
+    std::vector<ExprInstr> exprCode;
+    std::vector<CompiledExpr> exprs;
+    std::vector<OperandValue> constants;
+    std::vector<Block> blocks;                // 프로그램이 소유하는 블록 사본 (풀어낸 제어 블록은 statement 없이 보관)
+    std::vector<Operand> operands;            // 직접 계산하지 않는 파라미터 (getOperandValue 로 평가)
+    std::vector<CallSite> calls;
+    std::vector<WaitDependencies> waitDependencies; // WAIT_UNTIL 의 b
+    std::vector<VariableStore::Ref> variables; // 로드 시 해석한 변수 참조 (LOAD_VAR, CHANGE_VAR)
+    uint32_t loopSlotCount = 0;
+    std::vector<AotRegionFn> nativeRegions;   // AOT 구간 시작 pc -> 구간 함수 (연결된 AOT 코드가 없으면 비어 있음)
+};
+
+/**
+ * @brief 블록 실행이 미치는 영향 (로드 시 정적 분석용). 뒤에 오는 값일수록 제약이 큽니다.
+ */
+enum class BlockEffect : uint8_t
+{
+    PURE,        // 대기 없음, 시간/입력/변수/다른 엔티티를 읽지 않음 (리터럴, 산술, 문자열 연산)
+    SIDE_EFFECT, // 대기 없음, 상태를 바꾸거나 바깥 상태를 읽음
+    YIELDS       // 대기를 걸거나 스크립트/장면을 멈출 수 있음 (분류되지 않은 블록 포함)
+};
+
+// opcode 만 보고 분류합니다.
+BlockEffect classifyBlockEffect(Omocha::BlockTypeEnum type);
+// 파라미터의 리포터 블록과 statement 안의 블록까지 포함해 분류합니다.
+BlockEffect analyzeBlockEffect(const Block &block);
+// 조건 파라미터가 읽는 입력을 리포터 블록까지 따라가며 모읍니다.
+WaitDependencies analyzeWaitDependencies(const Operand &condition);
+
+/**
+ * @brief 스크립트가 엔진 전체가 함께 쓰는 상태를 읽거나 바꾸면 true (파라미터의 리포터 블록과 statement 안의 블록 포함)
+ * 변수/리스트, 대답, 프로젝트 타이머, 전체 소리 설정, 신호 보내기가 해당합니다.
+ * 이런 스크립트는 Engine::runScriptFrame 이 한 샤드에 모아 정렬 순서대로 실행합니다.
+ * 사용자 함수 호출 블록은 calleeUsesSharedState 로 판단합니다.
+ */
+bool analyzeSharedState(const Script &script, const std::function<bool(const Block &callBlock)> &calleeUsesSharedState);
+bool analyzeSharedState(const Block &block, const std::function<bool(const Block &callBlock)> &calleeUsesSharedState);
+
+/**
+ * @brief 트리 인터프리터가 실행하는 반복 블록(repeat_basic, repeat_while_true)에 스크립트 안에서 고유한 loopSlot 을 지정합니다.
+ * 슬롯은 스크립트/함수 본문마다 0 부터 매기고, 실행 시 호출 프레임의 treeLoopBase 를 더해 씁니다.
+ * compileScript / compileUserFunction 전에 호출해야 EXEC 블록 사본에도 슬롯이 남습니다.
+ * @return 사용한 슬롯 수
+ */
+int assignLoopSlots(Script &script);
+
+/**
+ * @brief Script 를 바이트코드로 컴파일합니다. 실행할 블록이 없으면 nullptr 를 반환합니다.
+ * 파라미터는 로드 시 이미 Operand 로 해석되어 있으므로 리터럴은 그대로 상수 테이블로 옮겨집니다.
+ */
+std::shared_ptr<const ScriptProgram> compileScript(Engine &engine, const std::string &objectId, const Script &script);
+
+/**
+ * @brief 사용자 함수 본문(function.body)과 결과값 표현식을 컴파일합니다.
+ * 본문 안의 파라미터/지역 변수 리포터는 호출 프레임의 자리를 바로 읽는 LOAD_ARG 로,
+ * 지역 변수 정하기/더하기는 SET_LOCAL/CHANGE_LOCAL 로 바뀝니다.
+ */
+void compileUserFunction(Engine &engine, UserFunction &function);
+
+/**
+ * @brief 현재 스레드가 실행 중인 사용자 함수 호출의 인자와 지역 변수
+ * VM 이 호출 프레임을 바꿀 때 갱신하며, LOAD_ARG/SET_LOCAL 과 Calculator 의 파라미터/지역 변수 블록이 사용합니다.
+ * 함수 밖에서는 function 이 nullptr 입니다.
+ */
+struct FunctionArgsView
+{
+    const UserFunction *function = nullptr;
+    std::vector<OperandValue> *values = nullptr;
+    uint32_t base = 0;
+
+    // 프레임의 index 번째 자리 (UserFunction::paramIndex / localVariableSlot). 범위를 벗어나면 nullptr
+    OperandValue *get(int index) const;
+};
+FunctionArgsView &currentFunctionArgs();
+
+/**
+ * @brief 컴파일된 표현식을 평가합니다. 재진입 가능하도록 스레드별 레지스터 스택을 사용합니다.
+ */
+OperandValue evaluateCompiledExpr(Engine &engine, const std::string &objectId, const ScriptProgram &program,
+                                  uint32_t exprIndex, const std::string &executionThreadId);
@@ -56,6 +56,8 @@ BlockTypeEnum stringToBlockTypeEnum(const std::string& typeStr) {
         {"get_canvas_input_value", BlockTypeEnum::GET_CANVAS_INPUT_VALUE},
         {"length_of_list", BlockTypeEnum::LENGTH_OF_LIST},
         {"is_included_in_list", BlockTypeEnum::IS_INCLUDED_IN_LIST},
+        {"is_touch_supported", BlockTypeEnum::IS_TOUCH_SUPPORTED},
+        {"text_read", BlockTypeEnum::TEXT_READ},
         {"show", BlockTypeEnum::SHOW},
         {"hide", BlockTypeEnum::HIDE},
         {"dialog_time", BlockTypeEnum::DIALOG_TIME},
@@ -85,6 +87,7 @@ BlockTypeEnum stringToBlockTypeEnum(const std::string& typeStr) {
         {"sound_speed_set", BlockTypeEnum::SOUND_SPEED_SET},
         {"sound_silent_all", BlockTypeEnum::SOUND_SILENT_ALL},
         {"play_bgm", BlockTypeEnum::PLAY_BGM},
+        {"stop_bgm", BlockTypeEnum::STOP_BGM},
         {"when_run_button_click", BlockTypeEnum::WHEN_RUN_BUTTON_CLICK},
         {"when_some_key_pressed", BlockTypeEnum::WHEN_SOME_KEY_PRESSED},
         {"mouse_clicked", BlockTypeEnum::MOUSE_CLICKED},
@@ -99,6 +102,11 @@ BlockTypeEnum stringToBlockTypeEnum(const std::string& typeStr) {
         {"get_pictures", BlockTypeEnum::GET_PICTURES },
         {"text_reporter_number", BlockTypeEnum::TEXT_REPORTER_NUMBER },
         {"text_reporter_string", BlockTypeEnum::TEXT_REPORTER_STRING },
+        {"number", BlockTypeEnum::NUMBER },
+        {"text", BlockTypeEnum::TEXT },
+        {"text_color", BlockTypeEnum::TEXT_COLOR },
+        {"get_sounds", BlockTypeEnum::GET_SOUNDS },
+        {"angle", BlockTypeEnum::ANGLE },
         {"get_variable", BlockTypeEnum::GET_VARIABLE},
         {"value_of_index_from_list", BlockTypeEnum::VALUE_OF_INDEX_FROM_LIST},
         {"set_visible_answer", BlockTypeEnum::SET_VISIBLE_ANSWER},
@@ -126,6 +134,9 @@ BlockTypeEnum stringToBlockTypeEnum(const std::string& typeStr) {
         {"stop_object", BlockTypeEnum::STOP_OBJECT}, // Added
         {"restart_project", BlockTypeEnum::RESTART_PROJECT}, // Added
         {"when_clone_start", BlockTypeEnum::WHEN_CLONE_START}, // Added
+        {"create_clone", BlockTypeEnum::CREATE_CLONE},
+        {"delete_clone", BlockTypeEnum::DELETE_CLONE},
+        {"remove_all_clones", BlockTypeEnum::REMOVE_ALL_CLONES},
         {"is_clicked", BlockTypeEnum::IS_CLICKED}, // 일반 마우스 클릭 판단
         {"is_object_clicked", BlockTypeEnum::IS_OBJECT_CLICKED_JUDGE}, // 특정 오브젝트 클릭 판단
         {"is_press_some_key", BlockTypeEnum::IS_KEY_PRESSED_JUDGE},     // 특정 키 눌림 판단
@@ -137,13 +148,27 @@ BlockTypeEnum stringToBlockTypeEnum(const std::string& typeStr) {
         {"is_boost_mode", BlockTypeEnum::IS_BOOST_MODE}, // 부스트 모드인가?
         {"is_current_device_type", BlockTypeEnum::IS_CURRENT_DEVICE_TYPE},
         // TextBox specific
+        {"text_write", BlockTypeEnum::TEXT_WRITE},
+        {"text_append", BlockTypeEnum::TEXT_APPEND},
+        {"text_prepend", BlockTypeEnum::TEXT_PREPEND},
         {"text_change_font_color", BlockTypeEnum::TEXT_SET_FONT_COLOR},
-        {"text_change_bg_color", BlockTypeEnum::TEXT_SET_BG_COLOR}
+        {"text_change_bg_color", BlockTypeEnum::TEXT_SET_BG_COLOR},
+        {"text_change_effect", BlockTypeEnum::TEXT_CHANGE_EFFECT},
+        // 함수 지역 변수
+        {"get_func_variable", BlockTypeEnum::GET_FUNC_VARIABLE},
+        {"set_func_variable", BlockTypeEnum::SET_FUNC_VARIABLE},
+        {"change_func_variable", BlockTypeEnum::CHANGE_FUNC_VARIABLE}
     };
     auto it = typeMap.find(typeStr);
     if (it != typeMap.end()) {
         return it->second;
     }
+    if (typeStr.starts_with("func_")) {
+        return BlockTypeEnum::FUNCTION_CALL;
+    }
+    if (typeStr.starts_with("stringParam_") || typeStr.starts_with("booleanParam_")) {
+        return BlockTypeEnum::FUNCTION_PARAM;
+    }
     return BlockTypeEnum::UNKNOWN;
 }
 
@@ -202,6 +227,8 @@ std::string blockTypeEnumToKoreanString(BlockTypeEnum type) {
         {BlockTypeEnum::GET_CANVAS_INPUT_VALUE, "대답 값"},
         {BlockTypeEnum::LENGTH_OF_LIST, "리스트의 항목 수"},
         {BlockTypeEnum::IS_INCLUDED_IN_LIST, "리스트에 항목이 포함되어 있는가"},
+        {BlockTypeEnum::IS_TOUCH_SUPPORTED, "터치 지원 여부"},
+        {BlockTypeEnum::TEXT_READ, "글상자 내용"},
         {BlockTypeEnum::SHOW, "모양 보이기"},
         {BlockTypeEnum::HIDE, "모양 숨기기"},
         {BlockTypeEnum::DIALOG_TIME, "~을 ~초 동안 말하기/생각하기"},
@@ -231,6 +258,7 @@ std::string blockTypeEnumToKoreanString(BlockTypeEnum type) {
         {BlockTypeEnum::SOUND_SPEED_SET, "소리 재생 속도를 ~로 정하기"},
         {BlockTypeEnum::SOUND_SILENT_ALL, "모든 소리 끄기"},
         {BlockTypeEnum::PLAY_BGM, "배경음악 재생하기"},
+        {BlockTypeEnum::STOP_BGM, "배경음악 끄기"},
         {BlockTypeEnum::WHEN_RUN_BUTTON_CLICK, "시작 버튼 클릭 시"},
         {BlockTypeEnum::WHEN_SOME_KEY_PRESSED, "키 눌렀을 때"},
         {BlockTypeEnum::MOUSE_CLICKED, "마우스 클릭 시"},
@@ -245,6 +273,11 @@ std::string blockTypeEnumToKoreanString(BlockTypeEnum type) {
         {BlockTypeEnum::GET_PICTURES, "모양 가져오기 (파라미터용)"},
         {BlockTypeEnum::TEXT_REPORTER_NUMBER, "숫자 입력 (파라미터용)"},
         {BlockTypeEnum::TEXT_REPORTER_STRING, "문자열 입력 (파라미터용)"},
+        {BlockTypeEnum::NUMBER, "숫자 (파라미터용)"},
+        {BlockTypeEnum::TEXT, "문자열 (파라미터용)"},
+        {BlockTypeEnum::TEXT_COLOR, "색상 (파라미터용)"},
+        {BlockTypeEnum::GET_SOUNDS, "소리 가져오기 (파라미터용)"},
+        {BlockTypeEnum::ANGLE, "각도 (파라미터용)"},
     {BlockTypeEnum::GET_VARIABLE, "변수 값 가져오기"},
     {BlockTypeEnum::VALUE_OF_INDEX_FROM_LIST, "리스트의 ~번째 항목 값"},
         // Flow
@@ -274,6 +307,9 @@ std::string blockTypeEnumToKoreanString(BlockTypeEnum type) {
         {BlockTypeEnum::STOP_OBJECT, "멈추기"}, // Added
         {BlockTypeEnum::RESTART_PROJECT, "다시 시작하기"}, // Added
         {BlockTypeEnum::WHEN_CLONE_START, "복제되었을 때"}, // Added
+        {BlockTypeEnum::CREATE_CLONE, "복제본 만들기"},
+        {BlockTypeEnum::DELETE_CLONE, "이 복제본 삭제하기"},
+        {BlockTypeEnum::REMOVE_ALL_CLONES, "모든 복제본 삭제하기"},
         {BlockTypeEnum::IS_CLICKED, "마우스를 클릭했는가?"}, // 일반 마우스 클릭
         {BlockTypeEnum::IS_OBJECT_CLICKED_JUDGE, "오브젝트를 클릭했는가?"}, // 특정 오브젝트 클릭
         {BlockTypeEnum::IS_KEY_PRESSED_JUDGE, "키가 눌려있는가?"},      // 특정 키 눌림 판단
@@ -285,8 +321,17 @@ std::string blockTypeEnumToKoreanString(BlockTypeEnum type) {
         {BlockTypeEnum::IS_BOOST_MODE, "부스트 모드인가?"}, // 부스트 모드인가?
         {BlockTypeEnum::IS_CURRENT_DEVICE_TYPE, "현재 장치 유형 확인"},
         // TextBox specific
+        {BlockTypeEnum::TEXT_WRITE, "글상자에 쓰기"},
+        {BlockTypeEnum::TEXT_APPEND, "글상자 뒤에 덧붙이기"},
+        {BlockTypeEnum::TEXT_PREPEND, "글상자 앞에 덧붙이기"},
         {BlockTypeEnum::TEXT_SET_FONT_COLOR, "글상자 글자색 바꾸기"},
-        {BlockTypeEnum::TEXT_SET_BG_COLOR, "글상자 배경색 바꾸기"}
+        {BlockTypeEnum::TEXT_SET_BG_COLOR, "글상자 배경색 바꾸기"},
+        {BlockTypeEnum::TEXT_CHANGE_EFFECT, "글상자 효과 바꾸기"},
+        {BlockTypeEnum::FUNCTION_CALL, "함수 호출"},
+        {BlockTypeEnum::FUNCTION_PARAM, "함수 파라미터"},
+        {BlockTypeEnum::GET_FUNC_VARIABLE, "함수 지역 변수 값"},
+        {BlockTypeEnum::SET_FUNC_VARIABLE, "함수 지역 변수 정하기"},
+        {BlockTypeEnum::CHANGE_FUNC_VARIABLE, "함수 지역 변수 더하기"}
     };
     auto it = koreanMap.find(type);
     if (it != koreanMap.end()) {
@@ -294,6 +339,166 @@ std::string blockTypeEnumToKoreanString(BlockTypeEnum type) {
     }
     return "알 수 없는 블록 타입";
 }
+
+BlockCategory blockTypeEnumToCategory(BlockTypeEnum type) {
+    switch (type) {
+        // Moving
+        case BlockTypeEnum::MOVE_DIRECTION:
+        case BlockTypeEnum::BOUNCE_WALL:
+        case BlockTypeEnum::MOVE_X:
+        case BlockTypeEnum::MOVE_Y:
+        case BlockTypeEnum::MOVE_XY_TIME:
+        case BlockTypeEnum::LOCATE_XY_TIME:
+        case BlockTypeEnum::LOCATE_X:
+        case BlockTypeEnum::LOCATE_Y:
+        case BlockTypeEnum::LOCATE_XY:
+        case BlockTypeEnum::LOCATE:
+        case BlockTypeEnum::LOCATE_OBJECT_TIME:
+        case BlockTypeEnum::ROTATE_RELATIVE:
+        case BlockTypeEnum::DIRECTION_RELATIVE:
+        case BlockTypeEnum::ROTATE_BY_TIME:
+        case BlockTypeEnum::DIRECTION_RELATIVE_DURATION:
+        case BlockTypeEnum::ROTATE_ABSOLUTE:
+        case BlockTypeEnum::DIRECTION_ABSOLUTE:
+        case BlockTypeEnum::SEE_ANGLE_OBJECT:
+        case BlockTypeEnum::MOVE_TO_ANGLE:
+            return BlockCategory::MOVING;
+        // Calculator (판단 블록 포함)
+        case BlockTypeEnum::CALC_BASIC:
+        case BlockTypeEnum::CALC_RAND:
+        case BlockTypeEnum::COORDINATE_MOUSE:
+        case BlockTypeEnum::COORDINATE_OBJECT:
+        case BlockTypeEnum::QUOTIENT_AND_MOD:
+        case BlockTypeEnum::CALC_OPERATION:
+        case BlockTypeEnum::GET_PROJECT_TIMER_VALUE:
+        case BlockTypeEnum::CHOOSE_PROJECT_TIMER_ACTION:
+        case BlockTypeEnum::SET_VISIBLE_PROJECT_TIMER:
+        case BlockTypeEnum::GET_DATE:
+        case BlockTypeEnum::DISTANCE_SOMETHING:
+        case BlockTypeEnum::LENGTH_OF_STRING:
+        case BlockTypeEnum::REVERSE_OF_STRING:
+        case BlockTypeEnum::COMBINE_SOMETHING:
+        case BlockTypeEnum::CHAR_AT:
+        case BlockTypeEnum::SUBSTRING:
+        case BlockTypeEnum::COUNT_MATCH_STRING:
+        case BlockTypeEnum::INDEX_OF_STRING:
+        case BlockTypeEnum::REPLACE_STRING:
+        case BlockTypeEnum::CHANGE_STRING_CASE:
+        case BlockTypeEnum::GET_BLOCK_COUNT:
+        case BlockTypeEnum::CHANGE_RGB_TO_HEX:
+        case BlockTypeEnum::CHANGE_HEX_TO_RGB:
+        case BlockTypeEnum::GET_BOOLEAN_VALUE:
+        case BlockTypeEnum::GET_USER_NAME:
+        case BlockTypeEnum::GET_NICKNAME:
+        case BlockTypeEnum::GET_SOUND_VOLUME:
+        case BlockTypeEnum::GET_SOUND_SPEED:
+        case BlockTypeEnum::GET_SOUND_DURATION:
+        case BlockTypeEnum::GET_CANVAS_INPUT_VALUE:
+        case BlockTypeEnum::LENGTH_OF_LIST:
+        case BlockTypeEnum::IS_INCLUDED_IN_LIST:
+        case BlockTypeEnum::IS_TOUCH_SUPPORTED:
+        case BlockTypeEnum::TEXT_READ:
+        case BlockTypeEnum::GET_VARIABLE:
+        case BlockTypeEnum::VALUE_OF_INDEX_FROM_LIST:
+        case BlockTypeEnum::IS_CLICKED:
+        case BlockTypeEnum::IS_OBJECT_CLICKED_JUDGE:
+        case BlockTypeEnum::IS_KEY_PRESSED_JUDGE:
+        case BlockTypeEnum::REACH_SOMETHING:
+        case BlockTypeEnum::IS_TYPE:
+        case BlockTypeEnum::BOOLEAN_BASIC_OPERATOR:
+        case BlockTypeEnum::BOOLEAN_AND_OR:
+        case BlockTypeEnum::BOOLEAN_NOT:
+        case BlockTypeEnum::IS_BOOST_MODE:
+        case BlockTypeEnum::IS_CURRENT_DEVICE_TYPE:
+        case BlockTypeEnum::FUNCTION_PARAM:
+        case BlockTypeEnum::GET_FUNC_VARIABLE:
+            return BlockCategory::CALCULATOR;
+        // Looks
+        case BlockTypeEnum::SHOW:
+        case BlockTypeEnum::HIDE:
+        case BlockTypeEnum::DIALOG_TIME:
+        case BlockTypeEnum::DIALOG:
+        case BlockTypeEnum::REMOVE_DIALOG:
+        case BlockTypeEnum::CHANGE_TO_SOME_SHAPE:
+        case BlockTypeEnum::CHANGE_TO_NEXT_SHAPE:
+        case BlockTypeEnum::ADD_EFFECT_AMOUNT:
+        case BlockTypeEnum::CHANGE_EFFECT_AMOUNT:
+        case BlockTypeEnum::ERASE_ALL_EFFECTS:
+        case BlockTypeEnum::CHANGE_SCALE_SIZE:
+        case BlockTypeEnum::SET_SCALE_SIZE:
+        case BlockTypeEnum::STRETCH_SCALE_SIZE:
+        case BlockTypeEnum::RESET_SCALE_SIZE:
+        case BlockTypeEnum::FLIP_X:
+        case BlockTypeEnum::FLIP_Y:
+        case BlockTypeEnum::CHANGE_OBJECT_INDEX:
+            return BlockCategory::LOOKS;
+        // Sound
+        case BlockTypeEnum::SOUND_SOMETHING_WITH_BLOCK:
+        case BlockTypeEnum::SOUND_SOMETHING_SECOND_WITH_BLOCK:
+        case BlockTypeEnum::SOUND_FROM_TO:
+        case BlockTypeEnum::SOUND_SOMETHING_WAIT_WITH_BLOCK:
+        case BlockTypeEnum::SOUND_SOMETHING_SECOND_WAIT_WITH_BLOCK:
+        case BlockTypeEnum::SOUND_FROM_TO_AND_WAIT:
+        case BlockTypeEnum::SOUND_VOLUME_CHANGE:
+        case BlockTypeEnum::SOUND_VOLUME_SET:
+        case BlockTypeEnum::SOUND_SPEED_CHANGE:
+        case BlockTypeEnum::SOUND_SPEED_SET:
+        case BlockTypeEnum::SOUND_SILENT_ALL:
+        case BlockTypeEnum::PLAY_BGM:
+        case BlockTypeEnum::STOP_BGM:
+            return BlockCategory::SOUND;
+        // Variable / List
+        case BlockTypeEnum::SET_VISIBLE_ANSWER:
+        case BlockTypeEnum::ASK_AND_WAIT:
+        case BlockTypeEnum::CHANGE_VARIABLE:
+        case BlockTypeEnum::SET_VARIABLE:
+        case BlockTypeEnum::SHOW_VARIABLE:
+        case BlockTypeEnum::HIDE_VARIABLE:
+        case BlockTypeEnum::ADD_VALUE_TO_LIST:
+        case BlockTypeEnum::REMOVE_VALUE_FROM_LIST:
+        case BlockTypeEnum::INSERT_VALUE_TO_LIST:
+        case BlockTypeEnum::CHANGE_VALUE_LIST_INDEX:
+        case BlockTypeEnum::SHOW_LIST:
+        case BlockTypeEnum::HIDE_LIST:
+            return BlockCategory::VARIABLE;
+        // Event (신호/장면)
+        case BlockTypeEnum::MESSAGE_CAST_ACTION:
+        case BlockTypeEnum::START_SCENE:
+        case BlockTypeEnum::START_NEIGHBOR_SCENE:
+            return BlockCategory::EVENT;
+        // Flow
+        case BlockTypeEnum::WAIT_SECOND:
+        case BlockTypeEnum::REPEAT_BASIC:
+        case BlockTypeEnum::REPEAT_INF:
+        case BlockTypeEnum::REPEAT_WHILE_TRUE:
+        case BlockTypeEnum::STOP_REPEAT:
+        case BlockTypeEnum::CONTINUE_REPEAT:
+        case BlockTypeEnum::_IF:
+        case BlockTypeEnum::IF_ELSE:
+        case BlockTypeEnum::WAIT_UNTIL_TRUE:
+        case BlockTypeEnum::STOP_OBJECT:
+        case BlockTypeEnum::RESTART_PROJECT:
+        case BlockTypeEnum::CREATE_CLONE:
+        case BlockTypeEnum::DELETE_CLONE:
+        case BlockTypeEnum::REMOVE_ALL_CLONES:
+            return BlockCategory::FLOW;
+        // TextBox
+        case BlockTypeEnum::TEXT_WRITE:
+        case BlockTypeEnum::TEXT_APPEND:
+        case BlockTypeEnum::TEXT_PREPEND:
+        case BlockTypeEnum::TEXT_SET_FONT_COLOR:
+        case BlockTypeEnum::TEXT_SET_BG_COLOR:
+        case BlockTypeEnum::TEXT_CHANGE_EFFECT:
+            return BlockCategory::TEXTBOX;
+        // 사용자 함수
+        case BlockTypeEnum::FUNCTION_CALL:
+        case BlockTypeEnum::SET_FUNC_VARIABLE:
+        case BlockTypeEnum::CHANGE_FUNC_VARIABLE:
+            return BlockCategory::FUNCTION;
+        default:
+            return BlockCategory::NONE;
+    }
+}
 ObjectIndexChangeType stringToObjectIndexChangeType(const std::string& typeStr) {
     if (typeStr == "FRONT") return ObjectIndexChangeType::BRING_TO_FRONT;
     if (typeStr == "FORWARD") return ObjectIndexChangeType::BRING_FORWARD;
@@ -71,6 +71,8 @@ namespace Omocha
         GET_CANVAS_INPUT_VALUE,  // New
         LENGTH_OF_LIST,          // New
         IS_INCLUDED_IN_LIST,     // New
+        IS_TOUCH_SUPPORTED,
+        TEXT_READ,
         // Looks
         SHOW,
         HIDE,
@@ -102,6 +104,7 @@ namespace Omocha
         SOUND_SPEED_SET,                        // New
         SOUND_SILENT_ALL,                       // New
         PLAY_BGM,                               // New
+        STOP_BGM,
         // Event Triggers (might not need Korean names in error messages if they are not "executed" in the same way)
         WHEN_RUN_BUTTON_CLICK,
         WHEN_SOME_KEY_PRESSED,
@@ -118,6 +121,11 @@ namespace Omocha
         GET_PICTURES,         // from getOperandValue
         TEXT_REPORTER_NUMBER, // from getOperandValue
         TEXT_REPORTER_STRING, // from getOperandValue
+        NUMBER,               // from getOperandValue
+        TEXT,                 // from getOperandValue
+        TEXT_COLOR,           // from getOperandValue
+        GET_SOUNDS,           // from getOperandValue
+        ANGLE,                // from getOperandValue
         GET_VARIABLE,             // To retrieve a variable's value
         VALUE_OF_INDEX_FROM_LIST, // 리스트의 특정 인덱스 값을 가져오는 블록
         // Variable/List specific actions (not value reporters)
@@ -146,6 +154,9 @@ namespace Omocha
         STOP_OBJECT,              // New: Stop script execution (from user request)
         RESTART_PROJECT,          // New: Restart the entire project
         WHEN_CLONE_START,          // New: Event when a clone is created
+        CREATE_CLONE,
+        DELETE_CLONE,
+        REMOVE_ALL_CLONES,
         // Judge (판단)
         IS_CLICKED,               // 마우스를 클릭했는가? (일반 클릭)
         IS_OBJECT_CLICKED_JUDGE,  // 특정 오브젝트를 클릭했는가? (is_object_clicked)
@@ -158,8 +169,39 @@ namespace Omocha
         IS_BOOST_MODE, //부스트 모드인가?
         IS_CURRENT_DEVICE_TYPE, // 현재 장치 유형 확인
         // TextBox specific actions
+        TEXT_WRITE,
+        TEXT_APPEND,
+        TEXT_PREPEND,
         TEXT_SET_FONT_COLOR,
-        TEXT_SET_BG_COLOR
+        TEXT_SET_BG_COLOR,
+        TEXT_CHANGE_EFFECT,
+        // 사용자 함수 (블록 타입 이름에 함수/파라미터 ID 가 붙습니다)
+        FUNCTION_CALL,  // func_<함수 ID>
+        FUNCTION_PARAM, // stringParam_<ID>, booleanParam_<ID>
+        GET_FUNC_VARIABLE,    // 함수 지역 변수 값
+        SET_FUNC_VARIABLE,    // 함수 지역 변수 정하기
+        CHANGE_FUNC_VARIABLE, // 함수 지역 변수 더하기
+
+        COUNT // 테이블 크기용. 항상 마지막에 둘 것
+    };
+
+    /**
+     * @brief 블록을 실행하는 핸들러 묶음 (Moving, Calculator, Looks ...)
+     * 블록 로드 시 opcode 와 함께 한 번만 결정됩니다.
+     */
+    enum class BlockCategory
+    {
+        NONE, // 실행 대상이 아님 (이벤트 트리거, 파라미터 전용, 알 수 없는 블록)
+        MOVING,
+        CALCULATOR,
+        LOOKS,
+        SOUND,
+        VARIABLE,
+        FUNCTION,
+        TEXTBOX,
+        EVENT,
+        FLOW,
+        COUNT
     };
 
     /**
@@ -176,5 +218,12 @@ namespace Omocha
      */
     std::string blockTypeEnumToKoreanString(BlockTypeEnum type);
 
+    /**
+     * @brief BlockTypeEnum 이 어느 핸들러에서 실행되는지 반환합니다.
+     * @param type The BlockTypeEnum value.
+     * @return 해당 블록을 처리하는 BlockCategory. 실행 대상이 아니면 NONE.
+     */
+    BlockCategory blockTypeEnumToCategory(BlockTypeEnum type);
+
     ObjectIndexChangeType stringToObjectIndexChangeType(const std::string& typeStr);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <chrono>
 #include <iostream> // 프로그레스 바 출력을 위해 추가
 #include <condition_variable>
+#include <algorithm>
 AudioEngineHelper::AudioEngineHelper() : logger("hibiki.log"), m_globalPlaybackSpeed(1.0f)
 {
     aeStdOut("Audio Engine Helper initializing...");
@@ -116,126 +117,136 @@ void AudioEngineHelper::clearPreloadedSounds()
     }
     aeStdOut(std::to_string(soundsCleared)+" preloaded sounds cleared.");
 }
-void AudioEngineHelper::playSound(const std::string &objectId, const std::string &filePath, bool loop, float initialVolume)
+AudioEngineHelper::FinishedSoundQueue::FinishedSoundQueue()
 {
-    if (!m_engineInitialized)
+    for (size_t i = 0; i < kCapacity; ++i)
     {
-        aeStdOut("Engine not initialized. Cannot play sound for object: " + objectId);
-        return;
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
     }
+}
 
-    // 해당 objectId로 이미 재생 중인 사운드가 있다면 정지하고 해제
-    auto it = m_activeSounds.find(objectId);
-    if (it != m_activeSounds.end())
+bool AudioEngineHelper::FinishedSoundQueue::push(uint64_t playbackId)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    while (true)
     {
-        ma_sound* pOldSound = it->second;
-        // Removed problematic path logging. The objectId is sufficient for identification.
-        aeStdOut("Found existing sound for object: " + objectId + ". Attempting to stop it.");
-
-        if (ma_sound_is_playing(pOldSound) == MA_TRUE) {
-            aeStdOut("Old sound for " + objectId + " IS PLAYING before stop command.");
-        } else {
-            aeStdOut("Old sound for " + objectId + " is NOT PLAYING before stop command. At end: " + std::string(ma_sound_at_end(pOldSound) ? "true" : "false"));
+        Cell &cell = m_cells[pos & (kCapacity - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.playbackId = playbackId;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
         }
-
-        // ma_sound_stop(pOldSound); // uninitializeSound 내부에서 이미 호출됨
-        // if (stop_result != MA_SUCCESS) {
-        //     aeStdOut("WARNING: ma_sound_stop() failed for " + objectId + " with error: " + ma_result_description(stop_result));
-        // }
-
-        // if (ma_sound_is_playing(pOldSound) == MA_TRUE) { // Check immediately after stop
-        //     aeStdOut("WARNING: Old sound for " + objectId + " STILL reported as PLAYING after ma_sound_stop(). At end: " + std::string(ma_sound_at_end(pOldSound) ? "true" : "false"));
-        // } else {
-        //     aeStdOut("Old sound for " + objectId + " successfully stopped (is_playing is false after stop command).");
-        // }
-        
-        aeStdOut("Uninitializing and deleting old sound for object: " + objectId);
-        uninitializeSound(pOldSound); // Calls ma_sound_stop and ma_sound_uninit
-        delete pOldSound;             // Then delete the ma_sound structure
-        m_activeSounds.erase(it);     // Finally, remove from map
-        aeStdOut("Old sound for " + objectId + " fully cleaned up from m_activeSounds.");
-    }
-    ma_sound *pSoundInstance = new (std::nothrow) ma_sound();
-    if (!pSoundInstance)
-    {
-        aeStdOut("Failed to allocate memory for sound instance: " + objectId);
-        return;
-    }
-
-    ma_result result = MA_ERROR; // Initialize to a non-success state
-
-    auto cache_it = m_decodedSoundsCache.find(filePath);
-    if (cache_it != m_decodedSoundsCache.end()) // Check if found in cache
-    {
-        // 캐시에서 발견됨, 복사하여 사용
-        // cache_it->second는 ma_sound*
-        result = ma_sound_init_copy(&m_engine, cache_it->second, 0, nullptr, pSoundInstance);
-        if (result == MA_SUCCESS)
+        else if (diff < 0)
         {
-            aeStdOut("Playing sound from cache: " + filePath + " for object: " + objectId);
+            return false; // 가득 참
         }
         else
         {
-            aeStdOut("Failed to copy sound from cache: " + filePath + ". Error: " + ma_result_description(result) + ". Loading from file instead.");
-            // result is already non-MA_SUCCESS, so it will fall through to load from file below
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
         }
     }
+}
 
-    // If not found in cache (result is still MA_ERROR) or if cache copy failed (result is non-MA_SUCCESS)
-    if (result != MA_SUCCESS)
-    { // 캐시에 없거나 복사 실패 시 파일에서 직접 로드
-        // MA_SOUND_FLAG_DECODE: 미리 디코딩하여 메모리에 로드 (짧은 효과음에 적합)
-        result = ma_sound_init_from_file(&m_engine, filePath.c_str(), MA_SOUND_FLAG_DECODE, nullptr, nullptr, pSoundInstance);
-        if (result != MA_SUCCESS)
+bool AudioEngineHelper::FinishedSoundQueue::pop(uint64_t &playbackId)
+{
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Cell &cell = m_cells[pos & (kCapacity - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
         {
-            aeStdOut("Failed to load sound file: " + filePath + " for object: " + objectId + ". Error: " + ma_result_description(result));
-            delete pSoundInstance; // 할당된 메모리 정리
-            return;
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                playbackId = cell.playbackId;
+                cell.sequence.store(pos + kCapacity, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // 비어 있음
+        }
+        else
+        {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
         }
-        aeStdOut("Playing sound loaded from file (not cached or cache copy failed): " + filePath + " for object: " + objectId);
     }
+}
 
-    ma_sound_set_looping(pSoundInstance, loop ? MA_TRUE : MA_FALSE);
-    ma_sound_set_volume(pSoundInstance, initialVolume);
-    ma_sound_set_pitch(pSoundInstance, m_globalPlaybackSpeed); // 전역 재생 속도 적용
-
-    float current_engine_volume_debug = ma_engine_get_volume(&m_engine);
-    aeStdOut("Sound '" + filePath + "' for object '" + objectId + "' PRE-START details: EngineVol=" + std::to_string(current_engine_volume_debug) +
-             ", InstanceVol=" + std::to_string(initialVolume) + // initialVolume is what was set by ma_sound_set_volume
-             ", InstancePitch=" + std::to_string(m_globalPlaybackSpeed)); // m_globalPlaybackSpeed is what was set by ma_sound_set_pitch
+void AudioEngineHelper::onSoundEnd(void *pUserData, ma_sound *pSound)
+{
+    // 오디오 스레드에서 호출됩니다. 여기서는 사운드를 해제하거나 로그를 쓰지 않고 큐에 넣기만 합니다.
+    (void)pSound;
+    auto *playing = static_cast<PlayingSound *>(pUserData);
+    playing->owner->notifySoundFinished(playing);
+}
 
-    ma_sound_start(pSoundInstance);
-    // Add a post-start check
-    if (ma_sound_is_playing(pSoundInstance) == MA_FALSE) {
-        aeStdOut("WARNING: Sound '" + filePath + "' for object '" + objectId + "' reported as NOT PLAYING immediately after ma_sound_start. At end: " + (ma_sound_at_end(pSoundInstance) ? "true" : "false"));
+void AudioEngineHelper::notifySoundFinished(PlayingSound *pSound)
+{
+    if (pSound->finished.exchange(true, std::memory_order_acq_rel))
+    {
+        return; // 이미 알림
+    }
+    if (!m_finishedSounds.push(pSound->playbackId))
+    {
+        m_finishedOverflow.store(true, std::memory_order_release);
     }
+}
 
-    m_activeSounds[objectId] = pSoundInstance; // 맵에 포인터 저장
-    aeStdOut("Sound started: " + filePath + " for object: " + objectId);
+bool AudioEngineHelper::popFinishedSound(uint64_t &playbackId)
+{
+    return m_finishedSounds.pop(playbackId);
 }
-void AudioEngineHelper::playSoundForDuration(const std::string &objectId, const std::string &filePath, double durationSeconds, bool loop, float initialVolume)
+
+bool AudioEngineHelper::consumeFinishedOverflow()
 {
-    if (!m_engineInitialized)
+    return m_finishedOverflow.exchange(false, std::memory_order_acq_rel);
+}
+
+bool AudioEngineHelper::isPlaybackActive(uint64_t playbackId) const
+{
+    for (const auto &pair : m_activeSounds)
     {
-        aeStdOut("Engine not initialized. Cannot play sound for object: " + objectId);
-        return;
+        if (pair.second->playbackId == playbackId)
+        {
+            return !pair.second->finished.load(std::memory_order_acquire);
+        }
     }
+    return false;
+}
+
+void AudioEngineHelper::releasePlayingSound(PlayingSound *pSound)
+{
+    uninitializeSound(&pSound->sound); // Calls ma_sound_stop and ma_sound_uninit
+    // uninit 뒤에는 끝 콜백이 더 오지 않으므로, 끝까지 재생되지 않은 소리는 여기서 끝남을 알립니다.
+    notifySoundFinished(pSound);
+    delete pSound;
+}
 
+AudioEngineHelper::PlayingSound *AudioEngineHelper::createPlayingSound(const std::string &objectId, const std::string &filePath, const char *logContext)
+{
     // 해당 objectId로 이미 재생 중인 사운드가 있다면 정지하고 해제
     auto it = m_activeSounds.find(objectId);
     if (it != m_activeSounds.end())
     {
         aeStdOut("Stopping and uninitializing existing sound for object: " + objectId);
-        uninitializeSound(it->second);
-        delete it->second;
+        releasePlayingSound(it->second);
         m_activeSounds.erase(it);
     }
 
-    ma_sound *pSoundInstance = new (std::nothrow) ma_sound();
+    PlayingSound *pSoundInstance = new (std::nothrow) PlayingSound();
     if (!pSoundInstance)
     {
-        aeStdOut("Failed to allocate memory for sound instance (for duration): " + objectId);
-        return;
+        aeStdOut(std::string("Failed to allocate memory for sound instance") + logContext + ": " + objectId);
+        return nullptr;
     }
 
     ma_result result = MA_ERROR; // Initialize to a non-success state
@@ -243,119 +254,105 @@ void AudioEngineHelper::playSoundForDuration(const std::string &objectId, const
     auto cache_it = m_decodedSoundsCache.find(filePath);
     if (cache_it != m_decodedSoundsCache.end()) // Check if found in cache
     {
-        result = ma_sound_init_copy(&m_engine, cache_it->second, 0, nullptr, pSoundInstance);
+        // 캐시에서 발견됨, 복사하여 사용
+        // cache_it->second는 ma_sound*
+        result = ma_sound_init_copy(&m_engine, cache_it->second, 0, nullptr, &pSoundInstance->sound);
         if (result == MA_SUCCESS)
         {
-            aeStdOut("Playing sound (for duration) from cache: " + filePath + " for object: " + objectId);
+            aeStdOut(std::string("Playing sound") + logContext + " from cache: " + filePath + " for object: " + objectId);
         }
         else
         {
-            aeStdOut("Failed to copy sound (for duration) from cache: " + filePath + ". Error: " + ma_result_description(result) + ". Loading from file.");
+            aeStdOut(std::string("Failed to copy sound") + logContext + " from cache: " + filePath + ". Error: " + ma_result_description(result) + ". Loading from file.");
         }
     }
 
     // If not found in cache (result is still MA_ERROR) or if cache copy failed (result is non-MA_SUCCESS)
-    if (result != MA_SUCCESS) 
-    {
-        result = ma_sound_init_from_file(&m_engine, filePath.c_str(), MA_SOUND_FLAG_DECODE, nullptr, nullptr, pSoundInstance);
+    if (result != MA_SUCCESS)
+    { // 캐시에 없거나 복사 실패 시 파일에서 직접 로드
+        // MA_SOUND_FLAG_DECODE: 미리 디코딩하여 메모리에 로드 (짧은 효과음에 적합)
+        result = ma_sound_init_from_file(&m_engine, filePath.c_str(), MA_SOUND_FLAG_DECODE, nullptr, nullptr, &pSoundInstance->sound);
         if (result != MA_SUCCESS)
         {
-            aeStdOut("Failed to load sound file (for duration): " + filePath + " for object: " + objectId + ". Error: " + ma_result_description(result));
-            delete pSoundInstance;
-            return;
+            aeStdOut(std::string("Failed to load sound file") + logContext + ": " + filePath + " for object: " + objectId + ". Error: " + ma_result_description(result));
+            delete pSoundInstance; // 할당된 메모리 정리
+            return nullptr;
         }
-        aeStdOut("Playing sound (for duration) loaded from file: " + filePath + " for object: " + objectId);
-    }
-
-    if (durationSeconds > 0.0)
-    {
-        ma_uint64 stopTimeMs = static_cast<ma_uint64>(durationSeconds * 1000.0);
-        ma_sound_set_stop_time_in_milliseconds(pSoundInstance, stopTimeMs);
-        aeStdOut("Sound '" + filePath + "' for object '" + objectId + "' will play for " + std::to_string(durationSeconds) + "s (stop time: " + std::to_string(stopTimeMs) + "ms)");
+        aeStdOut(std::string("Playing sound") + logContext + " loaded from file: " + filePath + " for object: " + objectId);
     }
 
-    ma_sound_set_looping(pSoundInstance, loop ? MA_TRUE : MA_FALSE);
-    ma_sound_set_pitch(pSoundInstance, m_globalPlaybackSpeed);
-    ma_sound_set_volume(pSoundInstance, initialVolume);
-    ma_sound_start(pSoundInstance);
-
-    m_activeSounds[objectId] = pSoundInstance;
-    aeStdOut("Sound started: " + filePath + " for object: " + objectId);
+    pSoundInstance->owner = this;
+    pSoundInstance->playbackId = m_nextPlaybackId.fetch_add(1, std::memory_order_relaxed);
+    ma_sound_set_end_callback(&pSoundInstance->sound, &AudioEngineHelper::onSoundEnd, pSoundInstance);
+    return pSoundInstance;
 }
-void AudioEngineHelper::playSoundFromTo(const std::string &objectId, const std::string &filePath, double startTimeSeconds, double endTimeSeconds, bool loop, float initialVolume)
+
+uint64_t AudioEngineHelper::playSound(const std::string &objectId, const std::string &filePath, bool loop, float initialVolume)
 {
     if (!m_engineInitialized)
     {
         aeStdOut("Engine not initialized. Cannot play sound for object: " + objectId);
-        return;
-    }
-
-    // 해당 objectId로 이미 재생 중인 사운드가 있다면 정지하고 해제
-    auto it = m_activeSounds.find(objectId);
-    if (it != m_activeSounds.end())
-    {
-        aeStdOut("Stopping and uninitializing existing sound for object: " + objectId);
-        uninitializeSound(it->second);
-        delete it->second;
-        m_activeSounds.erase(it);
+        return 0;
     }
 
-    ma_sound *pSoundInstance = new (std::nothrow) ma_sound();
+    PlayingSound *pSoundInstance = createPlayingSound(objectId, filePath, "");
     if (!pSoundInstance)
     {
-        aeStdOut("Failed to allocate memory for sound instance (from-to): " + objectId);
-        return;
+        return 0;
     }
+    ma_sound *pSound = &pSoundInstance->sound;
 
-    ma_result result = MA_ERROR; // Initialize to a non-success state
+    ma_sound_set_looping(pSound, loop ? MA_TRUE : MA_FALSE);
+    ma_sound_set_volume(pSound, initialVolume);
+    ma_sound_set_pitch(pSound, m_globalPlaybackSpeed); // 전역 재생 속도 적용
+    ma_sound_start(pSound);
 
-    auto cache_it = m_decodedSoundsCache.find(filePath);
-    if (cache_it != m_decodedSoundsCache.end()) // Check if found in cache
-    {
-        result = ma_sound_init_copy(&m_engine, cache_it->second, 0, nullptr, pSoundInstance);
-        if (result == MA_SUCCESS)
-        {
-            aeStdOut("Playing sound (from-to) from cache: " + filePath + " for object: " + objectId);
-        }
-        else
-        {
-            aeStdOut("Failed to copy sound (from-to) from cache: " + filePath + ". Error: " + ma_result_description(result) + ". Loading from file.");
-        }
-    }
-
-    // If not found in cache (result is still MA_ERROR) or if cache copy failed (result is non-MA_SUCCESS)
-    if (result != MA_SUCCESS) 
+    m_activeSounds[objectId] = pSoundInstance; // 맵에 포인터 저장
+    aeStdOut("Sound started: " + filePath + " for object: " + objectId);
+    return pSoundInstance->playbackId;
+}
+uint64_t AudioEngineHelper::playSoundForDuration(const std::string &objectId, const std::string &filePath, double durationSeconds, bool loop, float initialVolume)
+{
+    return playSoundFromTo(objectId, filePath, 0.0, durationSeconds, loop, initialVolume);
+}
+uint64_t AudioEngineHelper::playSoundFromTo(const std::string &objectId, const std::string &filePath, double startTimeSeconds, double endTimeSeconds, bool loop, float initialVolume)
+{
+    if (!m_engineInitialized)
     {
-        result = ma_sound_init_from_file(&m_engine, filePath.c_str(), MA_SOUND_FLAG_DECODE, nullptr, nullptr, pSoundInstance);
-        if (result != MA_SUCCESS)
-        {
-            aeStdOut("Failed to load sound file (from-to): " + filePath + " for object: " + objectId + ". Error: " + ma_result_description(result));
-            delete pSoundInstance;
-            return;
-        }
-        aeStdOut("Playing sound (from-to) loaded from file: " + filePath + " for object: " + objectId);
+        aeStdOut("Engine not initialized. Cannot play sound for object: " + objectId);
+        return 0;
     }
 
-    if (startTimeSeconds > 0.0)
+    PlayingSound *pSoundInstance = createPlayingSound(objectId, filePath, " (from-to)");
+    if (!pSoundInstance)
     {
-        ma_sound_seek_to_second(pSoundInstance, static_cast<float>(startTimeSeconds));
-        aeStdOut("Sound '" + filePath + "' seeked to " + std::to_string(startTimeSeconds) + "s for playFromTo.");
+        return 0;
     }
+    ma_sound *pSound = &pSoundInstance->sound;
 
-    if (endTimeSeconds > startTimeSeconds)
+    // 구간은 데이터 소스 범위로 지정합니다. 예약 정지(ma_sound_set_stop_time_*)와 달리 범위 끝에 닿으면 끝 콜백이 불립니다.
+    ma_uint32 sampleRate = 0;
+    ma_sound_get_data_format(pSound, nullptr, nullptr, &sampleRate, nullptr, 0);
+    if (sampleRate > 0 && (startTimeSeconds > 0.0 || endTimeSeconds > startTimeSeconds))
     {
-        ma_uint64 stopTimeMs = static_cast<ma_uint64>(endTimeSeconds * 1000.0);
-        ma_sound_set_stop_time_in_milliseconds(pSoundInstance, stopTimeMs);
-        aeStdOut("Sound '" + filePath + "' stop time set to " + std::to_string(stopTimeMs) + "ms for playFromTo.");
+        const ma_uint64 beginFrame = static_cast<ma_uint64>((std::max)(startTimeSeconds, 0.0) * sampleRate);
+        ma_uint64 endFrame = ~static_cast<ma_uint64>(0);
+        if (endTimeSeconds > startTimeSeconds)
+        {
+            endFrame = static_cast<ma_uint64>(endTimeSeconds * sampleRate);
+        }
+        ma_data_source_set_range_in_pcm_frames(ma_sound_get_data_source(pSound), beginFrame, endFrame);
+        aeStdOut("Sound '" + filePath + "' for object '" + objectId + "' range set to " + std::to_string(startTimeSeconds) + "s - " + std::to_string(endTimeSeconds) + "s");
     }
 
-    ma_sound_set_looping(pSoundInstance, loop ? MA_TRUE : MA_FALSE);
-    ma_sound_set_volume(pSoundInstance, initialVolume);
-    ma_sound_set_pitch(pSoundInstance, m_globalPlaybackSpeed);
-    ma_sound_start(pSoundInstance);
+    ma_sound_set_looping(pSound, loop ? MA_TRUE : MA_FALSE);
+    ma_sound_set_volume(pSound, initialVolume);
+    ma_sound_set_pitch(pSound, m_globalPlaybackSpeed);
+    ma_sound_start(pSound);
 
     m_activeSounds[objectId] = pSoundInstance;
     aeStdOut("Sound started: " + filePath + " for object: " + objectId);
+    return pSoundInstance->playbackId;
 }
 bool AudioEngineHelper::isSoundPlaying(const std::string &objectId) const
 {
@@ -365,7 +362,7 @@ bool AudioEngineHelper::isSoundPlaying(const std::string &objectId) const
     auto it = m_activeSounds.find(objectId);
     if (it != m_activeSounds.end())
     {
-        return ma_sound_is_playing(it->second) == MA_TRUE; // it->second는 ma_sound*
+        return ma_sound_is_playing(&it->second->sound) == MA_TRUE;
     }
     return false;
 }
@@ -408,9 +405,8 @@ void AudioEngineHelper::stopSound(const std::string &objectId)
     if (it != m_activeSounds.end())
     {
         aeStdOut("Stopping and uninitializing sound for object: " + objectId);
-        uninitializeSound(it->second); // it->second는 ma_sound*
-        delete it->second;             // 힙 메모리 해제
-        m_activeSounds.erase(it);      // 맵에서 제거
+        releasePlayingSound(it->second); // 정지 및 힙 메모리 해제
+        m_activeSounds.erase(it);        // 맵에서 제거
     }
     else
     {
@@ -425,8 +421,7 @@ void AudioEngineHelper::stopAllSounds()
     aeStdOut("Stopping all sounds...");
     for (auto &pair : m_activeSounds)
     {
-        uninitializeSound(pair.second); // pair.second는 ma_sound*
-        delete pair.second;             // 힙 메모리 해제
+        releasePlayingSound(pair.second); // 정지 및 힙 메모리 해제
     }
     // 배경음악도 중지
     if (m_backgroundMusicInitialized)
@@ -450,8 +445,7 @@ void AudioEngineHelper::stopAllSoundsExcept(const std::string &objectIdToKeepPla
     {
         if (pair.first != objectIdToKeepPlaying)
         {
-            uninitializeSound(pair.second); // pair.second는 ma_sound*
-            delete pair.second;             // 힙 메모리 해제
+            releasePlayingSound(pair.second); // 정지 및 힙 메모리 해제
             idsToRemove.push_back(pair.first);
         }
     }
@@ -469,7 +463,7 @@ unsigned int AudioEngineHelper::getPlayingSoundCount() const
     unsigned int playingCount = 0;
     for (const auto &pair : m_activeSounds)
     {
-        if (ma_sound_is_playing(pair.second)) // pair.second는 ma_sound*
+        if (ma_sound_is_playing(&pair.second->sound))
         {
             playingCount++;
         }
@@ -484,7 +478,7 @@ void AudioEngineHelper::setSoundVolume(const std::string &objectId, float volume
     auto it = m_activeSounds.find(objectId);
     if (it != m_activeSounds.end())
     {
-        ma_sound_set_volume(it->second, volume); // it->second는 ma_sound*
+        ma_sound_set_volume(&it->second->sound, volume);
     }
     else
     {
@@ -513,7 +507,7 @@ float AudioEngineHelper::getSoundVolume(const std::string &objectId) const
     auto it = m_activeSounds.find(objectId);
     if (it != m_activeSounds.end())
     {
-        return ma_sound_get_volume(it->second); // it->second는 ma_sound*
+        return ma_sound_get_volume(&it->second->sound);
     }
     aeStdOut("Cannot get volume: No sound found for object: " + objectId);
     return 0.0f; // 또는 오류 값 (예: -1.0f)
@@ -610,7 +604,7 @@ void AudioEngineHelper::setGlobalPlaybackSpeed(float speed)
     // 모든 활성 효과음에 적용
     for (auto &pair : m_activeSounds)
     {
-        ma_sound_set_pitch(pair.second, m_globalPlaybackSpeed); // pair.second는 ma_sound*
+        ma_sound_set_pitch(&pair.second->sound, m_globalPlaybackSpeed);
     }
     // 배경음악에 적용
     if (m_backgroundMusicInitialized)
@@ -1,5 +1,8 @@
 #pragma once // 헤더 가드 추가
 #include <string>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <vector> // getPlayingObjectIDs를 위해 추가 (선택 사항)
 #include <map>    // m_activeSounds를 위해 추가
 #include "Logger.h"
@@ -11,7 +14,42 @@ private:
     mutable SimpleLogger logger; 
     ma_engine m_engine;
 
-    std::map<std::string, ma_sound*> m_activeSounds; // 오브젝트 ID와 ma_sound 매핑
+    // 재생 중인 효과음 하나. 끝 콜백(오디오 스레드)이 playbackId 를 알 수 있도록 ma_sound 와 함께 둡니다.
+    struct PlayingSound
+    {
+        ma_sound sound;
+        AudioEngineHelper *owner = nullptr;
+        uint64_t playbackId = 0;
+        std::atomic<bool> finished{false}; // 끝남 알림을 한 번만 보내기 위한 플래그
+    };
+
+    /**
+     * @brief 끝난 재생 ID 를 모으는 잠금 없는 유한 큐 (Vyukov bounded MPMC)
+     * 오디오 스레드(끝 콜백)와 소리를 멈추는 스레드가 넣고, 엔진이 프레임마다 메인 스레드에서 꺼냅니다.
+     */
+    class FinishedSoundQueue
+    {
+    public:
+        FinishedSoundQueue();
+        bool push(uint64_t playbackId); // 가득 차면 false
+        bool pop(uint64_t &playbackId);
+
+    private:
+        static constexpr size_t kCapacity = 1024; // 2 의 거듭제곱이어야 합니다.
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            uint64_t playbackId;
+        };
+        std::array<Cell, kCapacity> m_cells;
+        alignas(64) std::atomic<size_t> m_enqueuePos{0};
+        alignas(64) std::atomic<size_t> m_dequeuePos{0};
+    };
+
+    std::map<std::string, PlayingSound*> m_activeSounds; // 오브젝트 ID와 재생 중인 사운드 매핑
+    std::atomic<uint64_t> m_nextPlaybackId{1};
+    FinishedSoundQueue m_finishedSounds;
+    std::atomic<bool> m_finishedOverflow{false}; // 큐가 가득 차 끝남 알림을 잃었음
 
     bool m_engineInitialized = false;
     std::map<std::string, ma_sound*> m_decodedSoundsCache; // 미리 디코딩된 사운드 캐시
@@ -22,6 +60,12 @@ private:
 
     // 내부적으로 사운드를 안전하게 해제하는 헬퍼 함수
     void uninitializeSound(ma_sound* pSound);
+    // 효과음을 멈추고 해제합니다. 아직 끝나지 않았다면 끝남을 알립니다. (기다리는 스크립트가 멈춘 소리에 묶이지 않도록)
+    void releasePlayingSound(PlayingSound *pSound);
+    // objectId 의 효과음 인스턴스를 새로 만들어 초기화합니다. (캐시 복사 또는 파일 로드) 실패하면 nullptr
+    PlayingSound *createPlayingSound(const std::string &objectId, const std::string &filePath, const char *logContext);
+    void notifySoundFinished(PlayingSound *pSound);
+    static void onSoundEnd(void *pUserData, ma_sound *pSound);
 
 public:
     AudioEngineHelper();
@@ -30,10 +74,17 @@ public:
     // 사운드 미리 로딩
     void preloadSound(const std::string& filePath);
     void clearPreloadedSounds(); // 모든 미리 로딩된 사운드 해제
-    // 효과음 관련 메서드
-    void playSound(const std::string& objectId, const std::string& filePath, bool loop=false, float initialVolume=1.0f);
-    void playSoundForDuration(const std::string &objectId, const std::string &filePath, double durationSeconds, bool loop=false, float initialVolume=1.0f);
-    void playSoundFromTo(const std::string &objectId, const std::string &filePath, double startTimeSeconds, double endTimeSeconds,  bool loop=false, float initialVolume=1.0f);
+    // 효과음 관련 메서드. 재생 ID 를 반환합니다. (실패하면 0)
+    // 재생이 끝나거나, 멈추거나, 같은 오브젝트의 다른 소리로 바뀌면 그 ID 가 popFinishedSound 로 한 번 나옵니다.
+    uint64_t playSound(const std::string& objectId, const std::string& filePath, bool loop=false, float initialVolume=1.0f);
+    uint64_t playSoundForDuration(const std::string &objectId, const std::string &filePath, double durationSeconds, bool loop=false, float initialVolume=1.0f);
+    uint64_t playSoundFromTo(const std::string &objectId, const std::string &filePath, double startTimeSeconds, double endTimeSeconds,  bool loop=false, float initialVolume=1.0f);
+    // 끝난 재생 ID 를 하나 꺼냅니다. 없으면 false
+    bool popFinishedSound(uint64_t &playbackId);
+    // 큐가 가득 차 끝남 알림을 잃은 적이 있으면 true 를 반환하고 표시를 지웁니다. (이때는 isPlaybackActive 로 확인)
+    bool consumeFinishedOverflow();
+    // 재생 ID 의 소리가 아직 끝나지 않았는지
+    bool isPlaybackActive(uint64_t playbackId) const;
     void stopSound(const std::string &objectId);
     void stopAllSounds();
     void stopAllSoundsExcept(const std::string& objectIdToKeepPlaying);
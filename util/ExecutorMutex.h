@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+
+/*
+ * 스크립트 실행기용 뮤텍스
+ *
+ * 작업자 풀로 스크립트를 실행할 때는 감싼 뮤텍스를 그대로 잠급니다.
+ * 인라인 실행기(모든 스크립트 스레드를 메인 스레드에서 차례로 실행)가 켜져 있으면 다른 스레드가 없으므로
+ * 잠금을 건너뜁니다. 분기는 프로젝트를 불러올 때만 바뀌므로 항상 같은 쪽으로 예측됩니다.
+ *
+ * 켜고 끄는 것은 이 뮤텍스를 잡은 스레드가 하나도 없을 때(프로젝트 로드 중, 작업자 풀을 멈춘 뒤)만 해야 합니다.
+ * 잠근 뒤에 상태가 바뀌면 unlock 이 짝을 잃습니다.
+ */
+
+class ExecutorLockElision
+{
+public:
+    static void setSingleThreaded(bool singleThreaded) { s_singleThreaded.store(singleThreaded, std::memory_order_release); }
+    static bool isSingleThreaded() { return s_singleThreaded.load(std::memory_order_relaxed); }
+
+private:
+    static inline std::atomic<bool> s_singleThreaded{false};
+};
+
+template<typename Mutex>
+class ExecutorMutex
+{
+public:
+    void lock()
+    {
+        if (!ExecutorLockElision::isSingleThreaded()) {
+            m_mutex.lock();
+        }
+    }
+
+    bool try_lock() { return ExecutorLockElision::isSingleThreaded() || m_mutex.try_lock(); }
+
+    void unlock()
+    {
+        if (!ExecutorLockElision::isSingleThreaded()) {
+            m_mutex.unlock();
+        }
+    }
+
+private:
+    Mutex m_mutex;
+};
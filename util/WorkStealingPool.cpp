@@ -0,0 +1,216 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+namespace {
+    constexpr int64_t kInitialRingCapacity = 256; // 2 의 거듭제곱이어야 합니다.
+
+    // 현재 스레드가 작업자로 속한 풀과 그 번호
+    thread_local const WorkStealingPool *t_pool = nullptr;
+    thread_local size_t t_workerIndex = 0;
+}
+
+WorkStealingPool::ChaseLevDeque::Ring::Ring(int64_t cap)
+    : capacity(cap), slots(std::make_unique<std::atomic<Task *>[]>(static_cast<size_t>(cap)))
+{
+}
+
+WorkStealingPool::ChaseLevDeque::ChaseLevDeque()
+{
+    m_rings.push_back(std::make_unique<Ring>(kInitialRingCapacity));
+    m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingPool::ChaseLevDeque::~ChaseLevDeque()
+{
+    Ring *ring = m_ring.load(std::memory_order_relaxed);
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    for (int64_t i = m_top.load(std::memory_order_relaxed); i < bottom; ++i) {
+        delete ring->get(i);
+    }
+}
+
+void WorkStealingPool::ChaseLevDeque::push(Task *task)
+{
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_acquire);
+    Ring *ring = m_ring.load(std::memory_order_relaxed);
+    if (bottom - top > ring->capacity - 1) {
+        auto bigger = std::make_unique<Ring>(ring->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, ring->get(i));
+        }
+        ring = bigger.get();
+        m_rings.push_back(std::move(bigger));
+        m_ring.store(ring, std::memory_order_release);
+    }
+    ring->put(bottom, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+WorkStealingPool::Task *WorkStealingPool::ChaseLevDeque::pop()
+{
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    Ring *ring = m_ring.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // 비어 있음
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Task *task = ring->get(bottom);
+    if (top == bottom) {
+        // 마지막 항목은 steal 과 경쟁합니다.
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+WorkStealingPool::Task *WorkStealingPool::ChaseLevDeque::steal()
+{
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return nullptr;
+    }
+    Ring *ring = m_ring.load(std::memory_order_acquire);
+    Task *task = ring->get(top);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr; // 다른 스레드가 먼저 가져감
+    }
+    return task;
+}
+
+bool WorkStealingPool::ChaseLevDeque::empty() const
+{
+    return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+}
+
+WorkStealingPool::WorkStealingPool(size_t threadCount, TaskRunner runner) : m_runner(std::move(runner))
+{
+    threadCount = (std::max)(threadCount, static_cast<size_t>(1));
+    // steal 이 m_workers 를 훑으므로 작업자를 시작하기 전에 모두 만들어 둡니다.
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers[i]->thread = std::thread(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    m_stop.store(true, std::memory_order_seq_cst); {
+        std::lock_guard lock(m_sleepMutex);
+    }
+    m_sleepCv.notify_all();
+    for (auto &worker: m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    // 종료 중에 작업자가 아닌 스레드가 넣은 작업
+    for (auto &queue: m_injected) {
+        for (Task *task: queue) {
+            delete task;
+        }
+    }
+}
+
+void WorkStealingPool::submit(Task task, TaskPriority priority)
+{
+    auto *owned = new Task(std::move(task));
+    const auto level = static_cast<size_t>(priority);
+    // 게시 전에 세어야 꺼낸 쪽의 감소가 먼저 일어나지 않습니다.
+    m_queued.fetch_add(1, std::memory_order_seq_cst);
+    if (t_pool == this) {
+        m_workers[t_workerIndex]->deques[level].push(owned);
+    } else {
+        std::lock_guard lock(m_injectedMutex);
+        m_injected[level].push_back(owned);
+        m_injectedCount.fetch_add(1, std::memory_order_release);
+    }
+    wakeOne();
+}
+
+int WorkStealingPool::currentWorkerIndex() const
+{
+    return t_pool == this ? static_cast<int>(t_workerIndex) : -1;
+}
+
+void WorkStealingPool::wakeOne()
+{
+    // 작업자는 m_sleeping 을 올린 뒤 잠금 안에서 m_queued 를 확인하므로, 0 을 읽었다면 그 작업자는 새 작업을 봅니다.
+    if (m_sleeping.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard lock(m_sleepMutex);
+        m_sleepCv.notify_one();
+    }
+}
+
+WorkStealingPool::Task *WorkStealingPool::findTask(size_t index)
+{
+    const size_t workerCount = m_workers.size();
+    Worker &self = *m_workers[index];
+    for (size_t level = 0; level < kPriorityCount; ++level) {
+        if (Task *task = self.deques[level].pop()) {
+            return task;
+        }
+        if (m_injectedCount.load(std::memory_order_acquire) > 0) {
+            std::lock_guard lock(m_injectedMutex);
+            auto &queue = m_injected[level];
+            if (!queue.empty()) {
+                Task *task = queue.front();
+                queue.pop_front();
+                m_injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        for (size_t k = 1; k < workerCount; ++k) {
+            if (Task *task = m_workers[(index + k) % workerCount]->deques[level].steal()) {
+                return task;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void WorkStealingPool::workerLoop(size_t index)
+{
+    t_pool = this;
+    t_workerIndex = index;
+    while (true) {
+        if (Task *task = findTask(index)) {
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            std::unique_ptr<Task> owned(task);
+            if (m_runner) {
+                m_runner(*owned);
+            } else {
+                (*owned)();
+            }
+            continue;
+        }
+        if (m_queued.load(std::memory_order_seq_cst) > 0) {
+            // 게시 중이거나 다른 작업자가 방금 가져간 작업. 잠들지 않고 다시 찾습니다.
+            std::this_thread::yield();
+            continue;
+        }
+        if (m_stop.load(std::memory_order_acquire)) {
+            break;
+        }
+        std::unique_lock lock(m_sleepMutex);
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        m_sleepCv.wait(lock, [this] {
+            return m_queued.load(std::memory_order_seq_cst) > 0 || m_stop.load(std::memory_order_acquire);
+        });
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+    t_pool = nullptr;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * 작업 훔치기(work-stealing) 스레드 풀
+ *
+ * 작업자마다 Chase-Lev 덱을 하나씩(우선순위 단계마다) 가지고, 작업자 안에서 게시한 작업은 자기 덱 아래쪽에
+ * 잠금 없이 넣고 꺼냅니다. 할 일이 없는 작업자는 다른 작업자 덱의 위쪽에서 훔쳐 옵니다.
+ * 작업자가 아닌 스레드(메인 루프 등)에서 게시한 작업은 우선순위별 주입 큐로 들어갑니다.
+ * 모든 큐가 비면 작업자는 조건 변수에서 잠듭니다.
+ */
+
+enum class TaskPriority : uint8_t
+{
+    HIGH,
+    NORMAL,
+    LOW
+};
+
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+    // 작업 하나를 실행합니다. 예외 처리 정책은 풀을 만든 쪽이 정합니다.
+    using TaskRunner = std::function<void(Task &)>;
+
+    WorkStealingPool(size_t threadCount, TaskRunner runner);
+    // 남은 작업을 모두 실행한 뒤 작업자를 join 합니다.
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    void submit(Task task, TaskPriority priority = TaskPriority::NORMAL);
+    size_t size() const { return m_workers.size(); }
+    // 현재 스레드가 이 풀의 작업자이면 그 번호, 아니면 -1
+    int currentWorkerIndex() const;
+
+private:
+    static constexpr size_t kPriorityCount = 3;
+
+    /**
+     * @brief Chase-Lev 덱 (Lê et al. 2013 의 약한 메모리 모델 버전)
+     * push / pop 은 소유 작업자만, steal 은 아무 스레드나 호출합니다. 항목은 소유권을 넘기는 Task 포인터입니다.
+     */
+    class ChaseLevDeque
+    {
+    public:
+        ChaseLevDeque();
+        ~ChaseLevDeque();
+        void push(Task *task);
+        Task *pop();
+        Task *steal();
+        bool empty() const;
+
+    private:
+        struct Ring
+        {
+            int64_t capacity;
+            std::unique_ptr<std::atomic<Task *>[]> slots;
+            explicit Ring(int64_t cap);
+            Task *get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_acquire); }
+            void put(int64_t i, Task *task) { slots[i & (capacity - 1)].store(task, std::memory_order_release); }
+        };
+        alignas(64) std::atomic<int64_t> m_top{0};
+        alignas(64) std::atomic<int64_t> m_bottom{0};
+        std::atomic<Ring *> m_ring;
+        // 커진 뒤의 이전 링은 steal 중인 스레드가 아직 읽을 수 있으므로 덱이 사라질 때까지 보관합니다. (소유자만 접근)
+        std::vector<std::unique_ptr<Ring>> m_rings;
+    };
+
+    struct Worker
+    {
+        std::array<ChaseLevDeque, kPriorityCount> deques;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::array<std::deque<Task *>, kPriorityCount> m_injected; // 작업자가 아닌 스레드가 게시한 작업
+    std::mutex m_injectedMutex;
+    std::atomic<size_t> m_injectedCount{0}; // 주입 큐가 비었으면 잠그지 않고 건너뛰기 위한 수
+    std::atomic<size_t> m_queued{0}; // 아직 꺼내지 않은 작업 수 (잠들지 판단용)
+    std::atomic<int> m_sleeping{0};  // 조건 변수에서 잠든 (또는 잠들려는) 작업자 수
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCv;
+    std::atomic<bool> m_stop{false};
+    TaskRunner m_runner;
+
+    void workerLoop(size_t index);
+    Task *findTask(size_t index);
+    void wakeOne();
+};